@@ -1,6 +1,22 @@
 #!/bin/sh
 
-g++ -O2 -Iinclude -o analyzer src/analyzer.cc src/SignalAnalyzer.cc -L/usr/X11R6/lib -lX11 -l fftw3
+# The signal processing library doesn't need X.
+g++ -O2 -Iinclude -c src/SpectrumTables.cc src/SpectrumEngine.cc src/FixedPointFft.cc src/SpectrumDetector.cc src/SpectrumStatistics.cc src/SpectrumMeter.cc src/SpectrumReference.cc src/HighResolutionSpectrum.cc src/SpectrumTraces.cc src/DisplayGovernor.cc src/ScopeTrigger.cc src/SpectrumAutoScaler.cc src/IqCorrector.cc src/LatencyMonitor.cc src/ToneBank.cc src/Demodulator.cc src/IqCodec.cc src/IqCompressor.cc src/IqDecompressor.cc src/CaptureRing.cc src/Renderer.cc src/NullRenderer.cc src/SoftwareRasterizer.cc src/ImageRenderer.cc src/TileRenderer.cc src/ControlSocket.cc src/CrossCorrelator.cc src/SharedRing.cc src/RealtimeMode.cc
+ar rcs libanalyzerdsp.a SpectrumTables.o SpectrumEngine.o FixedPointFft.o SpectrumDetector.o SpectrumStatistics.o SpectrumMeter.o SpectrumReference.o HighResolutionSpectrum.o SpectrumTraces.o DisplayGovernor.o ScopeTrigger.o SpectrumAutoScaler.o IqCorrector.o LatencyMonitor.o ToneBank.o Demodulator.o IqCodec.o IqCompressor.o IqDecompressor.o CaptureRing.o Renderer.o NullRenderer.o SoftwareRasterizer.o ImageRenderer.o TileRenderer.o ControlSocket.o CrossCorrelator.o SharedRing.o RealtimeMode.o
+rm -f SpectrumTables.o SpectrumEngine.o FixedPointFft.o SpectrumDetector.o SpectrumStatistics.o SpectrumMeter.o SpectrumReference.o HighResolutionSpectrum.o SpectrumTraces.o DisplayGovernor.o ScopeTrigger.o SpectrumAutoScaler.o IqCorrector.o LatencyMonitor.o ToneBank.o Demodulator.o IqCodec.o IqCompressor.o IqDecompressor.o CaptureRing.o Renderer.o NullRenderer.o SoftwareRasterizer.o ImageRenderer.o TileRenderer.o ControlSocket.o CrossCorrelator.o SharedRing.o RealtimeMode.o
 
-g++ -O2 -Iinclude -o fileThrottler src/fileThrottler.cc
+g++ -O2 -Iinclude -o analyzer src/analyzer.cc src/SignalAnalyzer.cc src/X11Renderer.cc -L. -lanalyzerdsp -L/usr/X11R6/lib -lX11 -l fftw3_threads -l fftw3 -lpthread -lrt
 
+g++ -O2 -Iinclude -o multiAnalyzer src/multiAnalyzer.cc src/StreamDispatcher.cc src/SignalAnalyzer.cc src/X11Renderer.cc -L. -lanalyzerdsp -L/usr/X11R6/lib -lX11 -l fftw3_threads -l fftw3 -lpthread
+
+g++ -O2 -Iinclude -o correlator src/correlator.cc src/X11Renderer.cc -L. -lanalyzerdsp -L/usr/X11R6/lib -lX11 -l fftw3 -lpthread
+
+g++ -O2 -Iinclude -o fileThrottler src/fileThrottler.cc -L. -lanalyzerdsp -lpthread -lrt
+
+g++ -O2 -Iinclude -o fftBenchmark src/fftBenchmark.cc -L. -lanalyzerdsp -l fftw3
+
+g++ -O2 -Iinclude -o spectrogram src/spectrogram.cc -L. -lanalyzerdsp -l fftw3 -lpthread
+
+g++ -O2 -Iinclude -o toneMonitor src/toneMonitor.cc -L. -lanalyzerdsp
+
+g++ -O2 -Iinclude -o toneBankCheck src/toneBankCheck.cc -L. -lanalyzerdsp
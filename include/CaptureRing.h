@@ -0,0 +1,104 @@
+//**************************************************************************
+// file name: CaptureRing.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class keeps the last few seconds of IQ data in a ring buffer so
+// that, when something interesting happens, the data from before it can
+// be saved along with the data that follows.  The ring is allocated once
+// and touched up front, so nothing is allocated and no page faults are
+// taken while samples arrive, and it can be locked into memory and
+// backed by huge pages.  When the ring is triggered, a thread writes the
+// pre-trigger history and the post-trigger window to a file, straight
+// from the ring, while the samples keep arriving.  The ring has a
+// second of slack beyond the pre-trigger history, so the writer has
+// that long to keep ahead of the samples that overwrite the ring.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __CAPTURERING__
+#define __CAPTURERING__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "IqCompressor.h"
+
+class CaptureRing
+{
+  //***************************** operations **************************
+
+  public:
+
+  CaptureRing(float sampleRate,
+              float preTriggerTime,
+              float postTriggerTime,
+              const char *filePrefixPtr,
+              bool lockMemory,
+              bool compress);
+
+ ~CaptureRing(void);
+
+  void acceptSamples(const int8_t *signalBufferPtr,uint32_t bufferLength);
+  void trigger(const char *reasonPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void allocateRing(bool lockMemory);
+  static void *threadEntry(void *argPtr);
+  void run(void);
+  void startCapture(void);
+  void finishCapture(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  float sampleRate;
+  const char *filePrefixPtr;
+  bool compress;
+
+  // Lengths in bytes of IQ data.
+  uint64_t preTriggerLength;
+  uint64_t postTriggerLength;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Ring support.  Positions count bytes from the
+  // start of the IQ data, and a position lives at
+  // position % ringLength in the ring.  Samples
+  // up to reservedPosition may be in the ring,
+  // and samples up to receivedPosition are.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  uint8_t *ringPtr;
+  uint64_t ringLength;
+  uint64_t mappedLength;
+  uint64_t receivedPosition;
+  uint64_t reservedPosition;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Capture support.  The capture covers the data
+  // from captureStart up to captureEnd, and the
+  // data up to writePosition has been written.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  bool capturePending;
+  uint64_t triggerPosition;
+  uint64_t captureStart;
+  uint64_t captureEnd;
+  uint64_t writePosition;
+  bool overrun;
+  char reason[32];
+  uint32_t captureNumber;
+  char fileName[256];
+  FILE *captureStreamPtr;
+  IqCompressor *compressorPtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  bool stopping;
+  pthread_mutex_t ringLock;
+  pthread_cond_t dataAvailable;
+  pthread_t thread;
+};
+
+#endif // __CAPTURERING__
@@ -0,0 +1,127 @@
+//**************************************************************************
+// file name: ControlSocket.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class lets other programs change the settings of a running
+// analyzer through a UNIX-domain socket, so the pipeline doesn't have to
+// be restarted.  The protocol is a line of text per command, such as
+// "reference -20" or "window blackman", and each command is answered
+// with a line that starts with "OK" or "ERROR".  A thread of its own
+// accepts connections and parses commands, and anything expensive, such
+// as a new window, is built by that thread.  The analyzer picks up the
+// commands between frames, applies them, and replies.  FFTW planning
+// isn't thread safe, so tables that the analyzer is finished with are
+// handed back, and this thread destroys them too.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __CONTROLSOCKET__
+#define __CONTROLSOCKET__
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "SpectrumTables.h"
+
+#define MAX_CONTROL_CLIENTS (4)
+#define CONTROL_QUEUE_SIZE (16)
+#define CONTROL_LINE_SIZE (128)
+
+enum ControlCommandType {ControlReferenceLevel=1, ControlVerticalGain,
+                         ControlDisplayType, ControlSampleRate,
+                         ControlWindow, ControlFrameAggregation,
+                         ControlAveragingLength, ControlFftSize};
+
+struct ControlCommand
+{
+  ControlCommandType type;
+  float value;
+
+  // The tables for a window command.
+  SpectrumTables *tablesPtr;
+
+  // This identifies the connection that the reply goes to.
+  uint32_t clientId;
+};
+
+struct ControlClient
+{
+  int descriptor;
+  uint32_t clientId;
+  char line[CONTROL_LINE_SIZE];
+  uint32_t lineLength;
+  bool discarding;
+};
+
+struct ControlReply
+{
+  uint32_t clientId;
+  char text[CONTROL_LINE_SIZE];
+};
+
+class ControlSocket
+{
+  //***************************** operations **************************
+
+  public:
+
+  ControlSocket(const char *pathPtr,uint32_t numberOfPoints);
+ ~ControlSocket(void);
+
+  bool isListening(void);
+
+  bool getCommand(ControlCommand *commandPtr);
+  void reply(ControlCommand *commandPtr,const char *textPtr);
+  void retireTables(SpectrumTables *tablesPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  static void *threadEntry(void *argPtr);
+  void run(void);
+  void acceptClient(void);
+  void readClient(ControlClient *clientPtr);
+  void parseLine(ControlClient *clientPtr);
+  bool queueCommand(ControlCommand *commandPtr);
+  void sendText(uint32_t clientId,const char *textPtr);
+  void sendReplies(void);
+  void wakeUp(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  char path[108];
+  uint32_t numberOfPoints;
+
+  int listenDescriptor;
+  int wakeupDescriptor;
+
+  ControlClient clients[MAX_CONTROL_CLIENTS];
+  uint32_t nextClientId;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Everything below is shared with the analyzer,
+  // and is protected by the lock.  The window
+  // commands that are queued, plus the tables that
+  // have been retired, are kept below the queue
+  // size, so the retired tables always fit.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  ControlCommand commands[CONTROL_QUEUE_SIZE];
+  uint32_t oldestCommand;
+  uint32_t numberOfCommands;
+  uint32_t numberOfWindowCommands;
+
+  ControlReply replies[CONTROL_QUEUE_SIZE];
+  uint32_t numberOfReplies;
+
+  SpectrumTables *retiredTables[CONTROL_QUEUE_SIZE + 1];
+  uint32_t numberOfRetiredTables;
+
+  bool stopping;
+  pthread_mutex_t controlLock;
+  pthread_t thread;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __CONTROLSOCKET__
@@ -0,0 +1,157 @@
+//**************************************************************************
+// file name: CrossCorrelator.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class computes the cross-correlation of two synchronized IQ
+// streams over a range of lags, with FFT's.  Each block of the second
+// stream is correlated against the block of the first stream that
+// surrounds it by the largest lag on either side (overlap-save), so
+// lags much longer than a block can be covered by choosing a larger
+// FFT.  A pool of threads correlates the blocks, each with its own FFT
+// buffers and its own running sums, and the sums are combined once per
+// result.  Each result is the correlation magnitude, normalized by the
+// energy of both streams (the coherence), at every lag, along with the
+// lag of the peak, interpolated to a fraction of a sample, and the
+// phase at the peak.  A positive lag means that the signal arrives at
+// the first stream later than at the second.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __CROSSCORRELATOR__
+#define __CROSSCORRELATOR__
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <fftw3.h>
+
+#define MAX_CORRELATION_THREADS (16)
+
+// There are this many blocks per thread.
+#define CORRELATION_JOBS_PER_THREAD (4)
+
+#define MAX_CORRELATION_JOBS \
+  (MAX_CORRELATION_THREADS * CORRELATION_JOBS_PER_THREAD)
+
+enum CorrelationJobState {CorrelationJobFree=0, CorrelationJobQueued,
+                          CorrelationJobBusy, CorrelationJobDone};
+
+struct CorrelationJob
+{
+  // The first stream, including the lags on either side.
+  int8_t *firstPtr;
+
+  // The second stream.
+  int8_t *secondPtr;
+
+  CorrelationJobState state;
+};
+
+class CrossCorrelator;
+
+struct CorrelationWorker
+{
+  CrossCorrelator *correlatorPtr;
+  fftw_complex *firstPtr;
+  fftw_complex *secondPtr;
+
+  // The running sums for the current result.
+  double *sumPtr;
+  double firstEnergy;
+  double secondEnergy;
+
+  pthread_t thread;
+};
+
+class CrossCorrelator
+{
+  //***************************** operations **************************
+
+  public:
+
+  CrossCorrelator(uint32_t maximumLag,
+                  uint32_t samplesPerResult,
+                  uint32_t numberOfThreads);
+
+ ~CrossCorrelator(void);
+
+  uint32_t getBlockLength(void);
+  uint32_t getMaximumLag(void);
+
+  bool acceptSamples(const int8_t *firstBufferPtr,
+                     const int8_t *secondBufferPtr);
+
+  const float *getCoherence(void);
+  double getPeakLag(void);
+  float getPeakCoherence(void);
+  float getPeakPhase(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  static void *threadEntry(void *argPtr);
+  void run(CorrelationWorker *workerPtr);
+  void correlateBlock(CorrelationWorker *workerPtr,CorrelationJob *jobPtr);
+
+  void submitJob(void);
+  void reclaimFinishedJobs(uint32_t maximumPending);
+  void computeResult(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t maximumLag;
+  uint32_t numberOfLags;
+  uint32_t fftSize;
+  uint32_t blockLength;
+  uint32_t blocksPerResult;
+
+  // The first block only primes the history.
+  bool primed;
+  uint32_t blocksInResult;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The most recent samples of each stream.  The
+  // second stream is delayed by the largest lag so
+  // that the first stream surrounds it.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  int8_t *firstHistoryPtr;
+  int8_t *secondHistoryPtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // FFTW3 support.
+  fftw_plan forwardPlan;
+  fftw_plan inversePlan;
+
+  uint32_t numberOfThreads;
+  CorrelationWorker workers[MAX_CORRELATION_THREADS];
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The jobs form a ring.  The oldest job is the
+  // next one to be reclaimed, the pending jobs
+  // follow it, and the job after those is being
+  // filled.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  CorrelationJob jobs[MAX_CORRELATION_JOBS];
+  uint32_t numberOfJobs;
+  uint32_t oldestJob;
+  uint32_t numberOfPendingJobs;
+  bool stopping;
+  pthread_mutex_t jobLock;
+  pthread_cond_t jobQueued;
+  pthread_cond_t jobDone;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The latest result.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  double *sumPtr;
+  float *coherencePtr;
+  double peakLag;
+  float peakCoherence;
+  float peakPhase;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __CROSSCORRELATOR__
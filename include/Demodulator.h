@@ -0,0 +1,142 @@
+//**************************************************************************
+// file name: Demodulator.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements an AM or FM demodulator that turns the IQ data
+// that the signal analyzer is displaying into 48000S/s, 16-bit PCM audio
+// that is written to a file descriptor.  The demodulator runs on its own
+// thread: blocks of IQ data are copied into a queue, and the thread
+// demodulates them, so the display keeps running.  If the queue is full,
+// because whatever reads the audio has fallen behind, the caller waits
+// for room, so that no audio is lost when the IQ data comes from a
+// file.  With live input, the block can instead be dropped and counted
+// rather than holding up the display.  FM is demodulated
+// with a polar discriminator (the angle of x[n] * conj(x[n-1])) that
+// uses a polynomial arctangent, four samples at a time with SSE.  AM
+// uses the same magnitude estimator as the oscilloscope, and the carrier
+// level is removed and used as the gain.  The audio is brought to
+// 48000S/s by a polyphase resampler that only computes the output
+// samples, and wide FM is de-emphasized.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __DEMODULATOR__
+#define __DEMODULATOR__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// This is the audio sample rate.
+#define AUDIO_SAMPLE_RATE (48000)
+
+// The queue holds this many blocks of this many IQ values.
+#define DEMODULATOR_QUEUE_LENGTH (16)
+#define DEMODULATOR_BLOCK_SIZE (16384)
+
+enum DemodulationType {AmDemodulation=1, NarrowFmDemodulation,
+                       WideFmDemodulation};
+
+class Demodulator
+{
+  //***************************** operations **************************
+
+  public:
+
+  Demodulator(DemodulationType type,
+              float sampleRate,
+              int outputDescriptor,
+              bool dropWhenFull);
+
+ ~Demodulator(void);
+
+  void acceptSamples(int8_t *signalBufferPtr,uint32_t bufferLength);
+  void reportStatistics(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  static void *threadEntry(void *argPtr);
+  void run(void);
+
+  void designResampler(void);
+  void demodulateBlock(int8_t *signalBufferPtr,uint32_t bufferLength);
+  void discriminate(int8_t *signalBufferPtr,
+                    uint32_t numberOfSamples,
+                    float *outputPtr);
+
+  uint32_t resample(void);
+  void writePcm(uint32_t numberOfSamples);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  DemodulationType type;
+  float sampleRate;
+
+  // FM support.
+  float previousI;
+  float previousQ;
+  float fmGain;
+  float iBuffer[(DEMODULATOR_BLOCK_SIZE / 2) + 1];
+  float qBuffer[(DEMODULATOR_BLOCK_SIZE / 2) + 1];
+
+  // AM support.
+  int16_t magnitudeBuffer[DEMODULATOR_BLOCK_SIZE / 2];
+  float carrierLevel;
+  float carrierAlpha;
+
+  // De-emphasis support.
+  bool deemphasisEnabled;
+  float deemphasisAlpha;
+  float deemphasisState;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Resampler support.  The sample rate is changed
+  // by interpolation / decimation, and each phase
+  // of the filter has tapsPerPhase taps, stored in
+  // reverse order.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  uint32_t interpolation;
+  uint32_t decimation;
+  uint32_t tapsPerPhase;
+  float *phaseTapsPtr;
+
+  // The last tapsPerPhase - 1 samples, followed by the new ones.
+  float *historyPtr;
+  uint32_t historyLength;
+
+  // The newest input sample of the next output, and its phase.
+  uint32_t inputIndex;
+  uint32_t phase;
+
+  float *audioBufferPtr;
+  int16_t *pcmBufferPtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Output support.
+  int outputDescriptor;
+  bool outputFailed;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Queue support.  Blocks go in at the tail and
+  // come out at the head.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  int8_t queue[DEMODULATOR_QUEUE_LENGTH][DEMODULATOR_BLOCK_SIZE];
+  uint32_t queueLengths[DEMODULATOR_QUEUE_LENGTH];
+  uint32_t queueHead;
+  uint32_t queueTail;
+  uint32_t queueCount;
+  bool stopping;
+  bool dropWhenFull;
+  uint64_t numberOfBlocks;
+  uint64_t numberOfDroppedBlocks;
+  pthread_mutex_t queueLock;
+  pthread_cond_t queueNotEmpty;
+  pthread_cond_t queueNotFull;
+  pthread_t thread;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __DEMODULATOR__
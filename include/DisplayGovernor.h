@@ -0,0 +1,81 @@
+//**************************************************************************
+// file name: DisplayGovernor.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a display frame rate governor.  IQ data arrives
+// much faster than a monitor can show it, so the governor decides when
+// a frame is due, and the analyzer accumulates everything that arrives
+// between frames.  The governor also measures how much time is spent
+// computing and rendering, relative to the real time that is represented
+// by the samples, so that the headroom of the system is known.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __DISPLAYGOVERNOR__
+#define __DISPLAYGOVERNOR__
+
+#include <stdio.h>
+#include <stdint.h>
+
+class DisplayGovernor
+{
+  //***************************** operations **************************
+
+  public:
+
+  DisplayGovernor(float framesPerSecond,
+      float sampleRate,
+      bool reportEnabled);
+
+ ~DisplayGovernor(void);
+
+  bool isFrameDue(void);
+
+  void startCompute(void);
+  void stopCompute(uint32_t numberOfSamples);
+
+  void startRender(void);
+  void stopRender(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  uint64_t getTimeInNs(void);
+  void reportStatistics(const char *labelPtr,
+                        uint64_t elapsedTime,
+                        uint64_t frames,
+                        uint64_t computeTime,
+                        uint64_t renderTime,
+                        uint64_t samples);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  float sampleRate;
+  bool reportEnabled;
+
+  // A value of zero means that every block is a frame.
+  uint64_t framePeriod;
+  uint64_t nextFrameTime;
+
+  // Measurement support.
+  uint64_t computeStartTime;
+  uint64_t renderStartTime;
+
+  // Totals since the start of the run.
+  uint64_t startTime;
+  uint64_t totalFrames;
+  uint64_t totalComputeTime;
+  uint64_t totalRenderTime;
+  uint64_t totalSamples;
+
+  // Totals since the last report.
+  uint64_t intervalStartTime;
+  uint64_t intervalFrames;
+  uint64_t intervalComputeTime;
+  uint64_t intervalRenderTime;
+  uint64_t intervalSamples;
+};
+
+#endif // __DISPLAYGOVERNOR__
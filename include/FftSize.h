@@ -0,0 +1,17 @@
+//**************************************************************************
+// file name: FftSize.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This defines the FFT size of the signal analyzer on its own, so that
+// the tools that work with the same blocks of IQ data (the spectrogram,
+// the FFT benchmark and so on) use the same size without pulling in the
+// display.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __FFTSIZE__
+#define __FFTSIZE__
+
+// This is the FFT size.
+#define N (8192)
+
+#endif // __FFTSIZE__
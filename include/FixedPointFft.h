@@ -0,0 +1,73 @@
+//**************************************************************************
+// file name: FixedPointFft.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a fixed-point FFT for 8-bit IQ data.  The data
+// is held as 16-bit integers, and block floating point is used to keep
+// the data from overflowing: before each stage, the whole block is
+// shifted down just enough that the stage can't overflow, and the shift
+// is remembered as a common exponent.  The transform is a radix-4
+// decimation in frequency FFT, with a final radix-2 stage when the size
+// is not a power of 4.  On x86 processors, the butterflies use SSE2.
+// For 8-bit input, this is plenty of precision, and it runs nicely on
+// processors that have lousy floating point performance.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __FIXEDPOINTFFT__
+#define __FIXEDPOINTFFT__
+
+#include <stdint.h>
+
+class FixedPointFft
+{
+  //***************************** operations **************************
+
+  public:
+
+  FixedPointFft(uint32_t numberOfPoints);
+
+ ~FixedPointFft(void);
+
+  int32_t transform(const int8_t *signalBufferPtr,uint32_t bufferLength);
+
+  void computePowerSpectrum(const int8_t *signalBufferPtr,
+                            uint32_t bufferLength,
+                            float *powerBufferPtr);
+
+  void getComplexSpectrum(double *spectrumPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  uint32_t computeOutputIndex(uint32_t position,uint32_t length);
+  int32_t loadInput(const int8_t *signalBufferPtr,uint32_t bufferLength);
+  int32_t radix4Stage(uint32_t length,uint32_t twiddleStride,int shift);
+  void radix2Stage(int shift);
+  int computeStageShift(int32_t maximum,int32_t limit);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfPoints;
+  uint32_t numberOfRadix4Stages;
+  bool radix2StageNeeded;
+
+  // The block exponent of the last transform.
+  int32_t exponent;
+
+  // Interleaved I,Q working data.
+  int16_t *dataPtr;
+
+  // The Hanning window in Q15.
+  int16_t *windowPtr;
+
+  // Interleaved cos,sin twiddle factors in Q15.
+  int16_t *twiddlePtr;
+
+  // Maps a frequency bin to its position in the working data.
+  uint32_t *positionTablePtr;
+};
+
+#endif // __FIXEDPOINTFFT__
@@ -0,0 +1,116 @@
+//**************************************************************************
+// file name: HighResolutionSpectrum.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class computes power spectra with FFT's that are far larger than
+// the display FFT, up to 16M points, for measuring carrier offsets to a
+// fraction of a hertz.  Blocks of IQ data are collected until there are
+// enough samples for an FFT, and then a thread of its own windows the
+// samples and runs a multithreaded FFTW plan over them, so the caller
+// never waits for the transform.  While it does, the next FFT's worth of
+// samples is collected.  All of the storage is one huge-page-friendly
+// mapping that is allocated and touched up front.  The spectrum is
+// reduced to display columns with peak binning, and its level is scaled
+// so that a tone reads the same as it does in the display FFT.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __HIGHRESOLUTIONSPECTRUM__
+#define __HIGHRESOLUTIONSPECTRUM__
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <fftw3.h>
+
+// These are the limits of the FFT size.
+#define MIN_HIGH_RESOLUTION_POINTS (65536)
+#define MAX_HIGH_RESOLUTION_POINTS (16 * 1024 * 1024)
+
+class HighResolutionSpectrum
+{
+  //***************************** operations **************************
+
+  public:
+
+  HighResolutionSpectrum(uint32_t numberOfPoints,
+                         uint32_t referencePoints,
+                         uint32_t numberOfThreads);
+
+ ~HighResolutionSpectrum(void);
+
+  bool isValid(void);
+  uint32_t getNumberOfPoints(void);
+  uint64_t getNumberOfSpectra(void);
+  uint64_t getNumberOfSkippedSpectra(void);
+
+  void acceptSamples(const int8_t *signalBufferPtr,uint32_t bufferLength);
+
+  bool binSpectrumSpan(uint32_t firstPoint,
+                       uint32_t numberOfPointsInSpan,
+                       float *binnedSpectrumInDbPtr,
+                       uint32_t numberOfBins,
+                       double *peakPointPtr,
+                       float *peakPowerInDbPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  bool allocateBuffers(void);
+  static void *threadEntry(void *argPtr);
+  void run(void);
+  void computeSpectrum(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfPoints;
+
+  // This scales the power to the display FFT.
+  float powerScale;
+
+  // This is where everything lives.
+  uint8_t *mappingPtr;
+  uint64_t mappedLength;
+
+  // This will be used for windowing data before the FFT.
+  float *windowPtr;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Samples are collected into one buffer while
+  // the other one is transformed.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  int8_t *fillBufferPtr;
+  int8_t *transformBufferPtr;
+  uint32_t fillLength;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // FFTW3 support.
+  fftw_complex *fftBufferPtr;
+  fftw_plan fftPlan;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The linear power spectrum, FFT shifted.  The
+  // thread fills the spare spectrum and swaps it
+  // with the current one.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  float *currentPowerPtr;
+  float *sparePowerPtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Thread support.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  bool valid;
+  bool transformPending;
+  bool stopping;
+  uint64_t numberOfSpectra;
+  uint64_t numberOfSkippedSpectra;
+  pthread_t thread;
+  pthread_mutex_t spectrumLock;
+  pthread_cond_t samplesReady;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __HIGHRESOLUTIONSPECTRUM__
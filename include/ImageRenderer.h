@@ -0,0 +1,77 @@
+//**************************************************************************
+// file name: ImageRenderer.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a renderer that draws each frame with the
+// software rasterizer and writes it as a binary PPM (color) or PGM
+// (gray) image.  The frames are either written to a directory, one
+// file per frame, or written back to back to stdout, which is the
+// format that "ffmpeg -f image2pipe" reads.  No X server is needed.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __IMAGERENDERER__
+#define __IMAGERENDERER__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "Renderer.h"
+#include "SoftwareRasterizer.h"
+
+class ImageRenderer : public Renderer
+{
+  //***************************** operations **************************
+
+  public:
+
+  ImageRenderer(int windowWidthInPixels,
+      int windowHeightInPixels,
+      const char *targetPtr,
+      bool grayscale);
+
+ ~ImageRenderer(void);
+
+  void setTitle(const char *titlePtr);
+  int getFontHeight(void);
+
+  void beginFrame(void);
+  void endFrame(void);
+  void clearArea(int x,int y,int width,int height);
+
+  void setColor(RenderColor color);
+  void drawLine(int x1,int y1,int x2,int y2);
+  void drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawSegments(RenderSegment *segmentsPtr,uint32_t numberOfSegments);
+  void drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawString(int x,int y,const char *textPtr);
+
+  int getKeystroke(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  bool writeFrame(FILE *streamPtr);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  // This is either a directory or "-" for stdout.
+  char target[256];
+  bool grayscale;
+
+  // The number of frames that have been written.
+  uint32_t frameNumber;
+
+  // This keeps a broken target from flooding stderr.
+  bool errorReported;
+
+  // These are the R,G,B values of each RenderColor.
+  uint8_t colorTable[NumberOfRenderColors][3];
+
+  // Everything is drawn here.
+  SoftwareRasterizer *rasterizerPtr;
+};
+
+#endif // __IMAGERENDERER__
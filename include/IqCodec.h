@@ -0,0 +1,107 @@
+//**************************************************************************
+// file name: IqCodec.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements the lossless compression of a block of 8-bit IQ
+// data.  Each of I and Q is predicted from its own past (no prediction,
+// the previous value, or a straight line through the previous two
+// values, whichever leaves the least entropy in the block), and the
+// prediction residuals are Huffman coded with a canonical code whose
+// lengths are stored with the block.  Codes are at most 12 bits long, so
+// decoding is one table lookup per value.  Every block can be decoded on
+// its own, and a block that doesn't compress is stored as it is.
+//
+// A compressed IQ stream looks like this:
+//
+//   "IQZ1", the block size (32 bits)
+//   blocks: the raw length (32 bits), the payload length (32 bits), the
+//   method (8 bits), the predictor (8 bits), 2 spare bytes, and the
+//   payload (128 bytes of code lengths, two per byte, then the code)
+//   an end block, with both lengths zero
+//   the offset of every block (64 bits each)
+//   the offset of the index (64 bits), the number of blocks (32 bits),
+//   "IQZI"
+//
+// All values are little endian.  Every block but the last holds
+// IQZ_BLOCK_SIZE raw bytes.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __IQCODEC__
+#define __IQCODEC__
+
+#include <stdint.h>
+
+// The number of raw bytes in a block.
+#define IQZ_BLOCK_SIZE (262144)
+
+#define IQZ_FILE_HEADER_SIZE (8)
+#define IQZ_BLOCK_HEADER_SIZE (12)
+#define IQZ_TRAILER_SIZE (16)
+
+// A compressed block, header included, is never larger than this.
+#define IQZ_MAX_COMPRESSED_SIZE (IQZ_BLOCK_HEADER_SIZE + IQZ_BLOCK_SIZE)
+
+// The longest Huffman code.
+#define IQZ_MAX_CODE_LENGTH (12)
+
+// These are the ways that a block is stored.
+#define IQZ_METHOD_STORED (0)
+#define IQZ_METHOD_HUFFMAN (1)
+
+class IqCodec
+{
+  //***************************** operations **************************
+
+  public:
+
+  IqCodec(void);
+ ~IqCodec(void);
+
+  uint32_t compressBlock(const uint8_t *rawPtr,
+                         uint32_t rawLength,
+                         uint8_t *compressedPtr);
+
+  bool decompressBlock(const uint8_t *compressedPtr,
+                       uint32_t compressedLength,
+                       uint8_t *rawPtr,
+                       uint32_t *rawLengthPtr);
+
+  static void putUint32(uint8_t *bufferPtr,uint32_t value);
+  static void putUint64(uint8_t *bufferPtr,uint64_t value);
+  static uint32_t getUint32(const uint8_t *bufferPtr);
+  static uint64_t getUint64(const uint8_t *bufferPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  uint32_t choosePredictor(const uint8_t *rawPtr,uint32_t rawLength);
+
+  void predict(const uint8_t *rawPtr,
+               uint32_t rawLength,
+               uint32_t predictor);
+
+  void reconstruct(uint8_t *rawPtr,uint32_t rawLength,uint32_t predictor);
+
+  void buildCodeLengths(uint32_t predictor);
+  void buildCodes(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  // The prediction residuals of a block.
+  uint8_t *residualPtr;
+
+  // The residual histogram of each predictor.
+  uint32_t counts[3][256];
+
+  // The Huffman code.
+  uint8_t codeLengths[256];
+  uint16_t codes[256];
+
+  // Decoding table: the symbol in the low 8 bits, the length above.
+  uint16_t decodeTable[1 << IQZ_MAX_CODE_LENGTH];
+};
+
+#endif // __IQCODEC__
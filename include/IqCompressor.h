@@ -0,0 +1,106 @@
+//**************************************************************************
+// file name: IqCompressor.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class writes IQ data to a stream in the compressed format that is
+// described in IqCodec.h.  The data is cut into blocks, and a pool of
+// threads compresses the blocks, each with its own codec, so the
+// compression keeps up with high sample rates.  The blocks are written
+// in order as they finish.  When the compressor is destroyed, the last
+// block, the end block and the block index are written.  If every
+// block is busy, the caller waits for the oldest one to be written.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __IQCOMPRESSOR__
+#define __IQCOMPRESSOR__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "IqCodec.h"
+
+#define MAX_COMPRESSION_THREADS (16)
+
+// There are this many blocks per thread.
+#define COMPRESSION_JOBS_PER_THREAD (2)
+
+#define MAX_COMPRESSION_JOBS \
+  (MAX_COMPRESSION_THREADS * COMPRESSION_JOBS_PER_THREAD)
+
+enum CompressionJobState {JobFree=0, JobQueued, JobCompressing, JobDone};
+
+struct CompressionJob
+{
+  uint8_t *rawPtr;
+  uint32_t rawLength;
+  uint8_t *compressedPtr;
+  uint32_t compressedLength;
+  CompressionJobState state;
+};
+
+class IqCompressor;
+
+struct CompressionWorker
+{
+  IqCompressor *compressorPtr;
+  IqCodec *codecPtr;
+  pthread_t thread;
+};
+
+class IqCompressor
+{
+  //***************************** operations **************************
+
+  public:
+
+  IqCompressor(FILE *streamPtr,uint32_t numberOfThreads);
+ ~IqCompressor(void);
+
+  void acceptSamples(const int8_t *signalBufferPtr,uint32_t bufferLength);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  static void *threadEntry(void *argPtr);
+  void run(IqCodec *codecPtr);
+
+  void submitJob(void);
+  void writeFinishedJobs(uint32_t maximumPending);
+  void writeBytes(const uint8_t *bufferPtr,uint32_t length);
+  void writeIndex(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  FILE *streamPtr;
+  uint64_t streamOffset;
+  bool outputFailed;
+
+  // The offset of each block that was written.
+  uint64_t *blockOffsetsPtr;
+  uint32_t numberOfBlocks;
+  uint32_t blockOffsetsCapacity;
+
+  uint32_t numberOfThreads;
+  CompressionWorker workers[MAX_COMPRESSION_THREADS];
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The jobs form a ring.  The oldest job is the
+  // next one to be written, the pending jobs follow
+  // it, and the job after those is being filled.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  CompressionJob jobs[MAX_COMPRESSION_JOBS];
+  uint32_t numberOfJobs;
+  uint32_t oldestJob;
+  uint32_t numberOfPendingJobs;
+  bool stopping;
+  pthread_mutex_t jobLock;
+  pthread_cond_t jobQueued;
+  pthread_cond_t jobDone;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __IQCOMPRESSOR__
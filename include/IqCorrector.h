@@ -0,0 +1,124 @@
+//**************************************************************************
+// file name: IqCorrector.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a front end stage that measures the quality of
+// IQ data as it arrives: the DC offset of I and Q, the gain and phase
+// imbalance between them, and the fraction of samples that are clipped.
+// The sums that the estimates come from are gathered in the same pass
+// that converts unsigned samples to signed ones, using SSE2 when it is
+// available, and they decay from block to block so that the estimates
+// follow changes in the hardware.  Optionally, the DC offset and the
+// imbalance are corrected, which gets rid of the DC spike that an rtl-sdr
+// puts in the middle of the spectrum.  The samples themselves are left
+// alone: the spectrum engine applies the correction in floating point as
+// it converts the samples for the FFT, since rounding back to 8 bits
+// leaves up to half a unit of DC, which is still a spike.  Whatever needs
+// 8-bit samples gets a corrected, rounded copy from correctSamples().
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __IQCORRECTOR__
+#define __IQCORRECTOR__
+
+#include <stdio.h>
+#include <stdint.h>
+
+// This describes the quality of the IQ data.
+struct IqQuality
+{
+  // DC offsets in sample units.
+  float dcOffsetI;
+  float dcOffsetQ;
+
+  // The power of I relative to Q in dB.
+  float gainImbalanceInDb;
+
+  // The departure of I and Q from quadrature in degrees.
+  float phaseErrorInDegrees;
+
+  // The percentage of samples that are at full scale.
+  float clipPercentage;
+};
+
+// This is the correction that follows from the estimates:
+// I' = I - dcOffsetI, Q' = (iFactor * I') + (qFactor * (Q - dcOffsetQ)).
+struct IqCorrection
+{
+  float dcOffsetI;
+  float dcOffsetQ;
+  float iFactor;
+  float qFactor;
+};
+
+class IqCorrector
+{
+  //***************************** operations **************************
+
+  public:
+
+  IqCorrector(bool correctionEnabled,
+      float sampleRate,
+      FILE *reportStreamPtr);
+
+ ~IqCorrector(void);
+
+  void acceptSamples(int8_t *signalBufferPtr,
+                     uint32_t bufferLength,
+                     bool unsignedSamples);
+
+  void getQuality(IqQuality *qualityPtr);
+  bool getCorrection(IqCorrection *correctionPtr);
+
+  void correctSamples(const int8_t *signalBufferPtr,
+                      uint32_t bufferLength,
+                      int8_t *correctedBufferPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void accumulateSums(int8_t *signalBufferPtr,
+                      uint32_t bufferLength,
+                      bool unsignedSamples);
+
+  void updateEstimates(uint32_t numberOfSamples);
+  void reportQuality(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  bool correctionEnabled;
+
+  // The sums of the current block.
+  int64_t blockSumI;
+  int64_t blockSumQ;
+  int64_t blockSumII;
+  int64_t blockSumQQ;
+  int64_t blockSumIQ;
+  uint64_t blockClips;
+
+  // The decayed sums of all of the blocks so far.
+  double sumI;
+  double sumQ;
+  double sumII;
+  double sumQQ;
+  double sumIQ;
+  double clips;
+  double samples;
+
+  // The current estimates.
+  IqQuality quality;
+
+  // The correction that follows from the estimates, along with the
+  // DC offsets in quality.
+  float iFactor;
+  float qFactor;
+
+  // Reporting support.
+  FILE *reportStreamPtr;
+  uint64_t reportInterval;
+  uint64_t samplesSinceReport;
+};
+
+#endif // __IQCORRECTOR__
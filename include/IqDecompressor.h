@@ -0,0 +1,62 @@
+//**************************************************************************
+// file name: IqDecompressor.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class reads IQ data from a stream in the compressed format that is
+// described in IqCodec.h.  The blocks are decoded one at a time as the
+// data is read, on the caller's thread, which is many times faster than
+// any sample rate that an SDR produces.  If the stream is a file, the
+// block index can be used to start anywhere in the data without
+// decoding what comes before.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __IQDECOMPRESSOR__
+#define __IQDECOMPRESSOR__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "IqCodec.h"
+
+class IqDecompressor
+{
+  //***************************** operations **************************
+
+  public:
+
+  IqDecompressor(FILE *streamPtr);
+ ~IqDecompressor(void);
+
+  bool isValid(void);
+  uint32_t readSamples(int8_t *signalBufferPtr,uint32_t bufferLength);
+  bool seek(uint64_t offset);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  bool readBlock(void);
+  bool loadIndex(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  FILE *streamPtr;
+  bool valid;
+  bool endOfStream;
+
+  IqCodec codec;
+  uint8_t *compressedPtr;
+
+  // The block that is being read.
+  uint8_t *rawPtr;
+  uint32_t rawLength;
+  uint32_t position;
+
+  // The offset of each block, once the index has been loaded.
+  uint64_t *blockOffsetsPtr;
+  uint32_t numberOfBlocks;
+};
+
+#endif // __IQDECOMPRESSOR__
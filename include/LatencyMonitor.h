@@ -0,0 +1,95 @@
+//**************************************************************************
+// file name: LatencyMonitor.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a measurement of how stale the display is.  Each
+// block of IQ data is stamped when it is read, and when a frame has made
+// it to the screen, the age of the oldest block that the frame shows is
+// recorded.  A program that feeds the analyzer (fileThrottler, for
+// example) can also send marker blocks, which carry the time at which
+// they were written, so that the time spent in pipes and stdio buffers
+// is measured as well.  The latencies are kept in logarithmic histograms
+// (40 bins per decade), and percentiles are reported to stderr every 10
+// seconds and at exit.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __LATENCYMONITOR__
+#define __LATENCYMONITOR__
+
+#include <stdio.h>
+#include <stdint.h>
+
+// The histograms cover 10us through 10s.
+#define LATENCY_BINS_PER_DECADE (40)
+#define LATENCY_NUMBER_OF_BINS (240)
+
+// The most markers that can be waiting for a frame.
+#define MAX_PENDING_MARKERS (16)
+
+// A marker block is at least this long.
+#define LATENCY_MARKER_MINIMUM_LENGTH (64)
+
+// This is a histogram of latencies.
+struct LatencyHistogram
+{
+  uint32_t counts[LATENCY_NUMBER_OF_BINS];
+  uint64_t total;
+  uint64_t maximum;
+};
+
+class LatencyMonitor
+{
+  //***************************** operations **************************
+
+  public:
+
+  LatencyMonitor(void);
+ ~LatencyMonitor(void);
+
+  void stampBlock(const int8_t *signalBufferPtr,uint32_t bufferLength);
+  void frameDisplayed(void);
+
+  static uint64_t getTimeInNs(void);
+
+  static void writeMarker(int8_t *signalBufferPtr,
+                          uint32_t bufferLength,
+                          uint64_t timestamp);
+
+  static bool readMarker(const int8_t *signalBufferPtr,
+                         uint32_t bufferLength,
+                         uint64_t *timestampPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void record(LatencyHistogram *histogramPtr,uint64_t latency);
+  float getPercentile(LatencyHistogram *histogramPtr,float percentile);
+  void reportHistogram(const char *labelPtr,LatencyHistogram *histogramPtr);
+  void reportStatistics(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  // Read time to screen, for the oldest block of each frame.
+  LatencyHistogram displayLatency;
+
+  // Write time to screen, for each marker.
+  LatencyHistogram markerLatency;
+
+  // Write time to read time, for each marker.
+  LatencyHistogram inputLatency;
+
+  // The read time of the oldest block that is waiting for a frame.
+  uint64_t oldestReadTime;
+
+  // The write times of the markers that are waiting for a frame.
+  uint64_t pendingMarkers[MAX_PENDING_MARKERS];
+  uint32_t numberOfPendingMarkers;
+
+  // Reporting support.
+  uint64_t lastReportTime;
+};
+
+#endif // __LATENCYMONITOR__
@@ -0,0 +1,44 @@
+//**************************************************************************
+// file name: NullRenderer.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a renderer that throws everything away.  The
+// signal analyzer still does all of its work, so this is handy for
+// measuring how fast the processing runs without a display getting in
+// the way.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __NULLRENDERER__
+#define __NULLRENDERER__
+
+#include <stdint.h>
+
+#include "Renderer.h"
+
+class NullRenderer : public Renderer
+{
+  //***************************** operations **************************
+
+  public:
+
+  NullRenderer(void);
+
+ ~NullRenderer(void);
+
+  void setTitle(const char *titlePtr);
+  int getFontHeight(void);
+
+  void beginFrame(void);
+  void endFrame(void);
+
+  void setColor(RenderColor color);
+  void drawLine(int x1,int y1,int x2,int y2);
+  void drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawSegments(RenderSegment *segmentsPtr,uint32_t numberOfSegments);
+  void drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawString(int x,int y,const char *textPtr);
+
+  int getKeystroke(void);
+};
+
+#endif // __NULLRENDERER__
@@ -0,0 +1,84 @@
+//**************************************************************************
+// file name: RealtimeMode.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class keeps the thread that reads, processes and displays the IQ
+// data (the hot path) from being descheduled or taking page faults.  It
+// is created before any other thread, and it confines the process to
+// the helper CPUs, so every thread that is created afterward (the
+// demodulator, the capture writer and so on) inherits them.  If only the
+// CPU of the hot path is given, the helper CPUs are all of the others.
+// When the hot path is entered, the stack is touched, all memory is
+// locked (which faults in every buffer that has been allocated), the hot
+// path thread is pinned to a CPU of its own, and it is switched to
+// SCHED_FIFO if the system allows it.  The page faults and context switches of the hot
+// path are reported to stderr at exit, so that it can be checked that it
+// never faults.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __REALTIMEMODE__
+#define __REALTIMEMODE__
+
+#include <stdint.h>
+#include <sched.h>
+#include <sys/resource.h>
+
+// This much of the stack is touched before it is locked.
+#define REALTIME_STACK_PREFAULT (256 * 1024)
+
+class RealtimeMode
+{
+  //***************************** operations **************************
+
+  public:
+
+  RealtimeMode(const char *cpuListPtr);
+ ~RealtimeMode(void);
+
+  bool isValid(void);
+
+  void enterHotPath(void);
+  void leaveHotPath(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  bool parseCpuList(const char *cpuListPtr);
+  void prefaultStack(void);
+  void reportStatistics(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  bool valid;
+
+  // The CPU of the hot path, or -1 to leave it unpinned.
+  int hotCpu;
+
+  // The CPUs of every other thread.
+  cpu_set_t helperCpus;
+  uint32_t numberOfHelperCpus;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // What could be done.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  bool memoryLocked;
+  bool pinned;
+  int fifoPriority;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Resource usage of the hot path thread.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  bool inHotPath;
+  bool measured;
+  struct rusage startUsage;
+  struct rusage endUsage;
+  uint64_t startTime;
+  uint64_t endTime;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __REALTIMEMODE__
@@ -0,0 +1,73 @@
+//**************************************************************************
+// file name: Renderer.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class defines the interface between the signal analyzer and
+// whatever it is drawing on.  The signal analyzer only ever clears the
+// display (or a part of it), draws lines, segments, points and strings in one of a small
+// set of colors, and asks for keystrokes.  A backend implements these
+// for a particular output: an X window, image files, or nothing at all.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __RENDERER__
+#define __RENDERER__
+
+#include <stdint.h>
+
+// These are all of the colors that the signal analyzer uses.
+enum RenderColor {BackgroundColor=0, GridColor, SignalColor,
+                  NoiseFloorColor, MaxHoldColor, MinHoldColor,
+                  AverageColor, HighResolutionColor, HighlightColor,
+                  NumberOfRenderColors};
+
+// This is a point on the display.  The origin is the upper left.
+struct RenderPoint
+{
+  int16_t x;
+  int16_t y;
+};
+
+// This is a line segment on the display.
+struct RenderSegment
+{
+  int16_t x1;
+  int16_t y1;
+  int16_t x2;
+  int16_t y2;
+};
+
+class Renderer
+{
+  //***************************** operations **************************
+
+  public:
+
+  virtual ~Renderer(void);
+
+  virtual void setTitle(const char *titlePtr) = 0;
+  virtual int getFontHeight(void) = 0;
+
+  virtual void beginFrame(void) = 0;
+  virtual void endFrame(void) = 0;
+  virtual void synchronize(void);
+  virtual void clearArea(int x,int y,int width,int height);
+
+  virtual void setColor(RenderColor color) = 0;
+  virtual void drawLine(int x1,int y1,int x2,int y2) = 0;
+
+  virtual void drawLines(RenderPoint *pointsPtr,
+                         uint32_t numberOfPoints) = 0;
+
+  virtual void drawSegments(RenderSegment *segmentsPtr,
+                            uint32_t numberOfSegments) = 0;
+
+  virtual void drawPoints(RenderPoint *pointsPtr,
+                          uint32_t numberOfPoints) = 0;
+
+  virtual void drawString(int x,int y,const char *textPtr) = 0;
+
+  virtual int getKeystroke(void) = 0;
+  virtual int getPointerPosition(void);
+};
+
+#endif // __RENDERER__
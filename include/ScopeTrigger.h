@@ -0,0 +1,121 @@
+//**************************************************************************
+// file name: ScopeTrigger.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements the level/edge trigger of an oscilloscope.  IQ
+// samples are fed to it as they arrive, and it searches the magnitude,
+// I or Q of the samples for a rising or falling crossing of a trigger
+// level.  When the trigger fires, a sweep of IQ samples is captured that
+// starts a few samples before the trigger point (these come from a small
+// history buffer when the trigger is near the start of a block) and
+// continues into as many following blocks as are needed.  The search
+// compares eight samples at a time, using SSE2 when it is available.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SCOPETRIGGER__
+#define __SCOPETRIGGER__
+
+#include <stdint.h>
+
+// This is the quantity that is compared against the trigger level.
+enum TriggerSource {TriggerOnMagnitude=1, TriggerOnI, TriggerOnQ};
+
+// This is the direction of the crossing.
+enum TriggerSlope {RisingEdge=1, FallingEdge};
+
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// Normal - Sweeps are only captured when the trigger fires.
+// Auto - If the trigger hasn't fired for two sweeps, a sweep is
+// captured anyway, so that something is always displayed.
+// Single - One sweep is captured, and the trigger must be re-armed
+// before another one is captured.
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+enum TriggerMode {NormalTrigger=1, AutoTrigger, SingleTrigger};
+
+class ScopeTrigger
+{
+  //***************************** operations **************************
+
+  public:
+
+  ScopeTrigger(uint32_t sweepLength,
+      TriggerSource source,
+      TriggerSlope slope,
+      int16_t level,
+      TriggerMode mode,
+      uint32_t holdoffInSamples);
+
+ ~ScopeTrigger(void);
+
+  void acceptSamples(const int8_t *signalBufferPtr,uint32_t bufferLength);
+  bool getSweep(int8_t *sweepBufferPtr);
+  void arm(void);
+
+  const char *getStatus(void);
+
+  private:
+
+  // These are the states of the trigger.
+  enum TriggerState {Armed=1, Capturing, HoldingOff, Stopped};
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void processBlock(const int8_t *signalBufferPtr,uint32_t numberOfSamples);
+  void extractSource(const int8_t *signalBufferPtr,uint32_t numberOfSamples);
+  int32_t findTrigger(uint32_t startIndex,uint32_t numberOfSamples);
+  bool isTriggerPoint(int16_t previousValue,int16_t value);
+
+  void startSweep(const int8_t *signalBufferPtr,uint32_t triggerIndex);
+
+  uint32_t continueSweep(const int8_t *signalBufferPtr,
+                         uint32_t startIndex,
+                         uint32_t numberOfSamples);
+
+  void updateHistory(const int8_t *signalBufferPtr,uint32_t numberOfSamples);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  // The trigger settings.
+  TriggerSource source;
+  TriggerSlope slope;
+  int16_t level;
+  TriggerMode mode;
+  uint32_t holdoffInSamples;
+
+  // The number of IQ samples in a sweep.
+  uint32_t sweepLength;
+
+  // The number of IQ samples of a sweep that precede the trigger point.
+  uint32_t preTriggerLength;
+
+  TriggerState state;
+
+  // The last source value of the previous block.
+  int16_t previousSourceValue;
+
+  // The number of samples for which the trigger hasn't fired.
+  uint32_t samplesWithoutTrigger;
+
+  // The number of holdoff samples that remain.
+  uint32_t holdoffRemaining;
+
+  // Whether the last sweep was forced by the auto mode.
+  bool autoTriggered;
+
+  // The sweep that is being captured, and the last one that completed.
+  int8_t *sweepBufferPtr;
+  int8_t *completedSweepPtr;
+  uint32_t sweepSamples;
+  bool sweepReady;
+
+  // The last preTriggerLength IQ samples of the previous blocks.
+  int8_t *historyPtr;
+
+  // The trigger source of the current block.
+  int16_t *sourceBufferPtr;
+  uint32_t sourceBufferLength;
+};
+
+#endif // __SCOPETRIGGER__
@@ -0,0 +1,120 @@
+//**************************************************************************
+// file name: SharedRing.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a ring of IQ data in POSIX shared memory that one
+// producer writes and several consumers, in other processes, read
+// without copying.  The data area is mapped twice, back to back, so any
+// piece of the ring up to its full size is contiguous, and a consumer
+// is handed a pointer straight into it.  The producer never waits for
+// a consumer.  Each consumer has its own read cursor, and a consumer
+// that falls more than a ring behind skips to the newest data and
+// counts the bytes that it lost.  The head, the consumer cursors and
+// the wakeup word live on separate cache lines.  Consumers sleep on a
+// futex, and the producer only makes a system call when somebody is
+// asleep.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SHAREDRING__
+#define __SHAREDRING__
+
+#include <stdint.h>
+
+#define MAX_RING_CONSUMERS (8)
+
+// This is "IQR1", written last by the producer once the ring is ready.
+#define SHARED_RING_MAGIC (0x31525149)
+
+// This is where the cursors are kept apart from each other.
+#define RING_CACHE_LINE (64)
+
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// The owner of a consumer slot is the process ID in the upper 32 bits
+// and the state in the lower 32 bits, so that a slot is claimed, or
+// taken over from a process that is gone, with one compare and swap.
+// An owner of 0 is a free slot.
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+#define RING_SLOT_ACTIVE (1)
+#define RING_SLOT_ATTACHING (2)
+#define RING_SLOT_OWNER(processId,state) \
+  ((((uint64_t)(processId)) << 32) | (state))
+
+// This is the state of a consumer, which the producer can also read.
+struct SharedRingConsumer
+{
+  uint64_t owner;
+  uint64_t tail;
+  uint64_t bytesRead;
+  uint64_t overruns;
+  uint64_t bytesLost;
+  uint64_t maximumLag;
+} __attribute__((aligned(RING_CACHE_LINE)));
+
+// This is the start of the shared memory.  The data follows it.
+struct SharedRingHeader
+{
+  uint32_t magic;
+  uint32_t capacity;
+  uint32_t headerSize;
+  uint32_t producerId;
+
+  // Written by the producer.
+  uint64_t head __attribute__((aligned(RING_CACHE_LINE)));
+  uint64_t reserved;
+  uint32_t sequence;
+  uint32_t ended;
+
+  // Written by the consumers.
+  uint32_t sleepers __attribute__((aligned(RING_CACHE_LINE)));
+
+  SharedRingConsumer consumers[MAX_RING_CONSUMERS];
+};
+
+class SharedRing
+{
+  //***************************** operations **************************
+
+  public:
+
+  SharedRing(const char *namePtr,uint32_t capacity);
+  SharedRing(const char *namePtr);
+ ~SharedRing(void);
+
+  bool isValid(void);
+
+  // The producer side.
+  int8_t *reserve(uint32_t length);
+  void commit(uint32_t length);
+
+  // The consumer side.
+  uint32_t acquire(const int8_t **dataPtrPtr,uint32_t length);
+  void release(uint32_t length);
+  void reportStatistics(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  bool mapRing(int descriptor,uint32_t capacity,bool producer);
+  void waitForData(uint32_t sequence);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  char name[64];
+  bool producer;
+  bool valid;
+
+  SharedRingHeader *headerPtr;
+  uint32_t headerSize;
+  uint32_t capacity;
+
+  // The data area, which is mapped twice.
+  int8_t *dataPtr;
+
+  // This is the slot of a consumer.
+  SharedRingConsumer *consumerPtr;
+};
+
+#endif // __SHAREDRING__
@@ -5,6 +5,8 @@
 // This class implements a signal processing block known as a signal
 // analyzer.  Given 8-bit IQ samples from an SDR, plots can be displayed
 // of the magnitude of the signal or the power spectrum of the signal.
+// Everything is drawn through a Renderer, so the display can be an X
+// window, a stream of images, or nothing at all.
 ///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
 
 #ifndef __SIGNALANALYZER__
@@ -15,44 +17,102 @@
 #include <unistd.h>
 #include <math.h>
 
-#include <fftw3.h>
-
-#include <X11/Xlib.h>
-
-// This is the FFT size.
-#define N (8192)
+#include "SpectrumDetector.h"
+#include "SpectrumStatistics.h"
+#include "SpectrumMeter.h"
+#include "HighResolutionSpectrum.h"
+#include "SpectrumReference.h"
+#include "SpectrumTraces.h"
+#include "FixedPointFft.h"
+#include "SpectrumEngine.h"
+#include "ScopeTrigger.h"
+#include "SpectrumAutoScaler.h"
+#include "IqCorrector.h"
+#include "CaptureRing.h"
+#include "Renderer.h"
+#include "FftSize.h"
+
+// The narrowest span that the spectrum can be zoomed to, in FFT bins.
+#define MINIMUM_VIEW_SPAN (64)
+
+// These are the display dimensions in pixels.
+#define DISPLAY_WIDTH (1024)
+#define DISPLAY_HEIGHT (256)
 
 enum DisplayType {SignalMagnitude=1, PowerSpectrum, Lissajous};
 
+// This is how spectra are combined between display updates.
+enum FrameAggregation {AverageFrames=1, PeakHoldFrames};
+
 class SignalAnalyzer
 {
   //***************************** operations **************************
 
   public:
 
-  SignalAnalyzer(DisplayType displayType,
+  SignalAnalyzer(Renderer *rendererPtr,
+      DisplayType displayType,
       float sampleRate,
       float verticalGain,
-      int32_t baselineInDb);
+      int32_t baselineInDb,
+      FrameAggregation frameAggregation,
+      SpectrumTables *tablesPtr);
 
  ~SignalAnalyzer(void);
 
-  void plotSignalMagnitude(int8_t *signalBufferPtr,uint32_t bufferLength);
-  void plotPowerSpectrum(int8_t *signalBufferPtr,uint32_t bufferLength);
-  void plotLissajous(int8_t *signalBufferPtr,uint32_t bufferLength);
+  void acceptSamples(int8_t *signalBufferPtr,uint32_t bufferLength);
+  void renderDisplay(void);
+
+  void setSignalDetector(SpectrumDetector *detectorPtr);
+  void setSpectrumStatistics(SpectrumStatistics *statisticsPtr);
+  void setSpectrumMeter(SpectrumMeter *meterPtr);
+  void setHighResolutionSpectrum(HighResolutionSpectrum *highResolutionPtr);
+  void setSpectrumReference(SpectrumReference *referencePtr,
+                            float highlightThresholdInDb);
+  void setSpectrumTraces(SpectrumTraces *tracesPtr);
+  void setFixedPointFft(FixedPointFft *fixedPointFftPtr);
+  void setScopeTrigger(ScopeTrigger *triggerPtr);
+  void setAutoScaler(SpectrumAutoScaler *autoScalerPtr);
+  void setIqCorrector(IqCorrector *correctorPtr);
+  void setCaptureRing(CaptureRing *capturePtr);
+
+  void setDisplayType(DisplayType displayType);
+  void setReferenceLevel(int32_t baselineInDb);
+  void setVerticalGain(float verticalGain);
+  void setSampleRate(float sampleRate);
+  void setFrameAggregation(FrameAggregation frameAggregation);
+  SpectrumTables *setSpectrumTables(SpectrumTables *tablesPtr);
 
   private:
 
   //*******************************************************************
   // Utility functions.
   //*******************************************************************
-  void initializeFftw(void);
-  void initializeX(void);
+  void updateTitle(void);
   void initializeAnnotationParameters(float sampleRate);
+  void updateFrequencyAnnotations(void);
+  void setSpectrumView(uint32_t span,uint32_t anchorBin,int anchorPixel);
+  uint32_t getBinAtPixel(int pixel);
+  void processKeystrokes(void);
   void drawGridlines(void);
+  void drawSpectrumTrace(float *traceInDbPtr,RenderColor color);
+  void drawBinnedTrace(float *binnedTraceInDbPtr,RenderColor color);
+  void drawHighResolutionTrace(void);
+  void drawHighlights(float offsetInDb);
+  void drawReferenceStatus(void);
+  void drawIqQuality(void);
+  void drawChannelReadings(void);
+
+  void accumulateSignalMagnitude(int8_t *signalBufferPtr,
+                                 uint32_t bufferLength);
 
-  uint32_t computeSignalMagnitude(int8_t *signalBufferPtr,
-                                  uint32_t bufferLength);
+  void accumulatePowerSpectrum(void);
+
+  void accumulateLissajous(int8_t *signalBufferPtr,uint32_t bufferLength);
+
+  void plotSignalMagnitude(void);
+  void plotPowerSpectrum(void);
+  void plotLissajous(void);
 
   uint32_t computeLogPowerSpectrum(int8_t *signalBufferPtr,
                                    uint32_t bufferLength);
@@ -64,9 +124,6 @@ class SignalAnalyzer
   // Display support.
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
   DisplayType displayType;
-  unsigned long scopeBackgroundColor;
-  unsigned long scopeGridColor;
-  unsigned long scopeSignalColor;
 
   char sweepTimeBuffer[80];
   char sweepTimeDivBuffer[80];
@@ -74,15 +131,21 @@ class SignalAnalyzer
   char frequencySpanDivBuffer[80];
   char sampleRateBuffer[80];
   char lissajousDivBuffer[80];
+  char triggerStatusBuffer[80];
+  char scaleBuffer[80];
 
   int annotationHorizontalPosition;
   int annotationFirstLinePosition;
   int annotationSecondLinePosition;
 
-  uint32_t spectrumStride;
   uint32_t signalStride;
   float verticalGain;
   int32_t baselineInDb;
+  float sampleRate;
+
+  // The part of the spectrum that is displayed, in FFT bins.
+  uint32_t viewStart;
+  uint32_t viewSpan;
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
 
   // We ulitmately map values to these pixels.
@@ -90,26 +153,102 @@ class SignalAnalyzer
   int windowHeightInPixels;
 
   // This is used for plotting of signals.
-  XPoint points[1024];
+  RenderPoint points[DISPLAY_WIDTH];
+
+  // This is used for plotting the oscilloscope envelope.
+  RenderSegment segments[DISPLAY_WIDTH];
+
+  // This is used for plotting the Lissajous scope.
+  RenderPoint lissajousPoints[256 * 256];
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Frame accumulation support.  Everything that
+  // arrives between display updates is combined
+  // here.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  FrameAggregation frameAggregation;
+  uint32_t blocksInFrame;
+  uint32_t spectraInFrame;
+  uint32_t sweepsInFrame;
+  float displayPowerBuffer[N];
+  int16_t envelopeMinimum[DISPLAY_WIDTH];
+  int16_t envelopeMaximum[DISPLAY_WIDTH];
+  uint8_t lissajousGrid[256 * 256];
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
 
   // This is used for signal magnitude results.
   int16_t magnitudeBuffer[N];
 
-  // This will be used to swap the upper and lower halves of an array.
-  uint32_t fftShiftTable[N];
+  // This is used for linear power spectrum results (FFT shifted).
+  float powerBuffer[N];
+
+  // This is used for power spectrum results in dB (FFT shifted).
+  float powerInDbBuffer[N];
+
+  // This is used for auxiliary traces in dB.
+  float traceBuffer[N];
+
+  // This is used for a trace that has been binned to the display width.
+  float binnedTraceBuffer[DISPLAY_WIDTH];
+
+  // This does all of the signal processing.
+  SpectrumEngine *enginePtr;
+
+  // Signal detection support.
+  SpectrumDetector *detectorPtr;
+
+  // Running spectral statistics support.
+  SpectrumStatistics *statisticsPtr;
+
+  // Channel power measurement support.
+  SpectrumMeter *meterPtr;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // High resolution spectrum support.  The trace
+  // is only binned again when there is a new
+  // spectrum or the view changes.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  HighResolutionSpectrum *highResolutionPtr;
+  float highResolutionTraceBuffer[DISPLAY_WIDTH];
+  bool highResolutionTraceValid;
+  uint64_t highResolutionSpectra;
+  uint32_t highResolutionViewStart;
+  uint32_t highResolutionViewSpan;
+  char highResolutionPeakBuffer[80];
+  char resolutionBandwidthBuffer[80];
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Reference spectrum support.  The differential
+  // display shows the live spectrum relative to
+  // the reference, and highlights whatever rises
+  // above it by more than the threshold.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  SpectrumReference *referencePtr;
+  bool differential;
+  float highlightThresholdInDb;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Max-hold, min-hold and averaging trace support.
+  SpectrumTraces *tracesPtr;
+
+  // Oscilloscope trigger support.
+  ScopeTrigger *triggerPtr;
+  int8_t sweepBuffer[2 * N];
+
+  // Automatic scaling support.
+  SpectrumAutoScaler *autoScalerPtr;
 
-  // This will be used for windowing data before the FFT.
-  double hanningWindow[N];
+  // IQ quality support.  Everything but the spectrum works with
+  // corrected samples that are rounded to 8 bits.
+  IqCorrector *correctorPtr;
+  int8_t correctedBuffer[2 * N];
 
-  // FFTW3 support.
-  fftw_complex *fftInputPtr;
-  fftw_complex *fftOutputPtr;
-  fftw_plan fftPlan;
+  // Capture support.
+  CaptureRing *capturePtr;
 
-  // Xlib support.
-  Display *displayPtr;
-  Window window;
-  GC graphicsContext;
+  // Everything is drawn with this.
+  Renderer *rendererPtr;
 };
 
 #endif // __SIGNALANALYZER__
@@ -0,0 +1,73 @@
+//**************************************************************************
+// file name: SoftwareRasterizer.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a simple software rasterizer.  It draws pixels,
+// lines and strings (in a built in 5x7 font) into an RGB frame buffer
+// in memory, and can write the frame buffer as a binary PPM or PGM
+// image.  Lines are clipped to the frame buffer before they are drawn,
+// so wildly off screen coordinates cost nothing.  All storage is
+// allocated when the rasterizer is constructed.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SOFTWARERASTERIZER__
+#define __SOFTWARERASTERIZER__
+
+#include <stdio.h>
+#include <stdint.h>
+
+// This is the size of a character cell.
+#define RASTER_FONT_WIDTH (6)
+#define RASTER_FONT_HEIGHT (7)
+
+class SoftwareRasterizer
+{
+  //***************************** operations **************************
+
+  public:
+
+  SoftwareRasterizer(int width,int height);
+
+ ~SoftwareRasterizer(void);
+
+  int getWidth(void);
+  int getHeight(void);
+  uint8_t *getPixels(void);
+
+  void setColor(uint8_t red,uint8_t green,uint8_t blue);
+  void fill(void);
+  void fillRectangle(int x,int y,int width,int height);
+  void drawPixel(int x,int y);
+  void drawLine(int x1,int y1,int x2,int y2);
+  void drawString(int x,int y,const char *textPtr);
+
+  bool writePpm(FILE *streamPtr);
+  bool writePgm(FILE *streamPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  int computeOutcode(int x,int y);
+  bool clipLine(int *x1Ptr,int *y1Ptr,int *x2Ptr,int *y2Ptr);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  int width;
+  int height;
+
+  // The current drawing color.
+  uint8_t red;
+  uint8_t green;
+  uint8_t blue;
+
+  // The frame buffer, 3 bytes (R,G,B) per pixel, row by row.
+  uint8_t *pixelsPtr;
+
+  // One row of gray levels for writing PGM images.
+  uint8_t *grayRowPtr;
+};
+
+#endif // __SOFTWARERASTERIZER__
@@ -0,0 +1,64 @@
+//**************************************************************************
+// file name: SpectrumAutoScaler.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements automatic scaling of the spectrum display.  The
+// displayed (binned) spectrum is folded into a running histogram of dB
+// values that decays with a time constant of a quarter of a second, so
+// the noise floor and the peaks can be found as percentiles of the
+// histogram without sorting anything.  The reference level and vertical
+// gain are only changed when the noise floor or the peaks wander out of
+// a comfortable band, so the display doesn't jitter, and they are chosen
+// so that the grid lines fall on round numbers of dB.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMAUTOSCALER__
+#define __SPECTRUMAUTOSCALER__
+
+#include <stdint.h>
+
+// The histogram covers -100dB through 100dB in half dB steps.
+#define AUTOSCALE_MINIMUM_DB (-100.0f)
+#define AUTOSCALE_BINS_PER_DB (2)
+#define AUTOSCALE_NUMBER_OF_BINS (400)
+
+class SpectrumAutoScaler
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumAutoScaler(float updatesPerSecond,
+      float displayRangeInDb);
+
+ ~SpectrumAutoScaler(void);
+
+  void accumulate(float *spectrumInDbPtr,uint32_t numberOfValues);
+
+  bool update(int32_t *baselineInDbPtr,float *verticalGainPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  float getPercentile(float percentile);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  // The range of the display, in dB, at a vertical gain of 1.
+  float displayRangeInDb;
+
+  // The weight that the histogram keeps on every update.
+  float decayFactor;
+
+  // The running histogram and its total weight.
+  float histogram[AUTOSCALE_NUMBER_OF_BINS];
+  float totalWeight;
+
+  // Whether a scale has been chosen yet.
+  bool scaleChosen;
+};
+
+#endif // __SPECTRUMAUTOSCALER__
@@ -0,0 +1,122 @@
+//**************************************************************************
+// file name: SpectrumDetector.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a cell-averaging constant false alarm rate
+// (CA-CFAR) signal detector.  Given a linear power spectrum, the noise
+// floor of each bin is estimated from the reference cells that surround
+// the bin (guard cells excluded), and bins that exceed the noise floor by
+// a threshold are clustered into signals.  Signals are tracked from one
+// spectrum to the next so that start and stop events can be emitted.  A
+// new signal must be seen in several spectra in a row before it starts,
+// since on noise alone the threshold is crossed somewhere in almost every
+// spectrum, but hardly ever in the same place twice.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMDETECTOR__
+#define __SPECTRUMDETECTOR__
+
+#include <stdio.h>
+#include <stdint.h>
+
+// This is the maximum number of signals that can be tracked.
+#define MAX_DETECTED_SIGNALS (64)
+
+// This describes a cluster of adjacent detected bins.
+struct DetectedSignal
+{
+  // Lowest and highest bins that are occupied.
+  uint32_t startBin;
+  uint32_t endBin;
+
+  // The strongest bin and its power (linear).
+  uint32_t peakBin;
+  float peakPower;
+
+  // Interpolated frequency of the peak in Hz.
+  float peakFrequency;
+
+  // Tracking support.
+  uint64_t startFrame;
+  uint64_t lastFrame;
+  uint32_t missCount;
+  uint32_t hitCount;
+  bool confirmed;
+  bool active;
+  bool updated;
+};
+
+class SpectrumDetector
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumDetector(uint32_t numberOfBins,
+      float sampleRate,
+      float thresholdInDb,
+      FILE *eventStreamPtr);
+
+ ~SpectrumDetector(void);
+
+  void processSpectrum(float *powerBufferPtr);
+  uint64_t getNumberOfStarts(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void estimateNoiseFloor(float *powerBufferPtr);
+  void findClusters(float *powerBufferPtr);
+  void trackSignals(void);
+  float interpolatePeakFrequency(float *powerBufferPtr,uint32_t peakBin);
+  void emitEvent(const char *eventNamePtr,
+                 DetectedSignal *signalPtr,
+                 uint64_t eventFrame);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfBins;
+  float sampleRate;
+  float binWidthInHz;
+
+  // Detection threshold relative to the noise floor (linear).
+  float thresholdFactor;
+
+  // CFAR window parameters (in bins, per side).
+  uint32_t guardCells;
+  uint32_t referenceCells;
+
+  // Gaps up to this many bins are merged into one signal.
+  uint32_t mergeGap;
+
+  // A signal is stopped after this many spectra without detection.
+  uint32_t hangFrames;
+
+  // A signal is started once it has been seen in this many spectra in
+  // a row.
+  uint32_t confirmFrames;
+
+  // Number of spectra that have been processed.
+  uint64_t frameCount;
+
+  // Number of signals that have started.
+  uint64_t numberOfStarts;
+
+  // Noise floor estimates for each bin.
+  float *noiseFloorPtr;
+
+  // Clusters found in the current spectrum.
+  DetectedSignal clusters[MAX_DETECTED_SIGNALS];
+  uint32_t numberOfClusters;
+
+  // Signals that are currently being tracked.
+  DetectedSignal signals[MAX_DETECTED_SIGNALS];
+
+  // Events are written here.
+  FILE *eventStreamPtr;
+};
+
+#endif // __SPECTRUMDETECTOR__
@@ -0,0 +1,120 @@
+//**************************************************************************
+// file name: SpectrumEngine.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements the signal processing core of the signal
+// analyzer.  Given 8-bit IQ samples from an SDR, it computes the
+// magnitude of the signal and the power spectrum of the signal, converts
+// power to decibels, and bins a spectrum down to a smaller number of
+// points.  It knows nothing about X, so it can be linked into any
+// program.  The caller provides all of the buffers, and all storage is
+// allocated when the engine is constructed, so nothing is allocated
+// while samples are being processed.  If an IQ corrector is attached, its
+// DC offset and imbalance correction is applied in floating point as the
+// samples are converted for the FFT.  The window, shift table and FFT
+// plan can be shared with other engines, so several analyzers in one
+// process pay for them only once.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMENGINE__
+#define __SPECTRUMENGINE__
+
+#include <stdint.h>
+
+#include <fftw3.h>
+
+#include "FixedPointFft.h"
+#include "SpectrumTables.h"
+#include "IqCorrector.h"
+
+class SpectrumEngine
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumEngine(uint32_t numberOfPoints);
+  SpectrumEngine(SpectrumTables *tablesPtr);
+
+ ~SpectrumEngine(void);
+
+  void setFixedPointFft(FixedPointFft *fixedPointFftPtr);
+  void setIqCorrector(IqCorrector *correctorPtr);
+  SpectrumTables *setTables(SpectrumTables *tablesPtr);
+  const double *getWindow(void);
+
+  uint32_t getNumberOfPoints(void);
+
+  static uint32_t computeSignalMagnitude(const int8_t *signalBufferPtr,
+                                         uint32_t bufferLength,
+                                         int16_t *magnitudeBufferPtr);
+
+  uint32_t computePowerSpectrum(const int8_t *signalBufferPtr,
+                                uint32_t bufferLength,
+                                float *powerBufferPtr);
+
+  void convertToDb(const float *powerBufferPtr,
+                   float scale,
+                   float *powerInDbBufferPtr);
+
+  void binSpectrum(const float *spectrumPtr,
+                   float *binnedSpectrumPtr,
+                   uint32_t numberOfBins);
+
+  void convertSpanToDb(const float *powerBufferPtr,
+                       float scale,
+                       float *powerInDbBufferPtr,
+                       uint32_t firstPoint,
+                       uint32_t numberOfPointsInSpan);
+
+  void convertSpanToRelativeDb(const float *powerBufferPtr,
+                               float scale,
+                               const float *referenceInDbPtr,
+                               float offsetInDb,
+                               float *powerInDbBufferPtr,
+                               uint32_t firstPoint,
+                               uint32_t numberOfPointsInSpan);
+
+  void binSpectrumSpan(const float *spectrumPtr,
+                       uint32_t firstPoint,
+                       uint32_t numberOfPointsInSpan,
+                       float *binnedSpectrumPtr,
+                       uint32_t numberOfBins);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void initialize(SpectrumTables *tablesPtr);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfPoints;
+
+  // The tables, and whether this engine built them itself.
+  SpectrumTables *tablesPtr;
+  bool ownsTables;
+
+  // This will be used to swap the upper and lower halves of an array.
+  const uint32_t *fftShiftTablePtr;
+
+  // This will be used for windowing data before the FFT.
+  const double *windowPtr;
+
+  // FFTW3 support.
+  fftw_complex *fftInputPtr;
+  fftw_complex *fftOutputPtr;
+  fftw_plan fftPlan;
+
+  // Fixed-point FFT support.
+  FixedPointFft *fixedPointFftPtr;
+
+  // IQ correction support.  The fixed-point FFT takes 8-bit samples, so
+  // it gets a corrected, rounded copy.
+  IqCorrector *correctorPtr;
+  int8_t *correctedSamplesPtr;
+};
+
+#endif // __SPECTRUMENGINE__
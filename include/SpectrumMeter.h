@@ -0,0 +1,125 @@
+//**************************************************************************
+// file name: SpectrumMeter.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class measures channels in a linear power spectrum.  For each
+// channel, the integrated channel power, the occupied bandwidth (the
+// bandwidth that holds 99% of the power of the channel and its adjacent
+// channels), and the adjacent channel power ratio on either side are
+// computed.  The running sum of the spectrum is built once per
+// spectrum, so the power in any range of bins is a single subtraction,
+// and many channels cost little more than one.  Channel power is
+// divided by the equivalent noise bandwidth of the window, so a tone
+// reads the same as its peak on the display.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMMETER__
+#define __SPECTRUMMETER__
+
+#include <stdio.h>
+#include <stdint.h>
+
+// This is the maximum number of channels that can be measured.
+#define MAX_METER_CHANNELS (64)
+
+// This is the fraction of the power that is inside the occupied band.
+#define OCCUPIED_FRACTION (0.99)
+
+// This describes a channel to be measured.
+struct MeterChannel
+{
+  // The channel, in Hz relative to the center frequency.
+  float centerFrequency;
+  float bandwidth;
+
+  // The distance to the center of each adjacent channel.
+  float spacing;
+
+  // The channel and its neighbors, in FFT bins [first, last).
+  uint32_t firstBin;
+  uint32_t lastBin;
+  uint32_t firstLowerBin;
+  uint32_t lastLowerBin;
+  uint32_t firstUpperBin;
+  uint32_t lastUpperBin;
+};
+
+// These are the measurements of a channel.
+struct ChannelReading
+{
+  float powerInDb;
+  float occupiedBandwidth;
+  float lowerAcprInDb;
+  float upperAcprInDb;
+};
+
+class SpectrumMeter
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumMeter(uint32_t numberOfBins,
+      float sampleRate,
+      FILE *logStreamPtr);
+
+ ~SpectrumMeter(void);
+
+  bool addChannel(float centerFrequency,float bandwidth,float spacing);
+  uint32_t getNumberOfChannels(void);
+
+  void setSampleRate(float sampleRate);
+  void setWindow(const double *windowPtr);
+
+  void processSpectrum(const float *powerBufferPtr);
+  uint32_t getReadings(ChannelReading *readingsPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void computeChannelBins(MeterChannel *channelPtr);
+  uint32_t frequencyToBin(float frequency);
+  double findCumulativeBin(double target,uint32_t firstBin,uint32_t lastBin);
+  double getRangePower(uint32_t firstBin,uint32_t lastBin);
+  void writeReadings(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfBins;
+  float sampleRate;
+  float binWidthInHz;
+
+  // This is the equivalent noise bandwidth of the window in bins.
+  double noiseBandwidth;
+
+  MeterChannel channels[MAX_METER_CHANNELS];
+  uint32_t numberOfChannels;
+
+  // This is the running sum of the spectrum, numberOfBins + 1 values.
+  double *cumulativePowerPtr;
+
+  // The measurements of the latest spectrum.
+  ChannelReading readings[MAX_METER_CHANNELS];
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The linear sums of the measurements since the
+  // readings were last retrieved.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  double powerSum[MAX_METER_CHANNELS];
+  double lowerSum[MAX_METER_CHANNELS];
+  double upperSum[MAX_METER_CHANNELS];
+  double occupiedSum[MAX_METER_CHANNELS];
+  uint32_t spectraInSums;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Number of spectra that have been processed.
+  uint64_t frameCount;
+
+  // The measurements of every spectrum are written here.
+  FILE *logStreamPtr;
+};
+
+#endif // __SPECTRUMMETER__
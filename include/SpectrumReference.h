@@ -0,0 +1,71 @@
+//**************************************************************************
+// file name: SpectrumReference.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class holds a reference spectrum, so that the live spectrum can be
+// displayed relative to it, which makes new signals stand out.  A
+// reference is captured by averaging the power spectra of a number of
+// display frames, and it is kept in decibels so that it can be
+// subtracted while the live spectrum is converted to decibels.  A
+// reference can be saved to a file and loaded again later, as long as
+// the FFT size and the sample rate match.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMREFERENCE__
+#define __SPECTRUMREFERENCE__
+
+#include <stdint.h>
+
+class SpectrumReference
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumReference(uint32_t numberOfBins,
+      float sampleRate,
+      uint32_t averagingLength,
+      const char *fileNamePtr);
+
+ ~SpectrumReference(void);
+
+  void startCapture(void);
+  bool accumulate(const float *powerBufferPtr,float scale);
+  void setSampleRate(float sampleRate);
+
+  bool isCapturing(void);
+  bool isAvailable(void);
+  uint32_t getFramesCaptured(void);
+  uint32_t getAveragingLength(void);
+  const float *getReferenceInDb(void);
+
+  bool load(const char *fileNamePtr);
+  bool save(const char *fileNamePtr);
+
+  private:
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfBins;
+  float sampleRate;
+  uint32_t averagingLength;
+
+  // New references are saved here, if it isn't NULL.
+  const char *fileNamePtr;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Capture support.  The frames are summed in
+  // linear power.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  bool capturing;
+  uint32_t framesCaptured;
+  float *sumPtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // The reference, in decibels.
+  bool available;
+  float *referenceInDbPtr;
+};
+
+#endif // __SPECTRUMREFERENCE__
@@ -0,0 +1,85 @@
+//**************************************************************************
+// file name: SpectrumStatistics.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class maintains running statistics of each bin of a power
+// spectrum over a sliding window of spectra.  The minimum, maximum, mean
+// and a percentile (the median by default) are available at any time.
+// Each bin keeps its window of values in sorted order, so when a new
+// spectrum arrives the oldest value is replaced by the newest value with
+// a single shift of the values in between.  Nothing is ever re-sorted.
+// Values are stored as hundredths of a decibel so that the sorted
+// windows are compact and the running sums are exact.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMSTATISTICS__
+#define __SPECTRUMSTATISTICS__
+
+#include <stdio.h>
+#include <stdint.h>
+
+class SpectrumStatistics
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumStatistics(uint32_t numberOfBins,
+      uint32_t windowLength,
+      float percentile,
+      FILE *statisticsStreamPtr);
+
+ ~SpectrumStatistics(void);
+
+  void processSpectrum(float *powerInDbBufferPtr);
+
+  void getMinimum(float *traceInDbPtr);
+  void getMaximum(float *traceInDbPtr);
+  void getMean(float *traceInDbPtr);
+  void getPercentile(float *traceInDbPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void replaceValue(int16_t *sortedPtr,int16_t oldValue,int16_t newValue);
+  void insertValue(int16_t *sortedPtr,uint32_t count,int16_t newValue);
+  void writeStatistics(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfBins;
+  uint32_t windowLength;
+
+  // This is the index into a sorted window for the percentile.
+  float percentile;
+  uint32_t percentileIndex;
+
+  // The number of spectra in the window (up to windowLength).
+  uint32_t count;
+
+  // The window slot that the next spectrum overwrites.
+  uint32_t oldestIndex;
+
+  // Number of spectra that have been processed.
+  uint64_t frameCount;
+
+  // Per-bin history in arrival order: [bin][windowLength].
+  int16_t *historyPtr;
+
+  // Per-bin history in sorted order: [bin][windowLength].
+  int16_t *sortedPtr;
+
+  // Per-bin running sums for the mean.
+  int32_t *sumPtr;
+
+  // Scratch trace used for headless output.
+  float *traceBufferPtr;
+
+  // Statistics are written here (headless output).
+  FILE *statisticsStreamPtr;
+};
+
+#endif // __SPECTRUMSTATISTICS__
@@ -0,0 +1,61 @@
+//**************************************************************************
+// file name: SpectrumTables.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class holds the parts of a spectrum engine that never change once
+// they are built: the FFT shift table, the window, and the FFTW plan.
+// None of them are written after construction, so any number of
+// engines, in any number of threads, can share one set of tables, and
+// an engine can be handed a new set that was built somewhere else.  The
+// plan is always executed with the new-array interface, so each engine
+// brings its own FFT buffers.  Every window is scaled to the coherent
+// gain of the Hanning window, so a tone reads the same level whichever
+// window is used.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMTABLES__
+#define __SPECTRUMTABLES__
+
+#include <stdint.h>
+
+#include <fftw3.h>
+
+// These are the windows that are applied before the FFT.
+enum WindowType {HanningWindow=1, HammingWindow, BlackmanWindow,
+                 RectangularWindow};
+
+class SpectrumTables
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumTables(uint32_t numberOfPoints,WindowType windowType);
+
+ ~SpectrumTables(void);
+
+  uint32_t getNumberOfPoints(void);
+  const uint32_t *getFftShiftTable(void);
+  WindowType getWindowType(void);
+  const double *getWindow(void);
+  fftw_plan getFftPlan(void);
+
+  private:
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfPoints;
+  WindowType windowType;
+
+  // This will be used to swap the upper and lower halves of an array.
+  uint32_t *fftShiftTablePtr;
+
+  // This will be used for windowing data before the FFT.
+  double *windowPtr;
+
+  // FFTW3 support.
+  fftw_plan fftPlan;
+};
+
+#endif // __SPECTRUMTABLES__
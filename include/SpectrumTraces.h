@@ -0,0 +1,69 @@
+//**************************************************************************
+// file name: SpectrumTraces.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements the max-hold, min-hold and video averaging traces
+// of a spectrum analyzer.  The traces are accumulated in linear power on
+// every power spectrum that is computed, so they don't depend upon how
+// often the display is updated.  The accumulation is a single pass over
+// the bins, using SSE when it is available.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __SPECTRUMTRACES__
+#define __SPECTRUMTRACES__
+
+#include <stdint.h>
+
+// These are the trace modes.  They may be or'ed together.
+#define TRACE_MAX_HOLD (1)
+#define TRACE_MIN_HOLD (2)
+#define TRACE_AVERAGE (4)
+
+class SpectrumTraces
+{
+  //***************************** operations **************************
+
+  public:
+
+  SpectrumTraces(uint32_t numberOfBins,
+      uint32_t traceModes,
+      uint32_t averagingLength);
+
+ ~SpectrumTraces(void);
+
+  void accumulate(float *powerBufferPtr);
+  void reset(void);
+  void setAveragingLength(uint32_t averagingLength);
+
+  uint32_t getTraceModes(void);
+
+  void getMaxHold(float *traceInDbPtr);
+  void getMinHold(float *traceInDbPtr);
+  void getAverage(float *traceInDbPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void convertToDb(float *tracePtr,float *traceInDbPtr);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  uint32_t numberOfBins;
+  uint32_t traceModes;
+
+  // The weight of a new spectrum in the average.
+  float averagingFactor;
+
+  // The number of spectra since the last reset.
+  uint32_t count;
+
+  // The traces in linear power.
+  float *maxHoldPtr;
+  float *minHoldPtr;
+  float *averagePtr;
+};
+
+#endif // __SPECTRUMTRACES__
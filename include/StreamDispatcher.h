@@ -0,0 +1,121 @@
+//**************************************************************************
+// file name: StreamDispatcher.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class feeds several IQ streams, each to its own signal analyzer,
+// from one process.  The streams can be FIFOs, files, TCP connections or
+// stdin.  One thread waits on all of them with epoll, reads whatever is
+// ready, and queues complete blocks; a pool of threads runs the blocks
+// through the analyzers.  A stream is only ever processed by one thread
+// at a time, so its blocks are analyzed in order, and the analyzers can
+// share their FFT tables.  When the queue of a stream is full, the
+// stream isn't read until a block has been processed, so a slow
+// analyzer pushes back on its source instead of using more memory.
+// Regular files can't be waited on, so they are read whenever their
+// queue has room.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __STREAMDISPATCHER__
+#define __STREAMDISPATCHER__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "SignalAnalyzer.h"
+
+#define MAX_STREAMS (8)
+#define MAX_DISPATCH_THREADS (16)
+
+// The number of blocks that can be waiting for each stream.
+#define STREAM_QUEUE_LENGTH (8)
+
+// Each block is one FFT's worth of IQ data.
+#define STREAM_BLOCK_SIZE (2 * N)
+
+struct AnalyzerStream
+{
+  const char *namePtr;
+  int descriptor;
+  SignalAnalyzer *analyzerPtr;
+
+  // This is held while the analyzer is processing or rendering.
+  pthread_mutex_t analyzerLock;
+
+  // Regular files can't be waited on with epoll.
+  bool pollable;
+  bool ended;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The blocks form a ring.  The queued blocks
+  // start at oldestBlock, and the block after
+  // them is being filled by the reading thread.
+  // A stream is paused while its queue is full,
+  // and busy while a thread is processing it.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  uint8_t *blocksPtr[STREAM_QUEUE_LENGTH];
+  uint32_t blockLengths[STREAM_QUEUE_LENGTH];
+  uint32_t oldestBlock;
+  uint32_t numberOfQueuedBlocks;
+  uint32_t fillLength;
+  bool paused;
+  bool busy;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+class StreamDispatcher
+{
+  //***************************** operations **************************
+
+  public:
+
+  StreamDispatcher(uint32_t numberOfThreads,bool unsignedSamples);
+ ~StreamDispatcher(void);
+
+  bool addStream(const char *namePtr);
+  void setAnalyzer(uint32_t index,SignalAnalyzer *analyzerPtr);
+  uint32_t getNumberOfStreams(void);
+  const char *getStreamName(uint32_t index);
+
+  bool dispatch(int timeoutInMs);
+  void renderStream(uint32_t index);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  int openStream(const char *namePtr);
+  int connectToServer(const char *namePtr);
+  void readStream(uint32_t index);
+  void queueBlock(AnalyzerStream *streamPtr);
+  void endStream(AnalyzerStream *streamPtr);
+  void resumeStreams(void);
+
+  static void *threadEntry(void *argPtr);
+  void run(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  bool unsignedSamples;
+
+  AnalyzerStream streams[MAX_STREAMS];
+  uint32_t numberOfStreams;
+
+  // The next stream that a thread looks at, so every stream gets a turn.
+  uint32_t nextStream;
+
+  // Threads wake up the reading thread with this when a stream can resume.
+  int epollDescriptor;
+  int wakeupDescriptor;
+
+  uint32_t numberOfThreads;
+  pthread_t threads[MAX_DISPATCH_THREADS];
+
+  bool stopping;
+  pthread_mutex_t queueLock;
+  pthread_cond_t blockQueued;
+};
+
+#endif // __STREAMDISPATCHER__
@@ -0,0 +1,96 @@
+//**************************************************************************
+// file name: TileRenderer.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a renderer that draws into one tile of another
+// renderer.  Everything that is drawn is moved by the offset of the tile,
+// so a signal analyzer that thinks it owns the whole display can share
+// one window (or one image) with other analyzers.  Lines and points are
+// clipped to the tile, so nothing spills into a neighbor.  Lines are
+// sent to the parent as segments.  A frame only clears
+// the tile, and nothing is sent to the display until whoever owns the
+// parent renderer finishes the frame of the whole display.  Keystrokes
+// don't come from the parent directly: the owner of the display decides
+// which tile a keystroke belongs to and queues it here.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __TILERENDERER__
+#define __TILERENDERER__
+
+#include <stdint.h>
+
+#include "Renderer.h"
+
+// This is the number of points or segments that are moved at once.
+#define TILE_CHUNK_SIZE (1024)
+
+// This is the number of keystrokes that can be waiting for the tile.
+#define TILE_KEY_QUEUE_SIZE (16)
+
+class TileRenderer : public Renderer
+{
+  //***************************** operations **************************
+
+  public:
+
+  TileRenderer(Renderer *parentPtr,int x,int y,int width,int height);
+
+ ~TileRenderer(void);
+
+  void setTitle(const char *titlePtr);
+  int getFontHeight(void);
+
+  void beginFrame(void);
+  void endFrame(void);
+  void clearArea(int x,int y,int width,int height);
+
+  void setColor(RenderColor color);
+  void drawLine(int x1,int y1,int x2,int y2);
+  void drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawSegments(RenderSegment *segmentsPtr,uint32_t numberOfSegments);
+  void drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawString(int x,int y,const char *textPtr);
+
+  void queueKeystroke(int key,int pointerPosition);
+  int getKeystroke(void);
+  int getPointerPosition(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  int computeOutcode(int x,int y);
+  bool clipLine(int *x1Ptr,int *y1Ptr,int *x2Ptr,int *y2Ptr);
+  void addSegment(int x1,int y1,int x2,int y2);
+  void flushSegments(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  Renderer *parentPtr;
+
+  // The tile, in pixels of the parent display.
+  int x;
+  int y;
+  int width;
+  int height;
+
+  // Moved and clipped copies of the caller's points and segments.
+  RenderPoint points[TILE_CHUNK_SIZE];
+  RenderSegment segments[TILE_CHUNK_SIZE];
+  uint32_t numberOfSegments;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Keystroke support.  Each keystroke is queued
+  // with the pointer position that came with it.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  int keys[TILE_KEY_QUEUE_SIZE];
+  int keyPointerPositions[TILE_KEY_QUEUE_SIZE];
+  uint32_t keyHead;
+  uint32_t keyCount;
+  int pointerPosition;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+};
+
+#endif // __TILERENDERER__
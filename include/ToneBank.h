@@ -0,0 +1,86 @@
+//**************************************************************************
+// file name: ToneBank.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a bank of Goertzel filters that watch the power
+// at a handful of fixed frequencies (pilots, beacons, and so on).  Each
+// filter is updated with every sample, and after each integration
+// period the power at every frequency is written to a report stream as
+// one line of text.  Only the frequencies of interest are computed, so
+// this costs far less than an FFT and can report far more often than
+// the display is drawn.  The recursion is run in double precision, since
+// in single precision the coefficient and the states are too coarse for
+// low frequencies and long integration periods.  Two filters are updated
+// at a time with SSE2 when it is available.  Since the IQ data is
+// complex, positive and negative frequencies (relative to the center)
+// are told apart.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __TONEBANK__
+#define __TONEBANK__
+
+#include <stdio.h>
+#include <stdint.h>
+
+// The most tones that can be watched.
+#define MAX_TONES (32)
+
+class ToneBank
+{
+  //***************************** operations **************************
+
+  public:
+
+  ToneBank(float sampleRate,
+           float *frequenciesPtr,
+           uint32_t numberOfTones,
+           uint32_t integrationLength,
+           FILE *reportStreamPtr);
+
+ ~ToneBank(void);
+
+  void acceptSamples(int8_t *signalBufferPtr,uint32_t bufferLength);
+
+  void getPowers(float *powersInDbPtr);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void runFilters(int8_t *signalBufferPtr,uint32_t numberOfSamples);
+  void finishIntegration(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  float sampleRate;
+  uint32_t numberOfTones;
+
+  // The tones are processed two at a time.
+  uint32_t numberOfGroups;
+
+  // The number of samples in each integration period.
+  uint32_t integrationLength;
+  uint32_t samplesIntegrated;
+
+  // 2cos(w) for the recursion, and cos(w), sin(w) for the final step.
+  double coefficients[MAX_TONES];
+  double cosines[MAX_TONES];
+  double sines[MAX_TONES];
+
+  // The last two filter states for I and for Q.
+  double stateI1[MAX_TONES];
+  double stateI2[MAX_TONES];
+  double stateQ1[MAX_TONES];
+  double stateQ2[MAX_TONES];
+
+  // The results of the last integration period.
+  float powersInDb[MAX_TONES];
+
+  // Reporting support.
+  FILE *reportStreamPtr;
+  uint64_t sampleCount;
+};
+
+#endif // __TONEBANK__
@@ -0,0 +1,79 @@
+//**************************************************************************
+// file name: X11Renderer.h
+//**************************************************************************
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// This class implements a renderer that draws in an X window.  This is
+// the way the signal analyzer has always displayed things.
+///_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+#ifndef __X11RENDERER__
+#define __X11RENDERER__
+
+#include <stdint.h>
+
+#include <X11/Xlib.h>
+
+#include "Renderer.h"
+
+// This is the number of points or segments that are sent to X at once.
+#define X11_CHUNK_SIZE (1024)
+
+class X11Renderer : public Renderer
+{
+  //***************************** operations **************************
+
+  public:
+
+  X11Renderer(int windowWidthInPixels,int windowHeightInPixels);
+
+ ~X11Renderer(void);
+
+  void setTitle(const char *titlePtr);
+  int getFontHeight(void);
+
+  void beginFrame(void);
+  void endFrame(void);
+  void synchronize(void);
+  void clearArea(int x,int y,int width,int height);
+
+  void setColor(RenderColor color);
+  void drawLine(int x1,int y1,int x2,int y2);
+  void drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawSegments(RenderSegment *segmentsPtr,uint32_t numberOfSegments);
+  void drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints);
+  void drawString(int x,int y,const char *textPtr);
+
+  int getKeystroke(void);
+  int getPointerPosition(void);
+
+  private:
+
+  //*******************************************************************
+  // Utility functions.
+  //*******************************************************************
+  void initializeX(void);
+
+  //*******************************************************************
+  // Attributes.
+  //*******************************************************************
+  int windowWidthInPixels;
+  int windowHeightInPixels;
+  int fontHeight;
+
+  // Where the pointer was when the last keystroke came from it.
+  int pointerPosition;
+
+  // These are the X pixel values of each RenderColor.
+  unsigned long colorTable[NumberOfRenderColors];
+
+  // Points and segments are converted to X format here.
+  XPoint points[X11_CHUNK_SIZE];
+  XSegment segments[X11_CHUNK_SIZE];
+
+  // Xlib support.
+  Display *displayPtr;
+  Window window;
+  GC graphicsContext;
+};
+
+#endif // __X11RENDERER__
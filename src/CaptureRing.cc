@@ -0,0 +1,630 @@
+//************************************************************************
+// file name: CaptureRing.cc
+//************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "CaptureRing.h"
+
+// The ring is mapped in multiples of this (the size of a huge page).
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// The writer writes at most this many bytes at a time.
+#define CAPTURE_CHUNK_SIZE (1024 * 1024)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: CaptureRing
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an CaptureRing.  The ring is allocated, and the writer
+  thread is started.
+
+  Calling Sequence: CaptureRing(sampleRate,
+                                preTriggerTime,
+                                postTriggerTime,
+                                filePrefixPtr,
+                                lockMemory,
+                                compress)
+
+  Inputs:
+
+    sampleRate - The sample rate of the IQ data in S/s.
+
+    preTriggerTime - The number of seconds of data before a trigger that
+    are saved.
+
+    postTriggerTime - The number of seconds of data after a trigger that
+    are saved.
+
+    filePrefixPtr - The captures are written to files named
+    <prefix>-001.iq, <prefix>-002.iq and so on.
+
+    lockMemory - A flag that indicates that the ring is to be locked into
+    memory and backed by huge pages, if the system allows it.
+
+    compress - A flag that indicates that the captures are to be
+    compressed (see IqCompressor), in which case the files end in .iqz.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+CaptureRing::CaptureRing(float sampleRate,
+  float preTriggerTime,
+  float postTriggerTime,
+  const char *filePrefixPtr,
+  bool lockMemory,
+  bool compress)
+{
+
+  if (sampleRate <= 0)
+  {
+    // Keep it sane.
+    sampleRate = 256000;
+  } // if
+
+  if (preTriggerTime < 0)
+  {
+    preTriggerTime = 0;
+  } // if
+
+  if (postTriggerTime < 0)
+  {
+    postTriggerTime = 0;
+  } // if
+
+  // Retrieve for later use.
+  this->sampleRate = sampleRate;
+  this->filePrefixPtr = filePrefixPtr;
+  this->compress = compress;
+
+  // Whole IQ pairs.
+  preTriggerLength = 2 * (uint64_t)(preTriggerTime * sampleRate);
+  postTriggerLength = 2 * (uint64_t)(postTriggerTime * sampleRate);
+
+  // Leave the writer a second of slack.
+  ringLength = preTriggerLength + (2 * (uint64_t)sampleRate);
+
+  allocateRing(lockMemory);
+
+  receivedPosition = 0;
+  reservedPosition = 0;
+
+  // Nothing is being captured.
+  capturePending = false;
+  captureNumber = 0;
+  captureStreamPtr = NULL;
+  compressorPtr = NULL;
+  stopping = false;
+
+  pthread_mutex_init(&ringLock,NULL);
+  pthread_cond_init(&dataAvailable,NULL);
+
+  pthread_create(&thread,NULL,threadEntry,this);
+
+  return;
+
+} // CaptureRing
+
+/*****************************************************************************
+
+  Name: ~CaptureRing
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an CaptureRing.  A capture that is in progress is
+  finished with whatever post-trigger data has arrived.
+
+  Calling Sequence: ~CaptureRing()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+CaptureRing::~CaptureRing(void)
+{
+
+  // Tell the thread to finish up.
+  pthread_mutex_lock(&ringLock);
+
+  stopping = true;
+
+  if (capturePending && (captureEnd > receivedPosition))
+  {
+    // No more data is coming.
+    captureEnd = receivedPosition;
+  } // if
+
+  pthread_cond_signal(&dataAvailable);
+  pthread_mutex_unlock(&ringLock);
+
+  pthread_join(thread,NULL);
+
+  pthread_cond_destroy(&dataAvailable);
+  pthread_mutex_destroy(&ringLock);
+
+  // Release resources.
+  if (ringPtr != NULL)
+  {
+    munmap(ringPtr,mappedLength);
+  } // if
+
+  return;
+
+} // ~CaptureRing
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to add IQ data to the ring.
+  Nothing is allocated, and the lock is only held long enough to update
+  the positions, so this never waits for the writer.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CaptureRing::acceptSamples(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint64_t position;
+  uint64_t offset;
+  uint64_t length;
+
+  if (ringPtr == NULL)
+  {
+    // There's no ring.
+    return;
+  } // if
+
+  // Let the writer know that this part of the ring is being overwritten.
+  pthread_mutex_lock(&ringLock);
+  position = receivedPosition;
+  reservedPosition = receivedPosition + bufferLength;
+  pthread_mutex_unlock(&ringLock);
+
+  while (bufferLength > 0)
+  {
+    offset = position % ringLength;
+    length = ringLength - offset;
+
+    if (length > bufferLength)
+    {
+      length = bufferLength;
+    } // if
+
+    memcpy(&ringPtr[offset],signalBufferPtr,length);
+
+    signalBufferPtr += length;
+    bufferLength -= length;
+    position += length;
+  } // while
+
+  pthread_mutex_lock(&ringLock);
+
+  receivedPosition = reservedPosition;
+
+  if (capturePending)
+  {
+    pthread_cond_signal(&dataAvailable);
+  } // if
+
+  pthread_mutex_unlock(&ringLock);
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: trigger
+
+  Purpose: The purpose of this function is to start a capture of the
+  data around now.  A trigger that arrives while a capture is in
+  progress is ignored.
+
+  Calling Sequence: trigger(reasonPtr)
+
+  Inputs:
+
+    reasonPtr - A pointer to a short description of the trigger, for the
+    report.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CaptureRing::trigger(const char *reasonPtr)
+{
+
+  if (ringPtr == NULL)
+  {
+    // There's no ring.
+    return;
+  } // if
+
+  pthread_mutex_lock(&ringLock);
+
+  if (!capturePending && !stopping)
+  {
+    triggerPosition = receivedPosition;
+
+    captureStart = (receivedPosition > preTriggerLength) ?
+                   (receivedPosition - preTriggerLength) : 0;
+
+    // Start on an I value.
+    captureStart &= ~(uint64_t)1;
+
+    captureEnd = receivedPosition + postTriggerLength;
+    writePosition = captureStart;
+    overrun = false;
+
+    strncpy(reason,reasonPtr,sizeof(reason) - 1);
+    reason[sizeof(reason) - 1] = '\0';
+
+    capturePending = true;
+    pthread_cond_signal(&dataAvailable);
+  } // if
+
+  pthread_mutex_unlock(&ringLock);
+
+  return;
+
+} // trigger
+
+/*****************************************************************************
+
+  Name: allocateRing
+
+  Purpose: The purpose of this function is to allocate the ring and to
+  touch every page of it, so that no page faults are taken later.  If
+  asked, huge pages are tried first, then transparent huge pages, and
+  the ring is locked into memory.
+
+  Calling Sequence: allocateRing(lockMemory)
+
+  Inputs:
+
+    lockMemory - A flag that indicates that the ring is to be locked into
+    memory and backed by huge pages.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CaptureRing::allocateRing(bool lockMemory)
+{
+  void *addressPtr;
+
+  mappedLength = ((ringLength + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) *
+                 HUGE_PAGE_SIZE;
+
+  addressPtr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if (lockMemory)
+  {
+    // This only works if huge pages have been reserved.
+    addressPtr = mmap(NULL,mappedLength,PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,-1,0);
+  } // if
+#endif
+
+  if (addressPtr == MAP_FAILED)
+  {
+    addressPtr = mmap(NULL,mappedLength,PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+
+#ifdef MADV_HUGEPAGE
+    if ((addressPtr != MAP_FAILED) && lockMemory)
+    {
+      madvise(addressPtr,mappedLength,MADV_HUGEPAGE);
+    } // if
+#endif
+  } // if
+
+  if (addressPtr == MAP_FAILED)
+  {
+    fprintf(stderr,"Could not allocate the capture ring\n");
+    ringPtr = NULL;
+    return;
+  } // if
+
+  ringPtr = (uint8_t *)addressPtr;
+
+  // Fault everything in now.
+  memset(ringPtr,0,mappedLength);
+
+  if (lockMemory)
+  {
+    if (mlock(ringPtr,mappedLength) != 0)
+    {
+      fprintf(stderr,"Could not lock the capture ring in memory"
+              " (see ulimit -l)\n");
+    } // if
+  } // if
+
+  return;
+
+} // allocateRing
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of the writer thread.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the CaptureRing.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *CaptureRing::threadEntry(void *argPtr)
+{
+
+  ((CaptureRing *)argPtr)->run();
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to write captures as their
+  data arrives, until the ring is being destroyed.  Data is written
+  straight from the ring without the lock held.  Afterward, if the
+  samples have caught up with the data that was written, the data may
+  have been overwritten while it was being written, and the capture is
+  cut short.
+
+  Calling Sequence: run()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CaptureRing::run(void)
+{
+  bool done;
+  uint64_t chunkStart;
+  uint64_t offset;
+  uint64_t length;
+  uint64_t availablePosition;
+
+  done = false;
+
+  pthread_mutex_lock(&ringLock);
+
+  while (!done)
+  {
+    if (capturePending)
+    {
+      if (captureStreamPtr == NULL)
+      {
+        pthread_mutex_unlock(&ringLock);
+        startCapture();
+        pthread_mutex_lock(&ringLock);
+      } // if
+
+      availablePosition = (receivedPosition < captureEnd) ?
+                          receivedPosition : captureEnd;
+
+      if ((captureStreamPtr == NULL) ||
+          overrun ||
+          (writePosition >= captureEnd))
+      {
+        pthread_mutex_unlock(&ringLock);
+        finishCapture();
+        pthread_mutex_lock(&ringLock);
+
+        capturePending = false;
+      } // if
+      else
+      {
+        if (writePosition < availablePosition)
+        {
+          chunkStart = writePosition;
+          offset = chunkStart % ringLength;
+
+          // Stop at the end of the ring.
+          length = availablePosition - chunkStart;
+
+          if (length > (ringLength - offset))
+          {
+            length = ringLength - offset;
+          } // if
+
+          if (length > CAPTURE_CHUNK_SIZE)
+          {
+            length = CAPTURE_CHUNK_SIZE;
+          } // if
+
+          pthread_mutex_unlock(&ringLock);
+
+          if (compressorPtr != NULL)
+          {
+            compressorPtr->acceptSamples((int8_t *)&ringPtr[offset],
+                                         (uint32_t)length);
+          } // if
+          else
+          {
+            fwrite(&ringPtr[offset],1,length,captureStreamPtr);
+          } // else
+
+          pthread_mutex_lock(&ringLock);
+
+          if (reservedPosition > (chunkStart + ringLength))
+          {
+            // The samples caught up with us.
+            overrun = true;
+          } // if
+
+          writePosition += length;
+        } // if
+        else
+        {
+          pthread_cond_wait(&dataAvailable,&ringLock);
+        } // else
+      } // else
+    } // if
+    else
+    {
+      if (stopping)
+      {
+        done = true;
+      } // if
+      else
+      {
+        pthread_cond_wait(&dataAvailable,&ringLock);
+      } // else
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&ringLock);
+
+  return;
+
+} // run
+
+/*****************************************************************************
+
+  Name: startCapture
+
+  Purpose: The purpose of this function is to open the file for a
+  capture.  It runs on the writer thread, so a slow file system doesn't
+  hold up the samples.
+
+  Calling Sequence: startCapture()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CaptureRing::startCapture(void)
+{
+
+  captureNumber++;
+
+  snprintf(fileName,sizeof(fileName),"%s-%03u.%s",
+           filePrefixPtr,captureNumber,compress ? "iqz" : "iq");
+
+  captureStreamPtr = fopen(fileName,"wb");
+
+  if (captureStreamPtr == NULL)
+  {
+    fprintf(stderr,"Could not open %s\n",fileName);
+    return;
+  } // if
+
+  if (compress)
+  {
+    compressorPtr = new IqCompressor(captureStreamPtr,0);
+  } // if
+
+  fprintf(stderr,"Capture %u (%s) at %.3fs: writing %s\n",
+          captureNumber,
+          reason,
+          triggerPosition / (2 * sampleRate),
+          fileName);
+
+  return;
+
+} // startCapture
+
+/*****************************************************************************
+
+  Name: finishCapture
+
+  Purpose: The purpose of this function is to close the file of a
+  capture and to report what was written.
+
+  Calling Sequence: finishCapture()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CaptureRing::finishCapture(void)
+{
+
+  if (captureStreamPtr == NULL)
+  {
+    // The file couldn't be opened.
+    return;
+  } // if
+
+  if (compressorPtr != NULL)
+  {
+    // This writes the last block and the block index.
+    delete compressorPtr;
+    compressorPtr = NULL;
+  } // if
+
+  fclose(captureStreamPtr);
+  captureStreamPtr = NULL;
+
+  fprintf(stderr,"Capture %u: %.3fs before and %.3fs after the trigger"
+          " written to %s\n",
+          captureNumber,
+          (triggerPosition - captureStart) / (2 * sampleRate),
+          (writePosition > triggerPosition) ?
+          ((writePosition - triggerPosition) / (2 * sampleRate)) : 0,
+          fileName);
+
+  if (overrun)
+  {
+    fprintf(stderr,"Capture %u fell behind the samples and was cut short;"
+            " its last %.3fs may be damaged\n",
+            captureNumber,
+            CAPTURE_CHUNK_SIZE / (2 * sampleRate));
+  } // if
+
+  return;
+
+} // finishCapture
@@ -0,0 +1,942 @@
+//************************************************************************
+// file name: ControlSocket.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+
+#include "ControlSocket.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: ControlSocket
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an ControlSocket.  The socket is created, replacing any
+  old socket with the same name, and the thread that serves it is
+  started.
+
+  Calling Sequence: ControlSocket(pathPtr,numberOfPoints)
+
+  Inputs:
+
+    pathPtr - The name of the socket in the file system.
+
+    numberOfPoints - The FFT size, which new tables are built for.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+ControlSocket::ControlSocket(const char *pathPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+  struct sockaddr_un address;
+
+  // Retrieve for later use.
+  this->numberOfPoints = numberOfPoints;
+  strncpy(path,pathPtr,sizeof(path) - 1);
+  path[sizeof(path) - 1] = 0;
+
+  for (i = 0; i < MAX_CONTROL_CLIENTS; i++)
+  {
+    clients[i].descriptor = -1;
+  } // for
+
+  nextClientId = 1;
+
+  oldestCommand = 0;
+  numberOfCommands = 0;
+  numberOfWindowCommands = 0;
+  numberOfReplies = 0;
+  numberOfRetiredTables = 0;
+  stopping = false;
+
+  pthread_mutex_init(&controlLock,NULL);
+
+  wakeupDescriptor = eventfd(0,EFD_NONBLOCK);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Set up the listening socket.  A socket that was left
+  // behind by an earlier run is removed first.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  memset(&address,0,sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path,path);
+
+  unlink(path);
+
+  listenDescriptor = socket(AF_UNIX,SOCK_STREAM,0);
+
+  if (listenDescriptor >= 0)
+  {
+    if ((bind(listenDescriptor,(struct sockaddr *)&address,
+              sizeof(address)) != 0) ||
+        (listen(listenDescriptor,MAX_CONTROL_CLIENTS) != 0))
+    {
+      close(listenDescriptor);
+      listenDescriptor = -1;
+    } // if
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (listenDescriptor < 0)
+  {
+    fprintf(stderr,"Could not create control socket %s: %s\n",
+            path,strerror(errno));
+    return;
+  } // if
+
+  pthread_create(&thread,NULL,threadEntry,this);
+
+  return;
+
+} // ControlSocket
+
+/*****************************************************************************
+
+  Name: ~ControlSocket
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an ControlSocket.  The thread is stopped, and then the
+  retired tables, and the tables of any commands that were never picked
+  up, are destroyed.
+
+  Calling Sequence: ~ControlSocket()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+ControlSocket::~ControlSocket(void)
+{
+  uint32_t i;
+
+  if (listenDescriptor >= 0)
+  {
+    pthread_mutex_lock(&controlLock);
+    stopping = true;
+    pthread_mutex_unlock(&controlLock);
+
+    wakeUp();
+    pthread_join(thread,NULL);
+
+    for (i = 0; i < MAX_CONTROL_CLIENTS; i++)
+    {
+      if (clients[i].descriptor >= 0)
+      {
+        close(clients[i].descriptor);
+      } // if
+    } // for
+
+    close(listenDescriptor);
+    unlink(path);
+  } // if
+
+  for (i = 0; i < numberOfRetiredTables; i++)
+  {
+    delete retiredTables[i];
+  } // for
+
+  for (i = 0; i < numberOfCommands; i++)
+  {
+    if (commands[(oldestCommand + i) % CONTROL_QUEUE_SIZE].type ==
+        ControlWindow)
+    {
+      delete commands[(oldestCommand + i) % CONTROL_QUEUE_SIZE].tablesPtr;
+    } // if
+  } // for
+
+  close(wakeupDescriptor);
+  pthread_mutex_destroy(&controlLock);
+
+  return;
+
+} // ~ControlSocket
+
+/*****************************************************************************
+
+  Name: isListening
+
+  Purpose: The purpose of this function is to determine whether the
+  socket was created.
+
+  Calling Sequence: listening = isListening()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    listening - A flag that indicates whether commands can arrive.  A
+    value of true indicates that they can.
+
+*****************************************************************************/
+bool ControlSocket::isListening(void)
+{
+
+  return (listenDescriptor >= 0);
+
+} // isListening
+
+/*****************************************************************************
+
+  Name: getCommand
+
+  Purpose: The purpose of this function is to retrieve the oldest command
+  that is waiting to be applied.  This never waits, so it can be called
+  between frames.  Each command must be answered with reply().
+
+  Calling Sequence: available = getCommand(commandPtr)
+
+  Inputs:
+
+    commandPtr - A pointer to storage for the command.
+
+ Outputs:
+
+    available - A flag that indicates whether a command was retrieved.
+    A value of true indicates that one was.
+
+*****************************************************************************/
+bool ControlSocket::getCommand(ControlCommand *commandPtr)
+{
+  bool available;
+
+  pthread_mutex_lock(&controlLock);
+
+  available = (numberOfCommands > 0);
+
+  if (available)
+  {
+    *commandPtr = commands[oldestCommand];
+
+    oldestCommand = (oldestCommand + 1) % CONTROL_QUEUE_SIZE;
+    numberOfCommands--;
+
+    if (commandPtr->type == ControlWindow)
+    {
+      numberOfWindowCommands--;
+    } // if
+  } // if
+
+  pthread_mutex_unlock(&controlLock);
+
+  return (available);
+
+} // getCommand
+
+/*****************************************************************************
+
+  Name: reply
+
+  Purpose: The purpose of this function is to answer a command.  The
+  reply is sent by the thread of the socket, so this never waits on a
+  client.  If the client has gone away, the reply is dropped.
+
+  Calling Sequence: reply(commandPtr,textPtr)
+
+  Inputs:
+
+    commandPtr - A pointer to the command that is answered.
+
+    textPtr - The reply, without a newline.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::reply(ControlCommand *commandPtr,const char *textPtr)
+{
+  ControlReply *replyPtr;
+
+  pthread_mutex_lock(&controlLock);
+
+  if (numberOfReplies < CONTROL_QUEUE_SIZE)
+  {
+    replyPtr = &replies[numberOfReplies];
+
+    replyPtr->clientId = commandPtr->clientId;
+    snprintf(replyPtr->text,sizeof(replyPtr->text),"%s\n",textPtr);
+
+    numberOfReplies++;
+  } // if
+
+  pthread_mutex_unlock(&controlLock);
+
+  wakeUp();
+
+  return;
+
+} // reply
+
+/*****************************************************************************
+
+  Name: retireTables
+
+  Purpose: The purpose of this function is to hand back tables that are
+  no longer in use.  They are destroyed by the thread of the socket,
+  which is the only thread that plans FFTs while the analyzer runs.
+
+  Calling Sequence: retireTables(tablesPtr)
+
+  Inputs:
+
+    tablesPtr - A pointer to the tables.  A value of NULL is ignored.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::retireTables(SpectrumTables *tablesPtr)
+{
+
+  if (tablesPtr == NULL)
+  {
+    return;
+  } // if
+
+  pthread_mutex_lock(&controlLock);
+  retiredTables[numberOfRetiredTables] = tablesPtr;
+  numberOfRetiredTables++;
+  pthread_mutex_unlock(&controlLock);
+
+  wakeUp();
+
+  return;
+
+} // retireTables
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of the thread of the socket.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the ControlSocket.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *ControlSocket::threadEntry(void *argPtr)
+{
+  ControlSocket *controlPtr;
+
+  controlPtr = (ControlSocket *)argPtr;
+
+  controlPtr->run();
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to serve the socket until the
+  ControlSocket is being destroyed.  It waits for connections, commands,
+  and the wakeups that mean there are replies to send or tables to
+  destroy.
+
+  Calling Sequence: run()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::run(void)
+{
+  uint32_t i;
+  uint32_t count;
+  uint64_t wakeups;
+  bool done;
+  ssize_t status;
+  ControlClient *clientsPtr[MAX_CONTROL_CLIENTS];
+  SpectrumTables *tablesPtr[CONTROL_QUEUE_SIZE + 1];
+  uint32_t numberOfTables;
+  struct pollfd descriptors[MAX_CONTROL_CLIENTS + 2];
+
+  done = false;
+
+  while (!done)
+  {
+    descriptors[0].fd = wakeupDescriptor;
+    descriptors[0].events = POLLIN;
+    descriptors[1].fd = listenDescriptor;
+    descriptors[1].events = POLLIN;
+
+    count = 2;
+
+    for (i = 0; i < MAX_CONTROL_CLIENTS; i++)
+    {
+      if (clients[i].descriptor >= 0)
+      {
+        descriptors[count].fd = clients[i].descriptor;
+        descriptors[count].events = POLLIN;
+        clientsPtr[count - 2] = &clients[i];
+        count++;
+      } // if
+    } // for
+
+    if (poll(descriptors,count,-1) < 0)
+    {
+      // Try again if a signal got in the way.
+      continue;
+    } // if
+
+    if (descriptors[0].revents != 0)
+    {
+      // This only clears the wakeup.
+      status = read(wakeupDescriptor,&wakeups,sizeof(wakeups));
+      (void)status;
+
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      // Take the retired tables, and destroy them once
+      // the lock has been released.
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      pthread_mutex_lock(&controlLock);
+
+      done = stopping;
+
+      numberOfTables = numberOfRetiredTables;
+
+      for (i = 0; i < numberOfTables; i++)
+      {
+        tablesPtr[i] = retiredTables[i];
+      } // for
+
+      numberOfRetiredTables = 0;
+
+      pthread_mutex_unlock(&controlLock);
+
+      for (i = 0; i < numberOfTables; i++)
+      {
+        delete tablesPtr[i];
+      } // for
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+      sendReplies();
+    } // if
+
+    for (i = 2; (i < count) && !done; i++)
+    {
+      if (descriptors[i].revents != 0)
+      {
+        readClient(clientsPtr[i - 2]);
+      } // if
+    } // for
+
+    if ((descriptors[1].revents != 0) && !done)
+    {
+      acceptClient();
+    } // if
+  } // while
+
+  return;
+
+} // run
+
+/*****************************************************************************
+
+  Name: acceptClient
+
+  Purpose: The purpose of this function is to accept a connection.  If
+  there are already as many clients as can be served, the connection is
+  told so and closed.
+
+  Calling Sequence: acceptClient()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::acceptClient(void)
+{
+  int descriptor;
+  uint32_t i;
+  ssize_t status;
+  const char *busyPtr;
+
+  descriptor = accept(listenDescriptor,NULL,NULL);
+
+  if (descriptor < 0)
+  {
+    return;
+  } // if
+
+  for (i = 0; i < MAX_CONTROL_CLIENTS; i++)
+  {
+    if (clients[i].descriptor < 0)
+    {
+      clients[i].descriptor = descriptor;
+      clients[i].clientId = nextClientId++;
+      clients[i].lineLength = 0;
+      clients[i].discarding = false;
+
+      return;
+    } // if
+  } // for
+
+  busyPtr = "ERROR too many connections\n";
+  status = send(descriptor,busyPtr,strlen(busyPtr),MSG_NOSIGNAL);
+  (void)status;
+
+  close(descriptor);
+
+  return;
+
+} // acceptClient
+
+/*****************************************************************************
+
+  Name: readClient
+
+  Purpose: The purpose of this function is to read what a client has
+  sent and parse each complete line.  A line that is too long is
+  answered with an error and thrown away.  When the client closes the
+  connection, its slot is freed.
+
+  Calling Sequence: readClient(clientPtr)
+
+  Inputs:
+
+    clientPtr - A pointer to the client.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::readClient(ControlClient *clientPtr)
+{
+  int i;
+  int count;
+  char buffer[256];
+
+  count = read(clientPtr->descriptor,buffer,sizeof(buffer));
+
+  if (count <= 0)
+  {
+    // The client is gone.
+    close(clientPtr->descriptor);
+    clientPtr->descriptor = -1;
+
+    return;
+  } // if
+
+  for (i = 0; i < count; i++)
+  {
+    if (buffer[i] == '\n')
+    {
+      if (clientPtr->discarding)
+      {
+        sendText(clientPtr->clientId,"ERROR line too long\n");
+      } // if
+      else
+      {
+        clientPtr->line[clientPtr->lineLength] = 0;
+        parseLine(clientPtr);
+      } // else
+
+      clientPtr->lineLength = 0;
+      clientPtr->discarding = false;
+    } // if
+    else
+    {
+      if (clientPtr->lineLength < (CONTROL_LINE_SIZE - 1))
+      {
+        clientPtr->line[clientPtr->lineLength] = buffer[i];
+        clientPtr->lineLength++;
+      } // if
+      else
+      {
+        clientPtr->discarding = true;
+      } // else
+    } // else
+  } // for
+
+  return;
+
+} // readClient
+
+/*****************************************************************************
+
+  Name: parseLine
+
+  Purpose: The purpose of this function is to parse a command and queue
+  it for the analyzer.  The commands are,
+
+    reference <dB> - The reference level of the spectrum display.
+    gain <gain> - The vertical gain of the display.
+    display <magnitude | spectrum | lissajous> - The display type.
+    rate <S/s> - The sample rate that the annotations show.
+    window <hanning | hamming | blackman | rectangular> - The window.
+    aggregation <average | peak> - How spectra are combined per frame.
+    averaging <spectra> - The length of the video average trace.
+    fft <points> - The FFT size.
+    help - A list of the commands.
+
+  The tables of a window are built here.  Errors in a command are
+  answered right away.
+
+  Calling Sequence: parseLine(clientPtr)
+
+  Inputs:
+
+    clientPtr - A pointer to the client, whose line is complete.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::parseLine(ControlClient *clientPtr)
+{
+  int count;
+  bool valid;
+  bool tablesAllowed;
+  char *endPtr;
+  char name[32];
+  char argument[64];
+  ControlCommand command;
+
+  count = sscanf(clientPtr->line,"%31s %63s",name,argument);
+
+  if (count < 1)
+  {
+    // Blank lines are ignored.
+    return;
+  } // if
+
+  if (strcmp(name,"help") == 0)
+  {
+    sendText(clientPtr->clientId,
+             "OK reference <dB> | gain <gain> |"
+             " display <magnitude|spectrum|lissajous> | rate <S/s> |"
+             " window <hanning|hamming|blackman|rectangular> |"
+             " aggregation <average|peak> | averaging <spectra> |"
+             " fft <points>\n");
+    return;
+  } // if
+
+  if (count < 2)
+  {
+    sendText(clientPtr->clientId,"ERROR missing value\n");
+    return;
+  } // if
+
+  command.clientId = clientPtr->clientId;
+  command.tablesPtr = NULL;
+  command.value = strtod(argument,&endPtr);
+
+  // Default to a numeric argument.
+  valid = (*endPtr == 0);
+
+  if (strcmp(name,"reference") == 0)
+  {
+    command.type = ControlReferenceLevel;
+  } // if
+  else
+  {
+    if (strcmp(name,"gain") == 0)
+    {
+      command.type = ControlVerticalGain;
+      valid = valid && (command.value > 0);
+    } // if
+    else
+    {
+      if (strcmp(name,"rate") == 0)
+      {
+        command.type = ControlSampleRate;
+        valid = valid && (command.value > 0);
+      } // if
+      else
+      {
+        if (strcmp(name,"averaging") == 0)
+        {
+          command.type = ControlAveragingLength;
+          valid = valid && (command.value >= 1);
+        } // if
+        else
+        {
+          if (strcmp(name,"fft") == 0)
+          {
+            command.type = ControlFftSize;
+            valid = valid && (command.value >= 1);
+          } // if
+          else
+          {
+            if (strcmp(name,"display") == 0)
+            {
+              command.type = ControlDisplayType;
+              command.value = (strcmp(argument,"magnitude") == 0) ? 1 :
+                              (strcmp(argument,"spectrum") == 0) ? 2 :
+                              (strcmp(argument,"lissajous") == 0) ? 3 : 0;
+              valid = (command.value != 0);
+            } // if
+            else
+            {
+              if (strcmp(name,"aggregation") == 0)
+              {
+                command.type = ControlFrameAggregation;
+                command.value = (strcmp(argument,"average") == 0) ? 1 :
+                                (strcmp(argument,"peak") == 0) ? 2 : 0;
+                valid = (command.value != 0);
+              } // if
+              else
+              {
+                if (strcmp(name,"window") == 0)
+                {
+                  command.type = ControlWindow;
+                  command.value =
+                    (strcmp(argument,"hanning") == 0) ? HanningWindow :
+                    (strcmp(argument,"hamming") == 0) ? HammingWindow :
+                    (strcmp(argument,"blackman") == 0) ? BlackmanWindow :
+                    (strcmp(argument,"rectangular") == 0) ?
+                      RectangularWindow : 0;
+                  valid = (command.value != 0);
+                } // if
+                else
+                {
+                  sendText(clientPtr->clientId,"ERROR unknown command\n");
+                  return;
+                } // else
+              } // else
+            } // else
+          } // else
+        } // else
+      } // else
+    } // else
+  } // else
+
+  if (!valid)
+  {
+    sendText(clientPtr->clientId,"ERROR bad value\n");
+    return;
+  } // if
+
+  if (command.type == ControlWindow)
+  {
+    pthread_mutex_lock(&controlLock);
+    tablesAllowed = ((numberOfWindowCommands + numberOfRetiredTables) <
+                     CONTROL_QUEUE_SIZE);
+    pthread_mutex_unlock(&controlLock);
+
+    if (!tablesAllowed)
+    {
+      sendText(clientPtr->clientId,"ERROR busy\n");
+      return;
+    } // if
+
+    // This is the expensive part, and the analyzer doesn't wait for it.
+    command.tablesPtr = new SpectrumTables(numberOfPoints,
+                                           (WindowType)command.value);
+  } // if
+
+  if (!queueCommand(&command))
+  {
+    delete command.tablesPtr;
+    sendText(clientPtr->clientId,"ERROR busy\n");
+  } // if
+
+  return;
+
+} // parseLine
+
+/*****************************************************************************
+
+  Name: queueCommand
+
+  Purpose: The purpose of this function is to queue a command for the
+  analyzer.
+
+  Calling Sequence: queued = queueCommand(commandPtr)
+
+  Inputs:
+
+    commandPtr - A pointer to the command.
+
+ Outputs:
+
+    queued - A flag that indicates whether there was room for the
+    command.  A value of true indicates that there was.
+
+*****************************************************************************/
+bool ControlSocket::queueCommand(ControlCommand *commandPtr)
+{
+  bool queued;
+
+  pthread_mutex_lock(&controlLock);
+
+  queued = (numberOfCommands < CONTROL_QUEUE_SIZE);
+
+  if (queued)
+  {
+    commands[(oldestCommand + numberOfCommands) % CONTROL_QUEUE_SIZE] =
+      *commandPtr;
+
+    numberOfCommands++;
+
+    if (commandPtr->type == ControlWindow)
+    {
+      numberOfWindowCommands++;
+    } // if
+  } // if
+
+  pthread_mutex_unlock(&controlLock);
+
+  return (queued);
+
+} // queueCommand
+
+/*****************************************************************************
+
+  Name: sendText
+
+  Purpose: The purpose of this function is to send text to a client, if
+  it is still connected.
+
+  Calling Sequence: sendText(clientId,textPtr)
+
+  Inputs:
+
+    clientId - The identity of the connection.
+
+    textPtr - The text.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::sendText(uint32_t clientId,const char *textPtr)
+{
+  uint32_t i;
+  ssize_t status;
+
+  for (i = 0; i < MAX_CONTROL_CLIENTS; i++)
+  {
+    if ((clients[i].descriptor >= 0) && (clients[i].clientId == clientId))
+    {
+      // A client that doesn't read its replies loses them.
+      status = send(clients[i].descriptor,textPtr,strlen(textPtr),
+                    MSG_NOSIGNAL | MSG_DONTWAIT);
+      (void)status;
+    } // if
+  } // for
+
+  return;
+
+} // sendText
+
+/*****************************************************************************
+
+  Name: sendReplies
+
+  Purpose: The purpose of this function is to send the replies that the
+  analyzer has queued.
+
+  Calling Sequence: sendReplies()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::sendReplies(void)
+{
+  uint32_t i;
+  uint32_t count;
+  ControlReply pending[CONTROL_QUEUE_SIZE];
+
+  pthread_mutex_lock(&controlLock);
+
+  count = numberOfReplies;
+
+  for (i = 0; i < count; i++)
+  {
+    pending[i] = replies[i];
+  } // for
+
+  numberOfReplies = 0;
+
+  pthread_mutex_unlock(&controlLock);
+
+  for (i = 0; i < count; i++)
+  {
+    sendText(pending[i].clientId,pending[i].text);
+  } // for
+
+  return;
+
+} // sendReplies
+
+/*****************************************************************************
+
+  Name: wakeUp
+
+  Purpose: The purpose of this function is to wake up the thread of the
+  socket.
+
+  Calling Sequence: wakeUp()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ControlSocket::wakeUp(void)
+{
+  uint64_t wakeup;
+  ssize_t status;
+
+  wakeup = 1;
+  status = write(wakeupDescriptor,&wakeup,sizeof(wakeup));
+  (void)status;
+
+  return;
+
+} // wakeUp
@@ -0,0 +1,869 @@
+//************************************************************************
+// file name: CrossCorrelator.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "CrossCorrelator.h"
+
+// The FFT is never smaller than this.
+#define MINIMUM_CORRELATION_FFT_SIZE (8192)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: CrossCorrelator
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an CrossCorrelator.  The FFT is the smallest power of
+  two that holds four times the largest lag, and each block is what is
+  left of it once the lags on either side are taken out, so a block is
+  never shorter than half of the FFT.  FFTW planning isn't thread safe,
+  so only one thread at a time may construct or destroy a correlator.
+
+  Calling Sequence: CrossCorrelator(maximumLag,
+                                    samplesPerResult,
+                                    numberOfThreads)
+
+  Inputs:
+
+    maximumLag - The largest lag, in samples, in either direction.
+
+    samplesPerResult - The number of samples of each stream that are
+    summed into each result.  It is rounded down to whole blocks, but
+    there is always at least one block.
+
+    numberOfThreads - The number of correlation threads.  A value of 0
+    uses one thread per processor.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+CrossCorrelator::CrossCorrelator(uint32_t maximumLag,
+                                 uint32_t samplesPerResult,
+                                 uint32_t numberOfThreads)
+{
+  uint32_t i;
+  fftw_complex *scratchPtr;
+
+  if (maximumLag == 0)
+  {
+    maximumLag = 1;
+  } // if
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  } // if
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = 1;
+  } // if
+
+  if (numberOfThreads > MAX_CORRELATION_THREADS)
+  {
+    numberOfThreads = MAX_CORRELATION_THREADS;
+  } // if
+
+  // Retrieve for later use.
+  this->maximumLag = maximumLag;
+  this->numberOfThreads = numberOfThreads;
+
+  numberOfLags = (2 * maximumLag) + 1;
+
+  for (fftSize = MINIMUM_CORRELATION_FFT_SIZE;
+       fftSize < (4 * maximumLag);
+       fftSize *= 2)
+  {
+  } // for
+
+  blockLength = fftSize - (2 * maximumLag);
+  blocksPerResult = samplesPerResult / blockLength;
+
+  if (blocksPerResult == 0)
+  {
+    blocksPerResult = 1;
+  } // if
+
+  primed = false;
+  blocksInResult = 0;
+
+  // The histories start out silent.
+  firstHistoryPtr = new int8_t[2 * (blockLength + (2 * maximumLag))];
+  secondHistoryPtr = new int8_t[2 * (blockLength + maximumLag)];
+  memset(firstHistoryPtr,0,2 * (blockLength + (2 * maximumLag)));
+  memset(secondHistoryPtr,0,2 * (blockLength + maximumLag));
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The plans are made in place with a scratch array, and
+  // executed in place on the buffers of each thread.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  scratchPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * fftSize);
+
+  forwardPlan = fftw_plan_dft_1d(fftSize,scratchPtr,scratchPtr,
+                                 FFTW_FORWARD,FFTW_ESTIMATE);
+
+  inversePlan = fftw_plan_dft_1d(fftSize,scratchPtr,scratchPtr,
+                                 FFTW_BACKWARD,FFTW_ESTIMATE);
+
+  fftw_free(scratchPtr);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  sumPtr = new double[2 * numberOfLags];
+  coherencePtr = new float[numberOfLags];
+
+  for (i = 0; i < numberOfLags; i++)
+  {
+    coherencePtr[i] = 0;
+  } // for
+
+  peakLag = 0;
+  peakCoherence = 0;
+  peakPhase = 0;
+
+  numberOfJobs = numberOfThreads * CORRELATION_JOBS_PER_THREAD;
+
+  for (i = 0; i < numberOfJobs; i++)
+  {
+    jobs[i].firstPtr = new int8_t[2 * (blockLength + (2 * maximumLag))];
+    jobs[i].secondPtr = new int8_t[2 * blockLength];
+    jobs[i].state = CorrelationJobFree;
+  } // for
+
+  oldestJob = 0;
+  numberOfPendingJobs = 0;
+  stopping = false;
+
+  pthread_mutex_init(&jobLock,NULL);
+  pthread_cond_init(&jobQueued,NULL);
+  pthread_cond_init(&jobDone,NULL);
+
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    workers[i].correlatorPtr = this;
+
+    workers[i].firstPtr =
+      (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * fftSize);
+
+    workers[i].secondPtr =
+      (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * fftSize);
+
+    workers[i].sumPtr = new double[2 * numberOfLags];
+    memset(workers[i].sumPtr,0,2 * numberOfLags * sizeof(double));
+    workers[i].firstEnergy = 0;
+    workers[i].secondEnergy = 0;
+
+    pthread_create(&workers[i].thread,NULL,threadEntry,&workers[i]);
+  } // for
+
+  return;
+
+} // CrossCorrelator
+
+/*****************************************************************************
+
+  Name: ~CrossCorrelator
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an CrossCorrelator.  Blocks that haven't made it into
+  a result are thrown away.
+
+  Calling Sequence: ~CrossCorrelator()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+CrossCorrelator::~CrossCorrelator(void)
+{
+  uint32_t i;
+
+  // Let the threads finish what they have.
+  reclaimFinishedJobs(0);
+
+  pthread_mutex_lock(&jobLock);
+  stopping = true;
+  pthread_cond_broadcast(&jobQueued);
+  pthread_mutex_unlock(&jobLock);
+
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    pthread_join(workers[i].thread,NULL);
+
+    fftw_free(workers[i].firstPtr);
+    fftw_free(workers[i].secondPtr);
+    delete[] workers[i].sumPtr;
+  } // for
+
+  pthread_cond_destroy(&jobDone);
+  pthread_cond_destroy(&jobQueued);
+  pthread_mutex_destroy(&jobLock);
+
+  // Release resources.
+  for (i = 0; i < numberOfJobs; i++)
+  {
+    delete[] jobs[i].firstPtr;
+    delete[] jobs[i].secondPtr;
+  } // for
+
+  fftw_destroy_plan(forwardPlan);
+  fftw_destroy_plan(inversePlan);
+
+  delete[] firstHistoryPtr;
+  delete[] secondHistoryPtr;
+  delete[] sumPtr;
+  delete[] coherencePtr;
+
+  return;
+
+} // ~CrossCorrelator
+
+/*****************************************************************************
+
+  Name: getBlockLength
+
+  Purpose: The purpose of this function is to retrieve the number of
+  samples of each stream that acceptSamples() takes.
+
+  Calling Sequence: blockLength = getBlockLength()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    blockLength - The number of complex samples in a block.
+
+*****************************************************************************/
+uint32_t CrossCorrelator::getBlockLength(void)
+{
+
+  return (blockLength);
+
+} // getBlockLength
+
+/*****************************************************************************
+
+  Name: getMaximumLag
+
+  Purpose: The purpose of this function is to retrieve the largest lag
+  that is computed.
+
+  Calling Sequence: maximumLag = getMaximumLag()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    maximumLag - The largest lag, in samples, in either direction.
+
+*****************************************************************************/
+uint32_t CrossCorrelator::getMaximumLag(void)
+{
+
+  return (maximumLag);
+
+} // getMaximumLag
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to accept a block of each
+  stream.  The block is copied into a job for the correlation threads,
+  and once a result's worth of blocks have been queued, this waits for
+  the threads and computes the result.  The very first block only fills
+  the history of the first stream, so that the second stream has
+  something on either side of it.
+
+  Calling Sequence: resultReady = acceptSamples(firstBufferPtr,
+                                                secondBufferPtr)
+
+  Inputs:
+
+    firstBufferPtr - A pointer to getBlockLength() signed IQ samples of
+    the first stream, formatted as I1,Q1; I2,Q2; ...
+
+    secondBufferPtr - A pointer to the same samples of the second
+    stream.
+
+ Outputs:
+
+    resultReady - A flag that indicates whether a new result is ready.
+    A value of true indicates that it is.
+
+*****************************************************************************/
+bool CrossCorrelator::acceptSamples(const int8_t *firstBufferPtr,
+                                    const int8_t *secondBufferPtr)
+{
+  CorrelationJob *jobPtr;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Slide the histories along.  The first stream keeps the
+  // lags on both sides of the block, and the second keeps
+  // enough to be delayed by the largest lag.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  memmove(firstHistoryPtr,
+          &firstHistoryPtr[2 * blockLength],
+          4 * maximumLag);
+
+  memcpy(&firstHistoryPtr[4 * maximumLag],firstBufferPtr,2 * blockLength);
+
+  memmove(secondHistoryPtr,
+          &secondHistoryPtr[2 * blockLength],
+          2 * maximumLag);
+
+  memcpy(&secondHistoryPtr[2 * maximumLag],secondBufferPtr,2 * blockLength);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (!primed)
+  {
+    primed = true;
+    return (false);
+  } // if
+
+  // The job after the pending ones is always free.
+  jobPtr = &jobs[(oldestJob + numberOfPendingJobs) % numberOfJobs];
+
+  memcpy(jobPtr->firstPtr,
+         firstHistoryPtr,
+         2 * (blockLength + (2 * maximumLag)));
+
+  memcpy(jobPtr->secondPtr,secondHistoryPtr,2 * blockLength);
+
+  submitJob();
+
+  blocksInResult++;
+
+  if (blocksInResult < blocksPerResult)
+  {
+    return (false);
+  } // if
+
+  // Wait for every block of the result.
+  reclaimFinishedJobs(0);
+
+  computeResult();
+  blocksInResult = 0;
+
+  return (true);
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: getCoherence
+
+  Purpose: The purpose of this function is to retrieve the coherence of
+  the latest result at every lag.
+
+  Calling Sequence: coherencePtr = getCoherence()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    coherencePtr - A pointer to 2 * getMaximumLag() + 1 values between 0
+    and 1, from the most negative lag to the most positive lag.
+
+*****************************************************************************/
+const float *CrossCorrelator::getCoherence(void)
+{
+
+  return (coherencePtr);
+
+} // getCoherence
+
+/*****************************************************************************
+
+  Name: getPeakLag
+
+  Purpose: The purpose of this function is to retrieve the lag of the
+  peak of the latest result.  A parabola is fitted through the peak and
+  its neighbors, so the lag is a fraction of a sample.
+
+  Calling Sequence: lag = getPeakLag()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    lag - The lag in samples.
+
+*****************************************************************************/
+double CrossCorrelator::getPeakLag(void)
+{
+
+  return (peakLag);
+
+} // getPeakLag
+
+/*****************************************************************************
+
+  Name: getPeakCoherence
+
+  Purpose: The purpose of this function is to retrieve the coherence at
+  the peak of the latest result.
+
+  Calling Sequence: coherence = getPeakCoherence()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    coherence - The coherence, between 0 and 1.
+
+*****************************************************************************/
+float CrossCorrelator::getPeakCoherence(void)
+{
+
+  return (peakCoherence);
+
+} // getPeakCoherence
+
+/*****************************************************************************
+
+  Name: getPeakPhase
+
+  Purpose: The purpose of this function is to retrieve the phase of the
+  correlation at the peak of the latest result, which is the phase of
+  the first stream relative to the second.
+
+  Calling Sequence: phase = getPeakPhase()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    phase - The phase in degrees.
+
+*****************************************************************************/
+float CrossCorrelator::getPeakPhase(void)
+{
+
+  return (peakPhase);
+
+} // getPeakPhase
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of a correlation thread.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the worker of the thread.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *CrossCorrelator::threadEntry(void *argPtr)
+{
+  CorrelationWorker *workerPtr;
+
+  workerPtr = (CorrelationWorker *)argPtr;
+
+  workerPtr->correlatorPtr->run(workerPtr);
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to correlate queued blocks
+  until the correlator is destroyed.
+
+  Calling Sequence: run(workerPtr)
+
+  Inputs:
+
+    workerPtr - A pointer to the worker of the thread.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CrossCorrelator::run(CorrelationWorker *workerPtr)
+{
+  uint32_t i;
+  bool done;
+  CorrelationJob *jobPtr;
+
+  done = false;
+
+  pthread_mutex_lock(&jobLock);
+
+  while (!done)
+  {
+    jobPtr = NULL;
+
+    for (i = 0; (i < numberOfPendingJobs) && (jobPtr == NULL); i++)
+    {
+      if (jobs[(oldestJob + i) % numberOfJobs].state == CorrelationJobQueued)
+      {
+        jobPtr = &jobs[(oldestJob + i) % numberOfJobs];
+      } // if
+    } // for
+
+    if (jobPtr != NULL)
+    {
+      jobPtr->state = CorrelationJobBusy;
+      pthread_mutex_unlock(&jobLock);
+
+      correlateBlock(workerPtr,jobPtr);
+
+      pthread_mutex_lock(&jobLock);
+      jobPtr->state = CorrelationJobDone;
+      pthread_cond_broadcast(&jobDone);
+    } // if
+    else
+    {
+      if (stopping)
+      {
+        done = true;
+      } // if
+      else
+      {
+        pthread_cond_wait(&jobQueued,&jobLock);
+      } // else
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&jobLock);
+
+  return;
+
+} // run
+
+/*****************************************************************************
+
+  Name: correlateBlock
+
+  Purpose: The purpose of this function is to correlate one block and
+  add it to the running sums of the thread.  Both streams are zero
+  padded to the FFT size, and the inverse FFT of the product of the
+  first spectrum and the conjugate of the second is the correlation.
+  The second stream is short enough that none of the lags that are kept
+  wrap around.
+
+  Calling Sequence: correlateBlock(workerPtr,jobPtr)
+
+  Inputs:
+
+    workerPtr - A pointer to the worker of the thread.
+
+    jobPtr - A pointer to the job.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CrossCorrelator::correlateBlock(CorrelationWorker *workerPtr,
+                                     CorrelationJob *jobPtr)
+{
+  uint32_t i;
+  uint32_t firstLength;
+  double real;
+  double imaginary;
+  fftw_complex *firstPtr;
+  fftw_complex *secondPtr;
+
+  firstPtr = workerPtr->firstPtr;
+  secondPtr = workerPtr->secondPtr;
+
+  firstLength = blockLength + (2 * maximumLag);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Load and zero pad both streams.  The energy of the
+  // first stream is measured over the part that lines up
+  // with the second stream at zero lag.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < firstLength; i++)
+  {
+    firstPtr[i][0] = jobPtr->firstPtr[2 * i];
+    firstPtr[i][1] = jobPtr->firstPtr[(2 * i) + 1];
+  } // for
+
+  for (i = maximumLag; i < (maximumLag + blockLength); i++)
+  {
+    workerPtr->firstEnergy += (firstPtr[i][0] * firstPtr[i][0]) +
+                              (firstPtr[i][1] * firstPtr[i][1]);
+  } // for
+
+  for (i = 0; i < blockLength; i++)
+  {
+    secondPtr[i][0] = jobPtr->secondPtr[2 * i];
+    secondPtr[i][1] = jobPtr->secondPtr[(2 * i) + 1];
+
+    workerPtr->secondEnergy += (secondPtr[i][0] * secondPtr[i][0]) +
+                               (secondPtr[i][1] * secondPtr[i][1]);
+  } // for
+
+  memset(&firstPtr[firstLength],0,
+         (fftSize - firstLength) * sizeof(fftw_complex));
+
+  memset(&secondPtr[blockLength],0,
+         (fftSize - blockLength) * sizeof(fftw_complex));
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  fftw_execute_dft(forwardPlan,firstPtr,firstPtr);
+  fftw_execute_dft(forwardPlan,secondPtr,secondPtr);
+
+  // Multiply by the conjugate of the second spectrum.
+  for (i = 0; i < fftSize; i++)
+  {
+    real = (firstPtr[i][0] * secondPtr[i][0]) +
+           (firstPtr[i][1] * secondPtr[i][1]);
+
+    imaginary = (firstPtr[i][1] * secondPtr[i][0]) -
+                (firstPtr[i][0] * secondPtr[i][1]);
+
+    firstPtr[i][0] = real;
+    firstPtr[i][1] = imaginary;
+  } // for
+
+  fftw_execute_dft(inversePlan,firstPtr,firstPtr);
+
+  // Lag 0 is at the largest lag.
+  for (i = 0; i < numberOfLags; i++)
+  {
+    workerPtr->sumPtr[2 * i] += firstPtr[i][0];
+    workerPtr->sumPtr[(2 * i) + 1] += firstPtr[i][1];
+  } // for
+
+  return;
+
+} // correlateBlock
+
+/*****************************************************************************
+
+  Name: submitJob
+
+  Purpose: The purpose of this function is to hand the job that was just
+  filled to the correlation threads.  If every job is busy, this waits
+  until the next one to be filled is free.
+
+  Calling Sequence: submitJob()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CrossCorrelator::submitJob(void)
+{
+
+  pthread_mutex_lock(&jobLock);
+
+  jobs[(oldestJob + numberOfPendingJobs) % numberOfJobs].state =
+    CorrelationJobQueued;
+
+  numberOfPendingJobs++;
+
+  pthread_cond_signal(&jobQueued);
+  pthread_mutex_unlock(&jobLock);
+
+  // Make room for the next job.
+  reclaimFinishedJobs(numberOfJobs - 1);
+
+  return;
+
+} // submitJob
+
+/*****************************************************************************
+
+  Name: reclaimFinishedJobs
+
+  Purpose: The purpose of this function is to free the jobs that have
+  been correlated, in order, and to wait for jobs until no more than a
+  given number are pending.
+
+  Calling Sequence: reclaimFinishedJobs(maximumPending)
+
+  Inputs:
+
+    maximumPending - The number of jobs that may be left pending.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CrossCorrelator::reclaimFinishedJobs(uint32_t maximumPending)
+{
+  bool done;
+
+  done = false;
+
+  pthread_mutex_lock(&jobLock);
+
+  while ((numberOfPendingJobs > 0) && !done)
+  {
+    if (jobs[oldestJob].state != CorrelationJobDone)
+    {
+      if (numberOfPendingJobs <= maximumPending)
+      {
+        // It can wait.
+        done = true;
+      } // if
+      else
+      {
+        pthread_cond_wait(&jobDone,&jobLock);
+      } // else
+    } // if
+    else
+    {
+      jobs[oldestJob].state = CorrelationJobFree;
+      oldestJob = (oldestJob + 1) % numberOfJobs;
+      numberOfPendingJobs--;
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&jobLock);
+
+  return;
+
+} // reclaimFinishedJobs
+
+/*****************************************************************************
+
+  Name: computeResult
+
+  Purpose: The purpose of this function is to combine the running sums
+  of the threads into a result, and to start the sums over.  Every job
+  has been reclaimed, so the threads are all waiting.
+
+  Calling Sequence: computeResult()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void CrossCorrelator::computeResult(void)
+{
+  uint32_t i;
+  uint32_t j;
+  uint32_t peak;
+  double firstEnergy;
+  double secondEnergy;
+  double normalization;
+  double left;
+  double right;
+  double curvature;
+  double offset;
+
+  memset(sumPtr,0,2 * numberOfLags * sizeof(double));
+  firstEnergy = 0;
+  secondEnergy = 0;
+
+  pthread_mutex_lock(&jobLock);
+
+  for (j = 0; j < numberOfThreads; j++)
+  {
+    for (i = 0; i < (2 * numberOfLags); i++)
+    {
+      sumPtr[i] += workers[j].sumPtr[i];
+    } // for
+
+    firstEnergy += workers[j].firstEnergy;
+    secondEnergy += workers[j].secondEnergy;
+
+    memset(workers[j].sumPtr,0,2 * numberOfLags * sizeof(double));
+    workers[j].firstEnergy = 0;
+    workers[j].secondEnergy = 0;
+  } // for
+
+  pthread_mutex_unlock(&jobLock);
+
+  // The inverse FFT isn't scaled, so that is taken care of here too.
+  normalization = fftSize * sqrt(firstEnergy * secondEnergy);
+
+  peak = 0;
+
+  for (i = 0; i < numberOfLags; i++)
+  {
+    if (normalization > 0)
+    {
+      coherencePtr[i] = hypot(sumPtr[2 * i],sumPtr[(2 * i) + 1]) /
+                        normalization;
+    } // if
+    else
+    {
+      coherencePtr[i] = 0;
+    } // else
+
+    if (coherencePtr[i] > coherencePtr[peak])
+    {
+      peak = i;
+    } // if
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Fit a parabola through the peak and its neighbors to
+  // find the lag between samples.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  offset = 0;
+
+  if ((peak > 0) && (peak < (numberOfLags - 1)))
+  {
+    left = coherencePtr[peak - 1];
+    right = coherencePtr[peak + 1];
+    curvature = left - (2 * coherencePtr[peak]) + right;
+
+    if (curvature < 0)
+    {
+      offset = 0.5 * (left - right) / curvature;
+    } // if
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  peakLag = ((double)peak + offset) - maximumLag;
+  peakCoherence = coherencePtr[peak];
+  peakPhase = (180 / M_PI) * atan2(sumPtr[(2 * peak) + 1],sumPtr[2 * peak]);
+
+  return;
+
+} // computeResult
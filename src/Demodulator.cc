@@ -0,0 +1,964 @@
+//************************************************************************
+// file name: Demodulator.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "Demodulator.h"
+#include "SpectrumEngine.h"
+
+// The largest interpolation factor that the resampler uses.
+#define MAX_INTERPOLATION (64)
+
+// The peak deviations that map to full scale, in Hz.
+#define NARROW_FM_DEVIATION (5000.0f)
+#define WIDE_FM_DEVIATION (75000.0f)
+
+// The de-emphasis time constant for wide FM, in seconds.
+#define DEEMPHASIS_TIME_CONSTANT (75e-6f)
+
+// The carrier level of AM follows the signal this slowly, in seconds.
+#define CARRIER_TIME_CONSTANT (0.1f)
+
+// A full scale audio sample maps to this, which leaves some headroom.
+#define PCM_SCALE (16384.0f)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: fastAtan2
+
+  Purpose: The purpose of this function is to compute atan2(y,x) with a
+  polynomial approximation of the arctangent over [0,1], which is good
+  to about 1e-5 radians.  The octant is then sorted out from the signs
+  and sizes of x and y.
+
+  Calling Sequence: angle = fastAtan2(y,x)
+
+  Inputs:
+
+    y - The imaginary part.
+
+    x - The real part.
+
+ Outputs:
+
+    angle - The angle in radians, from -pi to pi.
+
+*****************************************************************************/
+static inline float fastAtan2(float y,float x)
+{
+  float absoluteX;
+  float absoluteY;
+  float ratio;
+  float square;
+  float angle;
+
+  absoluteX = fabsf(x);
+  absoluteY = fabsf(y);
+
+  // Keep the ratio within [0,1].
+  if (absoluteY > absoluteX)
+  {
+    ratio = absoluteX / absoluteY;
+  } // if
+  else
+  {
+    ratio = absoluteY / (absoluteX + 1e-20f);
+  } // else
+
+  square = ratio * ratio;
+
+  angle = ratio * (0.99997726f + square * (-0.33262347f +
+          square * (0.19354346f + square * (-0.11643287f +
+          square * (0.05265332f + square * -0.01172120f)))));
+
+  if (absoluteY > absoluteX)
+  {
+    angle = (float)(M_PI / 2) - angle;
+  } // if
+
+  if (x < 0)
+  {
+    angle = (float)M_PI - angle;
+  } // if
+
+  if (y < 0)
+  {
+    angle = -angle;
+  } // if
+
+  return (angle);
+
+} // fastAtan2
+
+/*****************************************************************************
+
+  Name: Demodulator
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an Demodulator.  The demodulation thread is started
+  here.
+
+  Calling Sequence: Demodulator(type,
+                                sampleRate,
+                                outputDescriptor,
+                                dropWhenFull)
+
+  Inputs:
+
+    type - The type of demodulation: AmDemodulation, NarrowFmDemodulation
+    (5kHz deviation) or WideFmDemodulation (75kHz deviation, 75us
+    de-emphasis).
+
+    sampleRate - The sample rate of the IQ data in S/s.
+
+    outputDescriptor - The file descriptor that the PCM audio is
+    written to.
+
+    dropWhenFull - A flag that indicates what happens to a block when
+    the queue is full.  A value of true indicates that it is dropped, so
+    that live input never waits for the audio, and a value of false
+    indicates that the caller waits for room.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+Demodulator::Demodulator(DemodulationType type,
+  float sampleRate,
+  int outputDescriptor,
+  bool dropWhenFull)
+{
+
+  if (sampleRate <= 0)
+  {
+    // Keep it sane.
+    sampleRate = 256000;
+  } // if
+
+  // Retrieve for later use.
+  this->type = type;
+  this->sampleRate = sampleRate;
+  this->outputDescriptor = outputDescriptor;
+  this->dropWhenFull = dropWhenFull;
+
+  outputFailed = false;
+
+  // Full deviation maps to full scale.
+  fmGain = sampleRate / (2 * (float)M_PI *
+           ((type == WideFmDemodulation) ?
+            WIDE_FM_DEVIATION : NARROW_FM_DEVIATION));
+
+  previousI = 0;
+  previousQ = 0;
+
+  // These run at the audio sample rate.
+  carrierLevel = 0;
+  carrierAlpha = 1 - expf(-1.0f / (AUDIO_SAMPLE_RATE *
+                                   CARRIER_TIME_CONSTANT));
+
+  deemphasisEnabled = (type == WideFmDemodulation);
+  deemphasisAlpha = 1 - expf(-1.0f / (AUDIO_SAMPLE_RATE *
+                                      DEEMPHASIS_TIME_CONSTANT));
+  deemphasisState = 0;
+
+  // Set up the resampler.
+  designResampler();
+
+  // The queue is empty.
+  queueHead = 0;
+  queueTail = 0;
+  queueCount = 0;
+  stopping = false;
+  numberOfBlocks = 0;
+  numberOfDroppedBlocks = 0;
+
+  pthread_mutex_init(&queueLock,NULL);
+  pthread_cond_init(&queueNotEmpty,NULL);
+  pthread_cond_init(&queueNotFull,NULL);
+
+  // Everything is ready, so start demodulating.
+  pthread_create(&thread,NULL,threadEntry,this);
+
+  return;
+
+} // Demodulator
+
+/*****************************************************************************
+
+  Name: ~Demodulator
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an Demodulator.  Whatever is in the queue is demodulated
+  before the thread exits.
+
+  Calling Sequence: ~Demodulator()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+Demodulator::~Demodulator(void)
+{
+
+  // Tell the thread to finish up.
+  pthread_mutex_lock(&queueLock);
+  stopping = true;
+  pthread_cond_signal(&queueNotEmpty);
+  pthread_mutex_unlock(&queueLock);
+
+  pthread_join(thread,NULL);
+
+  pthread_cond_destroy(&queueNotEmpty);
+  pthread_cond_destroy(&queueNotFull);
+  pthread_mutex_destroy(&queueLock);
+
+  // Release resources.
+  delete[] phaseTapsPtr;
+  delete[] historyPtr;
+  delete[] audioBufferPtr;
+  delete[] pcmBufferPtr;
+
+  return;
+
+} // ~Demodulator
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to queue a block of IQ data
+  for demodulation.  The data is copied, so the caller may reuse the
+  buffer right away.  If the queue is full, which only happens when
+  whatever reads the audio falls behind, the caller waits for room, or,
+  if the demodulator was told to drop blocks, the block is dropped and
+  counted, so that the caller never waits for the audio.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Demodulator::acceptSamples(int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t length;
+
+  while (bufferLength > 0)
+  {
+    // Large buffers take more than one slot.
+    length = (bufferLength > DEMODULATOR_BLOCK_SIZE) ?
+             DEMODULATOR_BLOCK_SIZE : bufferLength;
+
+    pthread_mutex_lock(&queueLock);
+
+    numberOfBlocks++;
+
+    if (!dropWhenFull)
+    {
+      while (queueCount == DEMODULATOR_QUEUE_LENGTH)
+      {
+        // Nothing may be lost, so wait for the audio.
+        pthread_cond_wait(&queueNotFull,&queueLock);
+      } // while
+    } // if
+
+    if (queueCount == DEMODULATOR_QUEUE_LENGTH)
+    {
+      // The display must not wait for the audio.
+      numberOfDroppedBlocks++;
+    } // if
+    else
+    {
+      memcpy(queue[queueTail],signalBufferPtr,length);
+      queueLengths[queueTail] = length;
+
+      queueTail = (queueTail + 1) % DEMODULATOR_QUEUE_LENGTH;
+      queueCount++;
+
+      pthread_cond_signal(&queueNotEmpty);
+    } // else
+
+    pthread_mutex_unlock(&queueLock);
+
+    signalBufferPtr += length;
+    bufferLength -= length;
+  } // while
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: reportStatistics
+
+  Purpose: The purpose of this function is to report to stderr how many
+  blocks were queued for demodulation, and how many of them were dropped
+  because the queue was full.
+
+  Calling Sequence: reportStatistics()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Demodulator::reportStatistics(void)
+{
+
+  pthread_mutex_lock(&queueLock);
+
+  fprintf(stderr,"Demodulator: %llu blocks, %llu dropped (queue full)\n",
+          (unsigned long long)numberOfBlocks,
+          (unsigned long long)numberOfDroppedBlocks);
+
+  pthread_mutex_unlock(&queueLock);
+
+  return;
+
+} // reportStatistics
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of the demodulation thread.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the Demodulator.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *Demodulator::threadEntry(void *argPtr)
+{
+
+  ((Demodulator *)argPtr)->run();
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to demodulate blocks as they
+  arrive in the queue, until the demodulator is being destroyed and the
+  queue is empty.  The lock is not held while a block is demodulated,
+  since the slot at the head of the queue is not touched by anyone
+  else until it is released.
+
+  Calling Sequence: run()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Demodulator::run(void)
+{
+  bool done;
+  uint32_t slot;
+
+  // Set up for loop entry.
+  done = false;
+
+  while (!done)
+  {
+    pthread_mutex_lock(&queueLock);
+
+    while ((queueCount == 0) && (!stopping))
+    {
+      pthread_cond_wait(&queueNotEmpty,&queueLock);
+    } // while
+
+    slot = queueHead;
+    done = (queueCount == 0);
+
+    pthread_mutex_unlock(&queueLock);
+
+    if (!done)
+    {
+      demodulateBlock(queue[slot],queueLengths[slot]);
+
+      // Release the slot.
+      pthread_mutex_lock(&queueLock);
+      queueHead = (queueHead + 1) % DEMODULATOR_QUEUE_LENGTH;
+      queueCount--;
+      pthread_cond_signal(&queueNotFull);
+      pthread_mutex_unlock(&queueLock);
+    } // if
+  } // while
+
+  return;
+
+} // run
+
+/*****************************************************************************
+
+  Name: designResampler
+
+  Purpose: The purpose of this function is to set up the polyphase
+  resampler that brings the audio to AUDIO_SAMPLE_RATE.  The ratio of
+  the rates is reduced to interpolation / decimation.  If that would
+  take too large an interpolation factor, the closest ratio with a small
+  one is used instead, which is off by a small fraction of a percent.
+  The filter is a Blackman windowed sinc that passes 20kHz (or less, for
+  low sample rates) and stops at the new Nyquist frequency.
+
+  Calling Sequence: designResampler()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Demodulator::designResampler(void)
+{
+  uint32_t i;
+  uint32_t j;
+  uint32_t p;
+  uint32_t a;
+  uint32_t b;
+  uint32_t t;
+  uint32_t rate;
+  uint32_t totalTaps;
+  uint32_t maximumBlockSamples;
+  double ratio;
+  double error;
+  double bestError;
+  double nyquist;
+  double cutoff;
+  double transition;
+  double prototypeRate;
+  double x;
+  double sum;
+  double *prototypePtr;
+
+  rate = (uint32_t)(sampleRate + 0.5f);
+
+  // Find the greatest common divisor of the rates.
+  a = rate;
+  b = AUDIO_SAMPLE_RATE;
+
+  while (b != 0)
+  {
+    t = a % b;
+    a = b;
+    b = t;
+  } // while
+
+  interpolation = AUDIO_SAMPLE_RATE / a;
+  decimation = rate / a;
+
+  if (interpolation > MAX_INTERPOLATION)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Settle for the closest ratio with a small
+    // interpolation factor.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    bestError = 1e9;
+
+    for (i = 1; i <= MAX_INTERPOLATION; i++)
+    {
+      ratio = ((double)rate * i) / AUDIO_SAMPLE_RATE;
+      error = fabs(ratio - floor(ratio + 0.5)) / ratio;
+
+      if ((floor(ratio + 0.5) >= 1) && (error < bestError))
+      {
+        bestError = error;
+        interpolation = i;
+        decimation = (uint32_t)floor(ratio + 0.5);
+      } // if
+    } // for
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Design the prototype filter, which runs at the
+  // interpolated rate.  The Blackman window needs
+  // about 5.5 / transition taps.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  nyquist = 0.5 * ((sampleRate < AUDIO_SAMPLE_RATE) ?
+                   sampleRate : AUDIO_SAMPLE_RATE);
+  cutoff = nyquist * (20.0 / 24.0);
+  transition = nyquist / 3;
+  prototypeRate = (double)sampleRate * interpolation;
+
+  totalTaps = (uint32_t)ceil((5.5 * prototypeRate) / transition);
+
+  // Every phase has the same number of taps, a multiple of four.
+  tapsPerPhase = (totalTaps + interpolation - 1) / interpolation;
+  tapsPerPhase = (tapsPerPhase + 3) & ~3;
+  totalTaps = tapsPerPhase * interpolation;
+
+  prototypePtr = new double[totalTaps];
+  sum = 0;
+
+  for (i = 0; i < totalTaps; i++)
+  {
+    x = i - ((totalTaps - 1) / 2.0);
+    x *= (2 * cutoff) / prototypeRate;
+
+    prototypePtr[i] = (x == 0) ? 1 : (sin(M_PI * x) / (M_PI * x));
+
+    prototypePtr[i] *= 0.42 -
+                       (0.5 * cos((2 * M_PI * i) / (totalTaps - 1))) +
+                       (0.08 * cos((4 * M_PI * i) / (totalTaps - 1)));
+
+    sum += prototypePtr[i];
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Split the prototype into phases, with a gain of
+  // one for each, and store each phase backwards so
+  // that the dot product runs forward through the
+  // history.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  phaseTapsPtr = new float[totalTaps];
+
+  for (p = 0; p < interpolation; p++)
+  {
+    for (j = 0; j < tapsPerPhase; j++)
+    {
+      phaseTapsPtr[(p * tapsPerPhase) + j] =
+        (float)((prototypePtr[((tapsPerPhase - 1 - j) * interpolation) + p] *
+                 interpolation) / sum);
+    } // for
+  } // for
+
+  delete[] prototypePtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // The history starts out as silence.
+  maximumBlockSamples = DEMODULATOR_BLOCK_SIZE / 2;
+  historyPtr = new float[(tapsPerPhase - 1) + maximumBlockSamples];
+  memset(historyPtr,0,(tapsPerPhase - 1) * sizeof(float));
+  historyLength = tapsPerPhase - 1;
+
+  inputIndex = tapsPerPhase - 1;
+  phase = 0;
+
+  // This is the most audio that a block can produce.
+  i = ((maximumBlockSamples * interpolation) / decimation) + 2;
+
+  audioBufferPtr = new float[i];
+  pcmBufferPtr = new int16_t[i];
+
+  return;
+
+} // designResampler
+
+/*****************************************************************************
+
+  Name: demodulateBlock
+
+  Purpose: The purpose of this function is to demodulate a block of IQ
+  data, resample the result to AUDIO_SAMPLE_RATE, and write it.  The
+  demodulated samples go straight into the resampler history.
+
+  Calling Sequence: demodulateBlock(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Demodulator::demodulateBlock(int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t i;
+  uint32_t numberOfSamples;
+  uint32_t numberOfOutputs;
+  float *demodulatedPtr;
+  float sample;
+
+  numberOfSamples = bufferLength / 2;
+  demodulatedPtr = &historyPtr[historyLength];
+
+  if (type == AmDemodulation)
+  {
+    // This is the oscilloscope's magnitude estimator.
+    SpectrumEngine::computeSignalMagnitude(signalBufferPtr,
+                                           bufferLength,
+                                           magnitudeBuffer);
+
+    for (i = 0; i < numberOfSamples; i++)
+    {
+      demodulatedPtr[i] = magnitudeBuffer[i];
+    } // for
+  } // if
+  else
+  {
+    discriminate(signalBufferPtr,numberOfSamples,demodulatedPtr);
+  } // else
+
+  historyLength += numberOfSamples;
+
+  numberOfOutputs = resample();
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Finish the audio at the audio sample rate,
+  // where there is the least of it.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < numberOfOutputs; i++)
+  {
+    sample = audioBufferPtr[i];
+
+    if (type == AmDemodulation)
+    {
+      // Remove the carrier, and use it as the gain.
+      carrierLevel += carrierAlpha * (sample - carrierLevel);
+      sample = (sample - carrierLevel) /
+               ((carrierLevel > 1) ? carrierLevel : 1);
+    } // if
+
+    if (deemphasisEnabled)
+    {
+      deemphasisState += deemphasisAlpha * (sample - deemphasisState);
+      sample = deemphasisState;
+    } // if
+
+    sample *= PCM_SCALE;
+
+    // Clip rather than wrap.
+    sample = (sample > 32767) ? 32767 : sample;
+    sample = (sample < -32768) ? -32768 : sample;
+
+    pcmBufferPtr[i] = (int16_t)sample;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  writePcm(numberOfOutputs);
+
+  return;
+
+} // demodulateBlock
+
+/*****************************************************************************
+
+  Name: discriminate
+
+  Purpose: The purpose of this function is to demodulate FM with a polar
+  discriminator: the output is the angle of x[n] * conj(x[n-1]), which is
+  the phase advance from one sample to the next.  The last sample of a
+  block is kept for the first sample of the next one.  With SSE2, four
+  samples are handled at a time, using the same arctangent as
+  fastAtan2().
+
+  Calling Sequence: discriminate(signalBufferPtr,numberOfSamples,outputPtr)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.
+
+    numberOfSamples - The number of IQ samples.
+
+    outputPtr - A pointer to storage for numberOfSamples values.
+
+ Outputs:
+
+    outputPtr - The instantaneous frequency, where full deviation is 1.
+
+*****************************************************************************/
+void Demodulator::discriminate(int8_t *signalBufferPtr,
+  uint32_t numberOfSamples,
+  float *outputPtr)
+{
+  uint32_t i;
+  float real;
+  float imaginary;
+#ifdef __SSE2__
+  __m128 currentI;
+  __m128 currentQ;
+  __m128 lastI;
+  __m128 lastQ;
+  __m128 x;
+  __m128 y;
+  __m128 absoluteX;
+  __m128 absoluteY;
+  __m128 ratio;
+  __m128 square;
+  __m128 angle;
+  __m128 swapped;
+  __m128 mask;
+  __m128 signMask;
+  __m128 halfPi;
+  __m128 pi;
+  __m128 gain;
+  __m128 tiny;
+  __m128 zero;
+#endif
+
+  // The previous block's last sample comes first.
+  iBuffer[0] = previousI;
+  qBuffer[0] = previousQ;
+
+  for (i = 0; i < numberOfSamples; i++)
+  {
+    iBuffer[i + 1] = signalBufferPtr[2 * i];
+    qBuffer[i + 1] = signalBufferPtr[(2 * i) + 1];
+  } // for
+
+  // Reference the first sample.
+  i = 0;
+
+#ifdef __SSE2__
+  signMask = _mm_set1_ps(-0.0f);
+  halfPi = _mm_set1_ps((float)(M_PI / 2));
+  pi = _mm_set1_ps((float)M_PI);
+  gain = _mm_set1_ps(fmGain);
+  tiny = _mm_set1_ps(1e-20f);
+  zero = _mm_setzero_ps();
+
+  while ((i + 4) <= numberOfSamples)
+  {
+    lastI = _mm_loadu_ps(&iBuffer[i]);
+    lastQ = _mm_loadu_ps(&qBuffer[i]);
+    currentI = _mm_loadu_ps(&iBuffer[i + 1]);
+    currentQ = _mm_loadu_ps(&qBuffer[i + 1]);
+
+    // x[n] * conj(x[n-1]).
+    x = _mm_add_ps(_mm_mul_ps(currentI,lastI),_mm_mul_ps(currentQ,lastQ));
+    y = _mm_sub_ps(_mm_mul_ps(currentQ,lastI),_mm_mul_ps(currentI,lastQ));
+
+    absoluteX = _mm_andnot_ps(signMask,x);
+    absoluteY = _mm_andnot_ps(signMask,y);
+
+    // Keep the ratio within [0,1].
+    swapped = _mm_cmpgt_ps(absoluteY,absoluteX);
+    ratio = _mm_div_ps(_mm_min_ps(absoluteX,absoluteY),
+                       _mm_add_ps(_mm_max_ps(absoluteX,absoluteY),tiny));
+
+    square = _mm_mul_ps(ratio,ratio);
+
+    angle = _mm_set1_ps(-0.01172120f);
+    angle = _mm_add_ps(_mm_mul_ps(angle,square),_mm_set1_ps(0.05265332f));
+    angle = _mm_add_ps(_mm_mul_ps(angle,square),_mm_set1_ps(-0.11643287f));
+    angle = _mm_add_ps(_mm_mul_ps(angle,square),_mm_set1_ps(0.19354346f));
+    angle = _mm_add_ps(_mm_mul_ps(angle,square),_mm_set1_ps(-0.33262347f));
+    angle = _mm_add_ps(_mm_mul_ps(angle,square),_mm_set1_ps(0.99997726f));
+    angle = _mm_mul_ps(angle,ratio);
+
+    // Sort out the octant.
+    angle = _mm_or_ps(_mm_and_ps(swapped,_mm_sub_ps(halfPi,angle)),
+                      _mm_andnot_ps(swapped,angle));
+
+    mask = _mm_cmplt_ps(x,zero);
+    angle = _mm_or_ps(_mm_and_ps(mask,_mm_sub_ps(pi,angle)),
+                      _mm_andnot_ps(mask,angle));
+
+    // Take the sign of y.
+    angle = _mm_xor_ps(angle,_mm_and_ps(signMask,y));
+
+    _mm_storeu_ps(&outputPtr[i],_mm_mul_ps(angle,gain));
+
+    i += 4;
+  } // while
+#endif
+
+  // Handle whatever is left over (or everything, if SSE2 isn't around).
+  for (; i < numberOfSamples; i++)
+  {
+    real = (iBuffer[i + 1] * iBuffer[i]) + (qBuffer[i + 1] * qBuffer[i]);
+    imaginary = (qBuffer[i + 1] * iBuffer[i]) - (iBuffer[i + 1] * qBuffer[i]);
+
+    outputPtr[i] = fastAtan2(imaginary,real) * fmGain;
+  } // for
+
+  // Remember the last sample for the next block.
+  previousI = iBuffer[numberOfSamples];
+  previousQ = qBuffer[numberOfSamples];
+
+  return;
+
+} // discriminate
+
+/*****************************************************************************
+
+  Name: resample
+
+  Purpose: The purpose of this function is to compute the audio samples
+  that the new samples in the history make possible.  Output m needs
+  input floor(m * decimation / interpolation) and the phase
+  (m * decimation) mod interpolation, so only the outputs are computed,
+  each with one phase of the filter.  Afterwards, the history is trimmed
+  to the samples that the next outputs still need.
+
+  Calling Sequence: numberOfOutputs = resample()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfOutputs - The number of audio samples stored in the audio
+    buffer.
+
+*****************************************************************************/
+uint32_t Demodulator::resample(void)
+{
+  uint32_t j;
+  uint32_t numberOfOutputs;
+  uint32_t consumed;
+  float *tapsPtr;
+  float *samplesPtr;
+  float sum;
+#ifdef __SSE2__
+  __m128 accumulator;
+  float lanes[4];
+#endif
+
+  numberOfOutputs = 0;
+
+  while (inputIndex < historyLength)
+  {
+    tapsPtr = &phaseTapsPtr[phase * tapsPerPhase];
+    samplesPtr = &historyPtr[inputIndex + 1 - tapsPerPhase];
+
+#ifdef __SSE2__
+    accumulator = _mm_setzero_ps();
+
+    for (j = 0; j < tapsPerPhase; j += 4)
+    {
+      accumulator = _mm_add_ps(accumulator,
+                               _mm_mul_ps(_mm_loadu_ps(&tapsPtr[j]),
+                                          _mm_loadu_ps(&samplesPtr[j])));
+    } // for
+
+    _mm_storeu_ps(lanes,accumulator);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#else
+    sum = 0;
+
+    for (j = 0; j < tapsPerPhase; j++)
+    {
+      sum += tapsPtr[j] * samplesPtr[j];
+    } // for
+#endif
+
+    audioBufferPtr[numberOfOutputs] = sum;
+    numberOfOutputs++;
+
+    // Move on to the next output.
+    phase += decimation;
+    inputIndex += phase / interpolation;
+    phase %= interpolation;
+  } // while
+
+  // Keep only what the next outputs need.
+  consumed = historyLength - (tapsPerPhase - 1);
+
+  memmove(historyPtr,
+          &historyPtr[consumed],
+          (tapsPerPhase - 1) * sizeof(float));
+
+  historyLength -= consumed;
+  inputIndex -= consumed;
+
+  return (numberOfOutputs);
+
+} // resample
+
+/*****************************************************************************
+
+  Name: writePcm
+
+  Purpose: The purpose of this function is to write the PCM audio to the
+  output descriptor.  If writing fails, it is reported once, and no more
+  audio is written.
+
+  Calling Sequence: writePcm(numberOfSamples)
+
+  Inputs:
+
+    numberOfSamples - The number of samples in the PCM buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Demodulator::writePcm(uint32_t numberOfSamples)
+{
+  uint8_t *bufferPtr;
+  size_t bytesLeft;
+  ssize_t count;
+
+  bufferPtr = (uint8_t *)pcmBufferPtr;
+  bytesLeft = numberOfSamples * sizeof(int16_t);
+
+  while ((bytesLeft > 0) && (!outputFailed))
+  {
+    count = write(outputDescriptor,bufferPtr,bytesLeft);
+
+    if (count < 0)
+    {
+      if (errno != EINTR)
+      {
+        fprintf(stderr,"Could not write audio: %s\n",strerror(errno));
+        outputFailed = true;
+      } // if
+    } // if
+    else
+    {
+      bufferPtr += count;
+      bytesLeft -= count;
+    } // else
+  } // while
+
+  return;
+
+} // writePcm
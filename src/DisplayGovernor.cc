@@ -0,0 +1,418 @@
+//************************************************************************
+// file name: DisplayGovernor.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "DisplayGovernor.h"
+
+// Statistics are reported this often (in nanoseconds).
+#define REPORT_INTERVAL (10000000000ULL)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: DisplayGovernor
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an DisplayGovernor.
+
+  Calling Sequence: DisplayGovernor(framesPerSecond,
+                                    sampleRate,
+                                    reportEnabled)
+
+  Inputs:
+
+    framesPerSecond - The target display frame rate.  A value of zero
+    indicates that every block of IQ data is to be rendered.
+
+    sampleRate - The sample rate of incoming IQ data in units of S/s.
+
+    reportEnabled - A flag that indicates whether or not the frame rate
+    and headroom are to be reported to stderr.  A value of true
+    indicates that a report is written every 10 seconds and at exit.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+DisplayGovernor::DisplayGovernor(float framesPerSecond,
+  float sampleRate,
+  bool reportEnabled)
+{
+
+  if (sampleRate <= 0)
+  {
+    // Keep it sane.
+    sampleRate = 256000;
+  } // if
+
+  // Retrieve for later use.
+  this->sampleRate = sampleRate;
+  this->reportEnabled = reportEnabled;
+
+  if (framesPerSecond > 0)
+  {
+    framePeriod = (uint64_t)(1e9 / framesPerSecond);
+  } // if
+  else
+  {
+    framePeriod = 0;
+  } // else
+
+  // Start the clock.
+  startTime = getTimeInNs();
+  intervalStartTime = startTime;
+
+  // The first frame is due immediately.
+  nextFrameTime = startTime;
+
+  computeStartTime = 0;
+  renderStartTime = 0;
+
+  totalFrames = 0;
+  totalComputeTime = 0;
+  totalRenderTime = 0;
+  totalSamples = 0;
+
+  intervalFrames = 0;
+  intervalComputeTime = 0;
+  intervalRenderTime = 0;
+  intervalSamples = 0;
+
+  return;
+
+} // DisplayGovernor
+
+/*****************************************************************************
+
+  Name: ~DisplayGovernor
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an DisplayGovernor.  The statistics for the whole run
+  are reported if reporting is enabled.
+
+  Calling Sequence: ~DisplayGovernor()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+DisplayGovernor::~DisplayGovernor(void)
+{
+
+  if (reportEnabled)
+  {
+    reportStatistics("Total",
+                     getTimeInNs() - startTime,
+                     totalFrames,
+                     totalComputeTime,
+                     totalRenderTime,
+                     totalSamples);
+  } // if
+
+  return;
+
+} // ~DisplayGovernor
+
+/*****************************************************************************
+
+  Name: isFrameDue
+
+  Purpose: The purpose of this function is to determine whether or not
+  it is time to render a frame.  If the system falls behind, frames are
+  skipped rather than being rendered back to back.
+
+  Calling Sequence: frameDue = isFrameDue()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    frameDue - A flag that indicates whether or not a frame should be
+    rendered.  A value of true indicates that a frame should be rendered.
+
+*****************************************************************************/
+bool DisplayGovernor::isFrameDue(void)
+{
+  uint64_t now;
+
+  if (framePeriod == 0)
+  {
+    // Every block gets displayed.
+    return (true);
+  } // if
+
+  now = getTimeInNs();
+
+  if (now < nextFrameTime)
+  {
+    // Not yet.
+    return (false);
+  } // if
+
+  // Schedule the next frame.
+  nextFrameTime += framePeriod;
+
+  if (nextFrameTime <= now)
+  {
+    // We fell behind, so don't try to catch up.
+    nextFrameTime = now + framePeriod;
+  } // if
+
+  return (true);
+
+} // isFrameDue
+
+/*****************************************************************************
+
+  Name: startCompute
+
+  Purpose: The purpose of this function is to mark the start of the
+  processing of a block of IQ data.
+
+  Calling Sequence: startCompute()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void DisplayGovernor::startCompute(void)
+{
+
+  computeStartTime = getTimeInNs();
+
+  return;
+
+} // startCompute
+
+/*****************************************************************************
+
+  Name: stopCompute
+
+  Purpose: The purpose of this function is to mark the end of the
+  processing of a block of IQ data.
+
+  Calling Sequence: stopCompute(numberOfSamples)
+
+  Inputs:
+
+    numberOfSamples - The number of IQ sample pairs that were processed.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void DisplayGovernor::stopCompute(uint32_t numberOfSamples)
+{
+  uint64_t elapsedTime;
+
+  elapsedTime = getTimeInNs() - computeStartTime;
+
+  totalComputeTime += elapsedTime;
+  intervalComputeTime += elapsedTime;
+
+  totalSamples += numberOfSamples;
+  intervalSamples += numberOfSamples;
+
+  return;
+
+} // stopCompute
+
+/*****************************************************************************
+
+  Name: startRender
+
+  Purpose: The purpose of this function is to mark the start of the
+  rendering of a frame.
+
+  Calling Sequence: startRender()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void DisplayGovernor::startRender(void)
+{
+
+  renderStartTime = getTimeInNs();
+
+  return;
+
+} // startRender
+
+/*****************************************************************************
+
+  Name: stopRender
+
+  Purpose: The purpose of this function is to mark the end of the
+  rendering of a frame.  If reporting is enabled and the report interval
+  has elapsed, the statistics of the interval are reported.
+
+  Calling Sequence: stopRender()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void DisplayGovernor::stopRender(void)
+{
+  uint64_t now;
+  uint64_t elapsedTime;
+
+  now = getTimeInNs();
+  elapsedTime = now - renderStartTime;
+
+  totalRenderTime += elapsedTime;
+  intervalRenderTime += elapsedTime;
+
+  totalFrames++;
+  intervalFrames++;
+
+  if (reportEnabled && ((now - intervalStartTime) >= REPORT_INTERVAL))
+  {
+    reportStatistics("Display",
+                     now - intervalStartTime,
+                     intervalFrames,
+                     intervalComputeTime,
+                     intervalRenderTime,
+                     intervalSamples);
+
+    // Start a new interval.
+    intervalStartTime = now;
+    intervalFrames = 0;
+    intervalComputeTime = 0;
+    intervalRenderTime = 0;
+    intervalSamples = 0;
+  } // if
+
+  return;
+
+} // stopRender
+
+/*****************************************************************************
+
+  Name: reportStatistics
+
+  Purpose: The purpose of this function is to write the achieved frame
+  rate and the compute headroom to stderr.  Compute and render times are
+  expressed as a percentage of the real time that the samples represent,
+  so the headroom is how much more work could be done before the
+  analyzer can no longer keep up with the IQ data.
+
+  Calling Sequence: reportStatistics(labelPtr,
+                                     elapsedTime,
+                                     frames,
+                                     computeTime,
+                                     renderTime,
+                                     samples)
+
+  Inputs:
+
+    labelPtr - A pointer to a label for the report.
+
+    elapsedTime - The wall clock time of the measurement in nanoseconds.
+
+    frames - The number of frames that were rendered.
+
+    computeTime - The time spent processing IQ data in nanoseconds.
+
+    renderTime - The time spent rendering frames in nanoseconds.
+
+    samples - The number of IQ sample pairs that were processed.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void DisplayGovernor::reportStatistics(const char *labelPtr,
+  uint64_t elapsedTime,
+  uint64_t frames,
+  uint64_t computeTime,
+  uint64_t renderTime,
+  uint64_t samples)
+{
+  double framesPerSecond;
+  double signalTime;
+  double computeLoad;
+  double renderLoad;
+
+  if ((elapsedTime == 0) || (samples == 0))
+  {
+    // Nothing to report.
+    return;
+  } // if
+
+  framesPerSecond = frames / (elapsedTime / 1e9);
+
+  // This is the real time that the samples represent.
+  signalTime = (samples / sampleRate) * 1e9;
+
+  computeLoad = 100 * computeTime / signalTime;
+  renderLoad = 100 * renderTime / signalTime;
+
+  fprintf(stderr,"%s: %.1f frames/s, compute %.1f%%, render %.1f%%,"
+          " headroom %.1f%% of real time\n",
+          labelPtr,
+          framesPerSecond,
+          computeLoad,
+          renderLoad,
+          100 - computeLoad - renderLoad);
+
+  return;
+
+} // reportStatistics
+
+/*****************************************************************************
+
+  Name: getTimeInNs
+
+  Purpose: The purpose of this function is to read the monotonic clock.
+
+  Calling Sequence: now = getTimeInNs()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    now - The current time in nanoseconds.
+
+*****************************************************************************/
+uint64_t DisplayGovernor::getTimeInNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC,&now);
+
+  return (((uint64_t)now.tv_sec * 1000000000ULL) + now.tv_nsec);
+
+} // getTimeInNs
@@ -0,0 +1,793 @@
+//************************************************************************
+// file name: FixedPointFft.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "FixedPointFft.h"
+
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// A radix-4 butterfly can grow the magnitude of a complex value by
+// 4 * sqrt(2), so the input to a radix-4 stage must not exceed
+// 32767 / (4 * sqrt(2)).  A radix-2 butterfly (with no twiddle) grows
+// each component by at most 2.
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+#define RADIX4_INPUT_LIMIT (5792)
+#define RADIX2_INPUT_LIMIT (16383)
+
+// Windowed input is int8 * Q15 >> 8, so it is scaled by this amount.
+#define INPUT_SCALE (32767.0 / 256.0)
+
+// The most radix-4 stages that we support (4^12 = 16M points).
+#define MAX_RADIX4_STAGES (12)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: FixedPointFft
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an FixedPointFft.
+
+  Calling Sequence: FixedPointFft(numberOfPoints)
+
+  Inputs:
+
+    numberOfPoints - The size of the FFT.  This must be a power of 2, and
+    must be at least 4.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+FixedPointFft::FixedPointFft(uint32_t numberOfPoints)
+{
+  uint32_t i;
+  uint32_t length;
+  double angle;
+
+  // Retrieve for later use.
+  this->numberOfPoints = numberOfPoints;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Figure out the stages.  Radix-4 is used as long as
+  // possible, and a radix-2 stage finishes the job when
+  // the size is not a power of 4.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  numberOfRadix4Stages = 0;
+  length = numberOfPoints;
+
+  while ((length >= 4) && (numberOfRadix4Stages < MAX_RADIX4_STAGES))
+  {
+    numberOfRadix4Stages++;
+    length /= 4;
+  } // while
+
+  radix2StageNeeded = (length == 2);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Allocate storage.
+  dataPtr = new int16_t[2 * numberOfPoints];
+  windowPtr = new int16_t[numberOfPoints];
+  twiddlePtr = new int16_t[2 * numberOfPoints];
+  positionTablePtr = new uint32_t[numberOfPoints];
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    // Construct the Hanning window in Q15.
+    windowPtr[i] = (int16_t)lrint(32767 *
+      (0.5 - 0.5 * cos((2 * M_PI * i) / numberOfPoints)));
+
+    // Construct the twiddle factors, W^i = cos - j sin, in Q15.
+    angle = (2 * M_PI * i) / numberOfPoints;
+    twiddlePtr[2*i] = (int16_t)lrint(32767 * cos(angle));
+    twiddlePtr[(2*i)+1] = (int16_t)lrint(32767 * sin(angle));
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The output of a decimation in frequency FFT is in
+  // digit reversed order.  Build a table that maps each
+  // frequency bin to where it ends up.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    positionTablePtr[computeOutputIndex(i,numberOfPoints)] = i;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Nothing has been transformed.
+  exponent = 0;
+
+  return;
+
+} // FixedPointFft
+
+/*****************************************************************************
+
+  Name: ~FixedPointFft
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an FixedPointFft.
+
+  Calling Sequence: ~FixedPointFft()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+FixedPointFft::~FixedPointFft(void)
+{
+
+  // Release resources.
+  delete[] dataPtr;
+  delete[] windowPtr;
+  delete[] twiddlePtr;
+  delete[] positionTablePtr;
+
+  return;
+
+} // ~FixedPointFft
+
+/*****************************************************************************
+
+  Name: computeOutputIndex
+
+  Purpose: The purpose of this function is to determine which frequency
+  bin ends up at a given position of the working data.  A radix-4 stage
+  splits a block of length L into four blocks of length L/4, and block q
+  holds the bins 4k + q of the original block.  This is applied until
+  the blocks can't be split any further.
+
+  Calling Sequence: bin = computeOutputIndex(position,length)
+
+  Inputs:
+
+    position - The position within a block.
+
+    length - The length of the block.
+
+ Outputs:
+
+    bin - The frequency bin that is stored at the position.
+
+*****************************************************************************/
+uint32_t FixedPointFft::computeOutputIndex(uint32_t position,uint32_t length)
+{
+  uint32_t quarter;
+  uint32_t bin;
+
+  if (length <= 2)
+  {
+    // A radix-2 stage (or nothing) leaves things in natural order.
+    return (position);
+  } // if
+
+  quarter = length / 4;
+
+  bin = (4 * computeOutputIndex(position % quarter,quarter)) +
+        (position / quarter);
+
+  return (bin);
+
+} // computeOutputIndex
+
+/*****************************************************************************
+
+  Name: transform
+
+  Purpose: The purpose of this function is to window a block of IQ data
+  and compute its FFT.  The result stays in the working data, in digit
+  reversed order, and is scaled by 2^-exponent relative to the windowed
+  data scaled by INPUT_SCALE.
+
+  Calling Sequence: exponent = transform(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+ Outputs:
+
+    exponent - The block exponent of the result.
+
+*****************************************************************************/
+int32_t FixedPointFft::transform(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t i;
+  uint32_t length;
+  uint32_t twiddleStride;
+  int32_t maximum;
+  int shift;
+
+  // Window the data.
+  maximum = loadInput(signalBufferPtr,bufferLength);
+
+  exponent = 0;
+  length = numberOfPoints;
+  twiddleStride = 1;
+
+  for (i = 0; i < numberOfRadix4Stages; i++)
+  {
+    // Scale the block just enough to avoid overflow.
+    shift = computeStageShift(maximum,RADIX4_INPUT_LIMIT);
+    exponent += shift;
+
+    maximum = radix4Stage(length,twiddleStride,shift);
+
+    length /= 4;
+    twiddleStride *= 4;
+  } // for
+
+  if (radix2StageNeeded)
+  {
+    shift = computeStageShift(maximum,RADIX2_INPUT_LIMIT);
+    exponent += shift;
+
+    radix2Stage(shift);
+  } // if
+
+  return (exponent);
+
+} // transform
+
+/*****************************************************************************
+
+  Name: computePowerSpectrum
+
+  Purpose: The purpose of this function is to compute the power spectrum
+  of a block of IQ data.  The result is normalized exactly as the FFTW
+  path of the signal analyzer normalizes it, |X|^2 / N, and is FFT
+  shifted so that the center frequency is in the center of the array.
+
+  Calling Sequence: computePowerSpectrum(signalBufferPtr,
+                                         bufferLength,
+                                         powerBufferPtr)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+    powerBufferPtr - A pointer to storage for numberOfPoints values.
+
+ Outputs:
+
+    powerBufferPtr - The linear power spectrum.
+
+*****************************************************************************/
+void FixedPointFft::computePowerSpectrum(const int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  float *powerBufferPtr)
+{
+  uint32_t i;
+  uint32_t bin;
+  uint32_t position;
+  uint32_t halfSize;
+  int32_t iK;
+  int32_t qK;
+  float scale;
+
+  transform(signalBufferPtr,bufferLength);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Undo the block exponent and the input scaling, and
+  // normalize by the FFT size.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  scale = (float)(ldexp(1.0,2 * exponent) /
+                  (INPUT_SCALE * INPUT_SCALE * numberOfPoints));
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  halfSize = numberOfPoints / 2;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    // Output i holds the bin that is half the FFT size away.
+    bin = i + halfSize;
+
+    if (bin >= numberOfPoints)
+    {
+      bin -= numberOfPoints;
+    } // if
+
+    position = positionTablePtr[bin];
+
+    iK = dataPtr[2*position];
+    qK = dataPtr[(2*position)+1];
+
+    // The sum of squares fits easily in 32 bits.
+    powerBufferPtr[i] = (float)((iK * iK) + (qK * qK)) * scale;
+  } // for
+
+  return;
+
+} // computePowerSpectrum
+
+/*****************************************************************************
+
+  Name: getComplexSpectrum
+
+  Purpose: The purpose of this function is to retrieve the result of the
+  last transform in natural order, scaled to match the FFT of the
+  windowed data.  This is mainly useful for measuring the accuracy of
+  the fixed-point FFT.
+
+  Calling Sequence: getComplexSpectrum(spectrumPtr)
+
+  Inputs:
+
+    spectrumPtr - A pointer to storage for 2 * numberOfPoints values.
+
+ Outputs:
+
+    spectrumPtr - The spectrum formatted as interleaved real and
+    imaginary values.
+
+*****************************************************************************/
+void FixedPointFft::getComplexSpectrum(double *spectrumPtr)
+{
+  uint32_t i;
+  uint32_t position;
+  double scale;
+
+  scale = ldexp(1.0,exponent) / INPUT_SCALE;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    position = positionTablePtr[i];
+
+    spectrumPtr[2*i] = dataPtr[2*position] * scale;
+    spectrumPtr[(2*i)+1] = dataPtr[(2*position)+1] * scale;
+  } // for
+
+  return;
+
+} // getComplexSpectrum
+
+/*****************************************************************************
+
+  Name: loadInput
+
+  Purpose: The purpose of this function is to window a block of IQ data
+  into the working data.  If the block is short, the rest of the working
+  data is zeroed.
+
+  Calling Sequence: maximum = loadInput(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    maximum - The largest magnitude of any component.
+
+*****************************************************************************/
+int32_t FixedPointFft::loadInput(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t i;
+  uint32_t numberOfSamples;
+  int32_t value;
+  int32_t maximum;
+
+  numberOfSamples = bufferLength / 2;
+
+  if (numberOfSamples > numberOfPoints)
+  {
+    numberOfSamples = numberOfPoints;
+  } // if
+
+  maximum = 0;
+
+  for (i = 0; i < (2 * numberOfSamples); i++)
+  {
+    // An 8-bit sample times a Q15 window fits in 16 bits after >> 8.
+    value = ((int32_t)signalBufferPtr[i] * windowPtr[i >> 1] + 128) >> 8;
+    dataPtr[i] = (int16_t)value;
+
+    value = abs(value);
+
+    if (value > maximum)
+    {
+      maximum = value;
+    } // if
+  } // for
+
+  // Zero pad a short block.
+  for (; i < (2 * numberOfPoints); i++)
+  {
+    dataPtr[i] = 0;
+  } // for
+
+  return (maximum);
+
+} // loadInput
+
+/*****************************************************************************
+
+  Name: computeStageShift
+
+  Purpose: The purpose of this function is to compute the number of bits
+  by which a block must be shifted right so that its largest value does
+  not exceed a limit.
+
+  Calling Sequence: shift = computeStageShift(maximum,limit)
+
+  Inputs:
+
+    maximum - The largest magnitude in the block.
+
+    limit - The largest magnitude that is allowed.
+
+ Outputs:
+
+    shift - The number of bits to shift.
+
+*****************************************************************************/
+int FixedPointFft::computeStageShift(int32_t maximum,int32_t limit)
+{
+  int shift;
+
+  shift = 0;
+
+  // Allow for rounding when the block is shifted.
+  while (((maximum + ((1 << shift) >> 1)) >> shift) > limit)
+  {
+    shift++;
+  } // while
+
+  return (shift);
+
+} // computeStageShift
+
+/*****************************************************************************
+
+  Name: radix4Stage
+
+  Purpose: The purpose of this function is to perform one radix-4
+  decimation in frequency stage on every block of the working data.  For
+  a block of length L with quarter Q = L/4, and n in [0,Q), the four
+  values a = x[n], b = x[n+Q], c = x[n+2Q], d = x[n+3Q] are replaced by
+
+    x[n]    = a + b + c + d
+    x[n+Q]  = (a - jb - c + jd) W^n
+    x[n+2Q] = (a - b + c - d) W^2n
+    x[n+3Q] = (a + jb - c - jd) W^3n
+
+  where W = exp(-j2pi/L).  The inputs are shifted right (with rounding)
+  as they are loaded.  When SSE2 is available and Q is a multiple of 4,
+  four butterflies are done at a time; the twiddle multiplies use
+  pmaddwd so that each complex multiply is two instructions.
+
+  Calling Sequence: maximum = radix4Stage(length,twiddleStride,shift)
+
+  Inputs:
+
+    length - The length of the blocks.
+
+    twiddleStride - The twiddle table stride, numberOfPoints / length.
+
+    shift - The number of bits to shift the input right.
+
+ Outputs:
+
+    maximum - The largest magnitude of any component of the output.
+
+*****************************************************************************/
+int32_t FixedPointFft::radix4Stage(uint32_t length,
+  uint32_t twiddleStride,
+  int shift)
+{
+  uint32_t block;
+  uint32_t n;
+  uint32_t k;
+  uint32_t quarter;
+  uint32_t twiddleIndex;
+  int16_t *blockPtr;
+  int32_t round;
+  int32_t maximum;
+  int32_t a[2], b[2], c[2], d[2];
+  int32_t t0[2], t1[2], t2[2], t3[2];
+  int32_t y[4][2];
+  int32_t cosine;
+  int32_t sine;
+  int32_t real;
+  int32_t imaginary;
+#ifdef __SSE2__
+  int16_t coefficients[6][8];
+  __m128i av, bv, cv, dv;
+  __m128i s0, s1, s2, s3;
+  __m128i yv[4];
+  __m128i swapped;
+  __m128i realPart;
+  __m128i imaginaryPart;
+  __m128i roundVector;
+  __m128i productRound;
+  __m128i shiftCount;
+  __m128i oddMask;
+  __m128i maximumVector;
+  __m128i zero;
+  int16_t maximums[8];
+#endif
+
+  quarter = length / 4;
+  maximum = 0;
+
+  if (shift > 0)
+  {
+    round = 1 << (shift - 1);
+  } // if
+  else
+  {
+    round = 0;
+  } // else
+
+#ifdef __SSE2__
+  if ((quarter % 4) == 0)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Set up the constants for the vector butterflies.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    roundVector = _mm_set1_epi16((int16_t)round);
+    productRound = _mm_set1_epi32(1 << 14);
+    shiftCount = _mm_cvtsi32_si128(shift);
+    oddMask = _mm_set_epi16(-1,0,-1,0,-1,0,-1,0);
+    maximumVector = _mm_setzero_si128();
+    zero = _mm_setzero_si128();
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    for (n = 0; n < quarter; n += 4)
+    {
+      //--------------------------------------------
+      // Gather the twiddles of four butterflies.
+      // Row 2(k-1) holds cos,sin and row 2(k-1)+1
+      // holds -sin,cos for the product with W^kn.
+      //--------------------------------------------
+      for (k = 1; k <= 3; k++)
+      {
+        for (block = 0; block < 4; block++)
+        {
+          twiddleIndex = (k * (n + block) * twiddleStride) % numberOfPoints;
+          cosine = twiddlePtr[2*twiddleIndex];
+          sine = twiddlePtr[(2*twiddleIndex)+1];
+
+          coefficients[2*(k-1)][2*block] = (int16_t)cosine;
+          coefficients[2*(k-1)][(2*block)+1] = (int16_t)sine;
+          coefficients[(2*(k-1))+1][2*block] = (int16_t)-sine;
+          coefficients[(2*(k-1))+1][(2*block)+1] = (int16_t)cosine;
+        } // for
+      } // for
+      //--------------------------------------------
+
+      for (block = 0; block < numberOfPoints; block += length)
+      {
+        blockPtr = &dataPtr[2 * (block + n)];
+
+        av = _mm_loadu_si128((__m128i *)&blockPtr[0]);
+        bv = _mm_loadu_si128((__m128i *)&blockPtr[2*quarter]);
+        cv = _mm_loadu_si128((__m128i *)&blockPtr[4*quarter]);
+        dv = _mm_loadu_si128((__m128i *)&blockPtr[6*quarter]);
+
+        if (shift > 0)
+        {
+          // Block floating point scaling.
+          av = _mm_sra_epi16(_mm_adds_epi16(av,roundVector),shiftCount);
+          bv = _mm_sra_epi16(_mm_adds_epi16(bv,roundVector),shiftCount);
+          cv = _mm_sra_epi16(_mm_adds_epi16(cv,roundVector),shiftCount);
+          dv = _mm_sra_epi16(_mm_adds_epi16(dv,roundVector),shiftCount);
+        } // if
+
+        s0 = _mm_add_epi16(av,cv);
+        s1 = _mm_sub_epi16(av,cv);
+        s2 = _mm_add_epi16(bv,dv);
+        s3 = _mm_sub_epi16(bv,dv);
+
+        //--------------------------------------------
+        // -j(b - d) = (Im, -Re): swap the components
+        // and negate the imaginary lanes.
+        //--------------------------------------------
+        swapped = _mm_shufflelo_epi16(s3,_MM_SHUFFLE(2,3,0,1));
+        swapped = _mm_shufflehi_epi16(swapped,_MM_SHUFFLE(2,3,0,1));
+        swapped = _mm_sub_epi16(_mm_xor_si128(swapped,oddMask),oddMask);
+        //--------------------------------------------
+
+        yv[0] = _mm_add_epi16(s0,s2);
+        yv[1] = _mm_add_epi16(s1,swapped);
+        yv[2] = _mm_sub_epi16(s0,s2);
+        yv[3] = _mm_sub_epi16(s1,swapped);
+
+        for (k = 1; k <= 3; k++)
+        {
+          //--------------------------------------------
+          // (yr + j yi)(c - j s) in Q15.
+          //--------------------------------------------
+          realPart = _mm_madd_epi16(yv[k],
+            _mm_loadu_si128((__m128i *)coefficients[2*(k-1)]));
+          imaginaryPart = _mm_madd_epi16(yv[k],
+            _mm_loadu_si128((__m128i *)coefficients[(2*(k-1))+1]));
+
+          realPart = _mm_srai_epi32(_mm_add_epi32(realPart,productRound),15);
+          imaginaryPart =
+            _mm_srai_epi32(_mm_add_epi32(imaginaryPart,productRound),15);
+
+          yv[k] = _mm_packs_epi32(_mm_unpacklo_epi32(realPart,imaginaryPart),
+                                  _mm_unpackhi_epi32(realPart,imaginaryPart));
+          //--------------------------------------------
+        } // for
+
+        for (k = 0; k < 4; k++)
+        {
+          _mm_storeu_si128((__m128i *)&blockPtr[2*k*quarter],yv[k]);
+
+          // Track the largest magnitude for the next stage.
+          maximumVector = _mm_max_epi16(maximumVector,yv[k]);
+          maximumVector = _mm_max_epi16(maximumVector,
+                                        _mm_sub_epi16(zero,yv[k]));
+        } // for
+      } // for
+    } // for
+
+    _mm_storeu_si128((__m128i *)maximums,maximumVector);
+
+    for (k = 0; k < 8; k++)
+    {
+      if (maximums[k] > maximum)
+      {
+        maximum = maximums[k];
+      } // if
+    } // for
+
+    return (maximum);
+  } // if
+#endif
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Scalar butterflies.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (block = 0; block < numberOfPoints; block += length)
+  {
+    blockPtr = &dataPtr[2 * block];
+
+    for (n = 0; n < quarter; n++)
+    {
+      for (k = 0; k < 2; k++)
+      {
+        a[k] = (blockPtr[(2*n)+k] + round) >> shift;
+        b[k] = (blockPtr[(2*(n+quarter))+k] + round) >> shift;
+        c[k] = (blockPtr[(2*(n+(2*quarter)))+k] + round) >> shift;
+        d[k] = (blockPtr[(2*(n+(3*quarter)))+k] + round) >> shift;
+
+        t0[k] = a[k] + c[k];
+        t1[k] = a[k] - c[k];
+        t2[k] = b[k] + d[k];
+        t3[k] = b[k] - d[k];
+      } // for
+
+      // y0 = t0 + t2, y2 = t0 - t2.
+      y[0][0] = t0[0] + t2[0];
+      y[0][1] = t0[1] + t2[1];
+      y[2][0] = t0[0] - t2[0];
+      y[2][1] = t0[1] - t2[1];
+
+      // y1 = t1 - j t3, y3 = t1 + j t3.
+      y[1][0] = t1[0] + t3[1];
+      y[1][1] = t1[1] - t3[0];
+      y[3][0] = t1[0] - t3[1];
+      y[3][1] = t1[1] + t3[0];
+
+      for (k = 0; k < 4; k++)
+      {
+        if (k > 0)
+        {
+          // Apply the twiddle, W^kn.
+          twiddleIndex = (k * n * twiddleStride) % numberOfPoints;
+          cosine = twiddlePtr[2*twiddleIndex];
+          sine = twiddlePtr[(2*twiddleIndex)+1];
+
+          real = ((y[k][0] * cosine) + (y[k][1] * sine) + (1 << 14)) >> 15;
+          imaginary =
+            ((y[k][1] * cosine) - (y[k][0] * sine) + (1 << 14)) >> 15;
+
+          y[k][0] = real;
+          y[k][1] = imaginary;
+        } // if
+
+        blockPtr[2*(n+(k*quarter))] = (int16_t)y[k][0];
+        blockPtr[(2*(n+(k*quarter)))+1] = (int16_t)y[k][1];
+
+        if (abs(y[k][0]) > maximum)
+        {
+          maximum = abs(y[k][0]);
+        } // if
+
+        if (abs(y[k][1]) > maximum)
+        {
+          maximum = abs(y[k][1]);
+        } // if
+      } // for
+    } // for
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (maximum);
+
+} // radix4Stage
+
+/*****************************************************************************
+
+  Name: radix2Stage
+
+  Purpose: The purpose of this function is to perform the final radix-2
+  stage when the FFT size is not a power of 4.  Each adjacent pair of
+  values, a and b, is replaced by a + b and a - b.
+
+  Calling Sequence: radix2Stage(shift)
+
+  Inputs:
+
+    shift - The number of bits to shift the input right.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void FixedPointFft::radix2Stage(int shift)
+{
+  uint32_t i;
+  int32_t round;
+  int32_t a;
+  int32_t b;
+
+  if (shift > 0)
+  {
+    round = 1 << (shift - 1);
+  } // if
+  else
+  {
+    round = 0;
+  } // else
+
+  for (i = 0; i < (2 * numberOfPoints); i += 4)
+  {
+    // Real parts.
+    a = (dataPtr[i] + round) >> shift;
+    b = (dataPtr[i+2] + round) >> shift;
+    dataPtr[i] = (int16_t)(a + b);
+    dataPtr[i+2] = (int16_t)(a - b);
+
+    // Imaginary parts.
+    a = (dataPtr[i+1] + round) >> shift;
+    b = (dataPtr[i+3] + round) >> shift;
+    dataPtr[i+1] = (int16_t)(a + b);
+    dataPtr[i+3] = (int16_t)(a - b);
+  } // for
+
+  return;
+
+} // radix2Stage
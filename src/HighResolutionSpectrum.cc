@@ -0,0 +1,750 @@
+//************************************************************************
+// file name: HighResolutionSpectrum.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "HighResolutionSpectrum.h"
+
+// Buffers are laid out on huge page boundaries.
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: HighResolutionSpectrum
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an HighResolutionSpectrum.  The storage is allocated and
+  touched, the FFT is planned to use several threads, and the thread that
+  computes the spectra is started.
+
+  Calling Sequence: HighResolutionSpectrum(numberOfPoints,
+                                           referencePoints,
+                                           numberOfThreads)
+
+  Inputs:
+
+    numberOfPoints - The size of the FFT.  It is rounded up to a power of
+    two from MIN_HIGH_RESOLUTION_POINTS to MAX_HIGH_RESOLUTION_POINTS.
+
+    referencePoints - The size of the display FFT, whose levels the
+    spectrum is scaled to.
+
+    numberOfThreads - The number of threads that FFTW is allowed to use.
+    A value of 0 uses one thread per processor.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+HighResolutionSpectrum::HighResolutionSpectrum(uint32_t numberOfPoints,
+  uint32_t referencePoints,
+  uint32_t numberOfThreads)
+{
+  uint32_t i;
+  uint32_t points;
+  double phase;
+  long processors;
+
+  if (numberOfThreads == 0)
+  {
+    // Use every processor.
+    processors = sysconf(_SC_NPROCESSORS_ONLN);
+    numberOfThreads = (processors > 0) ? (uint32_t)processors : 1;
+  } // if
+
+  // FFTW is fastest with a power of two.
+  points = MIN_HIGH_RESOLUTION_POINTS;
+
+  while ((points < numberOfPoints) && (points < MAX_HIGH_RESOLUTION_POINTS))
+  {
+    points *= 2;
+  } // while
+
+  this->numberOfPoints = points;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The power of each bin is |X|^2 / numberOfPoints, like
+  // the display FFT, and a tone is referencePoints /
+  // numberOfPoints weaker than it is there, since the
+  // window sums to half the number of points.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  powerScale = (float)((double)referencePoints /
+                       ((double)points * (double)points));
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  fillLength = 0;
+  transformPending = false;
+  stopping = false;
+  numberOfSpectra = 0;
+  numberOfSkippedSpectra = 0;
+
+  valid = allocateBuffers();
+
+  if (!valid)
+  {
+    return;
+  } // if
+
+  for (i = 0; i < points; i++)
+  {
+    // This is the Hanning window, which sums to points / 2.
+    phase = (2 * M_PI * i) / points;
+    windowPtr[i] = (float)(0.5 - 0.5 * cos(phase));
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Only this plan uses more than one thread, so the
+  // planner is put back the way it was.  Measuring an FFT
+  // this big takes far too long, so it is estimated.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  fftw_init_threads();
+  fftw_plan_with_nthreads((int)numberOfThreads);
+
+  fftPlan = fftw_plan_dft_1d(points,fftBufferPtr,fftBufferPtr,
+                             FFTW_FORWARD,FFTW_ESTIMATE);
+
+  fftw_plan_with_nthreads(1);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  pthread_mutex_init(&spectrumLock,NULL);
+  pthread_cond_init(&samplesReady,NULL);
+
+  // Start computing spectra.
+  pthread_create(&thread,NULL,threadEntry,this);
+
+  return;
+
+} // HighResolutionSpectrum
+
+/*****************************************************************************
+
+  Name: ~HighResolutionSpectrum
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an HighResolutionSpectrum.  A spectrum that is being
+  computed is finished first.
+
+  Calling Sequence: ~HighResolutionSpectrum()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+HighResolutionSpectrum::~HighResolutionSpectrum(void)
+{
+
+  if (!valid)
+  {
+    return;
+  } // if
+
+  pthread_mutex_lock(&spectrumLock);
+  stopping = true;
+  pthread_cond_signal(&samplesReady);
+  pthread_mutex_unlock(&spectrumLock);
+
+  pthread_join(thread,NULL);
+
+  // Release resources.
+  fftw_destroy_plan(fftPlan);
+  munmap(mappingPtr,mappedLength);
+
+  pthread_mutex_destroy(&spectrumLock);
+  pthread_cond_destroy(&samplesReady);
+
+  return;
+
+} // ~HighResolutionSpectrum
+
+/*****************************************************************************
+
+  Name: isValid
+
+  Purpose: The purpose of this function is to indicate whether or not the
+  storage could be allocated.
+
+  Calling Sequence: valid = isValid()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    valid - A flag that indicates whether or not spectra can be computed.
+
+*****************************************************************************/
+bool HighResolutionSpectrum::isValid(void)
+{
+
+  return (valid);
+
+} // isValid
+
+/*****************************************************************************
+
+  Name: getNumberOfPoints
+
+  Purpose: The purpose of this function is to retrieve the FFT size,
+  after it was rounded to a power of two.
+
+  Calling Sequence: numberOfPoints = getNumberOfPoints()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfPoints - The FFT size.
+
+*****************************************************************************/
+uint32_t HighResolutionSpectrum::getNumberOfPoints(void)
+{
+
+  return (numberOfPoints);
+
+} // getNumberOfPoints
+
+/*****************************************************************************
+
+  Name: getNumberOfSpectra
+
+  Purpose: The purpose of this function is to retrieve the number of
+  spectra that have been computed.  A change in the number means that
+  there is a new spectrum to display.
+
+  Calling Sequence: numberOfSpectra = getNumberOfSpectra()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfSpectra - The number of spectra that have been computed.
+
+*****************************************************************************/
+uint64_t HighResolutionSpectrum::getNumberOfSpectra(void)
+{
+  uint64_t count;
+
+  pthread_mutex_lock(&spectrumLock);
+  count = numberOfSpectra;
+  pthread_mutex_unlock(&spectrumLock);
+
+  return (count);
+
+} // getNumberOfSpectra
+
+/*****************************************************************************
+
+  Name: getNumberOfSkippedSpectra
+
+  Purpose: The purpose of this function is to retrieve the number of
+  FFT's worth of samples that were thrown away because the previous
+  spectrum was still being computed.
+
+  Calling Sequence: numberOfSkippedSpectra = getNumberOfSkippedSpectra()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfSkippedSpectra - The number of skipped spectra.
+
+*****************************************************************************/
+uint64_t HighResolutionSpectrum::getNumberOfSkippedSpectra(void)
+{
+  uint64_t count;
+
+  pthread_mutex_lock(&spectrumLock);
+  count = numberOfSkippedSpectra;
+  pthread_mutex_unlock(&spectrumLock);
+
+  return (count);
+
+} // getNumberOfSkippedSpectra
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to collect a block of IQ data.
+  Once an FFT's worth has been collected, it is handed to the thread,
+  and collection starts again in the other buffer.  If the thread is
+  still busy with the previous spectrum, the samples are thrown away, so
+  this never waits.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void HighResolutionSpectrum::acceptSamples(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t length;
+  int8_t *bufferPtr;
+
+  if (!valid)
+  {
+    return;
+  } // if
+
+  while (bufferLength > 0)
+  {
+    length = (2 * numberOfPoints) - fillLength;
+    length = (bufferLength < length) ? bufferLength : length;
+
+    memcpy(&fillBufferPtr[fillLength],signalBufferPtr,length);
+
+    fillLength += length;
+    signalBufferPtr += length;
+    bufferLength -= length;
+
+    if (fillLength == (2 * numberOfPoints))
+    {
+      pthread_mutex_lock(&spectrumLock);
+
+      if (!transformPending)
+      {
+        // Swap the buffers.
+        bufferPtr = transformBufferPtr;
+        transformBufferPtr = fillBufferPtr;
+        fillBufferPtr = bufferPtr;
+
+        transformPending = true;
+        pthread_cond_signal(&samplesReady);
+      } // if
+      else
+      {
+        numberOfSkippedSpectra++;
+      } // else
+
+      pthread_mutex_unlock(&spectrumLock);
+
+      fillLength = 0;
+    } // if
+  } // while
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: binSpectrumSpan
+
+  Purpose: The purpose of this function is to reduce part of the latest
+  spectrum to a number of bins, in decibels.  Each output bin holds the
+  largest value of the points that it covers.  The strongest point in
+  the span is also found, and its position is interpolated from its
+  neighbors.
+
+  Calling Sequence: available = binSpectrumSpan(firstPoint,
+                                                numberOfPointsInSpan,
+                                                binnedSpectrumInDbPtr,
+                                                numberOfBins,
+                                                peakPointPtr,
+                                                peakPowerInDbPtr)
+
+  Inputs:
+
+    firstPoint - The first point of the span.
+
+    numberOfPointsInSpan - The number of points in the span.
+
+    binnedSpectrumInDbPtr - A pointer to storage for numberOfBins values.
+
+    numberOfBins - The number of output bins.
+
+    peakPointPtr - A pointer to storage for the position of the peak, in
+    points.
+
+    peakPowerInDbPtr - A pointer to storage for the power of the peak.
+
+ Outputs:
+
+    available - A flag that indicates whether or not a spectrum has been
+    computed yet.  Nothing is stored if it hasn't.
+
+*****************************************************************************/
+bool HighResolutionSpectrum::binSpectrumSpan(uint32_t firstPoint,
+  uint32_t numberOfPointsInSpan,
+  float *binnedSpectrumInDbPtr,
+  uint32_t numberOfBins,
+  double *peakPointPtr,
+  float *peakPowerInDbPtr)
+{
+  uint32_t bin;
+  uint32_t i;
+  uint32_t start;
+  uint32_t end;
+  uint32_t peakPoint;
+  float maximum;
+  float peakPower;
+  float left;
+  float center;
+  float right;
+  float denominator;
+  double offset;
+
+  if (!valid)
+  {
+    return (false);
+  } // if
+
+  // Keep it sane.
+  firstPoint = (firstPoint < numberOfPoints) ? firstPoint : 0;
+
+  if ((firstPoint + numberOfPointsInSpan) > numberOfPoints)
+  {
+    numberOfPointsInSpan = numberOfPoints - firstPoint;
+  } // if
+
+  pthread_mutex_lock(&spectrumLock);
+
+  if (numberOfSpectra == 0)
+  {
+    pthread_mutex_unlock(&spectrumLock);
+    return (false);
+  } // if
+
+  peakPoint = firstPoint;
+  peakPower = currentPowerPtr[firstPoint];
+
+  for (bin = 0; bin < numberOfBins; bin++)
+  {
+    // Compute the span of points that this output bin covers.
+    start = (uint32_t)(((uint64_t)bin * numberOfPointsInSpan) /
+                       numberOfBins);
+    end = (uint32_t)(((uint64_t)(bin + 1) * numberOfPointsInSpan) /
+                     numberOfBins);
+
+    if (end <= start)
+    {
+      // There are more output bins than points.
+      end = start + 1;
+    } // if
+
+    start += firstPoint;
+    end += firstPoint;
+
+    maximum = currentPowerPtr[start];
+
+    for (i = start + 1; i < end; i++)
+    {
+      if (currentPowerPtr[i] > maximum)
+      {
+        maximum = currentPowerPtr[i];
+      } // if
+    } // for
+
+    if (maximum > peakPower)
+    {
+      // Find the point within the output bin later.
+      peakPower = maximum;
+      peakPoint = start;
+    } // if
+
+    binnedSpectrumInDbPtr[bin] = 10 * log10f(maximum + 1e-20f);
+  } // for
+
+  // Find the strongest point in the strongest output bin.
+  while (((peakPoint + 1) < numberOfPoints) &&
+         (currentPowerPtr[peakPoint] < peakPower))
+  {
+    peakPoint++;
+  } // while
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Fit a parabola through the peak and its neighbors, in
+  // decibels.  This is good to a small fraction of a bin
+  // with the Hanning window.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  offset = 0;
+
+  if ((peakPoint > 0) && ((peakPoint + 1) < numberOfPoints))
+  {
+    left = 10 * log10f(currentPowerPtr[peakPoint - 1] + 1e-20f);
+    center = 10 * log10f(currentPowerPtr[peakPoint] + 1e-20f);
+    right = 10 * log10f(currentPowerPtr[peakPoint + 1] + 1e-20f);
+
+    denominator = left - (2 * center) + right;
+
+    if (denominator < 0)
+    {
+      offset = 0.5 * (left - right) / denominator;
+    } // if
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  pthread_mutex_unlock(&spectrumLock);
+
+  *peakPointPtr = peakPoint + offset;
+  *peakPowerInDbPtr = 10 * log10f(peakPower + 1e-20f);
+
+  return (true);
+
+} // binSpectrumSpan
+
+/*****************************************************************************
+
+  Name: allocateBuffers
+
+  Purpose: The purpose of this function is to allocate all of the
+  storage in one mapping, on huge page boundaries, and to ask for it to
+  be backed by transparent huge pages.  Every page is touched now, so
+  that no page faults are taken later.
+
+  Calling Sequence: success = allocateBuffers()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    success - A flag that indicates whether or not the storage could be
+    allocated.
+
+*****************************************************************************/
+bool HighResolutionSpectrum::allocateBuffers(void)
+{
+  void *addressPtr;
+  uint64_t windowLength;
+  uint64_t sampleLength;
+  uint64_t fftLength;
+  uint64_t powerLength;
+
+  // Each buffer starts on a huge page.
+  windowLength = (uint64_t)numberOfPoints * sizeof(float);
+  sampleLength = 2 * (uint64_t)numberOfPoints;
+  fftLength = (uint64_t)numberOfPoints * sizeof(fftw_complex);
+  powerLength = (uint64_t)numberOfPoints * sizeof(float);
+
+  windowLength = ((windowLength + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) *
+                 HUGE_PAGE_SIZE;
+  sampleLength = ((sampleLength + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) *
+                 HUGE_PAGE_SIZE;
+  fftLength = ((fftLength + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) *
+              HUGE_PAGE_SIZE;
+  powerLength = ((powerLength + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) *
+                HUGE_PAGE_SIZE;
+
+  mappedLength = windowLength + (2 * sampleLength) + fftLength +
+                 (2 * powerLength);
+
+  // Leave room to line the mapping up with a huge page.
+  addressPtr = mmap(NULL,mappedLength + HUGE_PAGE_SIZE,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+
+  if (addressPtr == MAP_FAILED)
+  {
+    fprintf(stderr,"Could not allocate %llu bytes for the"
+            " high resolution spectrum\n",
+            (unsigned long long)mappedLength);
+
+    return (false);
+  } // if
+
+  mappingPtr = (uint8_t *)addressPtr;
+  mappedLength += HUGE_PAGE_SIZE;
+
+#ifdef MADV_HUGEPAGE
+  madvise(mappingPtr,mappedLength,MADV_HUGEPAGE);
+#endif
+
+  // Fault everything in now.
+  memset(mappingPtr,0,mappedLength);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Carve up the mapping, starting at the first huge page
+  // boundary.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  addressPtr = (void *)((((uintptr_t)mappingPtr + HUGE_PAGE_SIZE - 1) /
+                         HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE);
+
+  fftBufferPtr = (fftw_complex *)addressPtr;
+  addressPtr = (uint8_t *)addressPtr + fftLength;
+
+  windowPtr = (float *)addressPtr;
+  addressPtr = (uint8_t *)addressPtr + windowLength;
+
+  fillBufferPtr = (int8_t *)addressPtr;
+  addressPtr = (uint8_t *)addressPtr + sampleLength;
+
+  transformBufferPtr = (int8_t *)addressPtr;
+  addressPtr = (uint8_t *)addressPtr + sampleLength;
+
+  currentPowerPtr = (float *)addressPtr;
+  addressPtr = (uint8_t *)addressPtr + powerLength;
+
+  sparePowerPtr = (float *)addressPtr;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (true);
+
+} // allocateBuffers
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of the thread that computes the spectra.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the HighResolutionSpectrum.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *HighResolutionSpectrum::threadEntry(void *argPtr)
+{
+
+  ((HighResolutionSpectrum *)argPtr)->run();
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to compute a spectrum each
+  time that an FFT's worth of samples has been collected, until the
+  object is being destroyed.  The spectrum is computed into the spare
+  buffer without the lock held, and the buffers are swapped afterward.
+
+  Calling Sequence: run()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void HighResolutionSpectrum::run(void)
+{
+  float *powerPtr;
+
+  pthread_mutex_lock(&spectrumLock);
+
+  while (!stopping)
+  {
+    if (!transformPending)
+    {
+      pthread_cond_wait(&samplesReady,&spectrumLock);
+    } // if
+    else
+    {
+      pthread_mutex_unlock(&spectrumLock);
+
+      computeSpectrum();
+
+      pthread_mutex_lock(&spectrumLock);
+
+      // The new spectrum replaces the old one.
+      powerPtr = currentPowerPtr;
+      currentPowerPtr = sparePowerPtr;
+      sparePowerPtr = powerPtr;
+
+      numberOfSpectra++;
+      transformPending = false;
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&spectrumLock);
+
+  return;
+
+} // run
+
+/*****************************************************************************
+
+  Name: computeSpectrum
+
+  Purpose: The purpose of this function is to compute the power spectrum
+  of the samples in the transform buffer.  The data is windowed,
+  transformed by FFTW's threads, and the scaled power of each bin is
+  stored, FFT shifted, in the spare power buffer.
+
+  Calling Sequence: computeSpectrum()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void HighResolutionSpectrum::computeSpectrum(void)
+{
+  uint32_t i;
+  uint32_t j;
+  uint32_t halfPoints;
+  double re;
+  double im;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    fftBufferPtr[i][0] = transformBufferPtr[2 * i] * windowPtr[i];
+    fftBufferPtr[i][1] = transformBufferPtr[(2 * i) + 1] * windowPtr[i];
+  } // for
+
+  fftw_execute(fftPlan);
+
+  halfPoints = numberOfPoints / 2;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    // Swap the upper and lower halves.
+    j = (i + halfPoints) & (numberOfPoints - 1);
+
+    re = fftBufferPtr[j][0];
+    im = fftBufferPtr[j][1];
+
+    sparePowerPtr[i] = (float)(((re * re) + (im * im)) * powerScale);
+  } // for
+
+  return;
+
+} // computeSpectrum
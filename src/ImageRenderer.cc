@@ -0,0 +1,565 @@
+//************************************************************************
+// file name: ImageRenderer.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ImageRenderer.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: ImageRenderer
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an ImageRenderer.
+
+  Calling Sequence: ImageRenderer(windowWidthInPixels,
+                                  windowHeightInPixels,
+                                  targetPtr,
+                                  grayscale)
+
+  Inputs:
+
+    windowWidthInPixels - The width of each frame.
+
+    windowHeightInPixels - The height of each frame.
+
+    targetPtr - The directory into which the frames are written, as
+    frame000000.ppm, frame000001.ppm, and so on.  A value of "-" writes
+    the frames to stdout.
+
+    grayscale - A flag that indicates that PGM images should be written
+    rather than PPM images.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+ImageRenderer::ImageRenderer(int windowWidthInPixels,
+  int windowHeightInPixels,
+  const char *targetPtr,
+  bool grayscale)
+{
+
+  // Retrieve for later use.
+  strncpy(target,targetPtr,sizeof(target) - 1);
+  target[sizeof(target) - 1] = 0;
+  this->grayscale = grayscale;
+
+  frameNumber = 0;
+  errorReported = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // These match the named colors that the X11 renderer
+  // uses, so the images look like the window.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Background is midnight blue.
+  colorTable[BackgroundColor][0] = 25;
+  colorTable[BackgroundColor][1] = 25;
+  colorTable[BackgroundColor][2] = 112;
+
+  // Grid is yellow.
+  colorTable[GridColor][0] = 255;
+  colorTable[GridColor][1] = 255;
+  colorTable[GridColor][2] = 0;
+
+  // Signal is green.
+  colorTable[SignalColor][0] = 0;
+  colorTable[SignalColor][1] = 255;
+  colorTable[SignalColor][2] = 0;
+
+  // Noise floor is cyan.
+  colorTable[NoiseFloorColor][0] = 0;
+  colorTable[NoiseFloorColor][1] = 255;
+  colorTable[NoiseFloorColor][2] = 255;
+
+  // Max-hold is red.
+  colorTable[MaxHoldColor][0] = 255;
+  colorTable[MaxHoldColor][1] = 0;
+  colorTable[MaxHoldColor][2] = 0;
+
+  // Min-hold is magenta.
+  colorTable[MinHoldColor][0] = 255;
+  colorTable[MinHoldColor][1] = 0;
+  colorTable[MinHoldColor][2] = 255;
+
+  // Average is white.
+  colorTable[AverageColor][0] = 255;
+  colorTable[AverageColor][1] = 255;
+  colorTable[AverageColor][2] = 255;
+
+  // High resolution is orange.
+  colorTable[HighResolutionColor][0] = 255;
+  colorTable[HighResolutionColor][1] = 165;
+  colorTable[HighResolutionColor][2] = 0;
+
+  // Highlights are hot pink.
+  colorTable[HighlightColor][0] = 255;
+  colorTable[HighlightColor][1] = 105;
+  colorTable[HighlightColor][2] = 180;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  rasterizerPtr = new SoftwareRasterizer(windowWidthInPixels,
+                                         windowHeightInPixels);
+
+  return;
+
+} // ImageRenderer
+
+/*****************************************************************************
+
+  Name: ~ImageRenderer
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an ImageRenderer.
+
+  Calling Sequence: ~ImageRenderer()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+ImageRenderer::~ImageRenderer(void)
+{
+
+  // Release resources.
+  delete rasterizerPtr;
+
+  return;
+
+} // ~ImageRenderer
+
+/*****************************************************************************
+
+  Name: setTitle
+
+  Purpose: The purpose of this function is to ignore a title.  Images
+  don't have one.
+
+  Calling Sequence: setTitle(titlePtr)
+
+  Inputs:
+
+    titlePtr - The title.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::setTitle(const char *titlePtr)
+{
+
+  (void)titlePtr;
+
+  return;
+
+} // setTitle
+
+/*****************************************************************************
+
+  Name: getFontHeight
+
+  Purpose: The purpose of this function is to retrieve the height of
+  the font that strings are drawn with.
+
+  Calling Sequence: fontHeight = getFontHeight()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    fontHeight - The font height in pixels.
+
+*****************************************************************************/
+int ImageRenderer::getFontHeight(void)
+{
+
+  return (RASTER_FONT_HEIGHT);
+
+} // getFontHeight
+
+/*****************************************************************************
+
+  Name: beginFrame
+
+  Purpose: The purpose of this function is to start a new frame by
+  filling it with the background color.
+
+  Calling Sequence: beginFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::beginFrame(void)
+{
+
+  setColor(BackgroundColor);
+  rasterizerPtr->fill();
+
+  return;
+
+} // beginFrame
+
+/*****************************************************************************
+
+  Name: clearArea
+
+  Purpose: The purpose of this function is to erase a rectangle of the
+  image to the background color.
+
+  Calling Sequence: clearArea(x,y,width,height)
+
+  Inputs:
+
+    x - The left edge of the rectangle in pixels.
+
+    y - The top edge of the rectangle in pixels.
+
+    width - The width of the rectangle in pixels.
+
+    height - The height of the rectangle in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::clearArea(int x,int y,int width,int height)
+{
+
+  setColor(BackgroundColor);
+  rasterizerPtr->fillRectangle(x,y,width,height);
+
+  return;
+
+} // clearArea
+
+/*****************************************************************************
+
+  Name: endFrame
+
+  Purpose: The purpose of this function is to finish a frame by writing
+  it out as an image.
+
+  Calling Sequence: endFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::endFrame(void)
+{
+  bool success;
+  char fileName[300];
+  FILE *streamPtr;
+
+  if (strcmp(target,"-") == 0)
+  {
+    // The frames are streamed back to back.
+    success = writeFrame(stdout);
+    fflush(stdout);
+  } // if
+  else
+  {
+    sprintf(fileName,"%s/frame%06u.%s",
+            target,frameNumber,grayscale ? "pgm" : "ppm");
+
+    streamPtr = fopen(fileName,"wb");
+
+    if (streamPtr != NULL)
+    {
+      success = writeFrame(streamPtr);
+
+      if (fclose(streamPtr) != 0)
+      {
+        success = false;
+      } // if
+    } // if
+    else
+    {
+      success = false;
+    } // else
+  } // else
+
+  if (!success && !errorReported)
+  {
+    fprintf(stderr,"Unable to write frame %u to %s\n",frameNumber,target);
+    errorReported = true;
+  } // if
+
+  frameNumber++;
+
+  return;
+
+} // endFrame
+
+/*****************************************************************************
+
+  Name: writeFrame
+
+  Purpose: The purpose of this function is to write the frame to a
+  stream in the selected image format.
+
+  Calling Sequence: success = writeFrame(streamPtr)
+
+  Inputs:
+
+    streamPtr - The stream to write to.
+
+ Outputs:
+
+    success - A flag that indicates whether the frame was written.
+
+*****************************************************************************/
+bool ImageRenderer::writeFrame(FILE *streamPtr)
+{
+  bool success;
+
+  if (grayscale)
+  {
+    success = rasterizerPtr->writePgm(streamPtr);
+  } // if
+  else
+  {
+    success = rasterizerPtr->writePpm(streamPtr);
+  } // else
+
+  return (success);
+
+} // writeFrame
+
+/*****************************************************************************
+
+  Name: setColor
+
+  Purpose: The purpose of this function is to set the color of
+  everything that is drawn from now on.
+
+  Calling Sequence: setColor(color)
+
+  Inputs:
+
+    color - The color.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::setColor(RenderColor color)
+{
+
+  rasterizerPtr->setColor(colorTable[color][0],
+                          colorTable[color][1],
+                          colorTable[color][2]);
+
+  return;
+
+} // setColor
+
+/*****************************************************************************
+
+  Name: drawLine
+
+  Purpose: The purpose of this function is to draw a line.
+
+  Calling Sequence: drawLine(x1,y1,x2,y2)
+
+  Inputs:
+
+    x1,y1 - The start of the line.
+
+    x2,y2 - The end of the line.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::drawLine(int x1,int y1,int x2,int y2)
+{
+
+  rasterizerPtr->drawLine(x1,y1,x2,y2);
+
+  return;
+
+} // drawLine
+
+/*****************************************************************************
+
+  Name: drawLines
+
+  Purpose: The purpose of this function is to draw a polyline through a
+  list of points.
+
+  Calling Sequence: drawLines(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+
+  for (i = 1; i < numberOfPoints; i++)
+  {
+    rasterizerPtr->drawLine(pointsPtr[i-1].x,pointsPtr[i-1].y,
+                            pointsPtr[i].x,pointsPtr[i].y);
+  } // for
+
+  return;
+
+} // drawLines
+
+/*****************************************************************************
+
+  Name: drawSegments
+
+  Purpose: The purpose of this function is to draw a list of unconnected
+  line segments.
+
+  Calling Sequence: drawSegments(segmentsPtr,numberOfSegments)
+
+  Inputs:
+
+    segmentsPtr - A pointer to the segments.
+
+    numberOfSegments - The number of segments.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::drawSegments(RenderSegment *segmentsPtr,
+  uint32_t numberOfSegments)
+{
+  uint32_t i;
+
+  for (i = 0; i < numberOfSegments; i++)
+  {
+    rasterizerPtr->drawLine(segmentsPtr[i].x1,segmentsPtr[i].y1,
+                            segmentsPtr[i].x2,segmentsPtr[i].y2);
+  } // for
+
+  return;
+
+} // drawSegments
+
+/*****************************************************************************
+
+  Name: drawPoints
+
+  Purpose: The purpose of this function is to draw a list of points.
+
+  Calling Sequence: drawPoints(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    rasterizerPtr->drawPixel(pointsPtr[i].x,pointsPtr[i].y);
+  } // for
+
+  return;
+
+} // drawPoints
+
+/*****************************************************************************
+
+  Name: drawString
+
+  Purpose: The purpose of this function is to draw a string.
+
+  Calling Sequence: drawString(x,y,textPtr)
+
+  Inputs:
+
+    x - The horizontal position of the start of the string.
+
+    y - The vertical position of the baseline of the string.
+
+    textPtr - The string.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ImageRenderer::drawString(int x,int y,const char *textPtr)
+{
+
+  rasterizerPtr->drawString(x,y,textPtr);
+
+  return;
+
+} // drawString
+
+/*****************************************************************************
+
+  Name: getKeystroke
+
+  Purpose: The purpose of this function is to retrieve the next
+  keystroke.  Nobody can type at this renderer.
+
+  Calling Sequence: key = getKeystroke()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    key - Always 0.
+
+*****************************************************************************/
+int ImageRenderer::getKeystroke(void)
+{
+
+  return (0);
+
+} // getKeystroke
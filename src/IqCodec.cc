@@ -0,0 +1,967 @@
+//************************************************************************
+// file name: IqCodec.cc
+//************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "IqCodec.h"
+
+// These are the predictors.
+#define PREDICTOR_NONE (0)
+#define PREDICTOR_DELTA (1)
+#define PREDICTOR_LINEAR (2)
+
+// The code lengths take this many bytes, two per byte.
+#define CODE_LENGTHS_SIZE (128)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: IqCodec
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an IqCodec.
+
+  Calling Sequence: IqCodec()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+IqCodec::IqCodec(void)
+{
+
+  residualPtr = new uint8_t[IQZ_BLOCK_SIZE];
+
+  return;
+
+} // IqCodec
+
+/*****************************************************************************
+
+  Name: ~IqCodec
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an IqCodec.
+
+  Calling Sequence: ~IqCodec()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+IqCodec::~IqCodec(void)
+{
+
+  delete[] residualPtr;
+
+  return;
+
+} // ~IqCodec
+
+/*****************************************************************************
+
+  Name: compressBlock
+
+  Purpose: The purpose of this function is to compress a block of IQ
+  data.  The predictor that leaves the least entropy is chosen, and the
+  residuals are Huffman coded.  If that doesn't make the block smaller,
+  the block is stored as it is.
+
+  Calling Sequence: compressedLength = compressBlock(rawPtr,
+                                                     rawLength,
+                                                     compressedPtr)
+
+  Inputs:
+
+    rawPtr - A pointer to the IQ data.
+
+    rawLength - The number of bytes of IQ data, from 1 to IQZ_BLOCK_SIZE.
+    It should be even, so that I and Q stay in step from block to block.
+
+    compressedPtr - A pointer to storage for IQZ_MAX_COMPRESSED_SIZE
+    bytes.
+
+ Outputs:
+
+    compressedPtr - The compressed block, header included.
+
+    compressedLength - The number of bytes in the compressed block.
+
+*****************************************************************************/
+uint32_t IqCodec::compressBlock(const uint8_t *rawPtr,
+  uint32_t rawLength,
+  uint8_t *compressedPtr)
+{
+  uint32_t i;
+  uint32_t predictor;
+  uint64_t numberOfBits;
+  uint32_t payloadLength;
+  uint64_t accumulator;
+  uint32_t accumulatorBits;
+  uint8_t *outputPtr;
+
+  predictor = choosePredictor(rawPtr,rawLength);
+
+  // Build a code for the residuals of that predictor.
+  buildCodeLengths(predictor);
+
+  numberOfBits = 0;
+
+  for (i = 0; i < 256; i++)
+  {
+    numberOfBits += (uint64_t)counts[predictor][i] * codeLengths[i];
+  } // for
+
+  payloadLength = CODE_LENGTHS_SIZE + (uint32_t)((numberOfBits + 7) / 8);
+
+  putUint32(&compressedPtr[0],rawLength);
+  compressedPtr[10] = 0;
+  compressedPtr[11] = 0;
+
+  if (payloadLength >= rawLength)
+  {
+    // It doesn't pay, so store the block.
+    putUint32(&compressedPtr[4],rawLength);
+    compressedPtr[8] = IQZ_METHOD_STORED;
+    compressedPtr[9] = PREDICTOR_NONE;
+    memcpy(&compressedPtr[IQZ_BLOCK_HEADER_SIZE],rawPtr,rawLength);
+
+    return (IQZ_BLOCK_HEADER_SIZE + rawLength);
+  } // if
+
+  putUint32(&compressedPtr[4],payloadLength);
+  compressedPtr[8] = IQZ_METHOD_HUFFMAN;
+  compressedPtr[9] = (uint8_t)predictor;
+
+  outputPtr = &compressedPtr[IQZ_BLOCK_HEADER_SIZE];
+
+  for (i = 0; i < 256; i += 2)
+  {
+    *outputPtr++ = codeLengths[i] | (codeLengths[i+1] << 4);
+  } // for
+
+  buildCodes();
+  predict(rawPtr,rawLength,predictor);
+
+  accumulator = 0;
+  accumulatorBits = 0;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Codes are packed most significant bit first.
+  // The accumulator is emptied four bytes at a
+  // time, and it never holds more than 31 + 12
+  // bits.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < rawLength; i++)
+  {
+    accumulator = (accumulator << codeLengths[residualPtr[i]]) |
+                  codes[residualPtr[i]];
+    accumulatorBits += codeLengths[residualPtr[i]];
+
+    if (accumulatorBits >= 32)
+    {
+      accumulatorBits -= 32;
+      outputPtr[0] = (uint8_t)(accumulator >> (accumulatorBits + 24));
+      outputPtr[1] = (uint8_t)(accumulator >> (accumulatorBits + 16));
+      outputPtr[2] = (uint8_t)(accumulator >> (accumulatorBits + 8));
+      outputPtr[3] = (uint8_t)(accumulator >> accumulatorBits);
+      outputPtr += 4;
+    } // if
+  } // for
+
+  while (accumulatorBits >= 8)
+  {
+    accumulatorBits -= 8;
+    *outputPtr++ = (uint8_t)(accumulator >> accumulatorBits);
+  } // while
+
+  if (accumulatorBits > 0)
+  {
+    // Pad the last byte with zeros.
+    *outputPtr++ = (uint8_t)(accumulator << (8 - accumulatorBits));
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (IQZ_BLOCK_HEADER_SIZE + payloadLength);
+
+} // compressBlock
+
+/*****************************************************************************
+
+  Name: decompressBlock
+
+  Purpose: The purpose of this function is to decompress a block of IQ
+  data.
+
+  Calling Sequence: success = decompressBlock(compressedPtr,
+                                              compressedLength,
+                                              rawPtr,
+                                              rawLengthPtr)
+
+  Inputs:
+
+    compressedPtr - A pointer to the compressed block, header included.
+
+    compressedLength - The number of bytes in the compressed block.
+
+    rawPtr - A pointer to storage for IQZ_BLOCK_SIZE bytes.
+
+    rawLengthPtr - A pointer to storage for the number of bytes of IQ
+    data.
+
+ Outputs:
+
+    rawPtr - The IQ data.
+
+    rawLengthPtr - The number of bytes of IQ data.
+
+    success - A flag that indicates whether the block was valid.  A value
+    of true indicates that it was, and a value of false indicates that it
+    was corrupt.
+
+*****************************************************************************/
+bool IqCodec::decompressBlock(const uint8_t *compressedPtr,
+  uint32_t compressedLength,
+  uint8_t *rawPtr,
+  uint32_t *rawLengthPtr)
+{
+  uint32_t i;
+  uint32_t j;
+  uint32_t rawLength;
+  uint32_t payloadLength;
+  uint32_t predictor;
+  uint32_t kraftSum;
+  uint32_t entry;
+  uint32_t firstEntry;
+  uint32_t lastEntry;
+  uint64_t accumulator;
+  uint32_t accumulatorBits;
+  const uint8_t *inputPtr;
+  const uint8_t *endPtr;
+
+  if (compressedLength < IQZ_BLOCK_HEADER_SIZE)
+  {
+    return (false);
+  } // if
+
+  rawLength = getUint32(&compressedPtr[0]);
+  payloadLength = getUint32(&compressedPtr[4]);
+  predictor = compressedPtr[9];
+
+  if ((rawLength > IQZ_BLOCK_SIZE) ||
+      (payloadLength != (compressedLength - IQZ_BLOCK_HEADER_SIZE)) ||
+      (predictor > PREDICTOR_LINEAR))
+  {
+    return (false);
+  } // if
+
+  *rawLengthPtr = rawLength;
+  inputPtr = &compressedPtr[IQZ_BLOCK_HEADER_SIZE];
+
+  switch (compressedPtr[8])
+  {
+    case IQZ_METHOD_STORED:
+    {
+      if (payloadLength != rawLength)
+      {
+        return (false);
+      } // if
+
+      memcpy(rawPtr,inputPtr,rawLength);
+
+      return (true);
+    } // case
+
+    case IQZ_METHOD_HUFFMAN:
+    {
+      break;
+    } // case
+
+    default:
+    {
+      return (false);
+    } // case
+  } // switch
+
+  if (payloadLength < CODE_LENGTHS_SIZE)
+  {
+    return (false);
+  } // if
+
+  for (i = 0; i < 256; i += 2)
+  {
+    codeLengths[i] = *inputPtr & 0x0f;
+    codeLengths[i+1] = *inputPtr >> 4;
+    inputPtr++;
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Make sure that the code is a prefix code, and
+  // build the decoding table.  A table entry that
+  // no code reaches decodes as a zero length code.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  kraftSum = 0;
+
+  for (i = 0; i < 256; i++)
+  {
+    if (codeLengths[i] > IQZ_MAX_CODE_LENGTH)
+    {
+      return (false);
+    } // if
+
+    if (codeLengths[i] != 0)
+    {
+      kraftSum += 1 << (IQZ_MAX_CODE_LENGTH - codeLengths[i]);
+    } // if
+  } // for
+
+  if (kraftSum > (1 << IQZ_MAX_CODE_LENGTH))
+  {
+    return (false);
+  } // if
+
+  buildCodes();
+  memset(decodeTable,0,sizeof(decodeTable));
+
+  for (i = 0; i < 256; i++)
+  {
+    if (codeLengths[i] != 0)
+    {
+      firstEntry = codes[i] << (IQZ_MAX_CODE_LENGTH - codeLengths[i]);
+      lastEntry = firstEntry + (1 << (IQZ_MAX_CODE_LENGTH - codeLengths[i]));
+
+      for (j = firstEntry; j < lastEntry; j++)
+      {
+        decodeTable[j] = (uint16_t)(i | (codeLengths[i] << 8));
+      } // for
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  endPtr = &compressedPtr[compressedLength];
+  accumulator = 0;
+  accumulatorBits = 0;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Decode the residuals.  The accumulator is kept
+  // at least 32 bits full, with zeros after the
+  // end of the block.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < rawLength; i++)
+  {
+    if (accumulatorBits < IQZ_MAX_CODE_LENGTH)
+    {
+      if ((inputPtr + 4) <= endPtr)
+      {
+        accumulator = (accumulator << 32) |
+                      ((uint32_t)inputPtr[0] << 24) |
+                      ((uint32_t)inputPtr[1] << 16) |
+                      ((uint32_t)inputPtr[2] << 8) |
+                      inputPtr[3];
+        inputPtr += 4;
+      } // if
+      else
+      {
+        for (j = 0; j < 4; j++)
+        {
+          accumulator <<= 8;
+
+          if (inputPtr < endPtr)
+          {
+            accumulator |= *inputPtr++;
+          } // if
+        } // for
+      } // else
+
+      accumulatorBits += 32;
+    } // if
+
+    entry = decodeTable[(accumulator >>
+                         (accumulatorBits - IQZ_MAX_CODE_LENGTH)) &
+                        ((1 << IQZ_MAX_CODE_LENGTH) - 1)];
+
+    residualPtr[i] = (uint8_t)entry;
+    accumulatorBits -= entry >> 8;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  reconstruct(rawPtr,rawLength,predictor);
+
+  return (true);
+
+} // decompressBlock
+
+/*****************************************************************************
+
+  Name: choosePredictor
+
+  Purpose: The purpose of this function is to choose the predictor that
+  leaves the least entropy in a block.  Noise-like signals compress best
+  with no prediction, and oversampled signals compress best with one of
+  the others.
+
+  Calling Sequence: predictor = choosePredictor(rawPtr,rawLength)
+
+  Inputs:
+
+    rawPtr - A pointer to the IQ data.
+
+    rawLength - The number of bytes of IQ data.
+
+ Outputs:
+
+    predictor - The predictor.  The histogram of its residuals is in
+    counts[predictor].
+
+*****************************************************************************/
+uint32_t IqCodec::choosePredictor(const uint8_t *rawPtr,uint32_t rawLength)
+{
+  uint32_t i;
+  uint32_t p;
+  uint32_t predictor;
+  uint8_t x;
+  uint8_t previous[2];
+  uint8_t older[2];
+  double entropy;
+  double bestEntropy;
+
+  memset(counts,0,sizeof(counts));
+
+  previous[0] = previous[1] = 0;
+  older[0] = older[1] = 0;
+
+  for (i = 0; i < rawLength; i++)
+  {
+    x = rawPtr[i];
+
+    counts[PREDICTOR_NONE][x]++;
+    counts[PREDICTOR_DELTA][(uint8_t)(x - previous[i & 1])]++;
+    counts[PREDICTOR_LINEAR][(uint8_t)(x - (2 * previous[i & 1]) +
+                                       older[i & 1])]++;
+
+    older[i & 1] = previous[i & 1];
+    previous[i & 1] = x;
+  } // for
+
+  predictor = PREDICTOR_NONE;
+  bestEntropy = 0;
+
+  for (p = PREDICTOR_NONE; p <= PREDICTOR_LINEAR; p++)
+  {
+    // This is the number of bits less rawLength * log2(rawLength).
+    entropy = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+      if (counts[p][i] != 0)
+      {
+        entropy -= counts[p][i] * log2((double)counts[p][i]);
+      } // if
+    } // for
+
+    if ((p == PREDICTOR_NONE) || (entropy < bestEntropy))
+    {
+      predictor = p;
+      bestEntropy = entropy;
+    } // if
+  } // for
+
+  return (predictor);
+
+} // choosePredictor
+
+/*****************************************************************************
+
+  Name: predict
+
+  Purpose: The purpose of this function is to compute the prediction
+  residuals of a block.  I and Q are predicted separately, and the values
+  before the start of the block are taken to be zero, so that the block
+  can be decoded on its own.  The arithmetic is modulo 256, so it works
+  for signed and unsigned samples alike.
+
+  Calling Sequence: predict(rawPtr,rawLength,predictor)
+
+  Inputs:
+
+    rawPtr - A pointer to the IQ data.
+
+    rawLength - The number of bytes of IQ data.
+
+    predictor - The predictor.
+
+ Outputs:
+
+    None.  The residuals are in residualPtr[].
+
+*****************************************************************************/
+void IqCodec::predict(const uint8_t *rawPtr,
+  uint32_t rawLength,
+  uint32_t predictor)
+{
+  uint32_t i;
+
+  switch (predictor)
+  {
+    case PREDICTOR_DELTA:
+    {
+      for (i = 0; (i < 2) && (i < rawLength); i++)
+      {
+        residualPtr[i] = rawPtr[i];
+      } // for
+
+      for (i = 2; i < rawLength; i++)
+      {
+        residualPtr[i] = rawPtr[i] - rawPtr[i-2];
+      } // for
+      break;
+    } // case
+
+    case PREDICTOR_LINEAR:
+    {
+      for (i = 0; (i < 4) && (i < rawLength); i++)
+      {
+        residualPtr[i] = rawPtr[i] - ((i >= 2) ? (2 * rawPtr[i-2]) : 0);
+      } // for
+
+      for (i = 4; i < rawLength; i++)
+      {
+        residualPtr[i] = rawPtr[i] - (2 * rawPtr[i-2]) + rawPtr[i-4];
+      } // for
+      break;
+    } // case
+
+    default:
+    {
+      memcpy(residualPtr,rawPtr,rawLength);
+      break;
+    } // case
+  } // switch
+
+  return;
+
+} // predict
+
+/*****************************************************************************
+
+  Name: reconstruct
+
+  Purpose: The purpose of this function is to undo the prediction of a
+  block.
+
+  Calling Sequence: reconstruct(rawPtr,rawLength,predictor)
+
+  Inputs:
+
+    rawPtr - A pointer to storage for the IQ data.
+
+    rawLength - The number of bytes of IQ data.
+
+    predictor - The predictor.
+
+ Outputs:
+
+    rawPtr - The IQ data.
+
+*****************************************************************************/
+void IqCodec::reconstruct(uint8_t *rawPtr,
+  uint32_t rawLength,
+  uint32_t predictor)
+{
+  uint32_t i;
+
+  switch (predictor)
+  {
+    case PREDICTOR_DELTA:
+    {
+      for (i = 0; (i < 2) && (i < rawLength); i++)
+      {
+        rawPtr[i] = residualPtr[i];
+      } // for
+
+      for (i = 2; i < rawLength; i++)
+      {
+        rawPtr[i] = residualPtr[i] + rawPtr[i-2];
+      } // for
+      break;
+    } // case
+
+    case PREDICTOR_LINEAR:
+    {
+      for (i = 0; (i < 4) && (i < rawLength); i++)
+      {
+        rawPtr[i] = residualPtr[i] + ((i >= 2) ? (2 * rawPtr[i-2]) : 0);
+      } // for
+
+      for (i = 4; i < rawLength; i++)
+      {
+        rawPtr[i] = residualPtr[i] + (2 * rawPtr[i-2]) - rawPtr[i-4];
+      } // for
+      break;
+    } // case
+
+    default:
+    {
+      memcpy(rawPtr,residualPtr,rawLength);
+      break;
+    } // case
+  } // switch
+
+  return;
+
+} // reconstruct
+
+/*****************************************************************************
+
+  Name: buildCodeLengths
+
+  Purpose: The purpose of this function is to build the lengths of a
+  Huffman code for the residuals of a predictor.  If any
+  code comes out longer than IQZ_MAX_CODE_LENGTH, the counts are halved
+  (rare values stay rare but get closer to common ones), and the code is
+  built again.
+
+  Calling Sequence: buildCodeLengths(predictor)
+
+  Inputs:
+
+    predictor - The predictor, whose histogram is in counts[predictor].
+
+ Outputs:
+
+    None.  The lengths are in codeLengths[].
+
+*****************************************************************************/
+void IqCodec::buildCodeLengths(uint32_t predictor)
+{
+  uint32_t i;
+  uint32_t numberOfNodes;
+  uint32_t numberOfLeaves;
+  uint32_t first;
+  uint32_t second;
+  uint32_t node;
+  uint32_t length;
+  uint32_t maximumLength;
+  uint32_t weights[512];
+  int32_t parents[512];
+  bool active[512];
+  bool done;
+
+  for (i = 0; i < 256; i++)
+  {
+    weights[i] = counts[predictor][i];
+  } // for
+
+  done = false;
+
+  while (!done)
+  {
+    memset(codeLengths,0,sizeof(codeLengths));
+    numberOfLeaves = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+      active[i] = (weights[i] != 0);
+      parents[i] = -1;
+
+      if (active[i])
+      {
+        numberOfLeaves++;
+        node = i;
+      } // if
+    } // for
+
+    if (numberOfLeaves == 0)
+    {
+      // Nothing to code.
+      return;
+    } // if
+
+    if (numberOfLeaves == 1)
+    {
+      // A single value still needs a code.
+      codeLengths[node] = 1;
+      return;
+    } // if
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Join the two lightest nodes until only the
+    // root is left.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    for (numberOfNodes = 256;
+         numberOfNodes < (256 + numberOfLeaves - 1);
+         numberOfNodes++)
+    {
+      first = second = 512;
+
+      for (i = 0; i < numberOfNodes; i++)
+      {
+        if (active[i])
+        {
+          if ((first == 512) || (weights[i] < weights[first]))
+          {
+            second = first;
+            first = i;
+          } // if
+          else
+          {
+            if ((second == 512) || (weights[i] < weights[second]))
+            {
+              second = i;
+            } // if
+          } // else
+        } // if
+      } // for
+
+      weights[numberOfNodes] = weights[first] + weights[second];
+      active[numberOfNodes] = true;
+      parents[numberOfNodes] = -1;
+      active[first] = active[second] = false;
+      parents[first] = parents[second] = (int32_t)numberOfNodes;
+    } // for
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    maximumLength = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+      if (weights[i] != 0)
+      {
+        length = 0;
+
+        for (node = i; parents[node] != -1; node = parents[node])
+        {
+          length++;
+        } // for
+
+        codeLengths[i] = (uint8_t)length;
+
+        if (length > maximumLength)
+        {
+          maximumLength = length;
+        } // if
+      } // if
+    } // for
+
+    if (maximumLength <= IQZ_MAX_CODE_LENGTH)
+    {
+      done = true;
+    } // if
+    else
+    {
+      for (i = 0; i < 256; i++)
+      {
+        if (weights[i] != 0)
+        {
+          weights[i] = (weights[i] + 1) / 2;
+        } // if
+      } // for
+    } // else
+  } // while
+
+  return;
+
+} // buildCodeLengths
+
+/*****************************************************************************
+
+  Name: buildCodes
+
+  Purpose: The purpose of this function is to assign the canonical codes
+  for the code lengths.  Shorter codes come first, and codes of the same
+  length are in the order of their values, so the lengths are all that a
+  decoder needs.
+
+  Calling Sequence: buildCodes()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.  The codes are in codes[].
+
+*****************************************************************************/
+void IqCodec::buildCodes(void)
+{
+  uint32_t i;
+  uint32_t code;
+  uint32_t lengthCounts[IQZ_MAX_CODE_LENGTH + 1];
+  uint32_t nextCodes[IQZ_MAX_CODE_LENGTH + 1];
+
+  memset(lengthCounts,0,sizeof(lengthCounts));
+
+  for (i = 0; i < 256; i++)
+  {
+    lengthCounts[codeLengths[i]]++;
+  } // for
+
+  lengthCounts[0] = 0;
+  code = 0;
+
+  for (i = 1; i <= IQZ_MAX_CODE_LENGTH; i++)
+  {
+    code = (code + lengthCounts[i-1]) << 1;
+    nextCodes[i] = code;
+  } // for
+
+  for (i = 0; i < 256; i++)
+  {
+    if (codeLengths[i] != 0)
+    {
+      codes[i] = (uint16_t)nextCodes[codeLengths[i]];
+      nextCodes[codeLengths[i]]++;
+    } // if
+  } // for
+
+  return;
+
+} // buildCodes
+
+/*****************************************************************************
+
+  Name: putUint32
+
+  Purpose: The purpose of this function is to store a 32-bit value, least
+  significant byte first.
+
+  Calling Sequence: putUint32(bufferPtr,value)
+
+  Inputs:
+
+    bufferPtr - A pointer to storage for 4 bytes.
+
+    value - The value.
+
+ Outputs:
+
+    bufferPtr - The stored value.
+
+*****************************************************************************/
+void IqCodec::putUint32(uint8_t *bufferPtr,uint32_t value)
+{
+  uint32_t i;
+
+  for (i = 0; i < 4; i++)
+  {
+    bufferPtr[i] = (uint8_t)(value >> (8 * i));
+  } // for
+
+  return;
+
+} // putUint32
+
+/*****************************************************************************
+
+  Name: putUint64
+
+  Purpose: The purpose of this function is to store a 64-bit value, least
+  significant byte first.
+
+  Calling Sequence: putUint64(bufferPtr,value)
+
+  Inputs:
+
+    bufferPtr - A pointer to storage for 8 bytes.
+
+    value - The value.
+
+ Outputs:
+
+    bufferPtr - The stored value.
+
+*****************************************************************************/
+void IqCodec::putUint64(uint8_t *bufferPtr,uint64_t value)
+{
+  uint32_t i;
+
+  for (i = 0; i < 8; i++)
+  {
+    bufferPtr[i] = (uint8_t)(value >> (8 * i));
+  } // for
+
+  return;
+
+} // putUint64
+
+/*****************************************************************************
+
+  Name: getUint32
+
+  Purpose: The purpose of this function is to retrieve a 32-bit value that
+  was stored least significant byte first.
+
+  Calling Sequence: value = getUint32(bufferPtr)
+
+  Inputs:
+
+    bufferPtr - A pointer to the stored value.
+
+ Outputs:
+
+    value - The value.
+
+*****************************************************************************/
+uint32_t IqCodec::getUint32(const uint8_t *bufferPtr)
+{
+  uint32_t i;
+  uint32_t value;
+
+  value = 0;
+
+  for (i = 0; i < 4; i++)
+  {
+    value |= (uint32_t)bufferPtr[i] << (8 * i);
+  } // for
+
+  return (value);
+
+} // getUint32
+
+/*****************************************************************************
+
+  Name: getUint64
+
+  Purpose: The purpose of this function is to retrieve a 64-bit value that
+  was stored least significant byte first.
+
+  Calling Sequence: value = getUint64(bufferPtr)
+
+  Inputs:
+
+    bufferPtr - A pointer to the stored value.
+
+ Outputs:
+
+    value - The value.
+
+*****************************************************************************/
+uint64_t IqCodec::getUint64(const uint8_t *bufferPtr)
+{
+  uint32_t i;
+  uint64_t value;
+
+  value = 0;
+
+  for (i = 0; i < 8; i++)
+  {
+    value |= (uint64_t)bufferPtr[i] << (8 * i);
+  } // for
+
+  return (value);
+
+} // getUint64
@@ -0,0 +1,525 @@
+//************************************************************************
+// file name: IqCompressor.cc
+//************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "IqCompressor.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: IqCompressor
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an IqCompressor.  The file header is written, and the
+  compression threads are started.
+
+  Calling Sequence: IqCompressor(streamPtr,numberOfThreads)
+
+  Inputs:
+
+    streamPtr - The stream that the compressed data is written to.
+
+    numberOfThreads - The number of compression threads.  A value of 0
+    uses one thread per processor.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+IqCompressor::IqCompressor(FILE *streamPtr,uint32_t numberOfThreads)
+{
+  uint32_t i;
+  uint8_t header[IQZ_FILE_HEADER_SIZE];
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  } // if
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = 1;
+  } // if
+
+  if (numberOfThreads > MAX_COMPRESSION_THREADS)
+  {
+    numberOfThreads = MAX_COMPRESSION_THREADS;
+  } // if
+
+  // Retrieve for later use.
+  this->streamPtr = streamPtr;
+  this->numberOfThreads = numberOfThreads;
+
+  streamOffset = 0;
+  outputFailed = false;
+
+  numberOfBlocks = 0;
+  blockOffsetsCapacity = 1024;
+  blockOffsetsPtr = new uint64_t[blockOffsetsCapacity];
+
+  numberOfJobs = numberOfThreads * COMPRESSION_JOBS_PER_THREAD;
+
+  for (i = 0; i < numberOfJobs; i++)
+  {
+    jobs[i].rawPtr = new uint8_t[IQZ_BLOCK_SIZE];
+    jobs[i].rawLength = 0;
+    jobs[i].compressedPtr = new uint8_t[IQZ_MAX_COMPRESSED_SIZE];
+    jobs[i].compressedLength = 0;
+    jobs[i].state = JobFree;
+  } // for
+
+  oldestJob = 0;
+  numberOfPendingJobs = 0;
+  stopping = false;
+
+  memcpy(header,"IQZ1",4);
+  IqCodec::putUint32(&header[4],IQZ_BLOCK_SIZE);
+  writeBytes(header,sizeof(header));
+
+  pthread_mutex_init(&jobLock,NULL);
+  pthread_cond_init(&jobQueued,NULL);
+  pthread_cond_init(&jobDone,NULL);
+
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    workers[i].compressorPtr = this;
+    workers[i].codecPtr = new IqCodec();
+    pthread_create(&workers[i].thread,NULL,threadEntry,&workers[i]);
+  } // for
+
+  return;
+
+} // IqCompressor
+
+/*****************************************************************************
+
+  Name: ~IqCompressor
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an IqCompressor.  The data that is still in the
+  compressor is written, followed by the end block and the block index.
+
+  Calling Sequence: ~IqCompressor()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+IqCompressor::~IqCompressor(void)
+{
+  uint32_t i;
+
+  if (jobs[(oldestJob + numberOfPendingJobs) % numberOfJobs].rawLength > 0)
+  {
+    // Send the partial block.
+    submitJob();
+  } // if
+
+  writeFinishedJobs(0);
+
+  // Tell the threads to finish up.
+  pthread_mutex_lock(&jobLock);
+  stopping = true;
+  pthread_cond_broadcast(&jobQueued);
+  pthread_mutex_unlock(&jobLock);
+
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    pthread_join(workers[i].thread,NULL);
+    delete workers[i].codecPtr;
+  } // for
+
+  writeIndex();
+  fflush(streamPtr);
+
+  pthread_cond_destroy(&jobDone);
+  pthread_cond_destroy(&jobQueued);
+  pthread_mutex_destroy(&jobLock);
+
+  // Release resources.
+  for (i = 0; i < numberOfJobs; i++)
+  {
+    delete[] jobs[i].rawPtr;
+    delete[] jobs[i].compressedPtr;
+  } // for
+
+  delete[] blockOffsetsPtr;
+
+  return;
+
+} // ~IqCompressor
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to add IQ data to the
+  compressed stream.  The data is copied, so the caller may reuse the
+  buffer right away.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCompressor::acceptSamples(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t length;
+  CompressionJob *jobPtr;
+
+  while (bufferLength > 0)
+  {
+    // This is the job that is being filled.
+    jobPtr = &jobs[(oldestJob + numberOfPendingJobs) % numberOfJobs];
+
+    length = IQZ_BLOCK_SIZE - jobPtr->rawLength;
+
+    if (length > bufferLength)
+    {
+      length = bufferLength;
+    } // if
+
+    memcpy(&jobPtr->rawPtr[jobPtr->rawLength],signalBufferPtr,length);
+    jobPtr->rawLength += length;
+
+    if (jobPtr->rawLength == IQZ_BLOCK_SIZE)
+    {
+      submitJob();
+    } // if
+
+    signalBufferPtr += length;
+    bufferLength -= length;
+  } // while
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of a compression thread.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the CompressionWorker of the thread.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *IqCompressor::threadEntry(void *argPtr)
+{
+  CompressionWorker *workerPtr;
+
+  workerPtr = (CompressionWorker *)argPtr;
+
+  workerPtr->compressorPtr->run(workerPtr->codecPtr);
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to compress queued jobs, the
+  oldest first, until the compressor is being destroyed.  The lock is not
+  held while a job is compressed, since a job that is being compressed
+  is not touched by anyone else.
+
+  Calling Sequence: run(codecPtr)
+
+  Inputs:
+
+    codecPtr - A pointer to the codec of the thread.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCompressor::run(IqCodec *codecPtr)
+{
+  uint32_t i;
+  bool done;
+  CompressionJob *jobPtr;
+
+  done = false;
+
+  pthread_mutex_lock(&jobLock);
+
+  while (!done)
+  {
+    jobPtr = NULL;
+
+    for (i = 0; (i < numberOfPendingJobs) && (jobPtr == NULL); i++)
+    {
+      if (jobs[(oldestJob + i) % numberOfJobs].state == JobQueued)
+      {
+        jobPtr = &jobs[(oldestJob + i) % numberOfJobs];
+      } // if
+    } // for
+
+    if (jobPtr != NULL)
+    {
+      jobPtr->state = JobCompressing;
+      pthread_mutex_unlock(&jobLock);
+
+      jobPtr->compressedLength = codecPtr->compressBlock(jobPtr->rawPtr,
+                                                         jobPtr->rawLength,
+                                                         jobPtr->compressedPtr);
+
+      pthread_mutex_lock(&jobLock);
+      jobPtr->state = JobDone;
+      pthread_cond_broadcast(&jobDone);
+    } // if
+    else
+    {
+      if (stopping)
+      {
+        done = true;
+      } // if
+      else
+      {
+        pthread_cond_wait(&jobQueued,&jobLock);
+      } // else
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&jobLock);
+
+  return;
+
+} // run
+
+/*****************************************************************************
+
+  Name: submitJob
+
+  Purpose: The purpose of this function is to hand the job that is being
+  filled to the compression threads.  Any jobs that are finished are
+  written, and if every job is busy, this waits until the next one to
+  be filled has been written.
+
+  Calling Sequence: submitJob()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCompressor::submitJob(void)
+{
+
+  pthread_mutex_lock(&jobLock);
+
+  jobs[(oldestJob + numberOfPendingJobs) % numberOfJobs].state = JobQueued;
+  numberOfPendingJobs++;
+
+  pthread_cond_signal(&jobQueued);
+  pthread_mutex_unlock(&jobLock);
+
+  // Make room for the next job.
+  writeFinishedJobs(numberOfJobs - 1);
+
+  return;
+
+} // submitJob
+
+/*****************************************************************************
+
+  Name: writeFinishedJobs
+
+  Purpose: The purpose of this function is to write the jobs that have
+  been compressed, in order, and to wait for jobs until no more than a
+  given number are pending.
+
+  Calling Sequence: writeFinishedJobs(maximumPending)
+
+  Inputs:
+
+    maximumPending - The number of jobs that may be left pending.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCompressor::writeFinishedJobs(uint32_t maximumPending)
+{
+  bool done;
+  uint64_t *newOffsetsPtr;
+  CompressionJob *jobPtr;
+
+  done = false;
+
+  pthread_mutex_lock(&jobLock);
+
+  while ((numberOfPendingJobs > 0) && !done)
+  {
+    jobPtr = &jobs[oldestJob];
+
+    if (jobPtr->state != JobDone)
+    {
+      if (numberOfPendingJobs <= maximumPending)
+      {
+        // It can wait.
+        done = true;
+      } // if
+      else
+      {
+        pthread_cond_wait(&jobDone,&jobLock);
+      } // else
+    } // if
+    else
+    {
+      // Nobody else touches a finished job.
+      pthread_mutex_unlock(&jobLock);
+
+      if (numberOfBlocks == blockOffsetsCapacity)
+      {
+        // Make room in the index.
+        newOffsetsPtr = new uint64_t[2 * blockOffsetsCapacity];
+        memcpy(newOffsetsPtr,blockOffsetsPtr,
+               numberOfBlocks * sizeof(uint64_t));
+        delete[] blockOffsetsPtr;
+        blockOffsetsPtr = newOffsetsPtr;
+        blockOffsetsCapacity *= 2;
+      } // if
+
+      blockOffsetsPtr[numberOfBlocks] = streamOffset;
+      numberOfBlocks++;
+
+      writeBytes(jobPtr->compressedPtr,jobPtr->compressedLength);
+
+      pthread_mutex_lock(&jobLock);
+
+      jobPtr->state = JobFree;
+      jobPtr->rawLength = 0;
+      oldestJob = (oldestJob + 1) % numberOfJobs;
+      numberOfPendingJobs--;
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&jobLock);
+
+  return;
+
+} // writeFinishedJobs
+
+/*****************************************************************************
+
+  Name: writeBytes
+
+  Purpose: The purpose of this function is to write to the stream and
+  keep track of the offset.  After a write fails, nothing more is
+  written.
+
+  Calling Sequence: writeBytes(bufferPtr,length)
+
+  Inputs:
+
+    bufferPtr - A pointer to the data.
+
+    length - The number of bytes to write.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCompressor::writeBytes(const uint8_t *bufferPtr,uint32_t length)
+{
+
+  if (outputFailed)
+  {
+    return;
+  } // if
+
+  if (fwrite(bufferPtr,1,length,streamPtr) != length)
+  {
+    fprintf(stderr,"Could not write the compressed IQ data\n");
+    outputFailed = true;
+  } // if
+
+  streamOffset += length;
+
+  return;
+
+} // writeBytes
+
+/*****************************************************************************
+
+  Name: writeIndex
+
+  Purpose: The purpose of this function is to write the end block, the
+  offset of every block, and the trailer that locates them.
+
+  Calling Sequence: writeIndex()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCompressor::writeIndex(void)
+{
+  uint32_t i;
+  uint64_t indexOffset;
+  uint8_t buffer[IQZ_TRAILER_SIZE];
+
+  // Both lengths are zero.
+  memset(buffer,0,IQZ_BLOCK_HEADER_SIZE);
+  writeBytes(buffer,IQZ_BLOCK_HEADER_SIZE);
+
+  indexOffset = streamOffset;
+
+  for (i = 0; i < numberOfBlocks; i++)
+  {
+    IqCodec::putUint64(buffer,blockOffsetsPtr[i]);
+    writeBytes(buffer,8);
+  } // for
+
+  IqCodec::putUint64(&buffer[0],indexOffset);
+  IqCodec::putUint32(&buffer[8],numberOfBlocks);
+  memcpy(&buffer[12],"IQZI",4);
+  writeBytes(buffer,IQZ_TRAILER_SIZE);
+
+  return;
+
+} // writeIndex
@@ -0,0 +1,641 @@
+//************************************************************************
+// file name: IqCorrector.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "IqCorrector.h"
+
+using namespace std;
+
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+// The running sums keep this much of their value from one block to
+// the next, so the estimates cover roughly the last 16 blocks.
+//_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+#define BLOCK_DECAY (1.0 - (1.0 / 16))
+
+// The SSE2 accumulators are flushed before they can overflow.
+#define CHUNKS_PER_FLUSH (4096)
+
+/*****************************************************************************
+
+  Name: IqCorrector
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an IqCorrector.
+
+  Calling Sequence: IqCorrector(correctionEnabled,
+                                sampleRate,
+                                reportStreamPtr)
+
+  Inputs:
+
+    correctionEnabled - A flag that indicates that the DC offset and IQ
+    imbalance should be removed from the samples, by whoever uses them.
+    Otherwise, they are only measured.
+
+    sampleRate - The sample rate of incoming IQ data in units of S/s.
+
+    reportStreamPtr - The stream that a quality report is written to
+    once a second (of samples).  A value of NULL disables the report.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+IqCorrector::IqCorrector(bool correctionEnabled,
+  float sampleRate,
+  FILE *reportStreamPtr)
+{
+
+  if (sampleRate <= 0)
+  {
+    // Keep it sane.
+    sampleRate = 256000;
+  } // if
+
+  // Retrieve for later use.
+  this->correctionEnabled = correctionEnabled;
+  this->reportStreamPtr = reportStreamPtr;
+
+  // Report once a second.
+  reportInterval = (uint64_t)sampleRate;
+  samplesSinceReport = 0;
+
+  // Nothing has been seen yet.
+  sumI = 0;
+  sumQ = 0;
+  sumII = 0;
+  sumQQ = 0;
+  sumIQ = 0;
+  clips = 0;
+  samples = 0;
+
+  memset(&quality,0,sizeof(quality));
+
+  // Start with no correction.
+  iFactor = 0;
+  qFactor = 1;
+
+  return;
+
+} // IqCorrector
+
+/*****************************************************************************
+
+  Name: ~IqCorrector
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an IqCorrector.
+
+  Calling Sequence: ~IqCorrector()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+IqCorrector::~IqCorrector(void)
+{
+
+  return;
+
+} // ~IqCorrector
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to measure a block of IQ data.
+  Unsigned samples are converted to signed samples in place while the
+  block is measured, but nothing is corrected here.  The correction that
+  getCorrection() returns afterward uses the estimates that include this
+  block.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,
+                                  bufferLength,
+                                  unsignedSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+    unsignedSamples - A flag that indicates that the samples are
+    unsigned 8-bit quantities, as written by rtl_sdr.
+
+ Outputs:
+
+    signalBufferPtr - The signed IQ data.
+
+*****************************************************************************/
+void IqCorrector::acceptSamples(int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  bool unsignedSamples)
+{
+
+  accumulateSums(signalBufferPtr,bufferLength,unsignedSamples);
+
+  updateEstimates(bufferLength / 2);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Report the quality once a second.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  samplesSinceReport += bufferLength / 2;
+
+  if (samplesSinceReport >= reportInterval)
+  {
+    reportQuality();
+    samplesSinceReport = 0;
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: getQuality
+
+  Purpose: The purpose of this function is to retrieve the current
+  estimates of the quality of the IQ data.
+
+  Calling Sequence: getQuality(qualityPtr)
+
+  Inputs:
+
+    qualityPtr - A pointer to storage for the estimates.
+
+ Outputs:
+
+    qualityPtr - The estimates.
+
+*****************************************************************************/
+void IqCorrector::getQuality(IqQuality *qualityPtr)
+{
+
+  *qualityPtr = quality;
+
+  return;
+
+} // getQuality
+
+/*****************************************************************************
+
+  Name: getCorrection
+
+  Purpose: The purpose of this function is to retrieve the correction
+  that removes the DC offset and the IQ imbalance, so that it can be
+  applied in floating point.
+
+  Calling Sequence: enabled = getCorrection(correctionPtr)
+
+  Inputs:
+
+    correctionPtr - A pointer to storage for the correction.
+
+ Outputs:
+
+    correctionPtr - The correction.
+
+    enabled - A flag that indicates whether or not the samples should be
+    corrected.
+
+*****************************************************************************/
+bool IqCorrector::getCorrection(IqCorrection *correctionPtr)
+{
+
+  correctionPtr->dcOffsetI = quality.dcOffsetI;
+  correctionPtr->dcOffsetQ = quality.dcOffsetQ;
+  correctionPtr->iFactor = iFactor;
+  correctionPtr->qFactor = qFactor;
+
+  return (correctionEnabled);
+
+} // getCorrection
+
+/*****************************************************************************
+
+  Name: accumulateSums
+
+  Purpose: The purpose of this function is to compute the sums of I, Q,
+  I*I, Q*Q and I*Q of a block, along with the number of values that are
+  at full scale (127 or -128), converting unsigned samples to signed
+  samples along the way.  With SSE2, sixteen values (eight IQ pairs) are
+  handled at a time: the bytes are sign extended to 16 bits, and the
+  multiply-add instruction forms the sums of I and Q separately by
+  masking out the other member of each pair.
+
+  Calling Sequence: accumulateSums(signalBufferPtr,
+                                   bufferLength,
+                                   unsignedSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+    unsignedSamples - A flag that indicates that the samples are
+    unsigned 8-bit quantities.
+
+ Outputs:
+
+    signalBufferPtr - The signed IQ data.
+
+*****************************************************************************/
+void IqCorrector::accumulateSums(int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  bool unsignedSamples)
+{
+  uint32_t i;
+  int32_t iValue;
+  int32_t qValue;
+#ifdef __SSE2__
+  uint32_t j;
+  uint32_t chunks;
+  int32_t lanes[4];
+  uint64_t clipLanes[2];
+  __m128i values;
+  __m128i words[2];
+  __m128i flaggedClips;
+  __m128i accumulatorI;
+  __m128i accumulatorQ;
+  __m128i accumulatorII;
+  __m128i accumulatorQQ;
+  __m128i accumulatorIQ;
+  __m128i clipCount;
+  __m128i iMask;
+  __m128i iOnes;
+  __m128i qOnes;
+  __m128i signFlip;
+  __m128i maximumValue;
+  __m128i minimumValue;
+  __m128i byteOnes;
+  __m128i zero;
+#endif
+
+  blockSumI = 0;
+  blockSumQ = 0;
+  blockSumII = 0;
+  blockSumQQ = 0;
+  blockSumIQ = 0;
+  blockClips = 0;
+
+  // Reference the first value.
+  i = 0;
+
+#ifdef __SSE2__
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // I is the low 16 bits of each 32-bit lane after sign
+  // extension, and Q is the high 16 bits.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  zero = _mm_setzero_si128();
+  iMask = _mm_set1_epi32(0x0000ffff);
+  iOnes = _mm_and_si128(iMask,_mm_set1_epi16(1));
+  qOnes = _mm_andnot_si128(iMask,_mm_set1_epi16(1));
+  signFlip = _mm_set1_epi8((char)0x80);
+  maximumValue = _mm_set1_epi8(127);
+  minimumValue = _mm_set1_epi8(-128);
+  byteOnes = _mm_set1_epi8(1);
+
+  while ((i + 16) <= bufferLength)
+  {
+    accumulatorI = zero;
+    accumulatorQ = zero;
+    accumulatorII = zero;
+    accumulatorQQ = zero;
+    accumulatorIQ = zero;
+    clipCount = zero;
+
+    for (chunks = 0;
+         (chunks < CHUNKS_PER_FLUSH) && ((i + 16) <= bufferLength);
+         chunks++)
+    {
+      values = _mm_loadu_si128((__m128i *)&signalBufferPtr[i]);
+
+      if (unsignedSamples)
+      {
+        // Subtracting 128 is the same as flipping the sign bit.
+        values = _mm_xor_si128(values,signFlip);
+        _mm_storeu_si128((__m128i *)&signalBufferPtr[i],values);
+      } // if
+
+      // Count the values that are at full scale.
+      flaggedClips = _mm_or_si128(_mm_cmpeq_epi8(values,maximumValue),
+                                  _mm_cmpeq_epi8(values,minimumValue));
+      clipCount = _mm_add_epi64(clipCount,
+                    _mm_sad_epu8(_mm_and_si128(flaggedClips,byteOnes),zero));
+
+      // Sign extend to 16 bits.
+      words[0] = _mm_srai_epi16(_mm_unpacklo_epi8(values,values),8);
+      words[1] = _mm_srai_epi16(_mm_unpackhi_epi8(values,values),8);
+
+      for (j = 0; j < 2; j++)
+      {
+        accumulatorI = _mm_add_epi32(accumulatorI,
+                                     _mm_madd_epi16(words[j],iOnes));
+
+        accumulatorQ = _mm_add_epi32(accumulatorQ,
+                                     _mm_madd_epi16(words[j],qOnes));
+
+        accumulatorII = _mm_add_epi32(accumulatorII,
+                          _mm_madd_epi16(words[j],
+                                         _mm_and_si128(words[j],iMask)));
+
+        accumulatorQQ = _mm_add_epi32(accumulatorQQ,
+                          _mm_madd_epi16(words[j],
+                                         _mm_andnot_si128(iMask,words[j])));
+
+        // Swapping I and Q within each pair gives 2*I*Q per lane.
+        accumulatorIQ = _mm_add_epi32(accumulatorIQ,
+                          _mm_madd_epi16(words[j],
+                            _mm_shufflehi_epi16(
+                              _mm_shufflelo_epi16(words[j],0xb1),0xb1)));
+      } // for
+
+      i += 16;
+    } // for
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Flush the lanes into the block sums.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    _mm_storeu_si128((__m128i *)lanes,accumulatorI);
+    blockSumI += (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    _mm_storeu_si128((__m128i *)lanes,accumulatorQ);
+    blockSumQ += (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    _mm_storeu_si128((__m128i *)lanes,accumulatorII);
+    blockSumII += (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    _mm_storeu_si128((__m128i *)lanes,accumulatorQQ);
+    blockSumQQ += (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    _mm_storeu_si128((__m128i *)lanes,accumulatorIQ);
+    blockSumIQ += ((int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3]) / 2;
+
+    _mm_storeu_si128((__m128i *)clipLanes,clipCount);
+    blockClips += clipLanes[0] + clipLanes[1];
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // while
+#endif
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Handle whatever is left over (or everything, if SSE2
+  // isn't available).
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (; (i + 2) <= bufferLength; i += 2)
+  {
+    if (unsignedSamples)
+    {
+      signalBufferPtr[i] -= 128;
+      signalBufferPtr[i+1] -= 128;
+    } // if
+
+    iValue = signalBufferPtr[i];
+    qValue = signalBufferPtr[i+1];
+
+    blockSumI += iValue;
+    blockSumQ += qValue;
+    blockSumII += iValue * iValue;
+    blockSumQQ += qValue * qValue;
+    blockSumIQ += iValue * qValue;
+
+    blockClips += ((iValue == 127) || (iValue == -128)) ? 1 : 0;
+    blockClips += ((qValue == 127) || (qValue == -128)) ? 1 : 0;
+  } // for
+
+  if ((i < bufferLength) && unsignedSamples)
+  {
+    // A stray value at the end still gets converted.
+    signalBufferPtr[i] -= 128;
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // accumulateSums
+
+/*****************************************************************************
+
+  Name: updateEstimates
+
+  Purpose: The purpose of this function is to fold the sums of a block
+  into the running sums and to update the estimates.  With the DC offset
+  removed, the gain imbalance is the ratio of the powers of I and Q, and
+  the sine of the phase error is the correlation coefficient of I and Q.
+  The correction scales Q back to the power of I and removes the part of
+  Q that is correlated with I.
+
+  Calling Sequence: updateEstimates(numberOfSamples)
+
+  Inputs:
+
+    numberOfSamples - The number of IQ samples in the block.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCorrector::updateEstimates(uint32_t numberOfSamples)
+{
+  double meanI;
+  double meanQ;
+  double varianceI;
+  double varianceQ;
+  double covariance;
+  double gain;
+  double sinePhase;
+  double cosinePhase;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Update the running sums.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  sumI = (sumI * BLOCK_DECAY) + blockSumI;
+  sumQ = (sumQ * BLOCK_DECAY) + blockSumQ;
+  sumII = (sumII * BLOCK_DECAY) + blockSumII;
+  sumQQ = (sumQQ * BLOCK_DECAY) + blockSumQQ;
+  sumIQ = (sumIQ * BLOCK_DECAY) + blockSumIQ;
+  clips = (clips * BLOCK_DECAY) + blockClips;
+  samples = (samples * BLOCK_DECAY) + numberOfSamples;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (samples < 1)
+  {
+    // Nothing to go on.
+    return;
+  } // if
+
+  meanI = sumI / samples;
+  meanQ = sumQ / samples;
+  varianceI = (sumII / samples) - (meanI * meanI);
+  varianceQ = (sumQQ / samples) - (meanQ * meanQ);
+  covariance = (sumIQ / samples) - (meanI * meanQ);
+
+  quality.dcOffsetI = (float)meanI;
+  quality.dcOffsetQ = (float)meanQ;
+
+  // Each IQ sample has two values that can clip.
+  quality.clipPercentage = (float)(100 * clips / (2 * samples));
+
+  if ((varianceI < 0.01) || (varianceQ < 0.01))
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // There is no signal to speak of, so there's no
+    // imbalance to measure or correct.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    quality.gainImbalanceInDb = 0;
+    quality.phaseErrorInDegrees = 0;
+    iFactor = 0;
+    qFactor = 1;
+
+    return;
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
+
+  gain = sqrt(varianceQ / varianceI);
+  sinePhase = covariance / sqrt(varianceI * varianceQ);
+
+  // Keep it sane.
+  sinePhase = (sinePhase > 0.99) ? 0.99 : sinePhase;
+  sinePhase = (sinePhase < -0.99) ? -0.99 : sinePhase;
+
+  cosinePhase = sqrt(1 - (sinePhase * sinePhase));
+
+  quality.gainImbalanceInDb = (float)(10 * log10(varianceI / varianceQ));
+  quality.phaseErrorInDegrees = (float)(asin(sinePhase) * 180 / M_PI);
+
+  iFactor = (float)(-sinePhase / cosinePhase);
+  qFactor = (float)(1 / (gain * cosinePhase));
+
+  return;
+
+} // updateEstimates
+
+/*****************************************************************************
+
+  Name: correctSamples
+
+  Purpose: The purpose of this function is to remove the DC offset and
+  the IQ imbalance from a block of IQ data, for whatever needs 8-bit
+  samples.  The results are rounded and saturated back to 8 bits, so up
+  to half a unit of DC remains.  The spectrum doesn't go through this;
+  it applies getCorrection() in floating point.
+
+  Calling Sequence: correctSamples(signalBufferPtr,
+                                   bufferLength,
+                                   correctedBufferPtr)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+    correctedBufferPtr - A pointer to storage for bufferLength values.
+    This may be the same storage as signalBufferPtr.
+
+ Outputs:
+
+    correctedBufferPtr - The corrected IQ data.
+
+*****************************************************************************/
+void IqCorrector::correctSamples(const int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  int8_t *correctedBufferPtr)
+{
+  uint32_t i;
+  float iValue;
+  float qValue;
+  long iResult;
+  long qResult;
+
+  for (i = 0; (i + 2) <= bufferLength; i += 2)
+  {
+    iValue = signalBufferPtr[i] - quality.dcOffsetI;
+    qValue = signalBufferPtr[i+1] - quality.dcOffsetQ;
+
+    iResult = lrintf(iValue);
+    qResult = lrintf((iFactor * iValue) + (qFactor * qValue));
+
+    // Saturate.
+    iResult = (iResult > 127) ? 127 : iResult;
+    iResult = (iResult < -128) ? -128 : iResult;
+    qResult = (qResult > 127) ? 127 : qResult;
+    qResult = (qResult < -128) ? -128 : qResult;
+
+    correctedBufferPtr[i] = (int8_t)iResult;
+    correctedBufferPtr[i+1] = (int8_t)qResult;
+  } // for
+
+  if (i < bufferLength)
+  {
+    // A stray value at the end is passed along.
+    correctedBufferPtr[i] = signalBufferPtr[i];
+  } // if
+
+  return;
+
+} // correctSamples
+
+/*****************************************************************************
+
+  Name: reportQuality
+
+  Purpose: The purpose of this function is to write the current estimates
+  to the report stream.  Each report is a line of comma separated values:
+  IQ, dcOffsetI, dcOffsetQ, gainImbalanceInDb, phaseErrorInDegrees,
+  clipPercentage.
+
+  Calling Sequence: reportQuality()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void IqCorrector::reportQuality(void)
+{
+
+  if (reportStreamPtr == NULL)
+  {
+    // Nowhere to write.
+    return;
+  } // if
+
+  fprintf(reportStreamPtr,"IQ,%.2f,%.2f,%.2f,%.2f,%.3f\n",
+          quality.dcOffsetI,
+          quality.dcOffsetQ,
+          quality.gainImbalanceInDb,
+          quality.phaseErrorInDegrees,
+          quality.clipPercentage);
+
+  fflush(reportStreamPtr);
+
+  return;
+
+} // reportQuality
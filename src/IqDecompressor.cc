@@ -0,0 +1,413 @@
+//************************************************************************
+// file name: IqDecompressor.cc
+//************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "IqDecompressor.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: IqDecompressor
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an IqDecompressor.  The file header is read and checked.
+
+  Calling Sequence: IqDecompressor(streamPtr)
+
+  Inputs:
+
+    streamPtr - The stream that the compressed data is read from.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+IqDecompressor::IqDecompressor(FILE *streamPtr)
+{
+  uint8_t header[IQZ_FILE_HEADER_SIZE];
+
+  // Retrieve for later use.
+  this->streamPtr = streamPtr;
+
+  compressedPtr = new uint8_t[IQZ_MAX_COMPRESSED_SIZE];
+  rawPtr = new uint8_t[IQZ_BLOCK_SIZE];
+  rawLength = 0;
+  position = 0;
+
+  // The index is loaded when it's needed.
+  blockOffsetsPtr = NULL;
+  numberOfBlocks = 0;
+
+  valid = false;
+
+  if (fread(header,1,sizeof(header),streamPtr) == sizeof(header))
+  {
+    if (memcmp(header,"IQZ1",4) == 0)
+    {
+      // The buffers are only big enough for our own block size.
+      valid = (IqCodec::getUint32(&header[4]) == IQZ_BLOCK_SIZE);
+    } // if
+  } // if
+
+  if (!valid)
+  {
+    fprintf(stderr,"The input is not compressed IQ data\n");
+  } // if
+
+  endOfStream = !valid;
+
+  return;
+
+} // IqDecompressor
+
+/*****************************************************************************
+
+  Name: ~IqDecompressor
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an IqDecompressor.
+
+  Calling Sequence: ~IqDecompressor()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+IqDecompressor::~IqDecompressor(void)
+{
+
+  // Release resources.
+  delete[] compressedPtr;
+  delete[] rawPtr;
+
+  if (blockOffsetsPtr != NULL)
+  {
+    delete[] blockOffsetsPtr;
+  } // if
+
+  return;
+
+} // ~IqDecompressor
+
+/*****************************************************************************
+
+  Name: isValid
+
+  Purpose: The purpose of this function is to indicate whether the stream
+  started with a valid header.
+
+  Calling Sequence: valid = isValid()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    valid - A flag that indicates whether the stream is compressed IQ
+    data.
+
+*****************************************************************************/
+bool IqDecompressor::isValid(void)
+{
+
+  return (valid);
+
+} // isValid
+
+/*****************************************************************************
+
+  Name: readSamples
+
+  Purpose: The purpose of this function is to read IQ data from the
+  compressed stream, in the manner of fread().
+
+  Calling Sequence: count = readSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to storage for the IQ data.
+
+    bufferLength - The number of values to read.
+
+ Outputs:
+
+    signalBufferPtr - The IQ data.
+
+    count - The number of values that were read.  This is less than
+    bufferLength only at the end of the stream.
+
+*****************************************************************************/
+uint32_t IqDecompressor::readSamples(int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t count;
+  uint32_t length;
+
+  count = 0;
+
+  while (count < bufferLength)
+  {
+    if (position == rawLength)
+    {
+      if (!readBlock())
+      {
+        // There's no more.
+        break;
+      } // if
+    } // if
+
+    length = rawLength - position;
+
+    if (length > (bufferLength - count))
+    {
+      length = bufferLength - count;
+    } // if
+
+    memcpy(&signalBufferPtr[count],&rawPtr[position],length);
+    position += length;
+    count += length;
+  } // while
+
+  return (count);
+
+} // readSamples
+
+/*****************************************************************************
+
+  Name: seek
+
+  Purpose: The purpose of this function is to move to an offset in the
+  IQ data.  Only the block that holds the offset is decoded.
+
+  Calling Sequence: success = seek(offset)
+
+  Inputs:
+
+    offset - The offset, in bytes of IQ data from the start of the data.
+
+ Outputs:
+
+    success - A flag that indicates whether the move happened.  A value of
+    false indicates that the stream can't seek (a pipe, for example) or
+    has no index.  An offset past the end of the data leaves the stream
+    at its end.
+
+*****************************************************************************/
+bool IqDecompressor::seek(uint64_t offset)
+{
+  uint32_t block;
+
+  if (!loadIndex())
+  {
+    return (false);
+  } // if
+
+  block = (uint32_t)(offset / IQZ_BLOCK_SIZE);
+
+  // Nothing is buffered now.
+  rawLength = 0;
+  position = 0;
+
+  if (block >= numberOfBlocks)
+  {
+    endOfStream = true;
+    return (true);
+  } // if
+
+  if (fseeko(streamPtr,(off_t)blockOffsetsPtr[block],SEEK_SET) != 0)
+  {
+    endOfStream = true;
+    return (false);
+  } // if
+
+  endOfStream = false;
+
+  if (readBlock())
+  {
+    position = (uint32_t)(offset % IQZ_BLOCK_SIZE);
+
+    if (position > rawLength)
+    {
+      position = rawLength;
+    } // if
+  } // if
+
+  return (true);
+
+} // seek
+
+/*****************************************************************************
+
+  Name: readBlock
+
+  Purpose: The purpose of this function is to read and decode the next
+  block of the stream.
+
+  Calling Sequence: success = readBlock()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    success - A flag that indicates whether a block was read.  A value of
+    false indicates the end of the stream, or a corrupt block.
+
+*****************************************************************************/
+bool IqDecompressor::readBlock(void)
+{
+  uint32_t payloadLength;
+
+  rawLength = 0;
+  position = 0;
+
+  if (endOfStream)
+  {
+    return (false);
+  } // if
+
+  if (fread(compressedPtr,1,IQZ_BLOCK_HEADER_SIZE,streamPtr) !=
+      IQZ_BLOCK_HEADER_SIZE)
+  {
+    // The stream was cut short, which happens when a capture is killed.
+    endOfStream = true;
+    return (false);
+  } // if
+
+  payloadLength = IqCodec::getUint32(&compressedPtr[4]);
+
+  if ((IqCodec::getUint32(&compressedPtr[0]) == 0) && (payloadLength == 0))
+  {
+    // This is the end block.
+    endOfStream = true;
+    return (false);
+  } // if
+
+  if (payloadLength > (IQZ_MAX_COMPRESSED_SIZE - IQZ_BLOCK_HEADER_SIZE))
+  {
+    fprintf(stderr,"Corrupt compressed IQ block\n");
+    endOfStream = true;
+    return (false);
+  } // if
+
+  if (fread(&compressedPtr[IQZ_BLOCK_HEADER_SIZE],1,payloadLength,
+            streamPtr) != payloadLength)
+  {
+    endOfStream = true;
+    return (false);
+  } // if
+
+  if (!codec.decompressBlock(compressedPtr,
+                             IQZ_BLOCK_HEADER_SIZE + payloadLength,
+                             rawPtr,
+                             &rawLength))
+  {
+    fprintf(stderr,"Corrupt compressed IQ block\n");
+    rawLength = 0;
+    endOfStream = true;
+    return (false);
+  } // if
+
+  return (rawLength > 0);
+
+} // readBlock
+
+/*****************************************************************************
+
+  Name: loadIndex
+
+  Purpose: The purpose of this function is to load the block index from
+  the end of the stream.  If that can't be done, the stream is left
+  where it was.
+
+  Calling Sequence: success = loadIndex()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    success - A flag that indicates whether the index is loaded.
+
+*****************************************************************************/
+bool IqDecompressor::loadIndex(void)
+{
+  uint32_t i;
+  off_t savedOffset;
+  uint64_t indexOffset;
+  uint8_t buffer[IQZ_TRAILER_SIZE];
+  bool success;
+
+  if (blockOffsetsPtr != NULL)
+  {
+    // It's already here.
+    return (true);
+  } // if
+
+  if (!valid)
+  {
+    return (false);
+  } // if
+
+  savedOffset = ftello(streamPtr);
+
+  if (savedOffset < 0)
+  {
+    // Pipes can't seek.
+    return (false);
+  } // if
+
+  success = false;
+
+  if (fseeko(streamPtr,-IQZ_TRAILER_SIZE,SEEK_END) == 0)
+  {
+    if (fread(buffer,1,IQZ_TRAILER_SIZE,streamPtr) == IQZ_TRAILER_SIZE)
+    {
+      if (memcmp(&buffer[12],"IQZI",4) == 0)
+      {
+        indexOffset = IqCodec::getUint64(&buffer[0]);
+        numberOfBlocks = IqCodec::getUint32(&buffer[8]);
+
+        if (fseeko(streamPtr,(off_t)indexOffset,SEEK_SET) == 0)
+        {
+          blockOffsetsPtr = new uint64_t[numberOfBlocks + 1];
+          success = true;
+
+          for (i = 0; (i < numberOfBlocks) && success; i++)
+          {
+            success = (fread(buffer,1,8,streamPtr) == 8);
+            blockOffsetsPtr[i] = IqCodec::getUint64(buffer);
+          } // for
+        } // if
+      } // if
+    } // if
+  } // if
+
+  if (!success)
+  {
+    if (blockOffsetsPtr != NULL)
+    {
+      delete[] blockOffsetsPtr;
+      blockOffsetsPtr = NULL;
+    } // if
+
+    numberOfBlocks = 0;
+    fseeko(streamPtr,savedOffset,SEEK_SET);
+  } // if
+
+  return (success);
+
+} // loadIndex
@@ -0,0 +1,523 @@
+//************************************************************************
+// file name: LatencyMonitor.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "LatencyMonitor.h"
+
+// Statistics are reported this often (in nanoseconds).
+#define REPORT_INTERVAL (10000000000ULL)
+
+// The first bin starts here (in nanoseconds).
+#define LATENCY_MINIMUM (10000.0)
+
+// A marker block starts with this, followed by an 8-byte timestamp.
+static const int8_t markerSignature[16] =
+{
+  'S','A','-','L','A','T','E','N','C','Y','-','M','A','R','K',0
+};
+
+#define MARKER_TIMESTAMP_OFFSET (16)
+#define MARKER_TONE_OFFSET (24)
+
+// The rest of a marker block is a tone at 1/8 of the sample rate.
+static const int8_t markerTone[8] = {100, 71, 0, -71, -100, -71, 0, 71};
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: LatencyMonitor
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an LatencyMonitor.
+
+  Calling Sequence: LatencyMonitor()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+LatencyMonitor::LatencyMonitor(void)
+{
+
+  memset(&displayLatency,0,sizeof(displayLatency));
+  memset(&markerLatency,0,sizeof(markerLatency));
+  memset(&inputLatency,0,sizeof(inputLatency));
+
+  // Nothing is waiting for a frame.
+  oldestReadTime = 0;
+  numberOfPendingMarkers = 0;
+
+  lastReportTime = getTimeInNs();
+
+  return;
+
+} // LatencyMonitor
+
+/*****************************************************************************
+
+  Name: ~LatencyMonitor
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an LatencyMonitor.  The statistics for the whole run are
+  reported.
+
+  Calling Sequence: ~LatencyMonitor()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+LatencyMonitor::~LatencyMonitor(void)
+{
+
+  reportStatistics();
+
+  return;
+
+} // ~LatencyMonitor
+
+/*****************************************************************************
+
+  Name: stampBlock
+
+  Purpose: The purpose of this function is to stamp a block of IQ data
+  that was just read.  This must be called before the samples are
+  converted or corrected, so that a marker block can be recognized.
+
+  Calling Sequence: stampBlock(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to the block, exactly as it was read.
+
+    bufferLength - The number of values in the block.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void LatencyMonitor::stampBlock(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint64_t now;
+  uint64_t markerTime;
+
+  now = getTimeInNs();
+
+  if (oldestReadTime == 0)
+  {
+    // This is the first block of a frame.
+    oldestReadTime = now;
+  } // if
+
+  if (readMarker(signalBufferPtr,bufferLength,&markerTime))
+  {
+    // The sender's clock must be behind ours.
+    if (markerTime <= now)
+    {
+      record(&inputLatency,now - markerTime);
+
+      if (numberOfPendingMarkers < MAX_PENDING_MARKERS)
+      {
+        pendingMarkers[numberOfPendingMarkers] = markerTime;
+        numberOfPendingMarkers++;
+      } // if
+    } // if
+  } // if
+
+  return;
+
+} // stampBlock
+
+/*****************************************************************************
+
+  Name: frameDisplayed
+
+  Purpose: The purpose of this function is to record the latencies of a
+  frame that has made it to the screen.  The renderer should have been
+  synchronized first, so that the frame really is on the screen.
+
+  Calling Sequence: frameDisplayed()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void LatencyMonitor::frameDisplayed(void)
+{
+  uint32_t i;
+  uint64_t now;
+
+  if (oldestReadTime == 0)
+  {
+    // Nothing new was shown.
+    return;
+  } // if
+
+  now = getTimeInNs();
+
+  record(&displayLatency,now - oldestReadTime);
+
+  for (i = 0; i < numberOfPendingMarkers; i++)
+  {
+    record(&markerLatency,now - pendingMarkers[i]);
+  } // for
+
+  // Start a new frame.
+  oldestReadTime = 0;
+  numberOfPendingMarkers = 0;
+
+  if ((now - lastReportTime) >= REPORT_INTERVAL)
+  {
+    reportStatistics();
+    lastReportTime = now;
+  } // if
+
+  return;
+
+} // frameDisplayed
+
+/*****************************************************************************
+
+  Name: getTimeInNs
+
+  Purpose: The purpose of this function is to read the monotonic clock.
+  The monotonic clock is shared by every process on the machine, so the
+  timestamps of marker blocks can be compared with it.
+
+  Calling Sequence: now = getTimeInNs()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    now - The current time in nanoseconds.
+
+*****************************************************************************/
+uint64_t LatencyMonitor::getTimeInNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC,&now);
+
+  return (((uint64_t)now.tv_sec * 1000000000ULL) + now.tv_nsec);
+
+} // getTimeInNs
+
+/*****************************************************************************
+
+  Name: writeMarker
+
+  Purpose: The purpose of this function is to turn a block of IQ data
+  into a marker block.  The block starts with a signature and the
+  timestamp, and the rest of it is a tone at 1/8 of the sample rate, so
+  the marker can be seen on the display too.  The sample stream must
+  be read in blocks that start where the marker block starts.
+
+  Calling Sequence: writeMarker(signalBufferPtr,bufferLength,timestamp)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to the block.
+
+    bufferLength - The number of values in the block.  Blocks shorter
+    than LATENCY_MARKER_MINIMUM_LENGTH are left alone.
+
+    timestamp - The time, from getTimeInNs(), that the block is sent.
+
+ Outputs:
+
+    signalBufferPtr - The marker block.
+
+*****************************************************************************/
+void LatencyMonitor::writeMarker(int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  uint64_t timestamp)
+{
+  uint32_t i;
+
+  if (bufferLength < LATENCY_MARKER_MINIMUM_LENGTH)
+  {
+    // Not enough room.
+    return;
+  } // if
+
+  memcpy(signalBufferPtr,markerSignature,sizeof(markerSignature));
+
+  for (i = 0; i < 8; i++)
+  {
+    // Least significant byte first.
+    signalBufferPtr[MARKER_TIMESTAMP_OFFSET + i] =
+      (int8_t)(timestamp >> (8 * i));
+  } // for
+
+  for (i = MARKER_TONE_OFFSET; (i + 2) <= bufferLength; i += 2)
+  {
+    // I leads Q by a quarter cycle.
+    signalBufferPtr[i] = markerTone[(i / 2) & 7];
+    signalBufferPtr[i+1] = markerTone[((i / 2) + 6) & 7];
+  } // for
+
+  return;
+
+} // writeMarker
+
+/*****************************************************************************
+
+  Name: readMarker
+
+  Purpose: The purpose of this function is to determine whether a block
+  of IQ data is a marker block, and if so, to retrieve its timestamp.
+
+  Calling Sequence: isMarker = readMarker(signalBufferPtr,
+                                          bufferLength,
+                                          timestampPtr)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to the block.
+
+    bufferLength - The number of values in the block.
+
+    timestampPtr - A pointer to storage for the timestamp.
+
+ Outputs:
+
+    timestampPtr - The time that the marker was sent.
+
+    isMarker - A flag that indicates that the block is a marker.
+
+*****************************************************************************/
+bool LatencyMonitor::readMarker(const int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  uint64_t *timestampPtr)
+{
+  uint32_t i;
+  uint64_t timestamp;
+
+  if (bufferLength < LATENCY_MARKER_MINIMUM_LENGTH)
+  {
+    return (false);
+  } // if
+
+  if (memcmp(signalBufferPtr,markerSignature,sizeof(markerSignature)) != 0)
+  {
+    return (false);
+  } // if
+
+  timestamp = 0;
+
+  for (i = 0; i < 8; i++)
+  {
+    timestamp |=
+      (uint64_t)(uint8_t)signalBufferPtr[MARKER_TIMESTAMP_OFFSET + i] <<
+      (8 * i);
+  } // for
+
+  *timestampPtr = timestamp;
+
+  return (true);
+
+} // readMarker
+
+/*****************************************************************************
+
+  Name: record
+
+  Purpose: The purpose of this function is to add a latency to a
+  histogram.
+
+  Calling Sequence: record(histogramPtr,latency)
+
+  Inputs:
+
+    histogramPtr - A pointer to the histogram.
+
+    latency - The latency in nanoseconds.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void LatencyMonitor::record(LatencyHistogram *histogramPtr,uint64_t latency)
+{
+  int32_t bin;
+
+  if (latency < LATENCY_MINIMUM)
+  {
+    bin = 0;
+  } // if
+  else
+  {
+    bin = (int32_t)(LATENCY_BINS_PER_DECADE *
+                    log10(latency / LATENCY_MINIMUM));
+
+    if (bin >= LATENCY_NUMBER_OF_BINS)
+    {
+      bin = LATENCY_NUMBER_OF_BINS - 1;
+    } // if
+  } // else
+
+  histogramPtr->counts[bin]++;
+  histogramPtr->total++;
+
+  if (latency > histogramPtr->maximum)
+  {
+    histogramPtr->maximum = latency;
+  } // if
+
+  return;
+
+} // record
+
+/*****************************************************************************
+
+  Name: getPercentile
+
+  Purpose: The purpose of this function is to find a percentile of a
+  histogram.  The upper edge of the bin is returned, but never more than
+  the largest latency seen, so the result is never optimistic and is
+  pessimistic by no more than the width of a bin (about 6%).
+
+  Calling Sequence: latencyInMs = getPercentile(histogramPtr,percentile)
+
+  Inputs:
+
+    histogramPtr - A pointer to the histogram.
+
+    percentile - The percentile, from 0 to 100.
+
+ Outputs:
+
+    latencyInMs - The latency in milliseconds.
+
+*****************************************************************************/
+float LatencyMonitor::getPercentile(LatencyHistogram *histogramPtr,
+  float percentile)
+{
+  uint32_t i;
+  uint64_t sum;
+  double target;
+  double latency;
+
+  target = histogramPtr->total * (percentile / 100);
+  sum = 0;
+
+  for (i = 0; i < (LATENCY_NUMBER_OF_BINS - 1); i++)
+  {
+    sum += histogramPtr->counts[i];
+
+    if (sum >= target)
+    {
+      break;
+    } // if
+  } // for
+
+  latency = LATENCY_MINIMUM * pow(10.0,(i + 1.0) / LATENCY_BINS_PER_DECADE);
+
+  if (latency > histogramPtr->maximum)
+  {
+    // Nothing took longer than this.
+    latency = histogramPtr->maximum;
+  } // if
+
+  return ((float)(latency / 1e6));
+
+} // getPercentile
+
+/*****************************************************************************
+
+  Name: reportHistogram
+
+  Purpose: The purpose of this function is to write the percentiles of a
+  histogram to stderr.
+
+  Calling Sequence: reportHistogram(labelPtr,histogramPtr)
+
+  Inputs:
+
+    labelPtr - A pointer to a label for the report.
+
+    histogramPtr - A pointer to the histogram.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void LatencyMonitor::reportHistogram(const char *labelPtr,
+  LatencyHistogram *histogramPtr)
+{
+
+  if (histogramPtr->total == 0)
+  {
+    // Nothing to report.
+    return;
+  } // if
+
+  fprintf(stderr,"%s latency: 50%% %.1fms, 90%% %.1fms, 99%% %.1fms,"
+          " max %.1fms (%llu samples)\n",
+          labelPtr,
+          getPercentile(histogramPtr,50),
+          getPercentile(histogramPtr,90),
+          getPercentile(histogramPtr,99),
+          histogramPtr->maximum / 1e6,
+          (unsigned long long)histogramPtr->total);
+
+  return;
+
+} // reportHistogram
+
+/*****************************************************************************
+
+  Name: reportStatistics
+
+  Purpose: The purpose of this function is to report all of the latency
+  histograms.
+
+  Calling Sequence: reportStatistics()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void LatencyMonitor::reportStatistics(void)
+{
+
+  reportHistogram("Display",&displayLatency);
+  reportHistogram("Marker",&markerLatency);
+  reportHistogram("Input",&inputLatency);
+
+  return;
+
+} // reportStatistics
@@ -0,0 +1,359 @@
+//************************************************************************
+// file name: NullRenderer.cc
+//************************************************************************
+#include "NullRenderer.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: NullRenderer
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an NullRenderer.
+
+  Calling Sequence: NullRenderer()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+NullRenderer::NullRenderer(void)
+{
+
+  return;
+
+} // NullRenderer
+
+/*****************************************************************************
+
+  Name: ~NullRenderer
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an NullRenderer.
+
+  Calling Sequence: ~NullRenderer()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+NullRenderer::~NullRenderer(void)
+{
+
+  return;
+
+} // ~NullRenderer
+
+/*****************************************************************************
+
+  Name: setTitle
+
+  Purpose: The purpose of this function is to ignore a title.
+
+  Calling Sequence: setTitle(titlePtr)
+
+  Inputs:
+
+    titlePtr - The title.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::setTitle(const char *titlePtr)
+{
+
+  (void)titlePtr;
+
+  return;
+
+} // setTitle
+
+/*****************************************************************************
+
+  Name: getFontHeight
+
+  Purpose: The purpose of this function is to retrieve the height of
+  the font.  There isn't one, so the height of the X fixed font is
+  reported so that the layout doesn't change.
+
+  Calling Sequence: fontHeight = getFontHeight()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    fontHeight - The font height in pixels.
+
+*****************************************************************************/
+int NullRenderer::getFontHeight(void)
+{
+
+  return (9);
+
+} // getFontHeight
+
+/*****************************************************************************
+
+  Name: beginFrame
+
+  Purpose: The purpose of this function is to ignore the start of a
+  frame.
+
+  Calling Sequence: beginFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::beginFrame(void)
+{
+
+  return;
+
+} // beginFrame
+
+/*****************************************************************************
+
+  Name: endFrame
+
+  Purpose: The purpose of this function is to ignore the end of a frame.
+
+  Calling Sequence: endFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::endFrame(void)
+{
+
+  return;
+
+} // endFrame
+
+/*****************************************************************************
+
+  Name: setColor
+
+  Purpose: The purpose of this function is to ignore a color change.
+
+  Calling Sequence: setColor(color)
+
+  Inputs:
+
+    color - The color.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::setColor(RenderColor color)
+{
+
+  (void)color;
+
+  return;
+
+} // setColor
+
+/*****************************************************************************
+
+  Name: drawLine
+
+  Purpose: The purpose of this function is to ignore a line.
+
+  Calling Sequence: drawLine(x1,y1,x2,y2)
+
+  Inputs:
+
+    x1,y1 - The start of the line.
+
+    x2,y2 - The end of the line.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::drawLine(int x1,int y1,int x2,int y2)
+{
+
+  (void)x1;
+  (void)y1;
+  (void)x2;
+  (void)y2;
+
+  return;
+
+} // drawLine
+
+/*****************************************************************************
+
+  Name: drawLines
+
+  Purpose: The purpose of this function is to ignore a polyline.
+
+  Calling Sequence: drawLines(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+
+  (void)pointsPtr;
+  (void)numberOfPoints;
+
+  return;
+
+} // drawLines
+
+/*****************************************************************************
+
+  Name: drawSegments
+
+  Purpose: The purpose of this function is to ignore line segments.
+
+  Calling Sequence: drawSegments(segmentsPtr,numberOfSegments)
+
+  Inputs:
+
+    segmentsPtr - A pointer to the segments.
+
+    numberOfSegments - The number of segments.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::drawSegments(RenderSegment *segmentsPtr,
+  uint32_t numberOfSegments)
+{
+
+  (void)segmentsPtr;
+  (void)numberOfSegments;
+
+  return;
+
+} // drawSegments
+
+/*****************************************************************************
+
+  Name: drawPoints
+
+  Purpose: The purpose of this function is to ignore points.
+
+  Calling Sequence: drawPoints(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+
+  (void)pointsPtr;
+  (void)numberOfPoints;
+
+  return;
+
+} // drawPoints
+
+/*****************************************************************************
+
+  Name: drawString
+
+  Purpose: The purpose of this function is to ignore a string.
+
+  Calling Sequence: drawString(x,y,textPtr)
+
+  Inputs:
+
+    x - The horizontal position of the start of the string.
+
+    y - The vertical position of the baseline of the string.
+
+    textPtr - The string.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void NullRenderer::drawString(int x,int y,const char *textPtr)
+{
+
+  (void)x;
+  (void)y;
+  (void)textPtr;
+
+  return;
+
+} // drawString
+
+/*****************************************************************************
+
+  Name: getKeystroke
+
+  Purpose: The purpose of this function is to retrieve the next
+  keystroke.  Nobody can type at this renderer.
+
+  Calling Sequence: key = getKeystroke()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    key - Always 0.
+
+*****************************************************************************/
+int NullRenderer::getKeystroke(void)
+{
+
+  return (0);
+
+} // getKeystroke
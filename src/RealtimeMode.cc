@@ -0,0 +1,500 @@
+//************************************************************************
+// file name: RealtimeMode.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <malloc.h>
+#include <sys/mman.h>
+
+#include "RealtimeMode.h"
+#include "LatencyMonitor.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: RealtimeMode
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an RealtimeMode.  The CPU list is parsed, and if there
+  are helper CPUs, the process is confined to them, so this must be
+  created before any other thread.  If the list only has the CPU of the
+  hot path, the helper CPUs are whatever other CPUs the process may use,
+  since a helper thread that shares a CPU with a SCHED_FIFO thread only
+  runs when that thread waits.  If there are none, that is reported.
+  Memory that is freed is kept by the process, so that it stays locked
+  once it has been locked.
+
+  Calling Sequence: RealtimeMode(cpuListPtr)
+
+  Inputs:
+
+    cpuListPtr - A comma separated list of CPUs and ranges of CPUs, for
+    example "2,4-7".  The first CPU runs the hot path, and the rest run
+    every other thread.  A value of "-" pins nothing.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+RealtimeMode::RealtimeMode(const char *cpuListPtr)
+{
+
+  hotCpu = -1;
+  numberOfHelperCpus = 0;
+  CPU_ZERO(&helperCpus);
+
+  memoryLocked = false;
+  pinned = false;
+  fifoPriority = 0;
+  inHotPath = false;
+  measured = false;
+
+  valid = parseCpuList(cpuListPtr);
+
+  if (!valid)
+  {
+    fprintf(stderr,"Invalid CPU list: %s\n",cpuListPtr);
+    return;
+  } // if
+
+  if ((hotCpu >= 0) && (numberOfHelperCpus == 0))
+  {
+    // Keep the helper threads off the hot CPU if they can go elsewhere.
+    if (sched_getaffinity(0,sizeof(helperCpus),&helperCpus) == 0)
+    {
+      CPU_CLR(hotCpu,&helperCpus);
+      numberOfHelperCpus = CPU_COUNT(&helperCpus);
+    } // if
+    else
+    {
+      CPU_ZERO(&helperCpus);
+    } // else
+
+    if (numberOfHelperCpus == 0)
+    {
+      fprintf(stderr,"Every thread shares CPU %d with the hot path, so"
+              " the demodulator, the capture writer and the other helper"
+              " threads only run when it waits, and may fall behind;"
+              " list a second CPU for them\n",hotCpu);
+    } // if
+  } // if
+
+  if (numberOfHelperCpus > 0)
+  {
+    // Every thread from now on starts out on the helper CPUs.
+    if (sched_setaffinity(0,sizeof(helperCpus),&helperCpus) != 0)
+    {
+      fprintf(stderr,"Could not move the helper threads: %s\n",
+              strerror(errno));
+    } // if
+  } // if
+
+  // Never give memory back, since it would come back unlocked.
+  mallopt(M_TRIM_THRESHOLD,-1);
+
+  return;
+
+} // RealtimeMode
+
+/*****************************************************************************
+
+  Name: ~RealtimeMode
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an RealtimeMode.  What was done is reported, along with
+  the page faults and context switches of the hot path.
+
+  Calling Sequence: ~RealtimeMode()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+RealtimeMode::~RealtimeMode(void)
+{
+
+  if (inHotPath)
+  {
+    leaveHotPath();
+  } // if
+
+  if (measured)
+  {
+    reportStatistics();
+  } // if
+
+  if (memoryLocked)
+  {
+    munlockall();
+  } // if
+
+  return;
+
+} // ~RealtimeMode
+
+/*****************************************************************************
+
+  Name: isValid
+
+  Purpose: The purpose of this function is to indicate whether or not the
+  CPU list made sense.
+
+  Calling Sequence: valid = isValid()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    valid - A flag that indicates whether or not the CPU list was valid.
+
+*****************************************************************************/
+bool RealtimeMode::isValid(void)
+{
+
+  return (valid);
+
+} // isValid
+
+/*****************************************************************************
+
+  Name: enterHotPath
+
+  Purpose: The purpose of this function is to prepare the calling thread
+  to run the hot path.  This should be called once everything has been
+  allocated and every other thread has been started.  The stack is
+  touched, all memory is locked, which faults in every page that hasn't
+  been touched yet, the thread is pinned to its CPU, and it is switched
+  to SCHED_FIFO.  Anything that isn't permitted is reported and skipped.
+  The resource usage of the thread is noted, so that only the faults
+  and context switches of the hot path are reported.
+
+  Calling Sequence: enterHotPath()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void RealtimeMode::enterHotPath(void)
+{
+  cpu_set_t hotCpus;
+  struct sched_param parameters;
+  int status;
+
+  if ((!valid) || inHotPath)
+  {
+    return;
+  } // if
+
+  prefaultStack();
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Lock what is mapped now and whatever is mapped later,
+  // which is only small stuff like stdio buffers.  If the
+  // limit won't allow that, lock what is mapped now.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  memoryLocked = (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+
+  if (!memoryLocked)
+  {
+    memoryLocked = (mlockall(MCL_CURRENT) == 0);
+  } // if
+
+  if (!memoryLocked)
+  {
+    fprintf(stderr,"Could not lock memory (see ulimit -l): %s\n",
+            strerror(errno));
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (hotCpu >= 0)
+  {
+    CPU_ZERO(&hotCpus);
+    CPU_SET(hotCpu,&hotCpus);
+
+    status = pthread_setaffinity_np(pthread_self(),sizeof(hotCpus),&hotCpus);
+    pinned = (status == 0);
+
+    if (!pinned)
+    {
+      fprintf(stderr,"Could not pin the hot path to CPU %d: %s\n",
+              hotCpu,strerror(status));
+    } // if
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Take the middle priority, so that anything that has
+  // been made more urgent by the administrator stays that
+  // way.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  parameters.sched_priority = (sched_get_priority_min(SCHED_FIFO) +
+                               sched_get_priority_max(SCHED_FIFO)) / 2;
+
+  status = pthread_setschedparam(pthread_self(),SCHED_FIFO,&parameters);
+
+  if (status == 0)
+  {
+    fifoPriority = parameters.sched_priority;
+  } // if
+  else
+  {
+    fprintf(stderr,"Running without SCHED_FIFO (needs CAP_SYS_NICE or"
+            " an rtprio limit): %s\n",strerror(status));
+  } // else
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  inHotPath = true;
+
+  // Start counting now.
+  startTime = LatencyMonitor::getTimeInNs();
+  getrusage(RUSAGE_THREAD,&startUsage);
+
+  return;
+
+} // enterHotPath
+
+/*****************************************************************************
+
+  Name: leaveHotPath
+
+  Purpose: The purpose of this function is to stop counting the faults
+  and context switches of the hot path, and to return the calling thread
+  to normal scheduling, so that shutting down doesn't hog its CPU.
+
+  Calling Sequence: leaveHotPath()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void RealtimeMode::leaveHotPath(void)
+{
+  struct sched_param parameters;
+
+  if (!inHotPath)
+  {
+    return;
+  } // if
+
+  getrusage(RUSAGE_THREAD,&endUsage);
+  endTime = LatencyMonitor::getTimeInNs();
+
+  if (fifoPriority != 0)
+  {
+    parameters.sched_priority = 0;
+    pthread_setschedparam(pthread_self(),SCHED_OTHER,&parameters);
+  } // if
+
+  inHotPath = false;
+  measured = true;
+
+  return;
+
+} // leaveHotPath
+
+/*****************************************************************************
+
+  Name: parseCpuList
+
+  Purpose: The purpose of this function is to parse a list of CPUs, such
+  as "2,4-7".  The first CPU is the one for the hot path, and the rest
+  are the helper CPUs.
+
+  Calling Sequence: valid = parseCpuList(cpuListPtr)
+
+  Inputs:
+
+    cpuListPtr - The list of CPUs, or "-" to pin nothing.
+
+ Outputs:
+
+    valid - A flag that indicates whether or not the list was valid.
+
+*****************************************************************************/
+bool RealtimeMode::parseCpuList(const char *cpuListPtr)
+{
+  const char *positionPtr;
+  char *endPtr;
+  long first;
+  long last;
+  long cpu;
+
+  if (strcmp(cpuListPtr,"-") == 0)
+  {
+    // Only lock memory and raise the priority.
+    return (true);
+  } // if
+
+  positionPtr = cpuListPtr;
+
+  while (*positionPtr != '\0')
+  {
+    first = strtol(positionPtr,&endPtr,10);
+
+    if (endPtr == positionPtr)
+    {
+      return (false);
+    } // if
+
+    last = first;
+    positionPtr = endPtr;
+
+    if (*positionPtr == '-')
+    {
+      positionPtr++;
+      last = strtol(positionPtr,&endPtr,10);
+
+      if (endPtr == positionPtr)
+      {
+        return (false);
+      } // if
+
+      positionPtr = endPtr;
+    } // if
+
+    if ((first < 0) || (last < first) || (last >= CPU_SETSIZE))
+    {
+      return (false);
+    } // if
+
+    for (cpu = first; cpu <= last; cpu++)
+    {
+      if (hotCpu < 0)
+      {
+        hotCpu = (int)cpu;
+      } // if
+      else
+      {
+        if ((cpu != hotCpu) && !CPU_ISSET(cpu,&helperCpus))
+        {
+          CPU_SET(cpu,&helperCpus);
+          numberOfHelperCpus++;
+        } // if
+      } // else
+    } // for
+
+    if (*positionPtr == ',')
+    {
+      positionPtr++;
+    } // if
+    else
+    {
+      if (*positionPtr != '\0')
+      {
+        return (false);
+      } // if
+    } // else
+  } // while
+
+  return (hotCpu >= 0);
+
+} // parseCpuList
+
+/*****************************************************************************
+
+  Name: prefaultStack
+
+  Purpose: The purpose of this function is to touch the part of the
+  stack that the hot path is likely to use, so that it is mapped before
+  memory is locked.
+
+  Calling Sequence: prefaultStack()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void RealtimeMode::prefaultStack(void)
+{
+  uint8_t stack[REALTIME_STACK_PREFAULT];
+  volatile uint8_t *touchPtr;
+  uint32_t i;
+
+  // The stores must not be optimized away.
+  touchPtr = stack;
+
+  for (i = 0; i < REALTIME_STACK_PREFAULT; i += 4096)
+  {
+    touchPtr[i] = 0;
+  } // for
+
+  return;
+
+} // prefaultStack
+
+/*****************************************************************************
+
+  Name: reportStatistics
+
+  Purpose: The purpose of this function is to report to stderr what was
+  done for the hot path, and the page faults and context switches that
+  it took anyway.  Involuntary context switches mean that something else
+  ran on its CPU, and voluntary ones are mostly waits for input.
+
+  Calling Sequence: reportStatistics()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void RealtimeMode::reportStatistics(void)
+{
+  char priorityBuffer[32];
+
+  if (fifoPriority != 0)
+  {
+    sprintf(priorityBuffer,"SCHED_FIFO %d",fifoPriority);
+  } // if
+  else
+  {
+    strcpy(priorityBuffer,"normal priority");
+  } // else
+
+  fprintf(stderr,"Realtime: %s, %s, %s, helpers on %u CPUs\n",
+          pinned ? "pinned" : "not pinned",
+          priorityBuffer,
+          memoryLocked ? "memory locked" : "memory not locked",
+          numberOfHelperCpus);
+
+  fprintf(stderr,"Hot path: %.1fs, %ld minor and %ld major page faults,"
+          " %ld involuntary and %ld voluntary context switches\n",
+          (endTime - startTime) / 1e9,
+          endUsage.ru_minflt - startUsage.ru_minflt,
+          endUsage.ru_majflt - startUsage.ru_majflt,
+          endUsage.ru_nivcsw - startUsage.ru_nivcsw,
+          endUsage.ru_nvcsw - startUsage.ru_nvcsw);
+
+  return;
+
+} // reportStatistics
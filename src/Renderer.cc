@@ -0,0 +1,123 @@
+//************************************************************************
+// file name: Renderer.cc
+//************************************************************************
+#include "Renderer.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: ~Renderer
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an Renderer.  Each backend releases its own resources.
+
+  Calling Sequence: ~Renderer()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+Renderer::~Renderer(void)
+{
+
+  return;
+
+} // ~Renderer
+
+/*****************************************************************************
+
+  Name: synchronize
+
+  Purpose: The purpose of this function is to wait until everything that
+  has been drawn is really on the display.  Backends that draw straight
+  into memory are always synchronized, so by default this does nothing.
+
+  Calling Sequence: synchronize()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Renderer::synchronize(void)
+{
+
+  return;
+
+} // synchronize
+
+/*****************************************************************************
+
+  Name: clearArea
+
+  Purpose: The purpose of this function is to erase a rectangle of the
+  display to the background color, so that one part of the display can
+  be redrawn without touching the rest.  Backends that don't keep an
+  image have nothing to erase, so by default this does nothing.
+
+  Calling Sequence: clearArea(x,y,width,height)
+
+  Inputs:
+
+    x - The left edge of the rectangle in pixels.
+
+    y - The top edge of the rectangle in pixels.
+
+    width - The width of the rectangle in pixels.
+
+    height - The height of the rectangle in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void Renderer::clearArea(int x,int y,int width,int height)
+{
+
+  (void)x;
+  (void)y;
+  (void)width;
+  (void)height;
+
+  return;
+
+} // clearArea
+
+/*****************************************************************************
+
+  Name: getPointerPosition
+
+  Purpose: The purpose of this function is to retrieve the horizontal
+  position of the pointer when the last keystroke was made with it (a
+  button press or a scroll wheel step).  Backends without a pointer
+  never have a position.
+
+  Calling Sequence: x = getPointerPosition()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    x - The horizontal position in pixels, or -1 if the last keystroke
+    didn't come from the pointer.
+
+*****************************************************************************/
+int Renderer::getPointerPosition(void)
+{
+
+  return (-1);
+
+} // getPointerPosition
@@ -0,0 +1,826 @@
+//************************************************************************
+// file name: ScopeTrigger.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ScopeTrigger.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: ScopeTrigger
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an ScopeTrigger.  The trigger point is placed one eighth
+  of the way into the sweep, so that what led up to the trigger can be
+  seen.
+
+  Calling Sequence: ScopeTrigger(sweepLength,
+                                 source,
+                                 slope,
+                                 level,
+                                 mode,
+                                 holdoffInSamples)
+
+  Inputs:
+
+    sweepLength - The number of IQ samples in a sweep.
+
+    source - The quantity that is compared against the trigger level.
+    Valid values are TriggerOnMagnitude, TriggerOnI and TriggerOnQ.
+
+    slope - The direction of the crossing.  Valid values are RisingEdge
+    and FallingEdge.
+
+    level - The trigger level.  Magnitudes range from 0 to 191, and I
+    and Q range from -128 to 127.
+
+    mode - The trigger mode.  Valid values are NormalTrigger, AutoTrigger
+    and SingleTrigger.
+
+    holdoffInSamples - The number of samples, after the end of a sweep,
+    for which the trigger is ignored.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+ScopeTrigger::ScopeTrigger(uint32_t sweepLength,
+  TriggerSource source,
+  TriggerSlope slope,
+  int16_t level,
+  TriggerMode mode,
+  uint32_t holdoffInSamples)
+{
+
+  // Retrieve for later use.
+  this->sweepLength = sweepLength;
+  this->source = source;
+  this->slope = slope;
+  this->level = level;
+  this->mode = mode;
+  this->holdoffInSamples = holdoffInSamples;
+
+  // Show a little of what happened before the trigger.
+  preTriggerLength = sweepLength / 8;
+
+  // Blocks are searched a sweep's worth at a time.
+  sourceBufferLength = sweepLength;
+
+  sweepBufferPtr = new int8_t[2 * sweepLength];
+  completedSweepPtr = new int8_t[2 * sweepLength];
+  sourceBufferPtr = new int16_t[sourceBufferLength];
+
+  // Allocate at least one sample so that nothing is special cased.
+  historyPtr = new int8_t[2 * (preTriggerLength + 1)];
+
+  // Nothing has been seen yet.
+  memset(historyPtr,0,2 * (preTriggerLength + 1));
+  previousSourceValue = 0;
+
+  // Wait for the first trigger.
+  state = Armed;
+  samplesWithoutTrigger = 0;
+  holdoffRemaining = 0;
+  autoTriggered = false;
+  sweepSamples = 0;
+  sweepReady = false;
+
+  return;
+
+} // ScopeTrigger
+
+/*****************************************************************************
+
+  Name: ~ScopeTrigger
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an ScopeTrigger.
+
+  Calling Sequence: ~ScopeTrigger()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+ScopeTrigger::~ScopeTrigger(void)
+{
+
+  // Release resources.
+  delete[] sweepBufferPtr;
+  delete[] completedSweepPtr;
+  delete[] sourceBufferPtr;
+  delete[] historyPtr;
+
+  return;
+
+} // ~ScopeTrigger
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to run the trigger over a
+  buffer of IQ data.  Large buffers are handled a sweep's worth of
+  samples at a time.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ScopeTrigger::acceptSamples(const int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t numberOfSamples;
+  uint32_t blockLength;
+
+  numberOfSamples = bufferLength / 2;
+
+  while (numberOfSamples > 0)
+  {
+    blockLength = numberOfSamples;
+
+    if (blockLength > sourceBufferLength)
+    {
+      blockLength = sourceBufferLength;
+    } // if
+
+    processBlock(signalBufferPtr,blockLength);
+
+    // Reference the next block.
+    signalBufferPtr += 2 * blockLength;
+    numberOfSamples -= blockLength;
+  } // while
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: getSweep
+
+  Purpose: The purpose of this function is to retrieve the sweep that was
+  most recently completed.  A sweep is only retrieved once.
+
+  Calling Sequence: available = getSweep(sweepBufferPtr)
+
+  Inputs:
+
+    sweepBufferPtr - A pointer to storage for 2 * sweepLength values.
+    The sweep is formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+ Outputs:
+
+    available - A flag that indicates whether a new sweep was stored.
+
+*****************************************************************************/
+bool ScopeTrigger::getSweep(int8_t *sweepBufferPtr)
+{
+
+  if (!sweepReady)
+  {
+    return (false);
+  } // if
+
+  memcpy(sweepBufferPtr,completedSweepPtr,2 * sweepLength);
+
+  sweepReady = false;
+
+  return (true);
+
+} // getSweep
+
+/*****************************************************************************
+
+  Name: arm
+
+  Purpose: The purpose of this function is to re-arm the trigger after a
+  single sweep has been captured.  In the other modes, the trigger re-arms
+  itself, and this function does nothing.
+
+  Calling Sequence: arm()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ScopeTrigger::arm(void)
+{
+
+  if (state == Stopped)
+  {
+    state = Armed;
+    samplesWithoutTrigger = 0;
+  } // if
+
+  return;
+
+} // arm
+
+/*****************************************************************************
+
+  Name: getStatus
+
+  Purpose: The purpose of this function is to retrieve a short description
+  of the state of the trigger, suitable for annotating a display.
+
+  Calling Sequence: statusPtr = getStatus()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    statusPtr - One of "Trig'd", "Auto", "Ready" or "Stop".
+
+*****************************************************************************/
+const char *ScopeTrigger::getStatus(void)
+{
+  const char *statusPtr;
+
+  switch (state)
+  {
+    case Armed:
+    {
+      statusPtr = autoTriggered ? "Auto" : "Ready";
+      break;
+    } // case
+
+    case Stopped:
+    {
+      statusPtr = "Stop";
+      break;
+    } // case
+
+    default:
+    {
+      statusPtr = autoTriggered ? "Auto" : "Trig'd";
+      break;
+    } // case
+  } // switch
+
+  return (statusPtr);
+
+} // getStatus
+
+/*****************************************************************************
+
+  Name: processBlock
+
+  Purpose: The purpose of this function is to run the trigger state
+  machine over a block of IQ data.  A block may hold the end of one sweep,
+  a holdoff, and the start of the next sweep.
+
+  Calling Sequence: processBlock(signalBufferPtr,numberOfSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    numberOfSamples - The number of IQ samples in the block.  This is no
+    larger than the sweep length.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ScopeTrigger::processBlock(const int8_t *signalBufferPtr,
+  uint32_t numberOfSamples)
+{
+  uint32_t i;
+  uint32_t count;
+  uint32_t samplesUntilAuto;
+  int32_t triggerIndex;
+  bool forced;
+
+  extractSource(signalBufferPtr,numberOfSamples);
+
+  // Reference the first sample.
+  i = 0;
+
+  while (i < numberOfSamples)
+  {
+    switch (state)
+    {
+      case Armed:
+      {
+        triggerIndex = findTrigger(i,numberOfSamples);
+        forced = false;
+
+        if (mode == AutoTrigger)
+        {
+          //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+          // Force a sweep if the trigger hasn't fired for two
+          // sweeps.
+          //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+          samplesUntilAuto = (2 * sweepLength) - samplesWithoutTrigger;
+
+          if ((triggerIndex < 0) ||
+              (((uint32_t)triggerIndex - i) > samplesUntilAuto))
+          {
+            if ((numberOfSamples - i) > samplesUntilAuto)
+            {
+              triggerIndex = i + samplesUntilAuto;
+              forced = true;
+            } // if
+          } // if
+          //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+        } // if
+
+        if (triggerIndex < 0)
+        {
+          // Nothing in the rest of this block.
+          samplesWithoutTrigger += numberOfSamples - i;
+          i = numberOfSamples;
+        } // if
+        else
+        {
+          autoTriggered = forced;
+          samplesWithoutTrigger = 0;
+
+          startSweep(signalBufferPtr,triggerIndex);
+          i = triggerIndex;
+        } // else
+        break;
+      } // case
+
+      case Capturing:
+      {
+        i = continueSweep(signalBufferPtr,i,numberOfSamples);
+        break;
+      } // case
+
+      case HoldingOff:
+      {
+        count = numberOfSamples - i;
+
+        if (count > holdoffRemaining)
+        {
+          count = holdoffRemaining;
+        } // if
+
+        i += count;
+        holdoffRemaining -= count;
+
+        if (holdoffRemaining == 0)
+        {
+          state = Armed;
+        } // if
+        break;
+      } // case
+
+      default:
+      {
+        // Stopped, so nothing happens until the trigger is re-armed.
+        i = numberOfSamples;
+        break;
+      } // case
+    } // switch
+  } // while
+
+  // The next block's first crossing needs these.
+  previousSourceValue = sourceBufferPtr[numberOfSamples - 1];
+  updateHistory(signalBufferPtr,numberOfSamples);
+
+  return;
+
+} // processBlock
+
+/*****************************************************************************
+
+  Name: extractSource
+
+  Purpose: The purpose of this function is to extract the trigger source
+  from a block of IQ data.  The magnitude is estimated the same way that
+  the oscilloscope display estimates it.
+
+  Calling Sequence: extractSource(signalBufferPtr,numberOfSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    numberOfSamples - The number of IQ samples in the block.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ScopeTrigger::extractSource(const int8_t *signalBufferPtr,
+  uint32_t numberOfSamples)
+{
+  uint32_t i;
+  int16_t iMagnitude;
+  int16_t qMagnitude;
+
+  switch (source)
+  {
+    case TriggerOnI:
+    {
+      for (i = 0; i < numberOfSamples; i++)
+      {
+        sourceBufferPtr[i] = signalBufferPtr[2 * i];
+      } // for
+      break;
+    } // case
+
+    case TriggerOnQ:
+    {
+      for (i = 0; i < numberOfSamples; i++)
+      {
+        sourceBufferPtr[i] = signalBufferPtr[(2 * i) + 1];
+      } // for
+      break;
+    } // case
+
+    default:
+    {
+      for (i = 0; i < numberOfSamples; i++)
+      {
+        iMagnitude = abs((int16_t)signalBufferPtr[2 * i]);
+        qMagnitude = abs((int16_t)signalBufferPtr[(2 * i) + 1]);
+
+        if (iMagnitude > qMagnitude)
+        {
+          sourceBufferPtr[i] = iMagnitude + (qMagnitude >> 1);
+        } // if
+        else
+        {
+          sourceBufferPtr[i] = qMagnitude + (iMagnitude >> 1);
+        } // else
+      } // for
+      break;
+    } // case
+  } // switch
+
+  return;
+
+} // extractSource
+
+/*****************************************************************************
+
+  Name: isTriggerPoint
+
+  Purpose: The purpose of this function is to determine whether a pair of
+  consecutive source values crosses the trigger level in the direction of
+  the trigger slope.
+
+  Calling Sequence: crossing = isTriggerPoint(previousValue,value)
+
+  Inputs:
+
+    previousValue - The earlier source value.
+
+    value - The later source value.
+
+ Outputs:
+
+    crossing - A flag that indicates that the level is crossed.
+
+*****************************************************************************/
+bool ScopeTrigger::isTriggerPoint(int16_t previousValue,int16_t value)
+{
+  bool crossing;
+
+  if (slope == RisingEdge)
+  {
+    crossing = (previousValue < level) && (value >= level);
+  } // if
+  else
+  {
+    crossing = (previousValue > level) && (value <= level);
+  } // else
+
+  return (crossing);
+
+} // isTriggerPoint
+
+/*****************************************************************************
+
+  Name: findTrigger
+
+  Purpose: The purpose of this function is to find the first trigger
+  point in the source of the current block.  Eight samples are compared
+  at a time, and only a group that contains a crossing is looked at
+  sample by sample, so the cost is a small fraction of a sample's worth
+  of work per sample.
+
+  Calling Sequence: triggerIndex = findTrigger(startIndex,numberOfSamples)
+
+  Inputs:
+
+    startIndex - The index of the first sample to consider.
+
+    numberOfSamples - The number of IQ samples in the block.
+
+ Outputs:
+
+    triggerIndex - The index of the trigger point, or -1 if there is none.
+
+*****************************************************************************/
+int32_t ScopeTrigger::findTrigger(uint32_t startIndex,uint32_t numberOfSamples)
+{
+  uint32_t i;
+  uint32_t j;
+  bool found;
+#ifdef __SSE2__
+  __m128i previousValues;
+  __m128i values;
+  __m128i levelVector;
+  __m128i crossings;
+#else
+  uint32_t crossings;
+#endif
+
+  // Reference the first sample.
+  i = startIndex;
+
+  if (i == 0)
+  {
+    // The sample before the first one came with the previous block.
+    if (isTriggerPoint(previousSourceValue,sourceBufferPtr[0]))
+    {
+      return (0);
+    } // if
+
+    i = 1;
+  } // if
+
+#ifdef __SSE2__
+  levelVector = _mm_set1_epi16(level);
+#endif
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Compare eight samples at a time.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (; (i + 8) <= numberOfSamples; i += 8)
+  {
+#ifdef __SSE2__
+    previousValues = _mm_loadu_si128((__m128i *)&sourceBufferPtr[i - 1]);
+    values = _mm_loadu_si128((__m128i *)&sourceBufferPtr[i]);
+
+    if (slope == RisingEdge)
+    {
+      // previous < level and not (value < level).
+      crossings = _mm_andnot_si128(_mm_cmplt_epi16(values,levelVector),
+                                   _mm_cmplt_epi16(previousValues,
+                                                   levelVector));
+    } // if
+    else
+    {
+      // previous > level and not (value > level).
+      crossings = _mm_andnot_si128(_mm_cmpgt_epi16(values,levelVector),
+                                   _mm_cmpgt_epi16(previousValues,
+                                                   levelVector));
+    } // else
+
+    found = (_mm_movemask_epi8(crossings) != 0);
+#else
+    crossings = 0;
+
+    for (j = 0; j < 8; j++)
+    {
+      crossings |= isTriggerPoint(sourceBufferPtr[i + j - 1],
+                                  sourceBufferPtr[i + j]);
+    } // for
+
+    found = (crossings != 0);
+#endif
+
+    if (found)
+    {
+      for (j = i; j < (i + 8); j++)
+      {
+        if (isTriggerPoint(sourceBufferPtr[j - 1],sourceBufferPtr[j]))
+        {
+          return ((int32_t)j);
+        } // if
+      } // for
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Handle whatever is left over.
+  for (; i < numberOfSamples; i++)
+  {
+    if (isTriggerPoint(sourceBufferPtr[i - 1],sourceBufferPtr[i]))
+    {
+      return ((int32_t)i);
+    } // if
+  } // for
+
+  return (-1);
+
+} // findTrigger
+
+/*****************************************************************************
+
+  Name: startSweep
+
+  Purpose: The purpose of this function is to start capturing a sweep.
+  The pre-trigger samples are copied from the current block and, if the
+  trigger point is near the start of the block, from the history of the
+  previous blocks.
+
+  Calling Sequence: startSweep(signalBufferPtr,triggerIndex)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    triggerIndex - The index of the trigger point in the block.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ScopeTrigger::startSweep(const int8_t *signalBufferPtr,
+  uint32_t triggerIndex)
+{
+  uint32_t fromHistory;
+
+  if (triggerIndex >= preTriggerLength)
+  {
+    memcpy(sweepBufferPtr,
+           &signalBufferPtr[2 * (triggerIndex - preTriggerLength)],
+           2 * preTriggerLength);
+  } // if
+  else
+  {
+    // The sweep starts in an earlier block.
+    fromHistory = preTriggerLength - triggerIndex;
+
+    memcpy(sweepBufferPtr,
+           &historyPtr[2 * triggerIndex],
+           2 * fromHistory);
+
+    memcpy(&sweepBufferPtr[2 * fromHistory],
+           signalBufferPtr,
+           2 * triggerIndex);
+  } // else
+
+  sweepSamples = preTriggerLength;
+  state = Capturing;
+
+  return;
+
+} // startSweep
+
+/*****************************************************************************
+
+  Name: continueSweep
+
+  Purpose: The purpose of this function is to add samples of the current
+  block to the sweep that is being captured.  When the sweep is complete,
+  it is made available and the trigger moves on to the holdoff.
+
+  Calling Sequence: nextIndex = continueSweep(signalBufferPtr,
+                                              startIndex,
+                                              numberOfSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    startIndex - The index of the first sample to add.
+
+    numberOfSamples - The number of IQ samples in the block.
+
+ Outputs:
+
+    nextIndex - The index of the first sample that wasn't added.
+
+*****************************************************************************/
+uint32_t ScopeTrigger::continueSweep(const int8_t *signalBufferPtr,
+  uint32_t startIndex,
+  uint32_t numberOfSamples)
+{
+  uint32_t count;
+  int8_t *swapPtr;
+
+  count = numberOfSamples - startIndex;
+
+  if (count > (sweepLength - sweepSamples))
+  {
+    count = sweepLength - sweepSamples;
+  } // if
+
+  memcpy(&sweepBufferPtr[2 * sweepSamples],
+         &signalBufferPtr[2 * startIndex],
+         2 * count);
+
+  sweepSamples += count;
+
+  if (sweepSamples == sweepLength)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The sweep is complete, so hand it over by swapping
+    // buffers.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    swapPtr = completedSweepPtr;
+    completedSweepPtr = sweepBufferPtr;
+    sweepBufferPtr = swapPtr;
+
+    sweepReady = true;
+    sweepSamples = 0;
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    if (mode == SingleTrigger)
+    {
+      state = Stopped;
+    } // if
+    else
+    {
+      holdoffRemaining = holdoffInSamples;
+      state = (holdoffRemaining > 0) ? HoldingOff : Armed;
+    } // else
+  } // if
+
+  return (startIndex + count);
+
+} // continueSweep
+
+/*****************************************************************************
+
+  Name: updateHistory
+
+  Purpose: The purpose of this function is to remember the last
+  pre-trigger's worth of samples, so that a sweep can start before the
+  block that holds its trigger point.
+
+  Calling Sequence: updateHistory(signalBufferPtr,numberOfSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    numberOfSamples - The number of IQ samples in the block.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ScopeTrigger::updateHistory(const int8_t *signalBufferPtr,
+  uint32_t numberOfSamples)
+{
+  uint32_t kept;
+
+  if (numberOfSamples >= preTriggerLength)
+  {
+    memcpy(historyPtr,
+           &signalBufferPtr[2 * (numberOfSamples - preTriggerLength)],
+           2 * preTriggerLength);
+  } // if
+  else
+  {
+    // A short block only pushes out part of the history.
+    kept = preTriggerLength - numberOfSamples;
+
+    memmove(historyPtr,&historyPtr[2 * numberOfSamples],2 * kept);
+    memcpy(&historyPtr[2 * kept],signalBufferPtr,2 * numberOfSamples);
+  } // else
+
+  return;
+
+} // updateHistory
@@ -0,0 +1,754 @@
+//************************************************************************
+// file name: SharedRing.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "SharedRing.h"
+
+// How long a consumer sleeps before it checks on the producer, in ms.
+#define RING_SLEEP_TIME (100)
+
+// How long a consumer waits for the ring to be created, in ms.
+#define RING_ATTACH_TIME (5000)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: roundToPages
+
+  Purpose: The purpose of this function is to round a size up to a whole
+  number of pages, which is what the ring is mapped in.
+
+  Calling Sequence: roundedSize = roundToPages(size)
+
+  Inputs:
+
+    size - The size in bytes.
+
+ Outputs:
+
+    roundedSize - The size rounded up to the page size.
+
+*****************************************************************************/
+static uint32_t roundToPages(uint32_t size)
+{
+  uint32_t pageSize;
+
+  pageSize = (uint32_t)sysconf(_SC_PAGESIZE);
+
+  return (((size + pageSize - 1) / pageSize) * pageSize);
+
+} // roundToPages
+
+/*****************************************************************************
+
+  Name: SharedRing
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  the producer of an SharedRing.  The shared memory is created, replacing
+  any ring with the same name that was left behind, and consumers can
+  attach once the ring is marked ready.
+
+  Calling Sequence: SharedRing(namePtr,capacity)
+
+  Inputs:
+
+    namePtr - The name of the ring.
+
+    capacity - The size of the ring in bytes.  It is rounded up to a
+    whole number of pages.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SharedRing::SharedRing(const char *namePtr,uint32_t capacity)
+{
+  int descriptor;
+
+  // Shared memory names start with a slash.
+  snprintf(name,sizeof(name),"%s%s",(namePtr[0] == '/') ? "" : "/",namePtr);
+
+  producer = true;
+  valid = false;
+  headerPtr = NULL;
+  dataPtr = NULL;
+  consumerPtr = NULL;
+
+  this->capacity = roundToPages(capacity);
+  headerSize = roundToPages(sizeof(SharedRingHeader));
+
+  shm_unlink(name);
+
+  descriptor = shm_open(name,O_CREAT | O_EXCL | O_RDWR,0600);
+
+  if (descriptor < 0)
+  {
+    fprintf(stderr,"Could not create shared ring %s: %s\n",
+            name,strerror(errno));
+    return;
+  } // if
+
+  if (ftruncate(descriptor,(off_t)headerSize + this->capacity) == 0)
+  {
+    valid = mapRing(descriptor,this->capacity,true);
+  } // if
+
+  close(descriptor);
+
+  if (!valid)
+  {
+    fprintf(stderr,"Could not map shared ring %s\n",name);
+    shm_unlink(name);
+    return;
+  } // if
+
+  // The new memory is all zeros, so the cursors start at the beginning.
+  headerPtr->capacity = this->capacity;
+  headerPtr->headerSize = headerSize;
+  headerPtr->producerId = (uint32_t)getpid();
+
+  // This tells the consumers that everything else is in place.
+  __atomic_store_n(&headerPtr->magic,SHARED_RING_MAGIC,__ATOMIC_RELEASE);
+
+  return;
+
+} // SharedRing
+
+/*****************************************************************************
+
+  Name: SharedRing
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  a consumer of an SharedRing.  This waits a little while for the
+  producer to create the ring, so the two can be started in either
+  order.  The consumer takes a free slot, or the slot of a consumer
+  that died, and starts with the newest data, or with the first data
+  if it was waiting for the ring.
+
+  Calling Sequence: SharedRing(namePtr)
+
+  Inputs:
+
+    namePtr - The name of the ring.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SharedRing::SharedRing(const char *namePtr)
+{
+  int descriptor;
+  uint32_t i;
+  uint32_t waited;
+  uint64_t expected;
+  uint64_t processId;
+  bool available;
+  uint32_t ringCapacity;
+  uint64_t head;
+  SharedRingHeader *probePtr;
+
+  // Shared memory names start with a slash.
+  snprintf(name,sizeof(name),"%s%s",(namePtr[0] == '/') ? "" : "/",namePtr);
+
+  producer = false;
+  valid = false;
+  headerPtr = NULL;
+  dataPtr = NULL;
+  consumerPtr = NULL;
+  capacity = 0;
+  headerSize = roundToPages(sizeof(SharedRingHeader));
+
+  descriptor = -1;
+  probePtr = (SharedRingHeader *)MAP_FAILED;
+  ringCapacity = 0;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Wait for the producer to create the ring and mark it
+  // ready.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  waited = 0;
+
+  while ((waited < RING_ATTACH_TIME) && (ringCapacity == 0))
+  {
+    if (descriptor < 0)
+    {
+      descriptor = shm_open(name,O_RDWR,0);
+    } // if
+
+    if ((descriptor >= 0) && (probePtr == MAP_FAILED))
+    {
+      probePtr = (SharedRingHeader *)mmap(NULL,headerSize,PROT_READ,
+                                          MAP_SHARED,descriptor,0);
+    } // if
+
+    if (probePtr != MAP_FAILED)
+    {
+      if (__atomic_load_n(&probePtr->magic,__ATOMIC_ACQUIRE) ==
+          SHARED_RING_MAGIC)
+      {
+        ringCapacity = probePtr->capacity;
+      } // if
+    } // if
+
+    if (ringCapacity == 0)
+    {
+      usleep(10000);
+      waited += 10;
+    } // if
+  } // while
+
+  if (probePtr != MAP_FAILED)
+  {
+    munmap(probePtr,headerSize);
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (ringCapacity == 0)
+  {
+    fprintf(stderr,"Shared ring %s isn't there\n",name);
+
+    if (descriptor >= 0)
+    {
+      close(descriptor);
+    } // if
+
+    return;
+  } // if
+
+  capacity = ringCapacity;
+  valid = mapRing(descriptor,capacity,false);
+  close(descriptor);
+
+  if (!valid)
+  {
+    fprintf(stderr,"Could not map shared ring %s\n",name);
+    return;
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Take a slot.  A slot whose process is gone is free.
+  // The process that was checked is part of the word that
+  // is swapped, so if another consumer takes the slot
+  // over first, the swap fails, even if that consumer has
+  // finished attaching by then.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  processId = (uint64_t)getpid();
+
+  for (i = 0; (i < MAX_RING_CONSUMERS) && (consumerPtr == NULL); i++)
+  {
+    expected = __atomic_load_n(&headerPtr->consumers[i].owner,
+                               __ATOMIC_ACQUIRE);
+
+    available = (expected == 0);
+
+    if (!available)
+    {
+      available = (kill((pid_t)(expected >> 32),0) != 0) && (errno == ESRCH);
+    } // if
+
+    if (available &&
+        __atomic_compare_exchange_n(&headerPtr->consumers[i].owner,
+                                    &expected,
+                                    RING_SLOT_OWNER(processId,
+                                                    RING_SLOT_ATTACHING),
+                                    false,
+                                    __ATOMIC_ACQ_REL,
+                                    __ATOMIC_RELAXED))
+    {
+      consumerPtr = &headerPtr->consumers[i];
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (consumerPtr == NULL)
+  {
+    fprintf(stderr,"Shared ring %s already has %d consumers\n",
+            name,MAX_RING_CONSUMERS);
+    valid = false;
+    return;
+  } // if
+
+  consumerPtr->bytesRead = 0;
+  consumerPtr->overruns = 0;
+  consumerPtr->bytesLost = 0;
+  consumerPtr->maximumLag = 0;
+
+  head = __atomic_load_n(&headerPtr->head,__ATOMIC_ACQUIRE);
+
+  if ((waited > 0) && (head <= capacity))
+  {
+    // We were waiting for the producer, so nothing has been missed yet.
+    head = 0;
+  } // if
+
+  // Start with the newest data.
+  __atomic_store_n(&consumerPtr->tail,head,__ATOMIC_RELEASE);
+
+  __atomic_store_n(&consumerPtr->owner,
+                   RING_SLOT_OWNER(processId,RING_SLOT_ACTIVE),
+                   __ATOMIC_RELEASE);
+
+  return;
+
+} // SharedRing
+
+/*****************************************************************************
+
+  Name: ~SharedRing
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SharedRing.  The producer marks the end of the data
+  and removes the name of the ring, and consumers that are attached
+  keep their mappings until they are done.  A consumer gives up its
+  slot.
+
+  Calling Sequence: ~SharedRing()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SharedRing::~SharedRing(void)
+{
+
+  if (headerPtr == NULL)
+  {
+    return;
+  } // if
+
+  if (producer)
+  {
+    __atomic_store_n(&headerPtr->ended,1,__ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&headerPtr->sequence,1,__ATOMIC_SEQ_CST);
+
+    syscall(SYS_futex,&headerPtr->sequence,FUTEX_WAKE,
+            0x7fffffff,NULL,NULL,0);
+
+    shm_unlink(name);
+  } // if
+  else
+  {
+    if (consumerPtr != NULL)
+    {
+      __atomic_store_n(&consumerPtr->owner,0,__ATOMIC_RELEASE);
+    } // if
+  } // else
+
+  if (dataPtr != NULL)
+  {
+    munmap(dataPtr,2 * capacity);
+  } // if
+
+  munmap(headerPtr,headerSize);
+
+  return;
+
+} // ~SharedRing
+
+/*****************************************************************************
+
+  Name: isValid
+
+  Purpose: The purpose of this function is to determine whether the ring
+  was created or attached.
+
+  Calling Sequence: status = isValid()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    status - A flag that indicates whether the ring can be used.  A
+    value of true indicates that it can.
+
+*****************************************************************************/
+bool SharedRing::isValid(void)
+{
+
+  return (valid);
+
+} // isValid
+
+/*****************************************************************************
+
+  Name: reserve
+
+  Purpose: The purpose of this function is to give the producer the
+  place in the ring where the next data goes, so it can be read or
+  generated right there.  Nothing is visible to the consumers until
+  commit() is called.
+
+  Calling Sequence: bufferPtr = reserve(length)
+
+  Inputs:
+
+    length - The most bytes that will be written.  It must be no more
+    than the size of the ring.
+
+ Outputs:
+
+    bufferPtr - A pointer to length contiguous bytes in the ring.
+
+*****************************************************************************/
+int8_t *SharedRing::reserve(uint32_t length)
+{
+  uint64_t head;
+
+  head = headerPtr->head;
+
+  // Consumers check this to see whether their data was overwritten.
+  __atomic_store_n(&headerPtr->reserved,head + length,__ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  return (&dataPtr[head % capacity]);
+
+} // reserve
+
+/*****************************************************************************
+
+  Name: commit
+
+  Purpose: The purpose of this function is to publish data that was
+  written at the place that reserve() gave, and to wake any consumers
+  that are asleep.
+
+  Calling Sequence: commit(length)
+
+  Inputs:
+
+    length - The number of bytes that were written.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SharedRing::commit(uint32_t length)
+{
+
+  __atomic_store_n(&headerPtr->head,headerPtr->head + length,
+                   __ATOMIC_SEQ_CST);
+
+  __atomic_add_fetch(&headerPtr->sequence,1,__ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(&headerPtr->sleepers,__ATOMIC_SEQ_CST) > 0)
+  {
+    syscall(SYS_futex,&headerPtr->sequence,FUTEX_WAKE,
+            0x7fffffff,NULL,NULL,0);
+  } // if
+
+  return;
+
+} // commit
+
+/*****************************************************************************
+
+  Name: acquire
+
+  Purpose: The purpose of this function is to give a consumer its next
+  piece of data, without copying it.  This waits until there is enough
+  data, or until the producer is gone.  If the producer has overwritten
+  data that the consumer hasn't read, the consumer skips to the newest
+  data, and the loss is counted.  The data stays in place until
+  release() is called, unless the consumer falls a whole ring behind.
+
+  Calling Sequence: count = acquire(dataPtrPtr,length)
+
+  Inputs:
+
+    dataPtrPtr - A pointer to storage for a pointer to the data.
+
+    length - The number of bytes that are wanted.  It must be no more
+    than the size of the ring.
+
+ Outputs:
+
+    count - The number of bytes that are available.  This is less than
+    the length only at the end of the data, and a value of 0 indicates
+    that there is no more.
+
+*****************************************************************************/
+uint32_t SharedRing::acquire(const int8_t **dataPtrPtr,uint32_t length)
+{
+  bool done;
+  uint32_t count;
+  uint32_t sequence;
+  uint64_t head;
+  uint64_t tail;
+  uint64_t lag;
+
+  tail = consumerPtr->tail;
+  count = 0;
+  done = false;
+
+  while (!done)
+  {
+    sequence = __atomic_load_n(&headerPtr->sequence,__ATOMIC_SEQ_CST);
+    head = __atomic_load_n(&headerPtr->head,__ATOMIC_SEQ_CST);
+
+    if ((__atomic_load_n(&headerPtr->reserved,__ATOMIC_ACQUIRE) - tail) >
+        capacity)
+    {
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      // We were lapped, so start over with the newest
+      // data.
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      consumerPtr->overruns++;
+      consumerPtr->bytesLost += head - tail;
+      tail = head;
+
+      __atomic_store_n(&consumerPtr->tail,tail,__ATOMIC_RELEASE);
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    } // if
+
+    lag = head - tail;
+
+    if (lag > consumerPtr->maximumLag)
+    {
+      consumerPtr->maximumLag = lag;
+    } // if
+
+    if (lag >= length)
+    {
+      count = length;
+      done = true;
+    } // if
+    else
+    {
+      if (__atomic_load_n(&headerPtr->ended,__ATOMIC_SEQ_CST))
+      {
+        // Whatever is left is all there is.
+        head = __atomic_load_n(&headerPtr->head,__ATOMIC_SEQ_CST);
+        count = (uint32_t)(((head - tail) < length) ? (head - tail) : length);
+        done = true;
+      } // if
+      else
+      {
+        waitForData(sequence);
+      } // else
+    } // else
+  } // while
+
+  *dataPtrPtr = &dataPtr[tail % capacity];
+
+  return (count);
+
+} // acquire
+
+/*****************************************************************************
+
+  Name: release
+
+  Purpose: The purpose of this function is to tell the ring that a
+  consumer is done with the data that acquire() gave it.  If the
+  producer overwrote the data while it was in use, that is counted as
+  an overrun.
+
+  Calling Sequence: release(length)
+
+  Inputs:
+
+    length - The number of bytes that were used.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SharedRing::release(uint32_t length)
+{
+  uint64_t tail;
+
+  tail = consumerPtr->tail;
+
+  // The data was read before this check.
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+  if ((__atomic_load_n(&headerPtr->reserved,__ATOMIC_RELAXED) - tail) >
+      capacity)
+  {
+    consumerPtr->overruns++;
+  } // if
+
+  consumerPtr->bytesRead += length;
+
+  __atomic_store_n(&consumerPtr->tail,tail + length,__ATOMIC_RELEASE);
+
+  return;
+
+} // release
+
+/*****************************************************************************
+
+  Name: reportStatistics
+
+  Purpose: The purpose of this function is to report, to stderr, how
+  much a consumer has read, how far behind the producer it got, and how
+  much it lost.
+
+  Calling Sequence: reportStatistics()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SharedRing::reportStatistics(void)
+{
+
+  if (consumerPtr == NULL)
+  {
+    return;
+  } // if
+
+  fprintf(stderr,"Shared ring %s: %.1fMB read, lag up to %llukB of %ukB,"
+          " %llu overruns, %llukB lost\n",
+          name,
+          consumerPtr->bytesRead / 1000000.0,
+          (unsigned long long)(consumerPtr->maximumLag / 1024),
+          capacity / 1024,
+          (unsigned long long)consumerPtr->overruns,
+          (unsigned long long)(consumerPtr->bytesLost / 1024));
+
+  return;
+
+} // reportStatistics
+
+/*****************************************************************************
+
+  Name: mapRing
+
+  Purpose: The purpose of this function is to map the header and the data
+  of the ring.  The data is mapped twice, one copy right after the
+  other, so that data which wraps around the end of the ring can still
+  be used in place.  Consumers can only read the data.
+
+  Calling Sequence: success = mapRing(descriptor,capacity,producer)
+
+  Inputs:
+
+    descriptor - The descriptor of the shared memory.
+
+    capacity - The size of the data in bytes.
+
+    producer - A flag that indicates whether the producer is mapping the
+    ring.  A value of true indicates that it is.
+
+ Outputs:
+
+    success - A flag that indicates whether the ring was mapped.  A value
+    of true indicates that it was.
+
+*****************************************************************************/
+bool SharedRing::mapRing(int descriptor,uint32_t capacity,bool producer)
+{
+  int protection;
+  void *addressPtr;
+  void *firstPtr;
+  void *secondPtr;
+
+  addressPtr = mmap(NULL,headerSize,PROT_READ | PROT_WRITE,MAP_SHARED,
+                    descriptor,0);
+
+  if (addressPtr == MAP_FAILED)
+  {
+    return (false);
+  } // if
+
+  headerPtr = (SharedRingHeader *)addressPtr;
+
+  // Set aside room for both copies of the data.
+  addressPtr = mmap(NULL,2 * capacity,PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+
+  if (addressPtr == MAP_FAILED)
+  {
+    return (false);
+  } // if
+
+  dataPtr = (int8_t *)addressPtr;
+
+  protection = producer ? (PROT_READ | PROT_WRITE) : PROT_READ;
+
+  firstPtr = mmap(dataPtr,capacity,protection,MAP_SHARED | MAP_FIXED,
+                  descriptor,headerSize);
+
+  secondPtr = mmap(&dataPtr[capacity],capacity,protection,
+                   MAP_SHARED | MAP_FIXED,descriptor,headerSize);
+
+  return ((firstPtr != MAP_FAILED) && (secondPtr != MAP_FAILED));
+
+} // mapRing
+
+/*****************************************************************************
+
+  Name: waitForData
+
+  Purpose: The purpose of this function is to put a consumer to sleep
+  until the producer commits more data.  The sleep is cut short now and
+  then, and if the producer died without saying so, the ring is marked
+  as ended on its behalf.
+
+  Calling Sequence: waitForData(sequence)
+
+  Inputs:
+
+    sequence - The sequence number that was seen with the head.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SharedRing::waitForData(uint32_t sequence)
+{
+  long status;
+  struct timespec timeout;
+
+  timeout.tv_sec = 0;
+  timeout.tv_nsec = RING_SLEEP_TIME * 1000000L;
+
+  __atomic_add_fetch(&headerPtr->sleepers,1,__ATOMIC_SEQ_CST);
+
+  // The sequence changes whenever the head does.
+  status = syscall(SYS_futex,&headerPtr->sequence,FUTEX_WAIT,
+                   sequence,&timeout,NULL,0);
+
+  __atomic_sub_fetch(&headerPtr->sleepers,1,__ATOMIC_SEQ_CST);
+
+  if ((status != 0) && (errno == ETIMEDOUT))
+  {
+    if ((kill((pid_t)headerPtr->producerId,0) != 0) && (errno == ESRCH))
+    {
+      __atomic_store_n(&headerPtr->ended,1,__ATOMIC_SEQ_CST);
+    } // if
+  } // if
+
+  return;
+
+} // waitForData
@@ -11,42 +11,6 @@
 
 using namespace std;
 
-/*****************************************************************************
-
-  Name: XErrorCallback
-
-  Purpose: The purpose of this function is to to handle errors that
-  are generated by X.
-
-  Calling Sequence: XErrorCallback(displayPtr,errorPtr)
- 
-  Inputs:
-
-    displayPtr - A pointer to the display for which the error was
-    generated.
-
-    errorPtr - A pointer to the error event for which the error
-    was generated.
-
- Outputs:
-
-    None.
-
-*****************************************************************************/
-static int XErrorCallback(Display *displayPtr,XErrorEvent *errorPtr)
-{
-  char msg[80];
-
-  // Retrieve the error text
-  XGetErrorText (displayPtr,errorPtr->error_code,msg,80);
-
-  // Display the error message to the user.
-  fprintf(stderr,"%s\n",msg);
-
-  return (0);
-
-} // XErrorCallback
-
 /*****************************************************************************
 
   Name: SignalAnalyzer
@@ -54,13 +18,19 @@ static int XErrorCallback(Display *displayPtr,XErrorEvent *errorPtr)
   Purpose: The purpose of this function is to serve as the constructor for
   an instance of an SignalAnalyzer.
 
-  Calling Sequence: SignalAnalyzer(displayType,
+  Calling Sequence: SignalAnalyzer(rendererPtr,
+                                   displayType,
                                    sampleRate,
                                    verticalGain,
-                                   baselineInDb)
+                                   baselineInDb,
+                                   frameAggregation,
+                                   tablesPtr)
  
   Inputs:
 
+    rendererPtr - A pointer to the renderer that everything is drawn
+    with.
+
     displayType - The type of analyzer display.
 
     sampleRate - The sample rate of incoming IQ data in units of S/s.
@@ -73,15 +43,25 @@ static int XErrorCallback(Display *displayPtr,XErrorEvent *errorPtr)
 
     baselineInDb - The spectrum analyzer reference level in decibels.
 
+    frameAggregation - The way that the power spectra that are computed
+    between display updates are combined.  Valid values are AverageFrames
+    and PeakHoldFrames.
+
+    tablesPtr - A pointer to FFT tables that are shared with other
+    analyzers.  A value of NULL gives the analyzer tables of its own.
+
  Outputs:
 
     None.
 
 *****************************************************************************/
-SignalAnalyzer::SignalAnalyzer(DisplayType displayType,
+SignalAnalyzer::SignalAnalyzer(Renderer *rendererPtr,
+  DisplayType displayType,
   float sampleRate,
   float verticalGain,
-  int32_t baselineInDb)
+  int32_t baselineInDb,
+  FrameAggregation frameAggregation,
+  SpectrumTables *tablesPtr)
 {
   uint32_t i;
 
@@ -98,27 +78,79 @@ SignalAnalyzer::SignalAnalyzer(DisplayType displayType,
   } // if
 
   // Retrieve for later use.
+  this->rendererPtr = rendererPtr;
   this->displayType = displayType;
+  this->sampleRate = sampleRate;
+  this->frameAggregation = frameAggregation;
+
+  // Nothing has been accumulated for display.
+  blocksInFrame = 0;
+  spectraInFrame = 0;
+  sweepsInFrame = 0;
+
+  // An empty envelope isn't drawn.
+  for (i = 0; i < DISPLAY_WIDTH; i++)
+  {
+    envelopeMinimum[i] = 32767;
+    envelopeMaximum[i] = -32768;
+  } // for
 
   // This is the display dimensions in pixels.
-  windowWidthInPixels = 1024;
-  windowHeightInPixels = 256;
+  windowWidthInPixels = DISPLAY_WIDTH;
+  windowHeightInPixels = DISPLAY_HEIGHT;
 
-  // Set strides.
-  spectrumStride = N / windowWidthInPixels;
+  // Set the stride.
   signalStride = N / windowWidthInPixels;
 
-  // Construct the Hanning window array.
-  for (i = 0; i < N; i++)
-  {
-    hanningWindow[i] = 0.5 - 0.5 * cos((2 * M_PI * i)/N);
-  } // for
+  // Default to showing the whole spectrum.
+  viewStart = 0;
+  viewSpan = N;
+
+  // Default to no signal detection.
+  detectorPtr = NULL;
+
+  // Default to no spectral statistics.
+  statisticsPtr = NULL;
+
+  // Default to no channel measurements.
+  meterPtr = NULL;
 
-  // Set up the FFT stuff.
-  initializeFftw();
+  // Default to the display FFT only.
+  highResolutionPtr = NULL;
+  highResolutionTraceValid = false;
 
-  // Do all the cool stuff for X.
-  initializeX();
+  // Default to the absolute spectrum.
+  referencePtr = NULL;
+  differential = false;
+  highlightThresholdInDb = 10;
+
+  // Default to the live trace only.
+  tracesPtr = NULL;
+
+  // Default to a free running oscilloscope.
+  triggerPtr = NULL;
+
+  // Default to the scale that the user asked for.
+  autoScalerPtr = NULL;
+
+  // Default to not knowing the quality of the IQ data.
+  correctorPtr = NULL;
+
+  // Default to no captures.
+  capturePtr = NULL;
+
+  // Set up the signal processing.
+  if (tablesPtr != NULL)
+  {
+    enginePtr = new SpectrumEngine(tablesPtr);
+  } // if
+  else
+  {
+    enginePtr = new SpectrumEngine(N);
+  } // else
+
+  // Name the display after what it shows.
+  updateTitle();
 
   // This sets up information stuff on the scopes.
   initializeAnnotationParameters(sampleRate);
@@ -148,13 +180,8 @@ SignalAnalyzer::SignalAnalyzer(DisplayType displayType,
 SignalAnalyzer::~SignalAnalyzer(void)
 {
 
-  // We're done with this display.
-  XCloseDisplay(displayPtr);
-
-  // Release FFT resources.
-  fftw_destroy_plan(fftPlan);
-  fftw_free(fftInputPtr);
-  fftw_free(fftOutputPtr);
+  // Release resources.
+  delete enginePtr;
 
   return;
 
@@ -162,12 +189,12 @@ SignalAnalyzer::~SignalAnalyzer(void)
 
 /*****************************************************************************
 
-  Name: initializeFftw
+  Name: updateTitle
 
-  Purpose: The purpose of this function is to initialize FFTW so that
-  FFT's can be performed.
+  Purpose: The purpose of this function is to set the title of the
+  display to match the display type.
 
-  Calling Sequence: initializeFftw()
+  Calling Sequence: updateTitle()
 
   Inputs:
 
@@ -178,167 +205,250 @@ SignalAnalyzer::~SignalAnalyzer(void)
     None.
 
 *****************************************************************************/
-void SignalAnalyzer::initializeFftw(void)
+void SignalAnalyzer::updateTitle(void)
 {
-  uint32_t i;
 
-  // Construct the permuted indices.
-  for (i = 0; i < N/2; i++)
+  switch (displayType)
   {
-    fftShiftTable[i] = i + N/2;
-    fftShiftTable[i + N/2] = i;
-  } // for
+    case SignalMagnitude:
+    {
+      rendererPtr->setTitle("Oscilloscope");
+      break;
+    } // case
+
+    case PowerSpectrum:
+    {
+      rendererPtr->setTitle("Spectrum Analyzer");
+      break;
+    } // case
 
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // This block of code sets up FFTW for a size of 8192 points.  This
-  // is the result of N being defined as 8192.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  fftInputPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*N);
-  fftOutputPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*N);
+    case Lissajous:
+    {
+      rendererPtr->setTitle("Lissajous Scope");
+      break;
+    } // case
 
-  fftPlan = fftw_plan_dft_1d(N,fftInputPtr,fftOutputPtr,
-                             FFTW_FORWARD,FFTW_ESTIMATE);
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    default:
+    {
+      rendererPtr->setTitle("Signal Analyzer");
+      break;
+    } // case
+  } // switch
 
   return;
 
-} // initializeFftw
+} // updateTitle
 
 /*****************************************************************************
 
-  Name: initializeX
+  Name: setDisplayType
+
+  Purpose: The purpose of this function is to change the type of the
+  display while the analyzer runs.  Whatever has accumulated for the
+  next frame is thrown away, since it was accumulated for the old
+  display.
 
-  Purpose: The purpose of this function is to perform all of the
-  initialization that is related to launching an X application.
+  Calling Sequence: setDisplayType(displayType)
 
-  Note: For a 16-bit display, the partitioning of the color values
-  are as follows (with r = red, g = green, blue = blue):
+  Inputs:
+
+    displayType - The type of analyzer display.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setDisplayType(DisplayType displayType)
+{
+
+  this->displayType = displayType;
+
+  // Start a new accumulation.
+  blocksInFrame = 0;
+  spectraInFrame = 0;
+  sweepsInFrame = 0;
+
+  updateTitle();
+
+  return;
 
-  r[4:0], g[5:0], blue[4:0] = rrrrr gggggg bbbbb = 16 bits
+} // setDisplayType
 
-  Calling Sequence: initializeX()
+/*****************************************************************************
+
+  Name: setReferenceLevel
+
+  Purpose: The purpose of this function is to change the reference level
+  of the spectrum display.
+
+  Calling Sequence: setReferenceLevel(baselineInDb)
 
   Inputs:
 
+    baselineInDb - The spectrum analyzer reference level in decibels.
+
+ Outputs:
+
     None.
 
+*****************************************************************************/
+void SignalAnalyzer::setReferenceLevel(int32_t baselineInDb)
+{
+
+  this->baselineInDb = baselineInDb;
+
+  return;
+
+} // setReferenceLevel
+
+/*****************************************************************************
+
+  Name: setVerticalGain
+
+  Purpose: The purpose of this function is to change the vertical gain
+  of the display.
+
+  Calling Sequence: setVerticalGain(verticalGain)
+
+  Inputs:
+
+    verticalGain - The vertical gain of the display.
+
  Outputs:
 
     None.
 
 *****************************************************************************/
-void SignalAnalyzer::initializeX(void)
+void SignalAnalyzer::setVerticalGain(float verticalGain)
 {
-  int blackColor;
-  int whiteColor;
-  int screen;
-  Colormap colormap;
-  XColor exact;
-  XColor closest;
-  XEvent event;
 
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Setup X.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Register the X error handler.
-  XSetErrorHandler(XErrorCallback);
+  this->verticalGain = verticalGain;
 
-  // Connect to the X server.
-  displayPtr = XOpenDisplay(NULL);
+  return;
 
-  // Retrieve these two colors.
-  blackColor = BlackPixel(displayPtr,DefaultScreen(displayPtr));
-  whiteColor = WhitePixel(displayPtr,DefaultScreen(displayPtr));
+} // setVerticalGain
 
-  //-------------------------------------------------------
-  // Initialize colors.  These colors will be used
-  // throughout the application.
-  //-------------------------------------------------------
-  // We need these for the color lookup invocations.
-  screen = DefaultScreen(displayPtr);
-  colormap = DefaultColormap(displayPtr,screen);
+/*****************************************************************************
 
-  // Background is midnight blue.
-  XAllocNamedColor(displayPtr,colormap,"midnight blue",&exact,&closest);
-  scopeBackgroundColor = closest.pixel;
+  Name: setSampleRate
 
-  // Grid is yellow.
-  XAllocNamedColor(displayPtr,colormap,"yellow",&exact,&closest);
-  scopeGridColor = closest.pixel;
+  Purpose: The purpose of this function is to change the sample rate
+  that the annotations of the display are computed from.  Only the
+  annotations change; the attached detector, demodulator and so on keep
+  the sample rate that they were built with.
 
-  // Signal is green.
-  XAllocNamedColor(displayPtr,colormap,"green",&exact,&closest);
-  scopeSignalColor = closest.pixel;
-  //-------------------------------------------------------
+  Calling Sequence: setSampleRate(sampleRate)
+
+  Inputs:
 
-  // Create the window.
-  window = XCreateSimpleWindow(displayPtr,
-                               DefaultRootWindow(displayPtr),
-                               0,
-                               0, 
-                               windowWidthInPixels,
-                               windowHeightInPixels,
-                               0,
-                               blackColor,
-                               scopeBackgroundColor);
+    sampleRate - The sample rate of incoming IQ data in units of S/s.
 
-  // We want to get MapNotify events.
-  XSelectInput(displayPtr,window,StructureNotifyMask);
+ Outputs:
 
-  // Create a "Graphics Context".
-  graphicsContext = XCreateGC(displayPtr,window,0,NULL);
+    None.
 
-  // First-time foreground is white.
-  XSetForeground(displayPtr,graphicsContext,whiteColor);
+*****************************************************************************/
+void SignalAnalyzer::setSampleRate(float sampleRate)
+{
 
-  switch (displayType)			
+  if (sampleRate > 0)
   {
-    case SignalMagnitude:
-    {
-      XStoreName(displayPtr,window,"Oscilloscope");
-      break;
-    } // case
+    this->sampleRate = sampleRate;
 
-    case PowerSpectrum:
-    {
-      XStoreName(displayPtr,window,"Spectrum Analyzer");
-      break;
-    } // case
+    initializeAnnotationParameters(sampleRate);
 
-    case Lissajous:
+    if (meterPtr != NULL)
     {
-      XStoreName(displayPtr,window,"Lissajous Scope");
-      break;
-    } // case
+      // The channels are in Hz, so they move to other bins.
+      meterPtr->setSampleRate(sampleRate);
+    } // if
 
-    default:
+    // The peak frequency has to be worked out again.
+    highResolutionTraceValid = false;
+
+    if (referencePtr != NULL)
     {
-      XStoreName(displayPtr,window,"Signal Analyzer");
-      break;
-    } // case
-  } // switch
+      // A reference taken at another rate doesn't line up.
+      referencePtr->setSampleRate(sampleRate);
+    } // if
+  } // if
 
-  // "Map" the window (that is, make it appear on the screen).
-  XMapWindow(displayPtr,window);
+  return;
 
-  // Wait for the MapNotify event.
-  for(;;)
-  {
-    XNextEvent(displayPtr, &event);
+} // setSampleRate
 
-    if (event.type == MapNotify)
-    {
-      break;
-    } // if);
-  } // for
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+/*****************************************************************************
+
+  Name: setFrameAggregation
+
+  Purpose: The purpose of this function is to change the way that the
+  power spectra that are computed between display updates are combined.
+  Whatever has accumulated for the next frame is thrown away, since it
+  was combined the old way.
+
+  Calling Sequence: setFrameAggregation(frameAggregation)
+
+  Inputs:
+
+    frameAggregation - Valid values are AverageFrames and PeakHoldFrames.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setFrameAggregation(FrameAggregation frameAggregation)
+{
+
+  this->frameAggregation = frameAggregation;
+
+  // Start a new accumulation.
+  blocksInFrame = 0;
+  spectraInFrame = 0;
+  sweepsInFrame = 0;
 
-  // Send the request to the server
-  XFlush(displayPtr);
- 
   return;
 
-} // initializeX
+} // setFrameAggregation
+
+/*****************************************************************************
+
+  Name: setSpectrumTables
+
+  Purpose: The purpose of this function is to switch the FFT to a new set
+  of tables, for example to change the window.  Build the tables away
+  from the thread that processes the samples, and call this between
+  blocks.
+
+  Calling Sequence: previousTablesPtr = setSpectrumTables(tablesPtr)
+
+  Inputs:
+
+    tablesPtr - A pointer to the new tables.  They must outlive the
+    analyzer.
+
+ Outputs:
+
+    previousTablesPtr - A pointer to the tables that were in use.  They
+    belong to the caller now.
+
+*****************************************************************************/
+SpectrumTables *SignalAnalyzer::setSpectrumTables(SpectrumTables *tablesPtr)
+{
+  SpectrumTables *previousTablesPtr;
+
+  previousTablesPtr = enginePtr->setTables(tablesPtr);
+
+  if (meterPtr != NULL)
+  {
+    // A new window has a different noise bandwidth.
+    meterPtr->setWindow(enginePtr->getWindow());
+  } // if
+
+  return (previousTablesPtr);
+
+} // setSpectrumTables
 
 /*****************************************************************************
 
@@ -361,11 +471,8 @@ void SignalAnalyzer::initializeX(void)
 void SignalAnalyzer::initializeAnnotationParameters(float sampleRate)
 {
   float sweepTimeInMs;
-  float frequencySpanInKHz;
   float sampleRateInKHz;
   int fontHeight;
-  int fontWidth;
-  XFontStruct *fontInfoPtr;
 
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
   // This is our font stuff.  By experiment, I see that
@@ -377,16 +484,8 @@ void SignalAnalyzer::initializeAnnotationParameters(float sampleRate)
   // characters.  Not too shoddy.  If you need more, just
   // adjust the number.
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // This is deterministic with respect to size.
-  fontInfoPtr = XLoadQueryFont(displayPtr,"fixed");
-
-  XSetFont(displayPtr,
-           graphicsContext,
-           fontInfoPtr->fid);
-
-  // Compute the height and width of the font.
-  fontHeight = fontInfoPtr->ascent - fontInfoPtr->descent;
-  fontWidth = XTextWidth(fontInfoPtr,"A",strlen("A"));
+  // The renderer knows its own font.
+  fontHeight = rendererPtr->getFontHeight();
 
   // Set our vertical positions of the annotations.
   annotationFirstLinePosition = fontHeight + 6;
@@ -410,8 +509,6 @@ void SignalAnalyzer::initializeAnnotationParameters(float sampleRate)
   sweepTimeInMs = N / sampleRate;
   sweepTimeInMs *= 1000;
 
-  // Compute frequency span in kHz.
-  frequencySpanInKHz = sampleRate / 1000;
   sampleRateInKHz = sampleRate / 1000;
 
   // Save in buffers to be displayed in oscilloscope.
@@ -419,8 +516,7 @@ void SignalAnalyzer::initializeAnnotationParameters(float sampleRate)
   sprintf(sweepTimeDivBuffer,"%.2fms/div",sweepTimeInMs/16);
 
   // Save in buffers to be displayed in spectrum analyzer.
-  sprintf(frequencySpanBuffer,"Frequency Span: %.2fkHz",frequencySpanInKHz);
-  sprintf(frequencySpanDivBuffer,"%.2fkHz/div",frequencySpanInKHz/16);
+  updateFrequencyAnnotations();
 
   // Save in buffers to displayed in Lissajous scope.
   sprintf(sampleRateBuffer,"Sample Rate: %.2fkHz",sampleRateInKHz);
@@ -433,12 +529,14 @@ void SignalAnalyzer::initializeAnnotationParameters(float sampleRate)
 
 /*****************************************************************************
 
-  Name: drawGridlines
+  Name: updateFrequencyAnnotations
 
-  Purpose: The purpose of this function is to draw a grid on the
-  analyzer display.
+  Purpose: The purpose of this function is to set up the frequency
+  annotations of the spectrum analyzer for the part of the spectrum
+  that is displayed.  When the display is zoomed, the center frequency,
+  relative to the center of the band, is shown too.
 
-  Calling Sequence: drawGridlines()
+  Calling Sequence: updateFrequencyAnnotations()
 
   Inputs:
 
@@ -449,426 +547,1930 @@ void SignalAnalyzer::initializeAnnotationParameters(float sampleRate)
     None.
 
 *****************************************************************************/
-void SignalAnalyzer::drawGridlines(void)
+void SignalAnalyzer::updateFrequencyAnnotations(void)
 {
-  uint32_t i;
-  int deltaH;
-  int deltaV;
-  int horizontalPosition;
-  int verticalPosition;
-
-  // Compute grid spacing.
-  deltaH = windowWidthInPixels / 16;
-  deltaV = windowHeightInPixels / 4;
+  float frequencySpanInKHz;
+  float centerFrequencyInKHz;
 
-  // Set the grid color.
-  XSetForeground(displayPtr,graphicsContext,scopeGridColor);
+  // Compute frequency span in kHz.
+  frequencySpanInKHz = ((float)viewSpan / N) * (sampleRate / 1000);
 
-  // Compute horizontal position of first vertical grid.
-  horizontalPosition = deltaH;
+  sprintf(frequencySpanBuffer,"Frequency Span: %.2fkHz",frequencySpanInKHz);
 
-  // Draw vertical lines.
-  for (i = 1; i < 16; i++)
+  if (viewSpan == N)
   {
-    XDrawLine(displayPtr,
-              window,
-              graphicsContext,
-              horizontalPosition,
-              0,
-              horizontalPosition,
-              windowHeightInPixels);
-
-    // Compute next horizontal position of vertical grid.
-    horizontalPosition += deltaH;
-  } // for
-
-  // Compute vertical position of first horizontal grid.
-  verticalPosition = deltaV;
-
-  // Draw horozontal lines.
-  for (i = 1; i < 4; i++)
+    sprintf(frequencySpanDivBuffer,"%.2fkHz/div",frequencySpanInKHz/16);
+  } // if
+  else
   {
-    XDrawLine(displayPtr,
-              window,
-              graphicsContext,
-              0,
-              verticalPosition,
-              windowWidthInPixels,
-              verticalPosition);
-
-    // Compute next vertical position of horizontal grid.
-    verticalPosition += deltaV;
-  } // for
-
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Nicely mark the horizontal center.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Bin N/2 is the center of the band.
+    centerFrequencyInKHz = (((float)viewStart + (viewSpan / 2) - (N / 2)) /
+                            N) * (sampleRate / 1000);
 
-  //---------------------------------
-  // Place marks on upper part of
-  // screen.
-  //---------------------------------
-  XDrawLine(displayPtr,
-            window,
-            graphicsContext,
-            (windowWidthInPixels/2) - 1,
-            0,
-            (windowWidthInPixels/2) - 1,
-            5);
-
-  XDrawLine(displayPtr,
-            window,
-            graphicsContext,
-            (windowWidthInPixels/2) + 1,
-            0,
-            (windowWidthInPixels/2) + 1,
-            5);
-
-  //---------------------------------
-  // Place marks on lower part of
-  // screen.
-  //---------------------------------
-  XDrawLine(displayPtr,
-            window,
-            graphicsContext,
-            (windowWidthInPixels/2) - 1,
-            windowHeightInPixels-5,
-            (windowWidthInPixels/2) - 1,
-            windowHeightInPixels);
-
-  XDrawLine(displayPtr,
-            window,
-            graphicsContext,
-            (windowWidthInPixels/2) + 1,
-            windowHeightInPixels-5,
-            (windowWidthInPixels/2) + 1,
-            windowHeightInPixels);
-
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    sprintf(frequencySpanDivBuffer,"%.2fkHz/div @ %+.2fkHz",
+            frequencySpanInKHz/16,
+            centerFrequencyInKHz);
+  } // else
 
-  // Send the request to the server
-  XFlush(displayPtr);
- 
   return;
 
-} // drawGridLines
+} // updateFrequencyAnnotations
 
 /*****************************************************************************
 
-  Name: plotSignalMagnitude
+  Name: setSpectrumView
 
-  Purpose: The purpose of this function is to perform a magnitude plot
-  of IQ data to the display.
+  Purpose: The purpose of this function is to choose the part of the
+  spectrum that is displayed.  The new view is placed so that a
+  particular bin lands on a particular pixel, which is how zooming
+  around the pointer and panning are both done.  The view is kept
+  within the spectrum.
 
-  Calling Sequence: plotSignalMagnitude(signalBufferPtr,bufferLength)
+  Calling Sequence: setSpectrumView(span,anchorBin,anchorPixel)
 
   Inputs:
 
-    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
-    formatted with interleaved data as: I1,Q1,I2,Q2,...
+    span - The number of FFT bins to display.  This is limited to
+    MINIMUM_VIEW_SPAN through N.
 
-    bufferLength - The number of values in the signal buffer.  This
-    represents the total number of items in the buffer, rather than
-    the number of IQ sample pairs in the buffer.
+    anchorBin - The FFT bin that is to be displayed at anchorPixel.
+
+    anchorPixel - The horizontal position of anchorBin in pixels.
 
  Outputs:
 
     None.
 
 *****************************************************************************/
-void SignalAnalyzer::plotSignalMagnitude(
-  int8_t *signalBufferPtr,
-  uint32_t bufferLength)
+void SignalAnalyzer::setSpectrumView(uint32_t span,
+  uint32_t anchorBin,
+  int anchorPixel)
 {
-  uint32_t i;
-  uint32_t j;
+  int32_t start;
 
-  bufferLength = computeSignalMagnitude(signalBufferPtr,bufferLength);
+  // Keep it sane.
+  span = (span < MINIMUM_VIEW_SPAN) ? MINIMUM_VIEW_SPAN : span;
+  span = (span > N) ? N : span;
 
-  // Reference the start of the points array.
-  j = 0;
+  start = (int32_t)anchorBin -
+          (int32_t)(((int64_t)anchorPixel * span) / windowWidthInPixels);
 
-  // We're fitting an 8192 IQ samples to the display width.
-  for (i = 0; i < bufferLength; i += signalStride)
-  {
-    points[j].x = (short)j;
-    points[j].y = windowHeightInPixels - magnitudeBuffer[i];
+  // Stay within the spectrum.
+  start = (start < 0) ? 0 : start;
+  start = (start > (int32_t)(N - span)) ? (int32_t)(N - span) : start;
 
-    // Reference the next storage location.
-    j++;
-  } // for
+  viewStart = (uint32_t)start;
+  viewSpan = span;
 
-  // Erase the previous plot.
-  XClearWindow(displayPtr,window);
+  updateFrequencyAnnotations();
+
+  return;
+
+} // setSpectrumView
+
+/*****************************************************************************
+
+  Name: getBinAtPixel
+
+  Purpose: The purpose of this function is to find the FFT bin that is
+  displayed at a horizontal position.
+
+  Calling Sequence: bin = getBinAtPixel(pixel)
+
+  Inputs:
+
+    pixel - The horizontal position in pixels.
+
+ Outputs:
+
+    bin - The FFT bin.
+
+*****************************************************************************/
+uint32_t SignalAnalyzer::getBinAtPixel(int pixel)
+{
+
+  // Keep it sane.
+  pixel = (pixel < 0) ? 0 : pixel;
+  pixel = (pixel >= windowWidthInPixels) ? (windowWidthInPixels - 1) : pixel;
+
+  return (viewStart + (uint32_t)(((uint64_t)pixel * viewSpan) /
+                                 windowWidthInPixels));
+
+} // getBinAtPixel
+
+/*****************************************************************************
+
+  Name: processKeystrokes
+
+  Purpose: The purpose of this function is to handle any keystrokes that
+  are pending, without waiting for keystrokes to arrive.  Keystrokes are
+  interpreted as follows:
+
+    r - Reset the max-hold, min-hold and average traces.
+
+    t - Re-arm a single sweep trigger.
+
+    + or = - Zoom the spectrum in by a factor of 2.
+
+    - - Zoom the spectrum out by a factor of 2.
+
+    0 - Show the whole spectrum.
+
+    < or , - Pan the spectrum left by a division.
+
+    > or . - Pan the spectrum right by a division.
+
+    c - Center the spectrum on the pointer (a left click).
+
+    w - Write the data around now to a file (with a capture ring).
+
+    s - Capture a new reference spectrum.
+
+    d - Switch between the absolute and differential spectrum displays.
+
+  When a zoom comes from the scroll wheel, the frequency under the
+  pointer stays put.  Otherwise, the center of the display does.
+
+  Calling Sequence: processKeystrokes()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::processKeystrokes(void)
+{
+  int key;
+  int anchorPixel;
+
+  for (key = rendererPtr->getKeystroke();
+       key != 0;
+       key = rendererPtr->getKeystroke())
+  {
+    switch (key)
+    {
+      case 'r':
+      case 'R':
+      {
+        if (tracesPtr != NULL)
+        {
+          // Start accumulating from scratch.
+          tracesPtr->reset();
+        } // if
+        break;
+      } // case
+
+      case 't':
+      case 'T':
+      {
+        if (triggerPtr != NULL)
+        {
+          // Wait for another single sweep.
+          triggerPtr->arm();
+        } // if
+        break;
+      } // case
+
+      case '+':
+      case '=':
+      case '-':
+      {
+        anchorPixel = rendererPtr->getPointerPosition();
+
+        if (anchorPixel < 0)
+        {
+          // Zoom about the center of the display.
+          anchorPixel = windowWidthInPixels / 2;
+        } // if
+
+        setSpectrumView((key == '-') ? (viewSpan * 2) : (viewSpan / 2),
+                        getBinAtPixel(anchorPixel),
+                        anchorPixel);
+        break;
+      } // case
+
+      case '0':
+      {
+        setSpectrumView(N,0,0);
+        break;
+      } // case
+
+      case '<':
+      case ',':
+      {
+        setSpectrumView(viewSpan,
+                        (viewStart > (viewSpan / 16)) ?
+                        (viewStart - (viewSpan / 16)) : 0,
+                        0);
+        break;
+      } // case
+
+      case '>':
+      case '.':
+      {
+        setSpectrumView(viewSpan,viewStart + (viewSpan / 16),0);
+        break;
+      } // case
+
+      case 'c':
+      case 'C':
+      {
+        anchorPixel = rendererPtr->getPointerPosition();
+
+        if (anchorPixel >= 0)
+        {
+          setSpectrumView(viewSpan,
+                          getBinAtPixel(anchorPixel),
+                          windowWidthInPixels / 2);
+        } // if
+        break;
+      } // case
+
+      case 'w':
+      case 'W':
+      {
+        if (capturePtr != NULL)
+        {
+          capturePtr->trigger("key");
+        } // if
+        break;
+      } // case
+
+      case 's':
+      case 'S':
+      {
+        if (referencePtr != NULL)
+        {
+          // Average the next frames into a new reference.
+          referencePtr->startCapture();
+        } // if
+        break;
+      } // case
+
+      case 'd':
+      case 'D':
+      {
+        // Switch between the absolute and differential displays.
+        differential = !differential;
+        break;
+      } // case
+
+      default:
+      {
+        break;
+      } // case
+    } // switch
+  } // for
+
+  return;
+
+} // processKeystrokes
+
+/*****************************************************************************
+
+  Name: drawGridlines
+
+  Purpose: The purpose of this function is to draw a grid on the
+  analyzer display.
+
+  Calling Sequence: drawGridlines()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawGridlines(void)
+{
+  uint32_t i;
+  int deltaH;
+  int deltaV;
+  int horizontalPosition;
+  int verticalPosition;
+
+  // Compute grid spacing.
+  deltaH = windowWidthInPixels / 16;
+  deltaV = windowHeightInPixels / 4;
+
+  // Set the grid color.
+  rendererPtr->setColor(GridColor);
+
+  // Compute horizontal position of first vertical grid.
+  horizontalPosition = deltaH;
+
+  // Draw vertical lines.
+  for (i = 1; i < 16; i++)
+  {
+    rendererPtr->drawLine(horizontalPosition,
+                          0,
+                          horizontalPosition,
+                          windowHeightInPixels);
+
+    // Compute next horizontal position of vertical grid.
+    horizontalPosition += deltaH;
+  } // for
+
+  // Compute vertical position of first horizontal grid.
+  verticalPosition = deltaV;
+
+  // Draw horozontal lines.
+  for (i = 1; i < 4; i++)
+  {
+    rendererPtr->drawLine(0,
+                          verticalPosition,
+                          windowWidthInPixels,
+                          verticalPosition);
+
+    // Compute next vertical position of horizontal grid.
+    verticalPosition += deltaV;
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Nicely mark the horizontal center.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //---------------------------------
+  // Place marks on upper part of
+  // screen.
+  //---------------------------------
+  rendererPtr->drawLine((windowWidthInPixels/2) - 1,
+                        0,
+                        (windowWidthInPixels/2) - 1,
+                        5);
+
+  rendererPtr->drawLine((windowWidthInPixels/2) + 1,
+                        0,
+                        (windowWidthInPixels/2) + 1,
+                        5);
+
+  //---------------------------------
+  // Place marks on lower part of
+  // screen.
+  //---------------------------------
+  rendererPtr->drawLine((windowWidthInPixels/2) - 1,
+                        windowHeightInPixels-5,
+                        (windowWidthInPixels/2) - 1,
+                        windowHeightInPixels);
+
+  rendererPtr->drawLine((windowWidthInPixels/2) + 1,
+                        windowHeightInPixels-5,
+                        (windowWidthInPixels/2) + 1,
+                        windowHeightInPixels);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // drawGridLines
+
+/*****************************************************************************
+
+  Name: drawSpectrumTrace
+
+  Purpose: The purpose of this function is to draw an auxiliary trace on
+  the spectrum analyzer display.  The trace is scaled exactly as the
+  live spectrum is scaled so that the two line up.
+
+  Calling Sequence: drawSpectrumTrace(traceInDbPtr,color)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to N power values, in decibels, ordered
+    from the lowest frequency to the highest frequency.
+
+    color - The color of the trace.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawSpectrumTrace(float *traceInDbPtr,
+  RenderColor color)
+{
+
+  // We're fitting the bins in view to the display width.
+  enginePtr->binSpectrumSpan(traceInDbPtr,
+                             viewStart,
+                             viewSpan,
+                             binnedTraceBuffer,
+                             windowWidthInPixels);
+
+  drawBinnedTrace(binnedTraceBuffer,color);
+
+  return;
+
+} // drawSpectrumTrace
+
+/*****************************************************************************
+
+  Name: drawBinnedTrace
+
+  Purpose: The purpose of this function is to draw a trace that has
+  already been binned to the display width.
+
+  Calling Sequence: drawBinnedTrace(binnedTraceInDbPtr,color)
+
+  Inputs:
+
+    binnedTraceInDbPtr - A pointer to windowWidthInPixels values in dB.
+
+    color - The color of the trace.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawBinnedTrace(float *binnedTraceInDbPtr,
+  RenderColor color)
+{
+  uint32_t j;
+  float powerInDb;
+
+  for (j = 0; j < (uint32_t)windowWidthInPixels; j++)
+  {
+    // Every trace is scaled the same way so that they line up.
+    powerInDb = (binnedTraceInDbPtr[j] + baselineInDb) * verticalGain * 3.2f;
+
+    points[j].x = (int16_t)j;
+    points[j].y = windowHeightInPixels - (int16_t)powerInDb;
+  } // for
+
+  // Set the trace color.
+  rendererPtr->setColor(color);
+
+  // Plot the trace.
+  rendererPtr->drawLines(points,windowWidthInPixels);
+
+  return;
+
+} // drawBinnedTrace
+
+/*****************************************************************************
+
+  Name: drawHighResolutionTrace
+
+  Purpose: The purpose of this function is to overlay the latest high
+  resolution spectrum on the spectrum display, and to annotate the
+  frequency and level of its strongest point in view along with the
+  resolution bandwidth.  The part of the spectrum that is in view is
+  binned again only when a new spectrum has been computed or the view
+  has changed, so frames in between cost almost nothing.
+
+  Calling Sequence: drawHighResolutionTrace()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawHighResolutionTrace(void)
+{
+  uint64_t numberOfSpectra;
+  uint32_t numberOfPoints;
+  uint32_t pointsPerBin;
+  uint32_t firstPoint;
+  uint32_t numberOfPointsInSpan;
+  double peakPoint;
+  float peakPowerInDb;
+  double peakFrequency;
+
+  if (highResolutionPtr == NULL)
+  {
+    return;
+  } // if
+
+  numberOfSpectra = highResolutionPtr->getNumberOfSpectra();
+
+  if ((!highResolutionTraceValid) ||
+      (numberOfSpectra != highResolutionSpectra) ||
+      (viewStart != highResolutionViewStart) ||
+      (viewSpan != highResolutionViewSpan))
+  {
+    numberOfPoints = highResolutionPtr->getNumberOfPoints();
+    pointsPerBin = numberOfPoints / N;
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // A display bin is centered on every pointsPerBin'th
+    // point, so it covers half of that on either side.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    firstPoint = viewStart * pointsPerBin;
+    firstPoint = (firstPoint >= (pointsPerBin / 2)) ?
+      firstPoint - (pointsPerBin / 2) : 0;
+
+    numberOfPointsInSpan = viewSpan * pointsPerBin;
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    highResolutionTraceValid =
+      highResolutionPtr->binSpectrumSpan(firstPoint,
+                                         numberOfPointsInSpan,
+                                         highResolutionTraceBuffer,
+                                         windowWidthInPixels,
+                                         &peakPoint,
+                                         &peakPowerInDb);
+
+    if (highResolutionTraceValid)
+    {
+      peakFrequency = (peakPoint - (numberOfPoints / 2)) *
+                      ((double)sampleRate / numberOfPoints);
+
+      sprintf(highResolutionPeakBuffer,"Peak: %+.2fHz %.1fdB",
+              peakFrequency,peakPowerInDb);
+
+      // The Hanning window is 1.5 bins wide.
+      sprintf(resolutionBandwidthBuffer,"RBW: %.3fHz (%uk FFT)",
+              1.5 * sampleRate / numberOfPoints,
+              numberOfPoints / 1024);
+    } // if
+
+    highResolutionSpectra = numberOfSpectra;
+    highResolutionViewStart = viewStart;
+    highResolutionViewSpan = viewSpan;
+  } // if
+
+  if (!highResolutionTraceValid)
+  {
+    // There isn't a spectrum yet.
+    return;
+  } // if
+
+  drawBinnedTrace(highResolutionTraceBuffer,HighResolutionColor);
+
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationSecondLinePosition + 30,
+                          highResolutionPeakBuffer);
+
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationSecondLinePosition + 45,
+                          resolutionBandwidthBuffer);
+
+  return;
+
+} // drawHighResolutionTrace
+
+/*****************************************************************************
+
+  Name: drawHighlights
+
+  Purpose: The purpose of this function is to mark the parts of the
+  differential display that are more than highlightThresholdInDb above
+  the reference.  A line is drawn at the threshold, and every column of
+  the trace that rises above it is filled down to the line.  This must
+  be called right after the differential trace has been drawn, since it
+  uses the binned trace and its points.
+
+  Calling Sequence: drawHighlights(offsetInDb)
+
+  Inputs:
+
+    offsetInDb - The offset that was added to the differences.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawHighlights(float offsetInDb)
+{
+  uint32_t j;
+  uint32_t numberOfSegments;
+  float thresholdInDb;
+  int16_t thresholdPosition;
+
+  thresholdInDb = offsetInDb + highlightThresholdInDb;
+
+  thresholdPosition = windowHeightInPixels -
+    (int16_t)((thresholdInDb + baselineInDb) * verticalGain * 3.2f);
+
+  numberOfSegments = 0;
+
+  for (j = 0; j < (uint32_t)windowWidthInPixels; j++)
+  {
+    if (binnedTraceBuffer[j] > thresholdInDb)
+    {
+      segments[numberOfSegments].x1 = (int16_t)j;
+      segments[numberOfSegments].y1 = thresholdPosition;
+      segments[numberOfSegments].x2 = (int16_t)j;
+      segments[numberOfSegments].y2 = points[j].y;
+      numberOfSegments++;
+    } // if
+  } // for
+
+  rendererPtr->setColor(HighlightColor);
+
+  rendererPtr->drawLine(0,
+                        thresholdPosition,
+                        windowWidthInPixels - 1,
+                        thresholdPosition);
+
+  if (numberOfSegments > 0)
+  {
+    rendererPtr->drawSegments(segments,numberOfSegments);
+
+    // Put the trace back on top.
+    rendererPtr->setColor(SignalColor);
+    rendererPtr->drawLines(points,windowWidthInPixels);
+  } // if
+
+  return;
+
+} // drawHighlights
+
+/*****************************************************************************
+
+  Name: drawReferenceStatus
+
+  Purpose: The purpose of this function is to annotate the display with
+  the progress of a reference that is being captured, and with the scale
+  of the differential display.
+
+  Calling Sequence: drawReferenceStatus()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawReferenceStatus(void)
+{
+  char textBuffer[80];
+
+  if (referencePtr == NULL)
+  {
+    return;
+  } // if
+
+  rendererPtr->setColor(HighlightColor);
+
+  if (differential && referencePtr->isAvailable())
+  {
+    rendererPtr->drawString(annotationHorizontalPosition,
+                            annotationSecondLinePosition + 30,
+                            "Differential, 0dB at center");
+
+    sprintf(textBuffer,"Highlight: >%+.1fdB",highlightThresholdInDb);
+
+    rendererPtr->drawString(annotationHorizontalPosition,
+                            annotationSecondLinePosition + 45,
+                            textBuffer);
+  } // if
+
+  if (referencePtr->isCapturing())
+  {
+    sprintf(textBuffer,"Reference: %u/%u frames",
+            referencePtr->getFramesCaptured(),
+            referencePtr->getAveragingLength());
+
+    rendererPtr->drawString(annotationHorizontalPosition,
+                            annotationSecondLinePosition + 60,
+                            textBuffer);
+  } // if
+
+  return;
+
+} // drawReferenceStatus
+
+/*****************************************************************************
+
+  Name: drawIqQuality
+
+  Purpose: The purpose of this function is to annotate the upper left
+  corner of the display with the DC offset, IQ imbalance and clip rate
+  of the IQ data, if they are being measured.
+
+  Calling Sequence: drawIqQuality()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawIqQuality(void)
+{
+  IqQuality quality;
+  char textBuffer[80];
+
+  if (correctorPtr == NULL)
+  {
+    // Nothing is being measured.
+    return;
+  } // if
+
+  correctorPtr->getQuality(&quality);
+
+  rendererPtr->setColor(SignalColor);
+
+  sprintf(textBuffer,"DC: I %+.1f, Q %+.1f",
+          quality.dcOffsetI,quality.dcOffsetQ);
+
+  rendererPtr->drawString(8,annotationFirstLinePosition,textBuffer);
+
+  sprintf(textBuffer,"Imbalance: %+.2fdB, %+.1fdeg",
+          quality.gainImbalanceInDb,quality.phaseErrorInDegrees);
+
+  rendererPtr->drawString(8,annotationSecondLinePosition,textBuffer);
+
+  sprintf(textBuffer,"Clipped: %.3f%%",quality.clipPercentage);
+
+  rendererPtr->drawString(8,annotationSecondLinePosition + 15,textBuffer);
+
+  return;
+
+} // drawIqQuality
+
+/*****************************************************************************
+
+  Name: drawChannelReadings
+
+  Purpose: The purpose of this function is to annotate the upper left
+  corner of the display with the channel power, occupied bandwidth and
+  adjacent channel power ratios of the first few channels, averaged over
+  the frame.  They go below the IQ quality if that is shown.
+
+  Calling Sequence: drawChannelReadings()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::drawChannelReadings(void)
+{
+  uint32_t i;
+  uint32_t numberOfReadings;
+  int position;
+  ChannelReading readings[MAX_METER_CHANNELS];
+  char textBuffer[80];
+
+  if (meterPtr == NULL)
+  {
+    // Nothing is being measured.
+    return;
+  } // if
+
+  numberOfReadings = meterPtr->getReadings(readings);
+
+  // Only a few channels fit.
+  numberOfReadings = (numberOfReadings > 4) ? 4 : numberOfReadings;
+
+  // Stay clear of the IQ quality.
+  position = (correctorPtr != NULL) ?
+    annotationSecondLinePosition + 30 : annotationFirstLinePosition;
+
+  rendererPtr->setColor(SignalColor);
+
+  for (i = 0; i < numberOfReadings; i++)
+  {
+    sprintf(textBuffer,"Ch%u: %.1fdB OBW %.1fkHz ACPR %.1f/%.1fdB",
+            i + 1,
+            readings[i].powerInDb,
+            readings[i].occupiedBandwidth / 1000,
+            readings[i].lowerAcprInDb,
+            readings[i].upperAcprInDb);
+
+    rendererPtr->drawString(8,position,textBuffer);
+
+    position += 15;
+  } // for
+
+  return;
+
+} // drawChannelReadings
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to process a block of IQ data.
+  This should be called for every block of IQ data that arrives.  The
+  results are combined with the results of the other blocks that have
+  arrived since the display was last rendered, so every sample
+  contributes to the display even though the display is rendered at a
+  much lower rate.  For the oscilloscope, the envelope (minimum and
+  maximum) of each display column is accumulated.  For the spectrum
+  analyzer, the power spectra are averaged or peak held.  For the
+  Lissajous scope, every IQ pair lights up its point.
+
+  If a signal detector, spectral statistics, a channel meter or spectrum
+  traces are attached, the power spectrum is computed for every block,
+  regardless of the display type.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::acceptSamples(
+  int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  IqCorrection correction;
+
+  if ((displayType == PowerSpectrum) ||
+      (detectorPtr != NULL) ||
+      (statisticsPtr != NULL) ||
+      (meterPtr != NULL) ||
+      (tracesPtr != NULL))
+  {
+    // Everything that is spectral must see every FFT.
+    computeLogPowerSpectrum(signalBufferPtr,bufferLength);
+  } // if
+
+  if ((correctorPtr != NULL) &&
+      ((displayType != PowerSpectrum) || (highResolutionPtr != NULL)))
+  {
+    if (correctorPtr->getCorrection(&correction))
+    {
+      if (bufferLength > (2 * N))
+      {
+        // Keep it sane.
+        bufferLength = 2 * N;
+      } // if
+
+      // The rest works with 8-bit samples, so round the correction.
+      correctorPtr->correctSamples(signalBufferPtr,
+                                   bufferLength,
+                                   correctedBuffer);
+
+      signalBufferPtr = correctedBuffer;
+    } // if
+  } // if
+
+  if (highResolutionPtr != NULL)
+  {
+    // This only collects the samples.  The FFT runs elsewhere.
+    highResolutionPtr->acceptSamples(signalBufferPtr,bufferLength);
+  } // if
+
+  switch (displayType)
+  {
+    case SignalMagnitude:
+    {
+      if (triggerPtr == NULL)
+      {
+        accumulateSignalMagnitude(signalBufferPtr,bufferLength);
+      } // if
+      else
+      {
+        // Only triggered sweeps are displayed.
+        triggerPtr->acceptSamples(signalBufferPtr,bufferLength);
+
+        if (triggerPtr->getSweep(sweepBuffer))
+        {
+          accumulateSignalMagnitude(sweepBuffer,2 * N);
+        } // if
+      } // else
+      break;
+    } // case
+
+    case PowerSpectrum:
+    {
+      accumulatePowerSpectrum();
+      break;
+    } // case
+
+    case Lissajous:
+    {
+      accumulateLissajous(signalBufferPtr,bufferLength);
+      break;
+    } // case
+
+    default:
+    {
+      break;
+    } // case
+  } // switch
+
+  // Keep track of what is waiting to be displayed.
+  blocksInFrame++;
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: renderDisplay
+
+  Purpose: The purpose of this function is to render everything that has
+  been accumulated since the display was last rendered, and to start a
+  new accumulation.  Pending keystrokes are handled here as well.
+
+  Calling Sequence: renderDisplay()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::renderDisplay(void)
+{
+
+  // Handle any keystrokes.
+  processKeystrokes();
+
+  if (blocksInFrame == 0)
+  {
+    // Nothing new to show.
+    return;
+  } // if
+
+  switch (displayType)
+  {
+    case SignalMagnitude:
+    {
+      plotSignalMagnitude();
+      break;
+    } // case
+
+    case PowerSpectrum:
+    {
+      plotPowerSpectrum();
+      break;
+    } // case
+
+    case Lissajous:
+    {
+      plotLissajous();
+      break;
+    } // case
+
+    default:
+    {
+      break;
+    } // case
+  } // switch
+
+  // Start a new accumulation.
+  blocksInFrame = 0;
+  spectraInFrame = 0;
+  sweepsInFrame = 0;
+
+  return;
+
+} // renderDisplay
+
+/*****************************************************************************
+
+  Name: accumulateSignalMagnitude
+
+  Purpose: The purpose of this function is to fold the magnitude of a
+  block of IQ data into the oscilloscope envelope.  Each display column
+  represents signalStride samples, and the minimum and maximum magnitude
+  of those samples, over all of the blocks of the frame, are kept.
+
+  Calling Sequence: accumulateSignalMagnitude(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::accumulateSignalMagnitude(
+  int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t i;
+  uint32_t j;
+  uint32_t column;
+  uint32_t numberOfColumns;
+  int16_t minimum;
+  int16_t maximum;
+
+  bufferLength = enginePtr->computeSignalMagnitude(signalBufferPtr,
+                                                   bufferLength,
+                                                   magnitudeBuffer);
+
+  // A partial block only covers part of the display.
+  numberOfColumns = bufferLength / signalStride;
+
+  if (sweepsInFrame == 0)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The first block of a frame starts a new envelope.
+    // Columns that this block doesn't cover are left
+    // empty (inverted) so that they don't get drawn.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    for (column = 0; column < (uint32_t)windowWidthInPixels; column++)
+    {
+      envelopeMinimum[column] = 32767;
+      envelopeMaximum[column] = -32768;
+    } // for
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
+
+  // Reference the first sample.
+  i = 0;
+
+  for (column = 0; column < numberOfColumns; column++)
+  {
+    minimum = envelopeMinimum[column];
+    maximum = envelopeMaximum[column];
+
+    for (j = 0; j < signalStride; j++)
+    {
+      if (magnitudeBuffer[i] < minimum)
+      {
+        minimum = magnitudeBuffer[i];
+      } // if
+
+      if (magnitudeBuffer[i] > maximum)
+      {
+        maximum = magnitudeBuffer[i];
+      } // if
+
+      i++;
+    } // for
+
+    envelopeMinimum[column] = minimum;
+    envelopeMaximum[column] = maximum;
+  } // for
+
+  sweepsInFrame++;
+
+  return;
+
+} // accumulateSignalMagnitude
+
+/*****************************************************************************
+
+  Name: accumulatePowerSpectrum
+
+  Purpose: The purpose of this function is to fold the power spectrum
+  that was just computed into the display spectrum.  Depending upon the
+  frame aggregation, the spectra of a frame are either averaged or peak
+  held.  This is done in linear power.
+
+  Calling Sequence: accumulatePowerSpectrum()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::accumulatePowerSpectrum(void)
+{
+  uint32_t i;
+
+  if (spectraInFrame == 0)
+  {
+    // The first spectrum of a frame starts a new accumulation.
+    memcpy(displayPowerBuffer,powerBuffer,sizeof(displayPowerBuffer));
+  } // if
+  else
+  {
+    if (frameAggregation == PeakHoldFrames)
+    {
+      for (i = 0; i < N; i++)
+      {
+        if (powerBuffer[i] > displayPowerBuffer[i])
+        {
+          displayPowerBuffer[i] = powerBuffer[i];
+        } // if
+      } // for
+    } // if
+    else
+    {
+      for (i = 0; i < N; i++)
+      {
+        displayPowerBuffer[i] += powerBuffer[i];
+      } // for
+    } // else
+  } // else
+
+  spectraInFrame++;
+
+  return;
+
+} // accumulatePowerSpectrum
+
+/*****************************************************************************
+
+  Name: accumulateLissajous
+
+  Purpose: The purpose of this function is to fold a block of IQ data
+  into the Lissajous display.  Each IQ pair marks its point in a grid
+  that covers every possible 8-bit IQ value, so the cost of rendering
+  doesn't depend upon how many blocks make up a frame.
+
+  Calling Sequence: accumulateLissajous(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::accumulateLissajous(
+  int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t i;
+  uint32_t index;
+
+  if (blocksInFrame == 0)
+  {
+    // The first block of a frame starts with a clean slate.
+    memset(lissajousGrid,0,sizeof(lissajousGrid));
+  } // if
+
+  for (i = 0; i < bufferLength; i += 2)
+  {
+    // The row is Q and the column is I.
+    index = ((uint32_t)(signalBufferPtr[i+1] + 128) << 8) |
+            (uint32_t)(signalBufferPtr[i] + 128);
+
+    lissajousGrid[index] = 1;
+  } // for
+
+  return;
+
+} // accumulateLissajous
+
+/*****************************************************************************
+
+  Name: plotSignalMagnitude
+
+  Purpose: The purpose of this function is to perform a magnitude plot
+  of IQ data to the display.  Each display column is drawn as a vertical
+  line that spans the envelope of the magnitude of the samples of the
+  column.
+
+  Calling Sequence: plotSignalMagnitude()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::plotSignalMagnitude(void)
+{
+  uint32_t i;
+  uint32_t j;
+
+  // Reference the start of the segments array.
+  j = 0;
+
+  // We're fitting an 8192 IQ samples to the display width.
+  for (i = 0; i < (uint32_t)windowWidthInPixels; i++)
+  {
+    if (envelopeMinimum[i] <= envelopeMaximum[i])
+    {
+      segments[j].x1 = (int16_t)i;
+      segments[j].y1 = windowHeightInPixels - envelopeMinimum[i];
+      segments[j].x2 = (int16_t)i;
+      segments[j].y2 = windowHeightInPixels - envelopeMaximum[i];
+
+      // Reference the next storage location.
+      j++;
+    } // if
+  } // for
+
+  // Erase the previous plot.
+  rendererPtr->beginFrame();
+
+  // Make this display pretty.
+  drawGridlines();
+
+  // Set the signal color.
+  rendererPtr->setColor(SignalColor);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Annotate the display.  This is really too
+  // sensitive to fonts.  I'll think of something
+  // later.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationFirstLinePosition,
+                          sweepTimeBuffer);
+
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationSecondLinePosition,
+                          sweepTimeDivBuffer);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (triggerPtr != NULL)
+  {
+    // Show what the trigger is up to.
+    sprintf(triggerStatusBuffer,"Trigger: %s",triggerPtr->getStatus());
+
+    rendererPtr->drawString(annotationHorizontalPosition,
+                            annotationSecondLinePosition + 15,
+                            triggerStatusBuffer);
+  } // if
+
+  // Plot the signal envelope.
+  rendererPtr->drawSegments(segments,j);
+
+  // Show the quality of the IQ data.
+  drawIqQuality();
+
+  // Show the frame.
+  rendererPtr->endFrame();
+
+  return;
+
+} // plotSignalMagnitude
+
+/*****************************************************************************
+
+  Name: plotPowerSpectrum
+
+  Purpose: The purpose of this function is to perform a power spectrum plot
+  of IQ data to the display.
+
+  Calling Sequence: plotPowerSpectrum()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::plotPowerSpectrum(void)
+{
+  float scale;
+  float offsetInDb;
+  bool showDifference;
+
+  if (frameAggregation == PeakHoldFrames)
+  {
+    scale = 1;
+  } // if
+  else
+  {
+    // Turn the sum into an average.
+    scale = 1.0f / spectraInFrame;
+  } // else
+
+  // Default to the absolute spectrum.
+  showDifference = false;
+
+  if (referencePtr != NULL)
+  {
+    if (referencePtr->accumulate(displayPowerBuffer,scale))
+    {
+      // Show what the new reference is for.
+      differential = true;
+    } // if
+
+    showDifference = differential && referencePtr->isAvailable();
+  } // if
+
+  // The display is 80dB high at unity gain, so no difference is centered.
+  offsetInDb = (40 / verticalGain) - baselineInDb;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Convert to decibels.  This happens once per
+  // frame rather than once per FFT, and only for
+  // the bins that are in view.  The reference is
+  // subtracted in the same pass.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if (showDifference)
+  {
+    enginePtr->convertSpanToRelativeDb(displayPowerBuffer,
+                                       scale,
+                                       referencePtr->getReferenceInDb(),
+                                       offsetInDb,
+                                       traceBuffer,
+                                       viewStart,
+                                       viewSpan);
+  } // if
+  else
+  {
+    enginePtr->convertSpanToDb(displayPowerBuffer,
+                               scale,
+                               traceBuffer,
+                               viewStart,
+                               viewSpan);
+  } // else
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // The scale follows the absolute spectrum only.
+  if ((autoScalerPtr != NULL) && !showDifference)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The scaler looks at exactly what is drawn,
+    // and the scale is set before anything is.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    enginePtr->binSpectrumSpan(traceBuffer,
+                               viewStart,
+                               viewSpan,
+                               binnedTraceBuffer,
+                               windowWidthInPixels);
+
+    autoScalerPtr->accumulate(binnedTraceBuffer,windowWidthInPixels);
+    autoScalerPtr->update(&baselineInDb,&verticalGain);
+
+    // The display is 80dB high, in four divisions, at unity gain.
+    sprintf(scaleBuffer,"Top: %.0fdB, %.0fdB/div",
+            (80 / verticalGain) - baselineInDb,
+            20 / verticalGain);
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
+
+  // Erase the previous plot.
+  rendererPtr->beginFrame();
+
+  // Make this display pretty.
+  drawGridlines();
+
+  // Set the signal color.
+  rendererPtr->setColor(SignalColor);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Annotate the display.  This is really too
+  // sensitive to fonts.  I'll think of something
+  // later.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationFirstLinePosition,
+                          frequencySpanBuffer);
+
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationSecondLinePosition,
+                          frequencySpanDivBuffer);
+
+  if (autoScalerPtr != NULL)
+  {
+    rendererPtr->drawString(annotationHorizontalPosition,
+                            annotationSecondLinePosition + 15,
+                            scaleBuffer);
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Plot the signal.
+  drawSpectrumTrace(traceBuffer,SignalColor);
+
+  if (showDifference)
+  {
+    // Mark whatever has risen above the reference.
+    drawHighlights(offsetInDb);
+  } // if
+
+  // The overlays are absolute, so they aren't shown against a reference.
+  if ((statisticsPtr != NULL) && !showDifference)
+  {
+    // Overlay the noise floor estimate.
+    statisticsPtr->getPercentile(traceBuffer);
+    drawSpectrumTrace(traceBuffer,NoiseFloorColor);
+  } // if
+
+  if ((tracesPtr != NULL) && !showDifference)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Overlay the hold and average traces.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    if (tracesPtr->getTraceModes() & TRACE_MAX_HOLD)
+    {
+      tracesPtr->getMaxHold(traceBuffer);
+      drawSpectrumTrace(traceBuffer,MaxHoldColor);
+    } // if
+
+    if (tracesPtr->getTraceModes() & TRACE_MIN_HOLD)
+    {
+      tracesPtr->getMinHold(traceBuffer);
+      drawSpectrumTrace(traceBuffer,MinHoldColor);
+    } // if
+
+    if (tracesPtr->getTraceModes() & TRACE_AVERAGE)
+    {
+      tracesPtr->getAverage(traceBuffer);
+      drawSpectrumTrace(traceBuffer,AverageColor);
+    } // if
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
+
+  if (!showDifference)
+  {
+    // Overlay the high resolution spectrum.
+    drawHighResolutionTrace();
+  } // if
+
+  // Show what the reference is doing.
+  drawReferenceStatus();
+
+  // Show the quality of the IQ data.
+  drawIqQuality();
+
+  // Show the channel measurements.
+  drawChannelReadings();
+
+  // Show the frame.
+  rendererPtr->endFrame();
+
+  return;
+
+} // plotPowerSpectrum
+
+/*****************************************************************************
+
+  Name: plotLissajous
+
+  Purpose: The purpose of this function is to perform a Lissajous plot
+  of IQ data to the display.  This provides a nice indication as to
+  whether or not the IQ data samples are clipping.  Clipping is indicated
+  by a square pattern.
+
+  Calling Sequence: plotLissajous()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::plotLissajous(void)
+{
+  uint32_t i;
+  uint32_t numberOfPoints;
+
+  // Reference the start of the points array.
+  numberOfPoints = 0;
+
+  // Every IQ pair that showed up during the frame gets plotted.
+  for (i = 0; i < (256 * 256); i++)
+  {
+    if (lissajousGrid[i] != 0)
+    {
+      // The column is I and the row is Q.
+      lissajousPoints[numberOfPoints].x =
+        (windowWidthInPixels / 2) + (int16_t)((int)(i & 0xff) - 128);
+      lissajousPoints[numberOfPoints].y =
+        (windowHeightInPixels / 2) - (int16_t)((int)(i >> 8) - 128);
+
+      numberOfPoints++;
+    } // if
+  } // for
+
+  // Erase the previous plot.
+  rendererPtr->beginFrame();
 
   // Make this display pretty.
   drawGridlines();
 
   // Set the signal color.
-  XSetForeground(displayPtr,graphicsContext,scopeSignalColor);
+  rendererPtr->setColor(SignalColor);
 
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
   // Annotate the display.  This is really too
   // sensitive to fonts.  I'll think of something
   // later.
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  XDrawString(displayPtr,window,graphicsContext,
-              annotationHorizontalPosition,
-              annotationFirstLinePosition,
-              sweepTimeBuffer,strlen(sweepTimeBuffer));
-
-  XDrawString(displayPtr,window,graphicsContext,
-              annotationHorizontalPosition,
-              annotationSecondLinePosition,
-              sweepTimeDivBuffer,strlen(sweepTimeDivBuffer));
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationFirstLinePosition,
+                          sampleRateBuffer);
+
+  rendererPtr->drawString(annotationHorizontalPosition,
+                          annotationSecondLinePosition,
+                          lissajousDivBuffer);
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
 
   // Plot the signal.
-  XDrawLines(displayPtr,
-             window,
-             graphicsContext,
-             points,windowWidthInPixels,
-             CoordModeOrigin);
+  rendererPtr->drawPoints(lissajousPoints,numberOfPoints);
+
+  // Show the quality of the IQ data.
+  drawIqQuality();
 
-  // Send the request to the server
-  XFlush(displayPtr);
+  // Show the frame.
+  rendererPtr->endFrame();
 
   return;
 
-} // plotSignalMagnitude
+} // plotLissajous
 
 /*****************************************************************************
 
-  Name: plotPowerSpectrum
+  Name: setSignalDetector
 
-  Purpose: The purpose of this function is to perform a power spectrum plot
-  of IQ data to the display.
+  Purpose: The purpose of this function is to attach a signal detector
+  to the analyzer.  Once attached, the detector processes every power
+  spectrum that is computed.
 
-  Calling Sequence: plotPowerSpectrum(signalBufferPtr,bufferLength)
+  Calling Sequence: setSignalDetector(detectorPtr)
 
   Inputs:
 
-    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
-    formatted with interleaved data as: I1,Q1,I2,Q2,...
+    detectorPtr - A pointer to the signal detector.  A value of NULL
+    disables detection.
 
-    bufferLength - The number of values in the signal buffer.  This
-    represents the total number of items in the buffer, rather than
-    the number of IQ sample pairs in the buffer.
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setSignalDetector(SpectrumDetector *detectorPtr)
+{
+
+  this->detectorPtr = detectorPtr;
+
+  return;
+
+} // setSignalDetector
+
+/*****************************************************************************
+
+  Name: setSpectrumStatistics
+
+  Purpose: The purpose of this function is to attach a running spectral
+  statistics block to the analyzer.  Once attached, the statistics are
+  updated with every power spectrum that is computed, and the noise
+  floor estimate is overlaid on the spectrum display.
+
+  Calling Sequence: setSpectrumStatistics(statisticsPtr)
+
+  Inputs:
+
+    statisticsPtr - A pointer to the statistics block.  A value of NULL
+    disables the statistics.
 
  Outputs:
 
     None.
 
 *****************************************************************************/
-void SignalAnalyzer::plotPowerSpectrum(
-  int8_t *signalBufferPtr,
-  uint32_t bufferLength)
+void SignalAnalyzer::setSpectrumStatistics(SpectrumStatistics *statisticsPtr)
 {
-  uint32_t i;
-  uint32_t j;
 
-  bufferLength = computeLogPowerSpectrum(signalBufferPtr,bufferLength);
+  this->statisticsPtr = statisticsPtr;
 
-  // Reference the start of the points array.
-  j = 0;
+  return;
+
+} // setSpectrumStatistics
+
+/*****************************************************************************
+
+  Name: setSpectrumMeter
+
+  Purpose: The purpose of this function is to attach a channel meter.
+  Once attached, every power spectrum that is computed is measured, and
+  the spectrum display shows the measurements.
+
+  Calling Sequence: setSpectrumMeter(meterPtr)
+
+  Inputs:
+
+    meterPtr - A pointer to the channel meter.  A value of NULL disables
+    the measurements.
 
-  // We're fitting an 8192-point FFT to the display width.
-  for (i = 0; i < bufferLength; i += spectrumStride)
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setSpectrumMeter(SpectrumMeter *meterPtr)
+{
+
+  this->meterPtr = meterPtr;
+
+  if (meterPtr != NULL)
   {
-    points[j].x = (short)j;
-    points[j].y = windowHeightInPixels - magnitudeBuffer[i];
+    // Allow for the noise bandwidth of the window.
+    meterPtr->setWindow(enginePtr->getWindow());
+  } // if
 
-    // Reference the next storage location.
-    j++;
-  } // for
+  return;
 
-  // Erase the previous plot.
-  XClearWindow(displayPtr,window);
+} // setSpectrumMeter
 
-  // Make this display pretty.
-  drawGridlines();
+/*****************************************************************************
 
-  // Set the signal color.
-  XSetForeground(displayPtr,graphicsContext,scopeSignalColor);
+  Name: setHighResolutionSpectrum
 
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Annotate the display.  This is really too
-  // sensitive to fonts.  I'll think of something
-  // later.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  XDrawString(displayPtr,window,graphicsContext,
-              annotationHorizontalPosition,
-              annotationFirstLinePosition,
-              frequencySpanBuffer,strlen(frequencySpanBuffer));
-
-  XDrawString(displayPtr,window,graphicsContext,
-              annotationHorizontalPosition,
-              annotationSecondLinePosition,
-              frequencySpanDivBuffer,strlen(frequencySpanDivBuffer));
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  Purpose: The purpose of this function is to attach a high resolution
+  spectrum.  Once attached, every block of IQ data is collected for it,
+  and the spectrum display overlays its latest spectrum, which follows
+  the zoom of the display.
 
-  // Plot the signal.
-  XDrawLines(displayPtr,
-             window,
-             graphicsContext,
-             points,windowWidthInPixels,
-             CoordModeOrigin);
+  Calling Sequence: setHighResolutionSpectrum(highResolutionPtr)
+
+  Inputs:
+
+    highResolutionPtr - A pointer to the high resolution spectrum.  Its
+    size must be a multiple of N.  A value of NULL removes the overlay.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setHighResolutionSpectrum(
+  HighResolutionSpectrum *highResolutionPtr)
+{
+
+  this->highResolutionPtr = highResolutionPtr;
 
-  // Send the request to the server
-  XFlush(displayPtr);
+  // Start over with the next frame.
+  highResolutionTraceValid = false;
 
   return;
 
-} // plotPowerSpectrum
+} // setHighResolutionSpectrum
 
 /*****************************************************************************
 
-  Name: plotLissajous
+  Name: setSpectrumReference
 
-  Purpose: The purpose of this function is to perform a Lissajous plot
-  of IQ data to the display.  This provides a nice indication as to
-  whether or not the IQ data samples are clipping.  Clipping is indicated
-  by a square pattern.
+  Purpose: The purpose of this function is to attach a reference
+  spectrum.  Once attached, pressing 's' in the display window captures
+  a new reference from the frames that follow, and pressing 'd' switches
+  between the absolute display and the differential display, which shows
+  the live spectrum relative to the reference.  The display becomes
+  differential when a capture completes.  If the reference already
+  holds a spectrum, the display starts out differential.
 
-  Calling Sequence: plotLissajous(signalBufferPtr,bufferLength)
+  Calling Sequence: setSpectrumReference(referencePtr,
+                                         highlightThresholdInDb)
 
   Inputs:
 
-    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
-    formatted with interleaved data as: I1,Q1,I2,Q2,...
+    referencePtr - A pointer to the reference.  A value of NULL shows the
+    absolute spectrum only.
 
-    bufferLength - The number of values in the signal buffer.  This
-    represents the total number of items in the buffer, rather than
-    the number of IQ sample pairs in the buffer.
+    highlightThresholdInDb - Whatever rises more than this above the
+    reference is highlighted.
 
  Outputs:
 
     None.
 
 *****************************************************************************/
-void SignalAnalyzer::plotLissajous(
-  int8_t *signalBufferPtr,
-  uint32_t bufferLength)
+void SignalAnalyzer::setSpectrumReference(SpectrumReference *referencePtr,
+  float highlightThresholdInDb)
 {
-  uint32_t i;
 
-  // We're fitting an 8192 IQ samples to the display width.
-  for (i = 0; i < bufferLength; i += 2)
-  {
-    points[i].x = (windowWidthInPixels / 2) + (short)signalBufferPtr[i];
-    points[i].y = (windowHeightInPixels / 2) - (short)signalBufferPtr[i+1];
-  } // for
+  this->referencePtr = referencePtr;
+  this->highlightThresholdInDb = highlightThresholdInDb;
 
-  // Erase the previous plot.
-  XClearWindow(displayPtr,window);
+  differential = (referencePtr != NULL) && referencePtr->isAvailable();
 
-  // Make this display pretty.
-  drawGridlines();
+  return;
 
-  // Set the signal color.
-  XSetForeground(displayPtr,graphicsContext,scopeSignalColor);
+} // setSpectrumReference
 
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Annotate the display.  This is really too
-  // sensitive to fonts.  I'll think of something
-  // later.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  XDrawString(displayPtr,window,graphicsContext,
-              annotationHorizontalPosition,
-              annotationFirstLinePosition,
-              sampleRateBuffer,strlen(sampleRateBuffer));
-
-  XDrawString(displayPtr,window,graphicsContext,
-              annotationHorizontalPosition,
-              annotationSecondLinePosition,
-              lissajousDivBuffer,strlen(lissajousDivBuffer));
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+/*****************************************************************************
 
-  // Plot the signal.
-  XDrawPoints(displayPtr,
-             window,
-             graphicsContext,
-             points,
-             (bufferLength/2),
-             CoordModeOrigin);
+  Name: setSpectrumTraces
+
+  Purpose: The purpose of this function is to attach max-hold, min-hold
+  and averaging traces to the analyzer.  Once attached, the traces are
+  updated with every power spectrum that is computed and are overlaid
+  on the spectrum display.  Pressing 'r' in the display window resets
+  the traces.
+
+  Calling Sequence: setSpectrumTraces(tracesPtr)
+
+  Inputs:
+
+    tracesPtr - A pointer to the traces.  A value of NULL disables the
+    traces.
+
+ Outputs:
 
-  // Send the request to the server
-  XFlush(displayPtr);
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setSpectrumTraces(SpectrumTraces *tracesPtr)
+{
+
+  this->tracesPtr = tracesPtr;
 
   return;
 
-} // plotLissajous
+} // setSpectrumTraces
 
 /*****************************************************************************
 
-  Name: computeSignalMagnitude
+  Name: setFixedPointFft
 
-  Purpose: The purpose of this function is to compute the magnitude of
-  IQ data.
+  Purpose: The purpose of this function is to select the FFT engine that
+  computes the power spectrum.  When a fixed-point FFT is attached, the
+  spectrum engine uses it instead of FFTW.  This is a good choice for older processors
+  that have lousy floating point performance, since 8-bit IQ data
+  doesn't need double precision.
 
-  Calling Sequence: numberOfSamples = computeSignalMagnitude(
-                                         signalBufferPtr,
-                                         bufferLength)
+  Calling Sequence: setFixedPointFft(fixedPointFftPtr)
 
   Inputs:
 
-    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
-    formatted with interleaved data as: I1,Q1,I2,Q2,...
+    fixedPointFftPtr - A pointer to the fixed-point FFT.  A value of NULL
+    selects FFTW.
 
-    bufferLength - The number of values in the signal buffer.  This
-    represents the total number of items in the buffer, rather than
-    the number of IQ sample pairs in the buffer.
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setFixedPointFft(FixedPointFft *fixedPointFftPtr)
+{
+
+  enginePtr->setFixedPointFft(fixedPointFftPtr);
+
+  return;
+
+} // setFixedPointFft
+
+/*****************************************************************************
+
+  Name: setScopeTrigger
+
+  Purpose: The purpose of this function is to attach a trigger to the
+  oscilloscope display.  When a trigger is attached, only the sweeps that
+  it captures are displayed, so periodic signals stand still.
+
+  Calling Sequence: setScopeTrigger(triggerPtr)
+
+  Inputs:
+
+    triggerPtr - A pointer to the trigger.  A value of NULL lets the
+    oscilloscope free run.
 
  Outputs:
 
     None.
 
 *****************************************************************************/
-uint32_t SignalAnalyzer::computeSignalMagnitude(
-  int8_t *signalBufferPtr,
-  uint32_t bufferLength)
+void SignalAnalyzer::setScopeTrigger(ScopeTrigger *triggerPtr)
 {
-  uint32_t i;
-  uint32_t magnitudeIndex;
-  int16_t iMagnitude, qMagnitude;
 
-  // Reference the beginning of the magnitude buffer.
-  magnitudeIndex = 0;
+  this->triggerPtr = triggerPtr;
 
-  for (i = 0; i < bufferLength; i += 2)
-  {
-    // Grab these values for the magnitude estimator.
-    iMagnitude = abs((int16_t)signalBufferPtr[i]);
-    qMagnitude = abs((int16_t)signalBufferPtr[i+1]);
+  return;
 
-    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-    // This block of code performs a magnitude estimation of
-    // the complex signal.
-    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-    if (iMagnitude > qMagnitude)
-    {
-      magnitudeBuffer[magnitudeIndex] = iMagnitude  + (qMagnitude >> 1);
-    } // if
-    else
-    {
-      magnitudeBuffer[magnitudeIndex] = qMagnitude + (iMagnitude >> 1);
-    } // else
-    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+} // setScopeTrigger
 
-    // Reference the next storage location.
-    magnitudeIndex++;
-  } // for
+/*****************************************************************************
+
+  Name: setAutoScaler
+
+  Purpose: The purpose of this function is to attach an automatic scaler
+  to the spectrum display.  When a scaler is attached, it sets the
+  reference level and vertical gain on every frame, and the values that
+  were passed to the constructor are only a starting point.
+
+  Calling Sequence: setAutoScaler(autoScalerPtr)
+
+  Inputs:
+
+    autoScalerPtr - A pointer to the automatic scaler.  A value of NULL
+    leaves the scale alone.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setAutoScaler(SpectrumAutoScaler *autoScalerPtr)
+{
+
+  this->autoScalerPtr = autoScalerPtr;
 
-  return (bufferLength / 2);
+  return;
+
+} // setAutoScaler
+
+/*****************************************************************************
+
+  Name: setIqCorrector
+
+  Purpose: The purpose of this function is to attach the IQ front end
+  stage, so that the quality of the IQ data can be shown on the display.
+  The stage itself is run on the samples before they are handed to the
+  analyzer.  If it corrects the samples, the spectrum engine applies the
+  correction in floating point, and everything else gets the samples
+  corrected and rounded to 8 bits.
+
+  Calling Sequence: setIqCorrector(correctorPtr)
+
+  Inputs:
+
+    correctorPtr - A pointer to the IQ front end stage.  A value of NULL
+    removes the annotation.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setIqCorrector(IqCorrector *correctorPtr)
+{
+
+  this->correctorPtr = correctorPtr;
+
+  enginePtr->setIqCorrector(correctorPtr);
+
+  return;
+
+} // setIqCorrector
+
+/*****************************************************************************
+
+  Name: setCaptureRing
+
+  Purpose: The purpose of this function is to attach a capture ring, so
+  that a capture can be started from the keyboard.  The ring itself is
+  fed with the samples before they are handed to the analyzer.
+
+  Calling Sequence: setCaptureRing(capturePtr)
+
+  Inputs:
+
+    capturePtr - A pointer to the capture ring.  A value of NULL disables
+    the capture key.
+
+ Outputs:
 
-} // computeSignalMagnitude
+    None.
+
+*****************************************************************************/
+void SignalAnalyzer::setCaptureRing(CaptureRing *capturePtr)
+{
+
+  this->capturePtr = capturePtr;
+
+  return;
+
+} // setCaptureRing
 
 /*****************************************************************************
 
   Name: computeLogPowerSpectrum
 
   Purpose: The purpose of this function is to compute the power spectrum
-  of IQ data.
+  of IQ data.  The linear power of each bin is stored, FFT shifted, in
+  powerBuffer[], and the spectrum is handed to the signal detector, the
+  spectral statistics, the channel meter and the spectrum traces.
 
   Calling Sequence: computeLogPowerSpectrum(signalBufferPtr,bufferLength)
 
@@ -890,88 +2492,47 @@ uint32_t SignalAnalyzer::computeLogPowerSpectrum(
   int8_t *signalBufferPtr,
   uint32_t bufferLength)
 {
-  uint32_t i;
-  uint32_t j;
-  int16_t iMagnitude, qMagnitude;
-  double power;
-  double powerInDb;
-  double iK, qK;
+  uint32_t numberOfSamples;
 
-  // Reference the beginning of the FFT buffer.
-  j = 0;
+  numberOfSamples = enginePtr->computePowerSpectrum(signalBufferPtr,
+                                                    bufferLength,
+                                                    powerBuffer);
 
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Fill up the input array.  The second index of the
-  // array is used as follows: a value of 0 references
-  // the real component of the signal, and a value of 1
-  // references the imaginary component of the signal.
-  // Each component is windowed so that sidelobes are
-  // reduced.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  for (i = 0; i < bufferLength; i += 2)
+  if (statisticsPtr != NULL)
   {
-    // Store the real value.
-    fftInputPtr[j][0] = (double)signalBufferPtr[i] * hanningWindow[j];
-
-    // Store the imaginary value.
-    fftInputPtr[j][1] = (double)signalBufferPtr[i+1] * hanningWindow[j];
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The log10() is expensive, so only pay for it when
+    // the statistics need it.  The display converts to
+    // decibels once per frame.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    enginePtr->convertToDb(powerBuffer,1,powerInDbBuffer);
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
 
-    // Reference the next storage location.
-    j += 1; 
-  } // for
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if (detectorPtr != NULL)
+  {
+    // Look for signals in every spectrum that we compute.
+    detectorPtr->processSpectrum(powerBuffer);
+  } // if
 
-  // Compute the DFT.
-  fftw_execute(fftPlan);
+  if (statisticsPtr != NULL)
+  {
+    // Update the running statistics with every spectrum.
+    statisticsPtr->processSpectrum(powerInDbBuffer);
+  } // if
 
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  // Compute the magnitude of the spectrum in decibels.
-  // Originally, I used a simple approximation for the
-  // magnitude, but the result was a lousy display of the
-  // spectrum.
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
-  for (i = 0; i < N; i++)
+  if (meterPtr != NULL)
   {
-    // Retrive the in-phase and quadrature parts.
-    iK = fftOutputPtr[i][0];
-    qK = fftOutputPtr[i][1];
+    // Measure the channels in every spectrum.
+    meterPtr->processSpectrum(powerBuffer);
+  } // if
 
-    // Compute signal power, |I + jQ|.
-    power = (iK * iK) + (qK * qK);
-    
-    // Scale for a normalized output.
-    power /= N;
-
-    // We want power in decibels.
-    powerInDb = 10*log10(power);
-
-    // Set the baseline to the reference level..
-    powerInDb += baselineInDb;
-
-    // "Amplidy" the signal.
-    powerInDb *= verticalGain;
-
-    // Scale to display 20dB, divided by the vertical gain, per division.
-    powerInDb *= 3.2;
-
-    //--------------------------------------------
-    // The fftShiftTable[] allows us to store
-    // the FFT output values such that the
-    // center frequency bin is in the center
-    // of the output array.  This results in a
-    // display that looks like that of a spectrum
-    // analyzer.
-    //--------------------------------------------
-    j = fftShiftTable[i];
-    //--------------------------------------------
-
-    // We're reusing the magnitude buffer for power values.
-    magnitudeBuffer[j] = (int16_t)powerInDb; 
-  } // for
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if (tracesPtr != NULL)
+  {
+    // The hold and average traces must see every spectrum.
+    tracesPtr->accumulate(powerBuffer);
+  } // if
 
-  return (bufferLength / 2);
+  return (numberOfSamples);
 
 } // computeLogPowerSpectrum
-
-
@@ -0,0 +1,771 @@
+//************************************************************************
+// file name: SoftwareRasterizer.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SoftwareRasterizer.h"
+
+using namespace std;
+
+// These are the Cohen-Sutherland outcodes.
+#define OUTCODE_LEFT (1)
+#define OUTCODE_RIGHT (2)
+#define OUTCODE_TOP (4)
+#define OUTCODE_BOTTOM (8)
+
+//*************************************************************************
+// This is a 5x7 font for the printable ASCII characters, ' ' through
+// '~'.  Each character is 5 columns, left to right, and bit 0 of each
+// column is the top row.
+//*************************************************************************
+static const uint8_t font[95][5] =
+{
+  {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5f,0x00,0x00}, // ' ' '!'
+  {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7f,0x14,0x7f,0x14}, // '"' '#'
+  {0x24,0x2a,0x7f,0x2a,0x12}, {0x23,0x13,0x08,0x64,0x62}, // '$' '%'
+  {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00}, // '&' '''
+  {0x00,0x1c,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1c,0x00}, // '(' ')'
+  {0x14,0x08,0x3e,0x08,0x14}, {0x08,0x08,0x3e,0x08,0x08}, // '*' '+'
+  {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, // ',' '-'
+  {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02}, // '.' '/'
+  {0x3e,0x51,0x49,0x45,0x3e}, {0x00,0x42,0x7f,0x40,0x00}, // '0' '1'
+  {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4b,0x31}, // '2' '3'
+  {0x18,0x14,0x12,0x7f,0x10}, {0x27,0x45,0x45,0x45,0x39}, // '4' '5'
+  {0x3c,0x4a,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03}, // '6' '7'
+  {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1e}, // '8' '9'
+  {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00}, // ':' ';'
+  {0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14}, // '<' '='
+  {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06}, // '>' '?'
+  {0x32,0x49,0x79,0x41,0x3e}, {0x7e,0x11,0x11,0x11,0x7e}, // '@' 'A'
+  {0x7f,0x49,0x49,0x49,0x36}, {0x3e,0x41,0x41,0x41,0x22}, // 'B' 'C'
+  {0x7f,0x41,0x41,0x22,0x1c}, {0x7f,0x49,0x49,0x49,0x41}, // 'D' 'E'
+  {0x7f,0x09,0x09,0x09,0x01}, {0x3e,0x41,0x49,0x49,0x7a}, // 'F' 'G'
+  {0x7f,0x08,0x08,0x08,0x7f}, {0x00,0x41,0x7f,0x41,0x00}, // 'H' 'I'
+  {0x20,0x40,0x41,0x3f,0x01}, {0x7f,0x08,0x14,0x22,0x41}, // 'J' 'K'
+  {0x7f,0x40,0x40,0x40,0x40}, {0x7f,0x02,0x0c,0x02,0x7f}, // 'L' 'M'
+  {0x7f,0x04,0x08,0x10,0x7f}, {0x3e,0x41,0x41,0x41,0x3e}, // 'N' 'O'
+  {0x7f,0x09,0x09,0x09,0x06}, {0x3e,0x41,0x51,0x21,0x5e}, // 'P' 'Q'
+  {0x7f,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31}, // 'R' 'S'
+  {0x01,0x01,0x7f,0x01,0x01}, {0x3f,0x40,0x40,0x40,0x3f}, // 'T' 'U'
+  {0x1f,0x20,0x40,0x20,0x1f}, {0x3f,0x40,0x38,0x40,0x3f}, // 'V' 'W'
+  {0x63,0x14,0x08,0x14,0x63}, {0x07,0x08,0x70,0x08,0x07}, // 'X' 'Y'
+  {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7f,0x41,0x41,0x00}, // 'Z' '['
+  {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7f,0x00}, // '\' ']'
+  {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40}, // '^' '_'
+  {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, // '`' 'a'
+  {0x7f,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20}, // 'b' 'c'
+  {0x38,0x44,0x44,0x48,0x7f}, {0x38,0x54,0x54,0x54,0x18}, // 'd' 'e'
+  {0x08,0x7e,0x09,0x01,0x02}, {0x0c,0x52,0x52,0x52,0x3e}, // 'f' 'g'
+  {0x7f,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7d,0x40,0x00}, // 'h' 'i'
+  {0x20,0x40,0x44,0x3d,0x00}, {0x7f,0x10,0x28,0x44,0x00}, // 'j' 'k'
+  {0x00,0x41,0x7f,0x40,0x00}, {0x7c,0x04,0x18,0x04,0x78}, // 'l' 'm'
+  {0x7c,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, // 'n' 'o'
+  {0x7c,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7c}, // 'p' 'q'
+  {0x7c,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20}, // 'r' 's'
+  {0x04,0x3f,0x44,0x40,0x20}, {0x3c,0x40,0x40,0x20,0x7c}, // 't' 'u'
+  {0x1c,0x20,0x40,0x20,0x1c}, {0x3c,0x40,0x30,0x40,0x3c}, // 'v' 'w'
+  {0x44,0x28,0x10,0x28,0x44}, {0x0c,0x50,0x50,0x50,0x3c}, // 'x' 'y'
+  {0x44,0x64,0x54,0x4c,0x44}, {0x00,0x08,0x36,0x41,0x00}, // 'z' '{'
+  {0x00,0x00,0x7f,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, // '|' '}'
+  {0x08,0x04,0x08,0x10,0x08}                              // '~'
+};
+
+/*****************************************************************************
+
+  Name: SoftwareRasterizer
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SoftwareRasterizer.
+
+  Calling Sequence: SoftwareRasterizer(width,height)
+
+  Inputs:
+
+    width - The width of the frame buffer in pixels.
+
+    height - The height of the frame buffer in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SoftwareRasterizer::SoftwareRasterizer(int width,int height)
+{
+
+  // Retrieve for later use.
+  this->width = width;
+  this->height = height;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // All storage is allocated up front so that nothing is
+  // allocated while frames are being drawn.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  pixelsPtr = new uint8_t[width * height * 3];
+  grayRowPtr = new uint8_t[width];
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Start with a black frame.
+  setColor(0,0,0);
+  fill();
+
+  // First-time drawing color is white.
+  setColor(255,255,255);
+
+  return;
+
+} // SoftwareRasterizer
+
+/*****************************************************************************
+
+  Name: ~SoftwareRasterizer
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SoftwareRasterizer.
+
+  Calling Sequence: ~SoftwareRasterizer()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SoftwareRasterizer::~SoftwareRasterizer(void)
+{
+
+  // Release resources.
+  delete[] pixelsPtr;
+  delete[] grayRowPtr;
+
+  return;
+
+} // ~SoftwareRasterizer
+
+/*****************************************************************************
+
+  Name: getWidth
+
+  Purpose: The purpose of this function is to retrieve the width of the
+  frame buffer.
+
+  Calling Sequence: width = getWidth()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    width - The width in pixels.
+
+*****************************************************************************/
+int SoftwareRasterizer::getWidth(void)
+{
+
+  return (width);
+
+} // getWidth
+
+/*****************************************************************************
+
+  Name: getHeight
+
+  Purpose: The purpose of this function is to retrieve the height of the
+  frame buffer.
+
+  Calling Sequence: height = getHeight()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    height - The height in pixels.
+
+*****************************************************************************/
+int SoftwareRasterizer::getHeight(void)
+{
+
+  return (height);
+
+} // getHeight
+
+/*****************************************************************************
+
+  Name: getPixels
+
+  Purpose: The purpose of this function is to provide access to the
+  frame buffer.  Pixels are stored row by row, starting with the top
+  row, as R,G,B bytes.
+
+  Calling Sequence: pixelsPtr = getPixels()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    pixelsPtr - A pointer to the frame buffer.
+
+*****************************************************************************/
+uint8_t *SoftwareRasterizer::getPixels(void)
+{
+
+  return (pixelsPtr);
+
+} // getPixels
+
+/*****************************************************************************
+
+  Name: setColor
+
+  Purpose: The purpose of this function is to set the color of
+  everything that is drawn from now on.
+
+  Calling Sequence: setColor(red,green,blue)
+
+  Inputs:
+
+    red - The red component.
+
+    green - The green component.
+
+    blue - The blue component.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SoftwareRasterizer::setColor(uint8_t red,uint8_t green,uint8_t blue)
+{
+
+  this->red = red;
+  this->green = green;
+  this->blue = blue;
+
+  return;
+
+} // setColor
+
+/*****************************************************************************
+
+  Name: fill
+
+  Purpose: The purpose of this function is to fill the whole frame
+  buffer with the current color.
+
+  Calling Sequence: fill()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SoftwareRasterizer::fill(void)
+{
+  int i;
+  uint8_t *pixelPtr;
+
+  // Fill the first row a pixel at a time.
+  pixelPtr = pixelsPtr;
+
+  for (i = 0; i < width; i++)
+  {
+    *pixelPtr++ = red;
+    *pixelPtr++ = green;
+    *pixelPtr++ = blue;
+  } // for
+
+  // Every other row is a copy of the first one.
+  for (i = 1; i < height; i++)
+  {
+    memcpy(&pixelsPtr[i * width * 3],pixelsPtr,width * 3);
+  } // for
+
+  return;
+
+} // fill
+
+/*****************************************************************************
+
+  Name: fillRectangle
+
+  Purpose: The purpose of this function is to fill a rectangle of the
+  frame buffer with the current color.  The parts of the rectangle that
+  are off screen are ignored.
+
+  Calling Sequence: fillRectangle(x,y,width,height)
+
+  Inputs:
+
+    x - The left edge of the rectangle in pixels.
+
+    y - The top edge of the rectangle in pixels.
+
+    width - The width of the rectangle in pixels.
+
+    height - The height of the rectangle in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SoftwareRasterizer::fillRectangle(int x,int y,int width,int height)
+{
+  int i;
+  int right;
+  int bottom;
+  uint8_t *rowPtr;
+  uint8_t *pixelPtr;
+
+  // Clip the rectangle to the frame buffer.
+  right = x + width;
+  bottom = y + height;
+  x = (x < 0) ? 0 : x;
+  y = (y < 0) ? 0 : y;
+  right = (right > this->width) ? this->width : right;
+  bottom = (bottom > this->height) ? this->height : bottom;
+
+  if ((x >= right) || (y >= bottom))
+  {
+    // Nothing is on screen.
+    return;
+  } // if
+
+  // Fill the first row a pixel at a time.
+  rowPtr = &pixelsPtr[((y * this->width) + x) * 3];
+  pixelPtr = rowPtr;
+
+  for (i = x; i < right; i++)
+  {
+    *pixelPtr++ = red;
+    *pixelPtr++ = green;
+    *pixelPtr++ = blue;
+  } // for
+
+  // Every other row is a copy of the first one.
+  for (i = y + 1; i < bottom; i++)
+  {
+    memcpy(&pixelsPtr[((i * this->width) + x) * 3],rowPtr,(right - x) * 3);
+  } // for
+
+  return;
+
+} // fillRectangle
+
+/*****************************************************************************
+
+  Name: drawPixel
+
+  Purpose: The purpose of this function is to set a pixel to the current
+  color.  Pixels that are outside of the frame buffer are ignored.
+
+  Calling Sequence: drawPixel(x,y)
+
+  Inputs:
+
+    x - The column of the pixel.
+
+    y - The row of the pixel.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SoftwareRasterizer::drawPixel(int x,int y)
+{
+  uint8_t *pixelPtr;
+
+  if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+  {
+    // Off screen.
+    return;
+  } // if
+
+  pixelPtr = &pixelsPtr[((y * width) + x) * 3];
+
+  pixelPtr[0] = red;
+  pixelPtr[1] = green;
+  pixelPtr[2] = blue;
+
+  return;
+
+} // drawPixel
+
+/*****************************************************************************
+
+  Name: drawLine
+
+  Purpose: The purpose of this function is to draw a line, including both
+  end points, in the current color.  The line is clipped to the frame
+  buffer and then drawn with Bresenham's algorithm.
+
+  Calling Sequence: drawLine(x1,y1,x2,y2)
+
+  Inputs:
+
+    x1,y1 - The start of the line.
+
+    x2,y2 - The end of the line.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SoftwareRasterizer::drawLine(int x1,int y1,int x2,int y2)
+{
+  int dx;
+  int dy;
+  int xStep;
+  int yStep;
+  int error;
+  int error2;
+
+  if (!clipLine(&x1,&y1,&x2,&y2))
+  {
+    // Nothing is visible.
+    return;
+  } // if
+
+  dx = abs(x2 - x1);
+  dy = -abs(y2 - y1);
+  xStep = (x1 < x2) ? 1 : -1;
+  yStep = (y1 < y2) ? 1 : -1;
+  error = dx + dy;
+
+  for (;;)
+  {
+    drawPixel(x1,y1);
+
+    if ((x1 == x2) && (y1 == y2))
+    {
+      break;
+    } // if
+
+    error2 = 2 * error;
+
+    if (error2 >= dy)
+    {
+      error += dy;
+      x1 += xStep;
+    } // if
+
+    if (error2 <= dx)
+    {
+      error += dx;
+      y1 += yStep;
+    } // if
+  } // for
+
+  return;
+
+} // drawLine
+
+/*****************************************************************************
+
+  Name: drawString
+
+  Purpose: The purpose of this function is to draw a string in the
+  current color.  Like X, the vertical position is the baseline of the
+  string.  Characters that the font doesn't have are drawn as spaces.
+
+  Calling Sequence: drawString(x,y,textPtr)
+
+  Inputs:
+
+    x - The horizontal position of the start of the string.
+
+    y - The vertical position of the baseline of the string.
+
+    textPtr - The string.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SoftwareRasterizer::drawString(int x,int y,const char *textPtr)
+{
+  int column;
+  int row;
+  int c;
+  uint8_t bits;
+
+  for (; *textPtr != 0; textPtr++)
+  {
+    c = (unsigned char)*textPtr;
+
+    if ((c >= ' ') && (c <= '~'))
+    {
+      for (column = 0; column < 5; column++)
+      {
+        bits = font[c - ' '][column];
+
+        for (row = 0; row < RASTER_FONT_HEIGHT; row++)
+        {
+          if (bits & (1 << row))
+          {
+            drawPixel(x + column,y - RASTER_FONT_HEIGHT + row);
+          } // if
+        } // for
+      } // for
+    } // if
+
+    // Reference the next character cell.
+    x += RASTER_FONT_WIDTH;
+  } // for
+
+  return;
+
+} // drawString
+
+/*****************************************************************************
+
+  Name: writePpm
+
+  Purpose: The purpose of this function is to write the frame buffer to
+  a stream as a binary (P6) PPM image.
+
+  Calling Sequence: success = writePpm(streamPtr)
+
+  Inputs:
+
+    streamPtr - The stream to write to.
+
+ Outputs:
+
+    success - A flag that indicates whether the image was written.  A
+    value of true indicates success, and a value of false indicates
+    failure.
+
+*****************************************************************************/
+bool SoftwareRasterizer::writePpm(FILE *streamPtr)
+{
+  size_t count;
+
+  fprintf(streamPtr,"P6\n%d %d\n255\n",width,height);
+
+  count = fwrite(pixelsPtr,width * 3,height,streamPtr);
+
+  return (count == (size_t)height);
+
+} // writePpm
+
+/*****************************************************************************
+
+  Name: writePgm
+
+  Purpose: The purpose of this function is to write the frame buffer to
+  a stream as a binary (P5) PGM image.  Each pixel is converted to its
+  luminance.
+
+  Calling Sequence: success = writePgm(streamPtr)
+
+  Inputs:
+
+    streamPtr - The stream to write to.
+
+ Outputs:
+
+    success - A flag that indicates whether the image was written.  A
+    value of true indicates success, and a value of false indicates
+    failure.
+
+*****************************************************************************/
+bool SoftwareRasterizer::writePgm(FILE *streamPtr)
+{
+  int i;
+  int j;
+  uint8_t *pixelPtr;
+  size_t count;
+
+  fprintf(streamPtr,"P5\n%d %d\n255\n",width,height);
+
+  // Reference the top row.
+  pixelPtr = pixelsPtr;
+  count = 0;
+
+  for (i = 0; i < height; i++)
+  {
+    for (j = 0; j < width; j++)
+    {
+      // Y = 0.299R + 0.587G + 0.114B in 8-bit fixed point.
+      grayRowPtr[j] = (uint8_t)(((77 * pixelPtr[0]) +
+                                 (150 * pixelPtr[1]) +
+                                 (29 * pixelPtr[2])) >> 8);
+
+      pixelPtr += 3;
+    } // for
+
+    count += fwrite(grayRowPtr,width,1,streamPtr);
+  } // for
+
+  return (count == (size_t)height);
+
+} // writePgm
+
+/*****************************************************************************
+
+  Name: computeOutcode
+
+  Purpose: The purpose of this function is to compute the Cohen-Sutherland
+  outcode of a point, which indicates on which sides of the frame buffer
+  the point lies.
+
+  Calling Sequence: outcode = computeOutcode(x,y)
+
+  Inputs:
+
+    x - The column of the point.
+
+    y - The row of the point.
+
+ Outputs:
+
+    outcode - A combination of OUTCODE_LEFT, OUTCODE_RIGHT, OUTCODE_TOP
+    and OUTCODE_BOTTOM, or 0 if the point is inside.
+
+*****************************************************************************/
+int SoftwareRasterizer::computeOutcode(int x,int y)
+{
+  int outcode;
+
+  outcode = 0;
+
+  if (x < 0)
+  {
+    outcode |= OUTCODE_LEFT;
+  } // if
+  else
+  {
+    if (x >= width)
+    {
+      outcode |= OUTCODE_RIGHT;
+    } // if
+  } // else
+
+  if (y < 0)
+  {
+    outcode |= OUTCODE_TOP;
+  } // if
+  else
+  {
+    if (y >= height)
+    {
+      outcode |= OUTCODE_BOTTOM;
+    } // if
+  } // else
+
+  return (outcode);
+
+} // computeOutcode
+
+/*****************************************************************************
+
+  Name: clipLine
+
+  Purpose: The purpose of this function is to clip a line to the frame
+  buffer using the Cohen-Sutherland algorithm.
+
+  Calling Sequence: visible = clipLine(x1Ptr,y1Ptr,x2Ptr,y2Ptr)
+
+  Inputs:
+
+    x1Ptr,y1Ptr - Pointers to the start of the line.
+
+    x2Ptr,y2Ptr - Pointers to the end of the line.
+
+ Outputs:
+
+    x1Ptr,y1Ptr,x2Ptr,y2Ptr - The clipped line.
+
+    visible - A flag that indicates whether any of the line is inside
+    the frame buffer.
+
+*****************************************************************************/
+bool SoftwareRasterizer::clipLine(int *x1Ptr,int *y1Ptr,int *x2Ptr,int *y2Ptr)
+{
+  int outcode1;
+  int outcode2;
+  int outcode;
+  int64_t x1, y1, x2, y2;
+  int64_t x, y;
+
+  x1 = *x1Ptr;
+  y1 = *y1Ptr;
+  x2 = *x2Ptr;
+  y2 = *y2Ptr;
+
+  outcode1 = computeOutcode(*x1Ptr,*y1Ptr);
+  outcode2 = computeOutcode(*x2Ptr,*y2Ptr);
+
+  for (;;)
+  {
+    if ((outcode1 | outcode2) == 0)
+    {
+      // Both ends are inside.
+      break;
+    } // if
+
+    if ((outcode1 & outcode2) != 0)
+    {
+      // Both ends are off the same side.
+      return (false);
+    } // if
+
+    // Pick an end that is outside.
+    outcode = (outcode1 != 0) ? outcode1 : outcode2;
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Move that end to the edge that it is beyond.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    if (outcode & (OUTCODE_TOP | OUTCODE_BOTTOM))
+    {
+      y = (outcode & OUTCODE_TOP) ? 0 : (height - 1);
+      x = x1 + (((x2 - x1) * (y - y1)) / (y2 - y1));
+    } // if
+    else
+    {
+      x = (outcode & OUTCODE_LEFT) ? 0 : (width - 1);
+      y = y1 + (((y2 - y1) * (x - x1)) / (x2 - x1));
+    } // else
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    if (outcode == outcode1)
+    {
+      x1 = x;
+      y1 = y;
+      outcode1 = computeOutcode((int)x1,(int)y1);
+    } // if
+    else
+    {
+      x2 = x;
+      y2 = y;
+      outcode2 = computeOutcode((int)x2,(int)y2);
+    } // else
+  } // for
+
+  *x1Ptr = (int)x1;
+  *y1Ptr = (int)y1;
+  *x2Ptr = (int)x2;
+  *y2Ptr = (int)y2;
+
+  return (true);
+
+} // clipLine
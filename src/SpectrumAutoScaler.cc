@@ -0,0 +1,297 @@
+//************************************************************************
+// file name: SpectrumAutoScaler.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "SpectrumAutoScaler.h"
+
+using namespace std;
+
+// The display has four vertical divisions.
+#define NUMBER_OF_DIVISIONS (4)
+
+// These are the vertical scales that are chosen from, in dB/div.
+static const float dbPerDivisionChoices[] = {5, 10, 15, 20, 25, 30, 40, 50};
+
+// The bottom of the display is a multiple of this, so that the grid
+// lines fall on round numbers.
+#define BOTTOM_STEP_IN_DB (5.0f)
+
+#define NUMBER_OF_SCALE_CHOICES \
+  (sizeof(dbPerDivisionChoices) / sizeof(dbPerDivisionChoices[0]))
+
+/*****************************************************************************
+
+  Name: SpectrumAutoScaler
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumAutoScaler.
+
+  Calling Sequence: SpectrumAutoScaler(updatesPerSecond,displayRangeInDb)
+
+  Inputs:
+
+    updatesPerSecond - The number of times a second that a spectrum is
+    accumulated.  This sets the decay of the histogram so that it
+    forgets the past in about a quarter of a second.
+
+    displayRangeInDb - The range, in dB, that the display covers at a
+    vertical gain of 1.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumAutoScaler::SpectrumAutoScaler(float updatesPerSecond,
+  float displayRangeInDb)
+{
+
+  if (updatesPerSecond <= 0)
+  {
+    // Keep it sane.
+    updatesPerSecond = 30;
+  } // if
+
+  // Retrieve for later use.
+  this->displayRangeInDb = displayRangeInDb;
+
+  // A time constant of a quarter of a second.
+  decayFactor = expf(-1.0f / (0.25f * updatesPerSecond));
+
+  // Nothing has been seen yet.
+  memset(histogram,0,sizeof(histogram));
+  totalWeight = 0;
+  scaleChosen = false;
+
+  return;
+
+} // SpectrumAutoScaler
+
+/*****************************************************************************
+
+  Name: ~SpectrumAutoScaler
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumAutoScaler.
+
+  Calling Sequence: ~SpectrumAutoScaler()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumAutoScaler::~SpectrumAutoScaler(void)
+{
+
+  return;
+
+} // ~SpectrumAutoScaler
+
+/*****************************************************************************
+
+  Name: accumulate
+
+  Purpose: The purpose of this function is to fold a spectrum into the
+  running histogram.  The old contents of the histogram are decayed
+  first, so the histogram always describes the last fraction of a
+  second.
+
+  Calling Sequence: accumulate(spectrumInDbPtr,numberOfValues)
+
+  Inputs:
+
+    spectrumInDbPtr - A pointer to the spectrum in dB.  This is normally
+    the spectrum that has been binned to the display width.
+
+    numberOfValues - The number of values in the spectrum.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumAutoScaler::accumulate(float *spectrumInDbPtr,
+  uint32_t numberOfValues)
+{
+  uint32_t i;
+  int32_t bin;
+
+  for (i = 0; i < AUTOSCALE_NUMBER_OF_BINS; i++)
+  {
+    histogram[i] *= decayFactor;
+  } // for
+
+  for (i = 0; i < numberOfValues; i++)
+  {
+    bin = (int32_t)((spectrumInDbPtr[i] - AUTOSCALE_MINIMUM_DB) *
+                    AUTOSCALE_BINS_PER_DB);
+
+    // Values off either end land in the end bins.
+    bin = (bin < 0) ? 0 : bin;
+    bin = (bin >= AUTOSCALE_NUMBER_OF_BINS) ?
+          (AUTOSCALE_NUMBER_OF_BINS - 1) : bin;
+
+    histogram[bin] += 1;
+  } // for
+
+  totalWeight = (totalWeight * decayFactor) + numberOfValues;
+
+  return;
+
+} // accumulate
+
+/*****************************************************************************
+
+  Name: update
+
+  Purpose: The purpose of this function is to adjust the reference level
+  and vertical gain of the display.  The noise floor is taken to be the
+  10th percentile of the histogram, and the peaks the 99.95th
+  percentile.  If the noise floor sits in the lower part of the display
+  and the peaks are on screen and use a reasonable part of it, nothing
+  is changed.  Otherwise, the smallest vertical scale that puts the
+  noise floor just above the bottom of the display and the peaks below
+  the top is chosen.
+
+  Calling Sequence: changed = update(baselineInDbPtr,verticalGainPtr)
+
+  Inputs:
+
+    baselineInDbPtr - A pointer to the current reference level.
+
+    verticalGainPtr - A pointer to the current vertical gain.
+
+ Outputs:
+
+    baselineInDbPtr - The new reference level.
+
+    verticalGainPtr - The new vertical gain.
+
+    changed - A flag that indicates that the scale was changed.
+
+*****************************************************************************/
+bool SpectrumAutoScaler::update(int32_t *baselineInDbPtr,
+  float *verticalGainPtr)
+{
+  uint32_t i;
+  bool changed;
+  float noiseFloor;
+  float peak;
+  float span;
+  float bottom;
+  float dbPerDivision;
+  int32_t baselineInDb;
+  float verticalGain;
+
+  if (totalWeight < 1)
+  {
+    // Nothing to go on.
+    return (false);
+  } // if
+
+  noiseFloor = getPercentile(10);
+  peak = getPercentile(99.95f);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // This is the hysteresis.  Leave a scale alone as long
+  // as it still works.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if (scaleChosen)
+  {
+    span = displayRangeInDb / *verticalGainPtr;
+    bottom = -(float)*baselineInDbPtr;
+
+    if ((noiseFloor >= bottom) &&
+        (noiseFloor <= (bottom + (0.4f * span))) &&
+        (peak <= (bottom + span)) &&
+        ((peak - noiseFloor) >= (0.45f * span)))
+    {
+      return (false);
+    } // if
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Find the smallest scale that fits, with the bottom of
+  // the display on a multiple of 5dB.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < NUMBER_OF_SCALE_CHOICES; i++)
+  {
+    dbPerDivision = dbPerDivisionChoices[i];
+    span = NUMBER_OF_DIVISIONS * dbPerDivision;
+
+    bottom = floorf((noiseFloor - (0.1f * span)) / BOTTOM_STEP_IN_DB) *
+             BOTTOM_STEP_IN_DB;
+
+    if ((peak + (0.05f * span)) <= (bottom + span))
+    {
+      break;
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  baselineInDb = -(int32_t)bottom;
+  verticalGain = displayRangeInDb / span;
+
+  changed = (baselineInDb != *baselineInDbPtr) ||
+            (verticalGain != *verticalGainPtr);
+
+  *baselineInDbPtr = baselineInDb;
+  *verticalGainPtr = verticalGain;
+
+  scaleChosen = true;
+
+  return (changed);
+
+} // update
+
+/*****************************************************************************
+
+  Name: getPercentile
+
+  Purpose: The purpose of this function is to find a percentile of the
+  running histogram.  This is a single pass over the histogram bins.
+
+  Calling Sequence: valueInDb = getPercentile(percentile)
+
+  Inputs:
+
+    percentile - The percentile, from 0 to 100.
+
+ Outputs:
+
+    valueInDb - The value of the percentile in dB.
+
+*****************************************************************************/
+float SpectrumAutoScaler::getPercentile(float percentile)
+{
+  uint32_t i;
+  float target;
+  float sum;
+
+  target = totalWeight * (percentile / 100);
+  sum = 0;
+
+  for (i = 0; i < (AUTOSCALE_NUMBER_OF_BINS - 1); i++)
+  {
+    sum += histogram[i];
+
+    if (sum >= target)
+    {
+      break;
+    } // if
+  } // for
+
+  return (AUTOSCALE_MINIMUM_DB +
+          ((i + 0.5f) / AUTOSCALE_BINS_PER_DB));
+
+} // getPercentile
@@ -0,0 +1,707 @@
+//************************************************************************
+// file name: SpectrumDetector.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "SpectrumDetector.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumDetector
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumDetector.
+
+  Calling Sequence: SpectrumDetector(numberOfBins,
+                                     sampleRate,
+                                     thresholdInDb,
+                                     eventStreamPtr)
+
+  Inputs:
+
+    numberOfBins - The number of bins in each power spectrum.
+
+    sampleRate - The sample rate of incoming IQ data in units of S/s.
+
+    thresholdInDb - The amount, in decibels, that a bin must exceed its
+    noise floor estimate to be considered occupied.
+
+    eventStreamPtr - A pointer to the stream to which start and stop
+    events are written.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumDetector::SpectrumDetector(uint32_t numberOfBins,
+  float sampleRate,
+  float thresholdInDb,
+  FILE *eventStreamPtr)
+{
+  uint32_t i;
+
+  if (sampleRate <= 0)
+  {
+    // Keep it sane.
+    sampleRate = 256000;
+  } // if
+
+  // Retrieve for later use.
+  this->numberOfBins = numberOfBins;
+  this->sampleRate = sampleRate;
+  this->eventStreamPtr = eventStreamPtr;
+
+  // Each bin spans this much bandwidth.
+  binWidthInHz = sampleRate / numberOfBins;
+
+  // Convert the threshold to a power ratio.
+  thresholdFactor = powf(10,thresholdInDb / 10);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // These values work nicely with an 8192-point FFT.  The
+  // guard cells keep the skirts of a signal out of its
+  // own noise estimate.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  guardCells = 4;
+  referenceCells = 16;
+  mergeGap = 2;
+  hangFrames = 3;
+  confirmFrames = 3;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Nothing has been processed yet.
+  frameCount = 0;
+  numberOfStarts = 0;
+  numberOfClusters = 0;
+
+  // Allocate the noise floor estimates.
+  noiseFloorPtr = new float[numberOfBins];
+
+  for (i = 0; i < MAX_DETECTED_SIGNALS; i++)
+  {
+    // No signals are being tracked.
+    signals[i].active = false;
+  } // for
+
+  return;
+
+} // SpectrumDetector
+
+/*****************************************************************************
+
+  Name: ~SpectrumDetector
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumDetector.  Any signals that are still being
+  tracked, and that have started, have their stop events emitted.
+
+  Calling Sequence: ~SpectrumDetector()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumDetector::~SpectrumDetector(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < MAX_DETECTED_SIGNALS; i++)
+  {
+    if (signals[i].active && signals[i].confirmed)
+    {
+      // The input has ended, so the signal has as well.
+      emitEvent("STOP",&signals[i],signals[i].lastFrame + 1);
+    } // if
+  } // for
+
+  // Release resources.
+  delete[] noiseFloorPtr;
+
+  return;
+
+} // ~SpectrumDetector
+
+/*****************************************************************************
+
+  Name: processSpectrum
+
+  Purpose: The purpose of this function is to run the detector on one
+  power spectrum.  This should be called for every FFT that is computed
+  so that no signals are missed.
+
+  Calling Sequence: processSpectrum(powerBufferPtr)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to the linear power spectrum.  The
+    spectrum is ordered such that the center frequency is in the center
+    of the array (the FFT output has already been shifted).
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumDetector::processSpectrum(float *powerBufferPtr)
+{
+
+  // Estimate the noise floor for each bin.
+  estimateNoiseFloor(powerBufferPtr);
+
+  // Group the occupied bins into signals.
+  findClusters(powerBufferPtr);
+
+  // Associate the clusters with the signals that we know about.
+  trackSignals();
+
+  // Keep track of time.
+  frameCount++;
+
+  return;
+
+} // processSpectrum
+
+/*****************************************************************************
+
+  Name: getNumberOfStarts
+
+  Purpose: The purpose of this function is to retrieve the number of
+  signals that have started so far.  A caller that wants to act on new
+  signals can watch for this to change.
+
+  Calling Sequence: numberOfStarts = getNumberOfStarts()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfStarts - The number of start events that have been emitted.
+
+*****************************************************************************/
+uint64_t SpectrumDetector::getNumberOfStarts(void)
+{
+
+  return (numberOfStarts);
+
+} // getNumberOfStarts
+
+/*****************************************************************************
+
+  Name: estimateNoiseFloor
+
+  Purpose: The purpose of this function is to estimate the noise floor of
+  each bin using cell averaging.  The reference cells on each side of the
+  bin under test are averaged, and the guard cells that are adjacent to
+  the bin under test are skipped.  The reference sums are slid across
+  the spectrum so that the cost is O(1) per bin regardless of the window
+  size.  Near the edges of the spectrum, only the reference cells that
+  exist are used.
+
+  Calling Sequence: estimateNoiseFloor(powerBufferPtr)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to the linear power spectrum.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumDetector::estimateNoiseFloor(float *powerBufferPtr)
+{
+  int32_t k;
+  int32_t n;
+  int32_t g;
+  int32_t r;
+  int32_t index;
+  double leftSum;
+  double rightSum;
+  int32_t leftCount;
+  int32_t rightCount;
+
+  // Work with signed quantities to keep the index math simple.
+  n = (int32_t)numberOfBins;
+  g = (int32_t)guardCells;
+  r = (int32_t)referenceCells;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Prime the windows for bin 0.  The left window is empty
+  // and the right window spans bins [g+1, g+r].
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  leftSum = 0;
+  leftCount = 0;
+  rightSum = 0;
+  rightCount = 0;
+
+  for (index = g + 1; (index <= (g + r)) && (index < n); index++)
+  {
+    rightSum += powerBufferPtr[index];
+    rightCount++;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  for (k = 0; k < n; k++)
+  {
+    if ((leftCount + rightCount) > 0)
+    {
+      noiseFloorPtr[k] = (leftSum + rightSum) / (leftCount + rightCount);
+    } // if
+    else
+    {
+      noiseFloorPtr[k] = powerBufferPtr[k];
+    } // else
+
+    //--------------------------------------------
+    // Slide the left window: bin k-g enters and
+    // bin k-g-r leaves.
+    //--------------------------------------------
+    index = k - g;
+    if (index >= 0)
+    {
+      leftSum += powerBufferPtr[index];
+      leftCount++;
+    } // if
+
+    index = k - g - r;
+    if (index >= 0)
+    {
+      leftSum -= powerBufferPtr[index];
+      leftCount--;
+    } // if
+    //--------------------------------------------
+
+    //--------------------------------------------
+    // Slide the right window: bin k+g+r+1 enters
+    // and bin k+g+1 leaves.
+    //--------------------------------------------
+    index = k + g + r + 1;
+    if (index < n)
+    {
+      rightSum += powerBufferPtr[index];
+      rightCount++;
+    } // if
+
+    index = k + g + 1;
+    if (index < n)
+    {
+      rightSum -= powerBufferPtr[index];
+      rightCount--;
+    } // if
+    //--------------------------------------------
+  } // for
+
+  return;
+
+} // estimateNoiseFloor
+
+/*****************************************************************************
+
+  Name: findClusters
+
+  Purpose: The purpose of this function is to group bins that exceed
+  their noise floor estimate into clusters.  Bins that are separated by
+  no more than mergeGap unoccupied bins are considered to belong to the
+  same signal.
+
+  Calling Sequence: findClusters(powerBufferPtr)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to the linear power spectrum.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumDetector::findClusters(float *powerBufferPtr)
+{
+  uint32_t i;
+  bool inCluster;
+  uint32_t lastOccupiedBin;
+  DetectedSignal *clusterPtr;
+
+  // Start with a clean slate.
+  numberOfClusters = 0;
+  inCluster = false;
+  lastOccupiedBin = 0;
+  clusterPtr = NULL;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    if (powerBufferPtr[i] > (noiseFloorPtr[i] * thresholdFactor))
+    {
+      if (inCluster && ((i - lastOccupiedBin) > (mergeGap + 1)))
+      {
+        // The gap is too large, so close the current cluster.
+        inCluster = false;
+      } // if
+
+      if (!inCluster)
+      {
+        if (numberOfClusters == MAX_DETECTED_SIGNALS)
+        {
+          // No more room, so ignore the rest of the spectrum.
+          break;
+        } // if
+
+        // Start a new cluster.
+        clusterPtr = &clusters[numberOfClusters];
+        numberOfClusters++;
+
+        clusterPtr->startBin = i;
+        clusterPtr->peakBin = i;
+        clusterPtr->peakPower = powerBufferPtr[i];
+        inCluster = true;
+      } // if
+
+      // Extend the cluster to this bin.
+      clusterPtr->endBin = i;
+
+      if (powerBufferPtr[i] > clusterPtr->peakPower)
+      {
+        clusterPtr->peakBin = i;
+        clusterPtr->peakPower = powerBufferPtr[i];
+      } // if
+
+      lastOccupiedBin = i;
+    } // if
+  } // for
+
+  for (i = 0; i < numberOfClusters; i++)
+  {
+    clusters[i].peakFrequency =
+      interpolatePeakFrequency(powerBufferPtr,clusters[i].peakBin);
+  } // for
+
+  return;
+
+} // findClusters
+
+/*****************************************************************************
+
+  Name: trackSignals
+
+  Purpose: The purpose of this function is to associate the clusters of
+  the current spectrum with the signals that are being tracked.  A
+  cluster that overlaps a tracked signal updates that signal.  The
+  occupied extents of a signal are those of the clusters that overlap it
+  in the current spectrum, so a signal that drifts or narrows is
+  followed rather than smeared over everything it has touched.  A
+  cluster that overlaps nothing is tracked as a candidate, which starts
+  (as of the spectrum in which it was first seen) once it has been seen
+  in confirmFrames spectra in a row, and is forgotten if it misses one
+  before then.  This keeps noise from starting signals: with the
+  default threshold of 10dB, noise crosses the threshold in two or
+  three places in almost every 8192 point spectrum.  A signal that has
+  started and has not been seen for more than hangFrames spectra is
+  stopped.
+
+  Calling Sequence: trackSignals()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumDetector::trackSignals(void)
+{
+  uint32_t i;
+  uint32_t j;
+  bool matched;
+  DetectedSignal *clusterPtr;
+  DetectedSignal *signalPtr;
+
+  for (j = 0; j < MAX_DETECTED_SIGNALS; j++)
+  {
+    signals[j].updated = false;
+  } // for
+
+  for (i = 0; i < numberOfClusters; i++)
+  {
+    clusterPtr = &clusters[i];
+    matched = false;
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Look for a tracked signal that overlaps the cluster.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    for (j = 0; (j < MAX_DETECTED_SIGNALS) && !matched; j++)
+    {
+      signalPtr = &signals[j];
+
+      if (signalPtr->active &&
+          (clusterPtr->startBin <= (signalPtr->endBin + mergeGap)) &&
+          ((clusterPtr->endBin + mergeGap) >= signalPtr->startBin))
+      {
+        if (!signalPtr->updated)
+        {
+          // The first cluster of this spectrum replaces the extents.
+          signalPtr->startBin = clusterPtr->startBin;
+          signalPtr->endBin = clusterPtr->endBin;
+        } // if
+        else
+        {
+          // Other clusters of this spectrum widen them.
+          if (clusterPtr->startBin < signalPtr->startBin)
+          {
+            signalPtr->startBin = clusterPtr->startBin;
+          } // if
+
+          if (clusterPtr->endBin > signalPtr->endBin)
+          {
+            signalPtr->endBin = clusterPtr->endBin;
+          } // if
+        } // else
+
+        // Remember the strongest peak.
+        if (clusterPtr->peakPower > signalPtr->peakPower)
+        {
+          signalPtr->peakBin = clusterPtr->peakBin;
+          signalPtr->peakPower = clusterPtr->peakPower;
+          signalPtr->peakFrequency = clusterPtr->peakFrequency;
+        } // if
+
+        signalPtr->lastFrame = frameCount;
+        signalPtr->missCount = 0;
+        signalPtr->updated = true;
+        matched = true;
+
+        if (!signalPtr->confirmed)
+        {
+          signalPtr->hitCount++;
+
+          if (signalPtr->hitCount >= confirmFrames)
+          {
+            // It isn't noise, so it started when it was first seen.
+            signalPtr->confirmed = true;
+
+            emitEvent("START",signalPtr,signalPtr->startFrame);
+            numberOfStarts++;
+          } // if
+        } // if
+      } // if
+    } // for
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // This may be a new signal, so start tracking it.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    for (j = 0; (j < MAX_DETECTED_SIGNALS) && !matched; j++)
+    {
+      signalPtr = &signals[j];
+
+      if (!signalPtr->active)
+      {
+        *signalPtr = *clusterPtr;
+        signalPtr->startFrame = frameCount;
+        signalPtr->lastFrame = frameCount;
+        signalPtr->missCount = 0;
+        signalPtr->hitCount = 1;
+        signalPtr->confirmed = (confirmFrames <= 1);
+        signalPtr->active = true;
+        signalPtr->updated = true;
+        matched = true;
+
+        if (signalPtr->confirmed)
+        {
+          emitEvent("START",signalPtr,frameCount);
+          numberOfStarts++;
+        } // if
+      } // if
+    } // for
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Stop the signals that have gone away.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (j = 0; j < MAX_DETECTED_SIGNALS; j++)
+  {
+    signalPtr = &signals[j];
+
+    if (signalPtr->active && !signalPtr->updated)
+    {
+      if (!signalPtr->confirmed)
+      {
+        // It was noise, so it never started.
+        signalPtr->active = false;
+      } // if
+      else
+      {
+        signalPtr->missCount++;
+
+        if (signalPtr->missCount > hangFrames)
+        {
+          // The signal ended after the last spectrum in which it was seen.
+          emitEvent("STOP",signalPtr,signalPtr->lastFrame + 1);
+          signalPtr->active = false;
+        } // if
+      } // else
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // trackSignals
+
+/*****************************************************************************
+
+  Name: interpolatePeakFrequency
+
+  Purpose: The purpose of this function is to estimate the frequency of a
+  spectral peak with better resolution than the bin width.  A parabola is
+  fit through the log power of the peak bin and its two neighbors, and
+  the vertex of the parabola is used as the peak location.
+
+  Calling Sequence: frequency = interpolatePeakFrequency(powerBufferPtr,
+                                                         peakBin)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to the linear power spectrum.
+
+    peakBin - The bin that contains the local maximum.
+
+ Outputs:
+
+    frequency - The interpolated peak frequency in Hz, relative to the
+    center frequency.
+
+*****************************************************************************/
+float SpectrumDetector::interpolatePeakFrequency(float *powerBufferPtr,
+  uint32_t peakBin)
+{
+  float alpha;
+  float beta;
+  float gamma;
+  float denominator;
+  float delta;
+  float frequency;
+
+  // Default to no correction.
+  delta = 0;
+
+  if ((peakBin > 0) && (peakBin < (numberOfBins - 1)))
+  {
+    // Work in decibels since the main lobe is nearly parabolic there.
+    alpha = 10 * log10f(powerBufferPtr[peakBin - 1] + 1e-20f);
+    beta = 10 * log10f(powerBufferPtr[peakBin] + 1e-20f);
+    gamma = 10 * log10f(powerBufferPtr[peakBin + 1] + 1e-20f);
+
+    denominator = alpha - (2 * beta) + gamma;
+
+    if (denominator != 0)
+    {
+      delta = 0.5f * (alpha - gamma) / denominator;
+    } // if
+  } // if
+
+  // The center bin corresponds to 0Hz.
+  frequency = ((float)peakBin + delta - (float)(numberOfBins / 2));
+  frequency *= binWidthInHz;
+
+  return (frequency);
+
+} // interpolatePeakFrequency
+
+/*****************************************************************************
+
+  Name: emitEvent
+
+  Purpose: The purpose of this function is to write a detection event to
+  the event stream.  Each event is one line of comma separated values
+  formatted as:
+
+    event,frame,timeInSeconds,centerFrequencyInHz,bandwidthInHz,
+    peakPowerInDb,peakFrequencyInHz,durationInSeconds
+
+  where event is either START or STOP.  Frequencies are relative to the
+  center frequency of the IQ data, and time is measured in samples so
+  that it is accurate for file playback.  The hang time that is used to
+  bridge short fades is not included in the time of a STOP event.  The
+  center frequency and bandwidth describe the bins that the signal
+  occupied in the last spectrum in which it was seen.  For a STOP event,
+  the peak power and peak frequency are those of the strongest peak over
+  the whole lifetime of the signal.
+
+  Calling Sequence: emitEvent(eventNamePtr,signalPtr,eventFrame)
+
+  Inputs:
+
+    eventNamePtr - A pointer to the name of the event.
+
+    signalPtr - A pointer to the signal that generated the event.
+
+    eventFrame - The spectrum number at which the event occurred.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumDetector::emitEvent(const char *eventNamePtr,
+  DetectedSignal *signalPtr,
+  uint64_t eventFrame)
+{
+  float timeInSeconds;
+  float durationInSeconds;
+  float centerFrequency;
+  float bandwidth;
+  float peakPowerInDb;
+  float secondsPerFrame;
+
+  if (eventStreamPtr == NULL)
+  {
+    // Nowhere to write.
+    return;
+  } // if
+
+  // Each spectrum represents this much time.
+  secondsPerFrame = numberOfBins / sampleRate;
+
+  timeInSeconds = eventFrame * secondsPerFrame;
+  durationInSeconds = (eventFrame - signalPtr->startFrame) * secondsPerFrame;
+
+  // Compute the occupied band.
+  centerFrequency = (signalPtr->startBin + signalPtr->endBin) / 2.0f;
+  centerFrequency -= (float)(numberOfBins / 2);
+  centerFrequency *= binWidthInHz;
+  bandwidth = (signalPtr->endBin - signalPtr->startBin + 1) * binWidthInHz;
+
+  peakPowerInDb = 10 * log10f(signalPtr->peakPower + 1e-20f);
+
+  fprintf(eventStreamPtr,"%s,%llu,%.6f,%.1f,%.1f,%.2f,%.1f,%.6f\n",
+          eventNamePtr,
+          (unsigned long long)eventFrame,
+          timeInSeconds,
+          centerFrequency,
+          bandwidth,
+          peakPowerInDb,
+          signalPtr->peakFrequency,
+          durationInSeconds);
+
+  // Events are useless if they show up late.
+  fflush(eventStreamPtr);
+
+  return;
+
+} // emitEvent
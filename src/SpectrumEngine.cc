@@ -0,0 +1,825 @@
+//************************************************************************
+// file name: SpectrumEngine.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SpectrumEngine.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumEngine
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumEngine.
+
+  Calling Sequence: SpectrumEngine(numberOfPoints)
+
+  Inputs:
+
+    numberOfPoints - The FFT size.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumEngine::SpectrumEngine(uint32_t numberOfPoints)
+{
+
+  // This engine has tables of its own.
+  initialize(new SpectrumTables(numberOfPoints,HanningWindow));
+  ownsTables = true;
+
+  return;
+
+} // SpectrumEngine
+
+/*****************************************************************************
+
+  Name: SpectrumEngine
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumEngine that shares its window, shift table
+  and FFT plan with other engines.  Only the FFT buffers belong to this
+  engine, so engines that share tables can run in different threads.
+
+  Calling Sequence: SpectrumEngine(tablesPtr)
+
+  Inputs:
+
+    tablesPtr - A pointer to the shared tables.  The tables must outlive
+    the engine.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumEngine::SpectrumEngine(SpectrumTables *tablesPtr)
+{
+
+  initialize(tablesPtr);
+  ownsTables = false;
+
+  return;
+
+} // SpectrumEngine
+
+/*****************************************************************************
+
+  Name: ~SpectrumEngine
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumEngine.
+
+  Calling Sequence: ~SpectrumEngine()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumEngine::~SpectrumEngine(void)
+{
+
+  // Release FFT resources.
+  fftw_free(fftInputPtr);
+  fftw_free(fftOutputPtr);
+
+  delete[] correctedSamplesPtr;
+
+  if (ownsTables)
+  {
+    delete tablesPtr;
+  } // if
+
+  return;
+
+} // ~SpectrumEngine
+
+/*****************************************************************************
+
+  Name: initialize
+
+  Purpose: The purpose of this function is to set up the engine with a
+  set of tables.  The FFT buffers are allocated here, so nothing is
+  allocated while samples are being processed.
+
+  Calling Sequence: initialize(tablesPtr)
+
+  Inputs:
+
+    tablesPtr - A pointer to the tables that the engine uses.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumEngine::initialize(SpectrumTables *tablesPtr)
+{
+
+  // Retrieve for later use.
+  this->tablesPtr = tablesPtr;
+  numberOfPoints = tablesPtr->getNumberOfPoints();
+  fftShiftTablePtr = tablesPtr->getFftShiftTable();
+  windowPtr = tablesPtr->getWindow();
+  fftPlan = tablesPtr->getFftPlan();
+
+  // Default to FFTW.
+  fixedPointFftPtr = NULL;
+
+  // Default to no IQ correction.
+  correctorPtr = NULL;
+  correctedSamplesPtr = new int8_t[2 * numberOfPoints];
+
+  fftInputPtr =
+    (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*numberOfPoints);
+  fftOutputPtr =
+    (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*numberOfPoints);
+
+  return;
+
+} // initialize
+
+/*****************************************************************************
+
+  Name: setFixedPointFft
+
+  Purpose: The purpose of this function is to select the FFT engine that
+  computes the power spectrum.  When a fixed-point FFT is attached, it
+  is used instead of FFTW.  It must have the same number of points as
+  the engine.
+
+  Calling Sequence: setFixedPointFft(fixedPointFftPtr)
+
+  Inputs:
+
+    fixedPointFftPtr - A pointer to the fixed-point FFT.  A value of NULL
+    selects FFTW.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumEngine::setFixedPointFft(FixedPointFft *fixedPointFftPtr)
+{
+
+  this->fixedPointFftPtr = fixedPointFftPtr;
+
+  return;
+
+} // setFixedPointFft
+
+/*****************************************************************************
+
+  Name: setIqCorrector
+
+  Purpose: The purpose of this function is to attach the IQ front end
+  stage whose correction is applied to the samples of every spectrum.
+  The correction is only applied if the corrector was told to correct.
+
+  Calling Sequence: setIqCorrector(correctorPtr)
+
+  Inputs:
+
+    correctorPtr - A pointer to the IQ front end stage.  A value of NULL
+    indicates that the samples are used as they are.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumEngine::setIqCorrector(IqCorrector *correctorPtr)
+{
+
+  this->correctorPtr = correctorPtr;
+
+  return;
+
+} // setIqCorrector
+
+/*****************************************************************************
+
+  Name: setTables
+
+  Purpose: The purpose of this function is to switch the engine to a new
+  set of tables, for example to change the window.  The tables can be
+  built by another thread, so nothing expensive happens here, and since
+  the switch happens between spectra, no spectrum ever mixes two sets.
+  The engine never owns tables that it is handed.
+
+  Calling Sequence: previousTablesPtr = setTables(tablesPtr)
+
+  Inputs:
+
+    tablesPtr - A pointer to the new tables.  They must have the same
+    number of points as the engine, and they must outlive the engine.
+
+ Outputs:
+
+    previousTablesPtr - A pointer to the tables that were in use.  They
+    belong to the caller now, even if the engine built them.
+
+*****************************************************************************/
+SpectrumTables *SpectrumEngine::setTables(SpectrumTables *tablesPtr)
+{
+  SpectrumTables *previousTablesPtr;
+
+  previousTablesPtr = this->tablesPtr;
+
+  this->tablesPtr = tablesPtr;
+  fftShiftTablePtr = tablesPtr->getFftShiftTable();
+  windowPtr = tablesPtr->getWindow();
+  fftPlan = tablesPtr->getFftPlan();
+
+  ownsTables = false;
+
+  return (previousTablesPtr);
+
+} // setTables
+
+/*****************************************************************************
+
+  Name: getWindow
+
+  Purpose: The purpose of this function is to retrieve the window that
+  is applied to the data before the FFT, so that measurements can allow
+  for its noise bandwidth.
+
+  Calling Sequence: windowPtr = getWindow()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    windowPtr - A pointer to numberOfPoints window values.
+
+*****************************************************************************/
+const double *SpectrumEngine::getWindow(void)
+{
+
+  return (windowPtr);
+
+} // getWindow
+
+/*****************************************************************************
+
+  Name: getNumberOfPoints
+
+  Purpose: The purpose of this function is to retrieve the FFT size.
+  Every spectrum that the engine produces has this many values.
+
+  Calling Sequence: numberOfPoints = getNumberOfPoints()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfPoints - The FFT size.
+
+*****************************************************************************/
+uint32_t SpectrumEngine::getNumberOfPoints(void)
+{
+
+  return (numberOfPoints);
+
+} // getNumberOfPoints
+
+/*****************************************************************************
+
+  Name: computeSignalMagnitude
+
+  Purpose: The purpose of this function is to compute the magnitude of
+  IQ data.  The magnitude is estimated as the larger of |I| and |Q| plus
+  half of the smaller one.  This doesn't depend upon the engine, so
+  anyone can use it.
+
+  Calling Sequence: numberOfSamples = computeSignalMagnitude(
+                                         signalBufferPtr,
+                                         bufferLength,
+                                         magnitudeBufferPtr)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+    magnitudeBufferPtr - A pointer to storage for bufferLength / 2
+    values.
+
+ Outputs:
+
+    numberOfSamples - The number of magnitude values that were stored.
+
+*****************************************************************************/
+uint32_t SpectrumEngine::computeSignalMagnitude(
+  const int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  int16_t *magnitudeBufferPtr)
+{
+  uint32_t i;
+  uint32_t magnitudeIndex;
+  int16_t iMagnitude, qMagnitude;
+
+  // Reference the beginning of the magnitude buffer.
+  magnitudeIndex = 0;
+
+  for (i = 0; i < bufferLength; i += 2)
+  {
+    // Grab these values for the magnitude estimator.
+    iMagnitude = abs((int16_t)signalBufferPtr[i]);
+    qMagnitude = abs((int16_t)signalBufferPtr[i+1]);
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // This block of code performs a magnitude estimation of
+    // the complex signal.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    if (iMagnitude > qMagnitude)
+    {
+      magnitudeBufferPtr[magnitudeIndex] = iMagnitude  + (qMagnitude >> 1);
+    } // if
+    else
+    {
+      magnitudeBufferPtr[magnitudeIndex] = qMagnitude + (iMagnitude >> 1);
+    } // else
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    // Reference the next storage location.
+    magnitudeIndex++;
+  } // for
+
+  return (bufferLength / 2);
+
+} // computeSignalMagnitude
+
+/*****************************************************************************
+
+  Name: computePowerSpectrum
+
+  Purpose: The purpose of this function is to compute the power spectrum
+  of IQ data.  The data is windowed, transformed, and the linear power of
+  each bin, |X|^2 / N, is stored FFT shifted so that the center frequency
+  is in the center of the array.  If the block is short, the rest of the
+  FFT input is zero padded.  If an IQ corrector is attached, the DC
+  offset and imbalance are removed as the samples are converted, so
+  nothing is rounded and no DC is left behind.
+
+  Calling Sequence: numberOfSamples = computePowerSpectrum(signalBufferPtr,
+                                                           bufferLength,
+                                                           powerBufferPtr)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.  This
+    represents the total number of items in the buffer, rather than
+    the number of IQ sample pairs in the buffer.
+
+    powerBufferPtr - A pointer to storage for numberOfPoints values.
+
+ Outputs:
+
+    numberOfSamples - The number of IQ samples that were transformed.
+
+*****************************************************************************/
+uint32_t SpectrumEngine::computePowerSpectrum(
+  const int8_t *signalBufferPtr,
+  uint32_t bufferLength,
+  float *powerBufferPtr)
+{
+  uint32_t i;
+  uint32_t j;
+  double power;
+  double iK, qK;
+  bool correcting;
+  IqCorrection correction;
+
+  if (bufferLength > (2 * numberOfPoints))
+  {
+    // Only one FFT's worth of data is used.
+    bufferLength = 2 * numberOfPoints;
+  } // if
+
+  // Default to using the samples as they are.
+  correcting = false;
+
+  if (correctorPtr != NULL)
+  {
+    correcting = correctorPtr->getCorrection(&correction);
+  } // if
+
+  if (fixedPointFftPtr != NULL)
+  {
+    if (correcting)
+    {
+      // The integer FFT only takes 8-bit samples.
+      correctorPtr->correctSamples(signalBufferPtr,
+                                   bufferLength,
+                                   correctedSamplesPtr);
+
+      signalBufferPtr = correctedSamplesPtr;
+    } // if
+
+    // The integer FFT produces the same normalized, shifted output.
+    fixedPointFftPtr->computePowerSpectrum(signalBufferPtr,
+                                           bufferLength,
+                                           powerBufferPtr);
+
+    return (bufferLength / 2);
+  } // if
+
+  // Reference the beginning of the FFT buffer.
+  j = 0;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Fill up the input array.  The second index of the
+  // array is used as follows: a value of 0 references
+  // the real component of the signal, and a value of 1
+  // references the imaginary component of the signal.
+  // Each component is windowed so that sidelobes are
+  // reduced.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if (correcting)
+  {
+    for (i = 0; i < bufferLength; i += 2)
+    {
+      // Remove the DC offset.
+      iK = (double)signalBufferPtr[i] - correction.dcOffsetI;
+      qK = (double)signalBufferPtr[i+1] - correction.dcOffsetQ;
+
+      // Remove the imbalance, and window.
+      fftInputPtr[j][0] = iK * windowPtr[j];
+      fftInputPtr[j][1] = ((correction.iFactor * iK) +
+                           (correction.qFactor * qK)) * windowPtr[j];
+
+      // Reference the next storage location.
+      j += 1;
+    } // for
+  } // if
+  else
+  {
+    for (i = 0; i < bufferLength; i += 2)
+    {
+      // Store the real value.
+      fftInputPtr[j][0] = (double)signalBufferPtr[i] * windowPtr[j];
+
+      // Store the imaginary value.
+      fftInputPtr[j][1] = (double)signalBufferPtr[i+1] * windowPtr[j];
+
+      // Reference the next storage location.
+      j += 1;
+    } // for
+  } // else
+
+  // Zero pad a short block.
+  for (; j < numberOfPoints; j++)
+  {
+    fftInputPtr[j][0] = 0;
+    fftInputPtr[j][1] = 0;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Compute the DFT with this engine's buffers.
+  fftw_execute_dft(fftPlan,fftInputPtr,fftOutputPtr);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Compute the power of the spectrum.  Originally, I used
+  // a simple approximation for the magnitude, but the
+  // result was a lousy display of the spectrum.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    // Retrive the in-phase and quadrature parts.
+    iK = fftOutputPtr[i][0];
+    qK = fftOutputPtr[i][1];
+
+    // Compute signal power, |I + jQ|.
+    power = (iK * iK) + (qK * qK);
+
+    // Scale for a normalized output.
+    power /= numberOfPoints;
+
+    //--------------------------------------------
+    // The fftShiftTable[] allows us to store
+    // the FFT output values such that the
+    // center frequency bin is in the center
+    // of the output array.  This results in a
+    // display that looks like that of a spectrum
+    // analyzer.
+    //--------------------------------------------
+    j = fftShiftTablePtr[i];
+    //--------------------------------------------
+
+    // Save the linear power.
+    powerBufferPtr[j] = (float)power;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (bufferLength / 2);
+
+} // computePowerSpectrum
+
+/*****************************************************************************
+
+  Name: convertToDb
+
+  Purpose: The purpose of this function is to convert a linear power
+  spectrum to decibels.  A scale factor is applied first, so a sum of
+  spectra can be converted to an average in the same pass.  A floor
+  keeps empty bins from turning into -infinity.
+
+  Calling Sequence: convertToDb(powerBufferPtr,scale,powerInDbBufferPtr)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to numberOfPoints linear power values.
+
+    scale - The factor by which each power value is multiplied.
+
+    powerInDbBufferPtr - A pointer to storage for numberOfPoints values.
+    This may be the same storage as powerBufferPtr.
+
+ Outputs:
+
+    powerInDbBufferPtr - The power spectrum in decibels.
+
+*****************************************************************************/
+void SpectrumEngine::convertToDb(const float *powerBufferPtr,
+  float scale,
+  float *powerInDbBufferPtr)
+{
+
+  convertSpanToDb(powerBufferPtr,scale,powerInDbBufferPtr,0,numberOfPoints);
+
+  return;
+
+} // convertToDb
+
+/*****************************************************************************
+
+  Name: binSpectrum
+
+  Purpose: The purpose of this function is to reduce a spectrum to a
+  smaller number of bins, for example, to the width of a display.  Each
+  output bin holds the largest value of the input bins that it covers,
+  which is what the positive peak detector of a spectrum analyzer does,
+  so a narrow signal never falls between the cracks.  This works equally
+  well on linear or decibel values.
+
+  Calling Sequence: binSpectrum(spectrumPtr,
+                                binnedSpectrumPtr,
+                                numberOfBins)
+
+  Inputs:
+
+    spectrumPtr - A pointer to numberOfPoints spectrum values.
+
+    binnedSpectrumPtr - A pointer to storage for numberOfBins values.
+
+    numberOfBins - The number of output bins.
+
+ Outputs:
+
+    binnedSpectrumPtr - The binned spectrum.
+
+*****************************************************************************/
+void SpectrumEngine::binSpectrum(const float *spectrumPtr,
+  float *binnedSpectrumPtr,
+  uint32_t numberOfBins)
+{
+
+  binSpectrumSpan(spectrumPtr,0,numberOfPoints,binnedSpectrumPtr,numberOfBins);
+
+  return;
+
+} // binSpectrum
+
+/*****************************************************************************
+
+  Name: convertSpanToDb
+
+  Purpose: The purpose of this function is to convert part of a linear
+  power spectrum to decibels.  This is what convertToDb() does, but only
+  the points in the span are touched, which saves work when only part of
+  the spectrum is displayed.
+
+  Calling Sequence: convertSpanToDb(powerBufferPtr,
+                                    scale,
+                                    powerInDbBufferPtr,
+                                    firstPoint,
+                                    numberOfPointsInSpan)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to numberOfPoints linear power values.
+
+    scale - The factor by which each power value is multiplied.
+
+    powerInDbBufferPtr - A pointer to storage for numberOfPoints values.
+    This may be the same storage as powerBufferPtr.
+
+    firstPoint - The first point of the span.
+
+    numberOfPointsInSpan - The number of points in the span.
+
+ Outputs:
+
+    powerInDbBufferPtr - The span of the power spectrum in decibels, at
+    the same positions that it has in powerBufferPtr.
+
+*****************************************************************************/
+void SpectrumEngine::convertSpanToDb(const float *powerBufferPtr,
+  float scale,
+  float *powerInDbBufferPtr,
+  uint32_t firstPoint,
+  uint32_t numberOfPointsInSpan)
+{
+  uint32_t i;
+  uint32_t end;
+
+  end = firstPoint + numberOfPointsInSpan;
+
+  if (end > numberOfPoints)
+  {
+    // Keep it sane.
+    end = numberOfPoints;
+  } // if
+
+  for (i = firstPoint; i < end; i++)
+  {
+    powerInDbBufferPtr[i] = 10 * log10f((powerBufferPtr[i] * scale) + 1e-20f);
+  } // for
+
+  return;
+
+} // convertSpanToDb
+
+/*****************************************************************************
+
+  Name: convertSpanToRelativeDb
+
+  Purpose: The purpose of this function is to convert part of a linear
+  power spectrum to decibels relative to a reference spectrum.  The
+  reference is subtracted in the same pass that converts to decibels, so
+  a differential display costs no more than a normal one.  An offset is
+  added, which puts a difference of zero wherever the display wants it.
+
+  Calling Sequence: convertSpanToRelativeDb(powerBufferPtr,
+                                            scale,
+                                            referenceInDbPtr,
+                                            offsetInDb,
+                                            powerInDbBufferPtr,
+                                            firstPoint,
+                                            numberOfPointsInSpan)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to numberOfPoints linear power values.
+
+    scale - The factor by which each power value is multiplied.
+
+    referenceInDbPtr - A pointer to numberOfPoints reference values in
+    decibels.
+
+    offsetInDb - The value that is added to every difference.
+
+    powerInDbBufferPtr - A pointer to storage for numberOfPoints values.
+    This may be the same storage as powerBufferPtr.
+
+    firstPoint - The first point of the span.
+
+    numberOfPointsInSpan - The number of points in the span.
+
+ Outputs:
+
+    powerInDbBufferPtr - The span of the difference in decibels, plus the
+    offset, at the same positions that it has in powerBufferPtr.
+
+*****************************************************************************/
+void SpectrumEngine::convertSpanToRelativeDb(const float *powerBufferPtr,
+  float scale,
+  const float *referenceInDbPtr,
+  float offsetInDb,
+  float *powerInDbBufferPtr,
+  uint32_t firstPoint,
+  uint32_t numberOfPointsInSpan)
+{
+  uint32_t i;
+  uint32_t end;
+
+  end = firstPoint + numberOfPointsInSpan;
+
+  if (end > numberOfPoints)
+  {
+    // Keep it sane.
+    end = numberOfPoints;
+  } // if
+
+  for (i = firstPoint; i < end; i++)
+  {
+    powerInDbBufferPtr[i] = 10 * log10f((powerBufferPtr[i] * scale) + 1e-20f) -
+                            referenceInDbPtr[i] + offsetInDb;
+  } // for
+
+  return;
+
+} // convertSpanToRelativeDb
+
+/*****************************************************************************
+
+  Name: binSpectrumSpan
+
+  Purpose: The purpose of this function is to reduce part of a spectrum
+  to a number of bins.  This is what binSpectrum() does, but only for the
+  points in the span.  When the span has fewer points than there are
+  bins, each point fills several bins.
+
+  Calling Sequence: binSpectrumSpan(spectrumPtr,
+                                    firstPoint,
+                                    numberOfPointsInSpan,
+                                    binnedSpectrumPtr,
+                                    numberOfBins)
+
+  Inputs:
+
+    spectrumPtr - A pointer to numberOfPoints spectrum values.
+
+    firstPoint - The first point of the span.
+
+    numberOfPointsInSpan - The number of points in the span.
+
+    binnedSpectrumPtr - A pointer to storage for numberOfBins values.
+
+    numberOfBins - The number of output bins.
+
+ Outputs:
+
+    binnedSpectrumPtr - The binned spectrum.
+
+*****************************************************************************/
+void SpectrumEngine::binSpectrumSpan(const float *spectrumPtr,
+  uint32_t firstPoint,
+  uint32_t numberOfPointsInSpan,
+  float *binnedSpectrumPtr,
+  uint32_t numberOfBins)
+{
+  uint32_t bin;
+  uint32_t i;
+  uint32_t start;
+  uint32_t end;
+  float maximum;
+
+  for (bin = 0; bin < numberOfBins; bin++)
+  {
+    // Compute the span of input bins that this output bin covers.
+    start = (uint32_t)(((uint64_t)bin * numberOfPointsInSpan) /
+                       numberOfBins);
+    end = (uint32_t)(((uint64_t)(bin + 1) * numberOfPointsInSpan) /
+                     numberOfBins);
+
+    if (end <= start)
+    {
+      // There are more output bins than input bins.
+      end = start + 1;
+    } // if
+
+    start += firstPoint;
+    end += firstPoint;
+
+    maximum = spectrumPtr[start];
+
+    for (i = start + 1; i < end; i++)
+    {
+      if (spectrumPtr[i] > maximum)
+      {
+        maximum = spectrumPtr[i];
+      } // if
+    } // for
+
+    binnedSpectrumPtr[bin] = maximum;
+  } // for
+
+  return;
+
+} // binSpectrumSpan
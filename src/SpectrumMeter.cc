@@ -0,0 +1,695 @@
+//************************************************************************
+// file name: SpectrumMeter.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "SpectrumMeter.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumMeter
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumMeter.  Until a window is set, the spectrum
+  is assumed to have been computed with a Hanning window.
+
+  Calling Sequence: SpectrumMeter(numberOfBins,sampleRate,logStreamPtr)
+
+  Inputs:
+
+    numberOfBins - The number of bins in each power spectrum.
+
+    sampleRate - The sample rate of incoming IQ data in units of S/s.
+
+    logStreamPtr - A pointer to the stream to which the measurements of
+    every spectrum are written.  A value of NULL writes nothing.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumMeter::SpectrumMeter(uint32_t numberOfBins,
+  float sampleRate,
+  FILE *logStreamPtr)
+{
+
+  if (sampleRate <= 0)
+  {
+    // Keep it sane.
+    sampleRate = 256000;
+  } // if
+
+  // Retrieve for later use.
+  this->numberOfBins = numberOfBins;
+  this->sampleRate = sampleRate;
+  this->logStreamPtr = logStreamPtr;
+
+  // Each bin spans this much bandwidth.
+  binWidthInHz = sampleRate / numberOfBins;
+
+  // This is the Hanning window.
+  noiseBandwidth = 1.5;
+
+  numberOfChannels = 0;
+  spectraInSums = 0;
+  frameCount = 0;
+
+  // The running sum starts with an empty range.
+  cumulativePowerPtr = new double[numberOfBins + 1];
+  cumulativePowerPtr[0] = 0;
+
+  return;
+
+} // SpectrumMeter
+
+/*****************************************************************************
+
+  Name: ~SpectrumMeter
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumMeter.
+
+  Calling Sequence: ~SpectrumMeter()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumMeter::~SpectrumMeter(void)
+{
+
+  if (logStreamPtr != NULL)
+  {
+    fflush(logStreamPtr);
+  } // if
+
+  // Release resources.
+  delete[] cumulativePowerPtr;
+
+  return;
+
+} // ~SpectrumMeter
+
+/*****************************************************************************
+
+  Name: addChannel
+
+  Purpose: The purpose of this function is to add a channel to be
+  measured.  The adjacent channels have the same bandwidth as the
+  channel, and are centered the spacing away on either side.
+
+  Calling Sequence: success = addChannel(centerFrequency,
+                                         bandwidth,
+                                         spacing)
+
+  Inputs:
+
+    centerFrequency - The center of the channel in Hz, relative to the
+    center frequency of the IQ data.
+
+    bandwidth - The bandwidth of the channel in Hz.
+
+    spacing - The distance between the center of the channel and the
+    center of each adjacent channel in Hz.  A value of 0 places the
+    adjacent channels right next to the channel.
+
+ Outputs:
+
+    success - A flag that indicates whether or not the channel was added.
+    A value of true indicates that it was added, and a value of false
+    indicates that there was no room or the bandwidth was invalid.
+
+*****************************************************************************/
+bool SpectrumMeter::addChannel(float centerFrequency,
+  float bandwidth,
+  float spacing)
+{
+  MeterChannel *channelPtr;
+
+  if ((numberOfChannels == MAX_METER_CHANNELS) || (bandwidth <= 0))
+  {
+    return (false);
+  } // if
+
+  channelPtr = &channels[numberOfChannels];
+
+  channelPtr->centerFrequency = centerFrequency;
+  channelPtr->bandwidth = bandwidth;
+  channelPtr->spacing = (spacing > 0) ? spacing : bandwidth;
+
+  computeChannelBins(channelPtr);
+
+  // Start the channel with empty sums.
+  powerSum[numberOfChannels] = 0;
+  lowerSum[numberOfChannels] = 0;
+  upperSum[numberOfChannels] = 0;
+  occupiedSum[numberOfChannels] = 0;
+
+  numberOfChannels++;
+
+  return (true);
+
+} // addChannel
+
+/*****************************************************************************
+
+  Name: getNumberOfChannels
+
+  Purpose: The purpose of this function is to retrieve the number of
+  channels that are being measured.
+
+  Calling Sequence: numberOfChannels = getNumberOfChannels()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfChannels - The number of channels.
+
+*****************************************************************************/
+uint32_t SpectrumMeter::getNumberOfChannels(void)
+{
+
+  return (numberOfChannels);
+
+} // getNumberOfChannels
+
+/*****************************************************************************
+
+  Name: setSampleRate
+
+  Purpose: The purpose of this function is to change the sample rate of
+  the IQ data.  The channels keep their frequencies, so they move to
+  different bins.
+
+  Calling Sequence: setSampleRate(sampleRate)
+
+  Inputs:
+
+    sampleRate - The sample rate of incoming IQ data in units of S/s.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumMeter::setSampleRate(float sampleRate)
+{
+  uint32_t i;
+
+  if (sampleRate > 0)
+  {
+    this->sampleRate = sampleRate;
+    binWidthInHz = sampleRate / numberOfBins;
+
+    for (i = 0; i < numberOfChannels; i++)
+    {
+      computeChannelBins(&channels[i]);
+    } // for
+  } // if
+
+  return;
+
+} // setSampleRate
+
+/*****************************************************************************
+
+  Name: setWindow
+
+  Purpose: The purpose of this function is to tell the meter which window
+  the spectrum was computed with.  Every bin of a windowed spectrum
+  collects the noise of a little more than one bin, so the power of a
+  range of bins is divided by the equivalent noise bandwidth of the
+  window, numberOfBins * sum(w^2) / sum(w)^2.
+
+  Calling Sequence: setWindow(windowPtr)
+
+  Inputs:
+
+    windowPtr - A pointer to numberOfBins window values.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumMeter::setWindow(const double *windowPtr)
+{
+  uint32_t i;
+  double sum;
+  double sumOfSquares;
+
+  sum = 0;
+  sumOfSquares = 0;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    sum += windowPtr[i];
+    sumOfSquares += windowPtr[i] * windowPtr[i];
+  } // for
+
+  if (sum > 0)
+  {
+    noiseBandwidth = (numberOfBins * sumOfSquares) / (sum * sum);
+  } // if
+
+  return;
+
+} // setWindow
+
+/*****************************************************************************
+
+  Name: processSpectrum
+
+  Purpose: The purpose of this function is to measure every channel in
+  one power spectrum.  This should be called for every FFT that is
+  computed.  The running sum of the spectrum is built first, and then
+  the power of each channel and its neighbors is the difference of two
+  sums.  The edges of the occupied band are found by a binary search of
+  the running sum, and are interpolated within their bins.
+
+  Calling Sequence: processSpectrum(powerBufferPtr)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to numberOfBins linear power values, FFT
+    shifted so that the center frequency is in the middle.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumMeter::processSpectrum(const float *powerBufferPtr)
+{
+  uint32_t i;
+  uint32_t firstBin;
+  uint32_t lastBin;
+  double sum;
+  double power;
+  double lowerPower;
+  double upperPower;
+  double totalPower;
+  double lowerEdge;
+  double upperEdge;
+  double occupiedBandwidth;
+  MeterChannel *channelPtr;
+
+  frameCount++;
+
+  if (numberOfChannels == 0)
+  {
+    // Nothing to measure.
+    return;
+  } // if
+
+  // Build the running sum of the spectrum.
+  sum = 0;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    sum += powerBufferPtr[i];
+    cumulativePowerPtr[i + 1] = sum;
+  } // for
+
+  for (i = 0; i < numberOfChannels; i++)
+  {
+    channelPtr = &channels[i];
+
+    power = getRangePower(channelPtr->firstBin,channelPtr->lastBin);
+    lowerPower = getRangePower(channelPtr->firstLowerBin,
+                               channelPtr->lastLowerBin);
+    upperPower = getRangePower(channelPtr->firstUpperBin,
+                               channelPtr->lastUpperBin);
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The occupied bandwidth is measured over the channel
+    // and its neighbors, with half of the remaining power
+    // on either side of the band.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    firstBin = channelPtr->firstLowerBin;
+    lastBin = channelPtr->lastUpperBin;
+    totalPower = cumulativePowerPtr[lastBin] - cumulativePowerPtr[firstBin];
+    occupiedBandwidth = 0;
+
+    if (totalPower > 0)
+    {
+      lowerEdge = findCumulativeBin(cumulativePowerPtr[firstBin] +
+                                    ((1 - OCCUPIED_FRACTION) / 2) *
+                                    totalPower,
+                                    firstBin,
+                                    lastBin);
+
+      upperEdge = findCumulativeBin(cumulativePowerPtr[firstBin] +
+                                    ((1 + OCCUPIED_FRACTION) / 2) *
+                                    totalPower,
+                                    firstBin,
+                                    lastBin);
+
+      occupiedBandwidth = (upperEdge - lowerEdge) * binWidthInHz;
+    } // if
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    readings[i].powerInDb = 10 * log10(power + 1e-20);
+    readings[i].occupiedBandwidth = occupiedBandwidth;
+
+    readings[i].lowerAcprInDb =
+      (channelPtr->lastLowerBin > channelPtr->firstLowerBin) ?
+        10 * log10((lowerPower + 1e-20) / (power + 1e-20)) : NAN;
+
+    readings[i].upperAcprInDb =
+      (channelPtr->lastUpperBin > channelPtr->firstUpperBin) ?
+        10 * log10((upperPower + 1e-20) / (power + 1e-20)) : NAN;
+
+    // Accumulate for the display.
+    powerSum[i] += power;
+    lowerSum[i] += lowerPower;
+    upperSum[i] += upperPower;
+    occupiedSum[i] += occupiedBandwidth;
+  } // for
+
+  spectraInSums++;
+
+  if (logStreamPtr != NULL)
+  {
+    writeReadings();
+  } // if
+
+  return;
+
+} // processSpectrum
+
+/*****************************************************************************
+
+  Name: getReadings
+
+  Purpose: The purpose of this function is to retrieve the measurements
+  of every channel, averaged over the spectra that have been processed
+  since the readings were last retrieved.  Powers are averaged before
+  they are converted to decibels.  If no spectra have been processed,
+  the latest readings are retrieved again.
+
+  Calling Sequence: numberOfChannels = getReadings(readingsPtr)
+
+  Inputs:
+
+    readingsPtr - A pointer to storage for MAX_METER_CHANNELS readings.
+
+ Outputs:
+
+    numberOfChannels - The number of readings that were stored.
+
+*****************************************************************************/
+uint32_t SpectrumMeter::getReadings(ChannelReading *readingsPtr)
+{
+  uint32_t i;
+  MeterChannel *channelPtr;
+
+  for (i = 0; i < numberOfChannels; i++)
+  {
+    if (spectraInSums > 0)
+    {
+      channelPtr = &channels[i];
+
+      readings[i].powerInDb =
+        10 * log10((powerSum[i] / spectraInSums) + 1e-20);
+
+      readings[i].occupiedBandwidth = occupiedSum[i] / spectraInSums;
+
+      readings[i].lowerAcprInDb =
+        (channelPtr->lastLowerBin > channelPtr->firstLowerBin) ?
+          10 * log10((lowerSum[i] + 1e-20) / (powerSum[i] + 1e-20)) : NAN;
+
+      readings[i].upperAcprInDb =
+        (channelPtr->lastUpperBin > channelPtr->firstUpperBin) ?
+          10 * log10((upperSum[i] + 1e-20) / (powerSum[i] + 1e-20)) : NAN;
+
+      // Start a new accumulation.
+      powerSum[i] = 0;
+      lowerSum[i] = 0;
+      upperSum[i] = 0;
+      occupiedSum[i] = 0;
+    } // if
+
+    readingsPtr[i] = readings[i];
+  } // for
+
+  spectraInSums = 0;
+
+  return (numberOfChannels);
+
+} // getReadings
+
+/*****************************************************************************
+
+  Name: computeChannelBins
+
+  Purpose: The purpose of this function is to find the bins that a
+  channel and its neighbors cover.  A bin belongs to a channel when its
+  center frequency is inside the channel.  Parts of a channel that are
+  outside of the spectrum are left out.
+
+  Calling Sequence: computeChannelBins(channelPtr)
+
+  Inputs:
+
+    channelPtr - A pointer to the channel.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumMeter::computeChannelBins(MeterChannel *channelPtr)
+{
+  float halfBandwidth;
+  float lowerCenter;
+  float upperCenter;
+
+  halfBandwidth = channelPtr->bandwidth / 2;
+  lowerCenter = channelPtr->centerFrequency - channelPtr->spacing;
+  upperCenter = channelPtr->centerFrequency + channelPtr->spacing;
+
+  channelPtr->firstBin =
+    frequencyToBin(channelPtr->centerFrequency - halfBandwidth);
+  channelPtr->lastBin =
+    frequencyToBin(channelPtr->centerFrequency + halfBandwidth);
+
+  channelPtr->firstLowerBin = frequencyToBin(lowerCenter - halfBandwidth);
+  channelPtr->lastLowerBin = frequencyToBin(lowerCenter + halfBandwidth);
+
+  if (channelPtr->lastLowerBin > channelPtr->firstBin)
+  {
+    // Overlapping channels don't share bins.
+    channelPtr->lastLowerBin = channelPtr->firstBin;
+  } // if
+
+  channelPtr->firstUpperBin = frequencyToBin(upperCenter - halfBandwidth);
+  channelPtr->lastUpperBin = frequencyToBin(upperCenter + halfBandwidth);
+
+  if (channelPtr->firstUpperBin < channelPtr->lastBin)
+  {
+    // Overlapping channels don't share bins.
+    channelPtr->firstUpperBin = channelPtr->lastBin;
+  } // if
+
+  return;
+
+} // computeChannelBins
+
+/*****************************************************************************
+
+  Name: frequencyToBin
+
+  Purpose: The purpose of this function is to find the first bin whose
+  center frequency is at or above a frequency.  The result is clamped to
+  the spectrum, so it can be used as either end of a range of bins.
+
+  Calling Sequence: bin = frequencyToBin(frequency)
+
+  Inputs:
+
+    frequency - The frequency in Hz, relative to the center frequency.
+
+ Outputs:
+
+    bin - The bin, from 0 to numberOfBins.
+
+*****************************************************************************/
+uint32_t SpectrumMeter::frequencyToBin(float frequency)
+{
+  double position;
+
+  // Bin numberOfBins / 2 is centered on 0Hz.
+  position = ceil((frequency / binWidthInHz) + (numberOfBins / 2));
+
+  position = (position < 0) ? 0 : position;
+  position = (position > numberOfBins) ? numberOfBins : position;
+
+  return ((uint32_t)position);
+
+} // frequencyToBin
+
+/*****************************************************************************
+
+  Name: findCumulativeBin
+
+  Purpose: The purpose of this function is to find where the running sum
+  of the spectrum reaches a value.  The sum is searched by bisection, and
+  the position is interpolated within the bin where the value is
+  reached, assuming that the power is spread evenly across the bin.
+
+  Calling Sequence: position = findCumulativeBin(target,firstBin,lastBin)
+
+  Inputs:
+
+    target - The value of the running sum that is to be found.
+
+    firstBin - The first bin of the range to be searched.
+
+    lastBin - The bin after the last bin of the range to be searched.
+
+ Outputs:
+
+    position - The position, in bins, at which the running sum reaches
+    the target.
+
+*****************************************************************************/
+double SpectrumMeter::findCumulativeBin(double target,
+  uint32_t firstBin,
+  uint32_t lastBin)
+{
+  uint32_t low;
+  uint32_t high;
+  uint32_t middle;
+  double binPower;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Find the first sum that reaches the target.  The sum
+  // at firstBin is below the target, and the sum at
+  // lastBin is not.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  low = firstBin;
+  high = lastBin;
+
+  while ((high - low) > 1)
+  {
+    middle = low + ((high - low) / 2);
+
+    if (cumulativePowerPtr[middle] < target)
+    {
+      low = middle;
+    } // if
+    else
+    {
+      high = middle;
+    } // else
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // The target is reached somewhere in bin low.
+  binPower = cumulativePowerPtr[high] - cumulativePowerPtr[low];
+
+  if (binPower <= 0)
+  {
+    return ((double)low);
+  } // if
+
+  return (low + ((target - cumulativePowerPtr[low]) / binPower));
+
+} // findCumulativeBin
+
+/*****************************************************************************
+
+  Name: getRangePower
+
+  Purpose: The purpose of this function is to compute the power in a
+  range of bins from the running sum of the spectrum.  The power is
+  corrected for the noise bandwidth of the window.
+
+  Calling Sequence: power = getRangePower(firstBin,lastBin)
+
+  Inputs:
+
+    firstBin - The first bin of the range.
+
+    lastBin - The bin after the last bin of the range.
+
+ Outputs:
+
+    power - The linear power in the range.
+
+*****************************************************************************/
+double SpectrumMeter::getRangePower(uint32_t firstBin,uint32_t lastBin)
+{
+  double power;
+
+  power = 0;
+
+  if (lastBin > firstBin)
+  {
+    power = cumulativePowerPtr[lastBin] - cumulativePowerPtr[firstBin];
+    power /= noiseBandwidth;
+  } // if
+
+  return (power);
+
+} // getRangePower
+
+/*****************************************************************************
+
+  Name: writeReadings
+
+  Purpose: The purpose of this function is to write the measurements of
+  the latest spectrum to the log, one line per channel, formatted as
+  spectrum,seconds,channel,powerDb,occupiedBandwidthHz,lowerAcprDb,
+  upperAcprDb.  An adjacent channel that is outside of the spectrum is
+  written as nan.
+
+  Calling Sequence: writeReadings()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumMeter::writeReadings(void)
+{
+  uint32_t i;
+  double timeInSeconds;
+
+  // Each spectrum consumes numberOfBins samples.
+  timeInSeconds = (double)(frameCount - 1) * numberOfBins / sampleRate;
+
+  for (i = 0; i < numberOfChannels; i++)
+  {
+    fprintf(logStreamPtr,"%llu,%.6f,%u,%.2f,%.1f,%.2f,%.2f\n",
+            (unsigned long long)frameCount - 1,
+            timeInSeconds,
+            i + 1,
+            readings[i].powerInDb,
+            readings[i].occupiedBandwidth,
+            readings[i].lowerAcprInDb,
+            readings[i].upperAcprInDb);
+  } // for
+
+  return;
+
+} // writeReadings
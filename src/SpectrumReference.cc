@@ -0,0 +1,525 @@
+//************************************************************************
+// file name: SpectrumReference.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <errno.h>
+
+#include "SpectrumReference.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumReference
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumReference.  If a file is specified and it
+  exists, the reference is loaded from it.
+
+  Calling Sequence: SpectrumReference(numberOfBins,
+                                      sampleRate,
+                                      averagingLength,
+                                      fileNamePtr)
+
+  Inputs:
+
+    numberOfBins - The number of bins in each power spectrum.
+
+    sampleRate - The sample rate of the IQ data in S/s.
+
+    averagingLength - The number of frames that are averaged into a
+    reference.
+
+    fileNamePtr - The file that the reference is loaded from, and that
+    new references are saved to.  A value of NULL keeps references in
+    memory only.  The name must outlive this object.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumReference::SpectrumReference(uint32_t numberOfBins,
+  float sampleRate,
+  uint32_t averagingLength,
+  const char *fileNamePtr)
+{
+
+  if (averagingLength == 0)
+  {
+    // Keep it sane.
+    averagingLength = 1;
+  } // if
+
+  // Retrieve for later use.
+  this->numberOfBins = numberOfBins;
+  this->sampleRate = sampleRate;
+  this->averagingLength = averagingLength;
+  this->fileNamePtr = fileNamePtr;
+
+  capturing = false;
+  framesCaptured = 0;
+  available = false;
+
+  sumPtr = new float[numberOfBins];
+  referenceInDbPtr = new float[numberOfBins];
+
+  if (fileNamePtr != NULL)
+  {
+    // A missing file just means that there is no reference yet.
+    load(fileNamePtr);
+  } // if
+
+  return;
+
+} // SpectrumReference
+
+/*****************************************************************************
+
+  Name: ~SpectrumReference
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumReference.
+
+  Calling Sequence: ~SpectrumReference()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumReference::~SpectrumReference(void)
+{
+
+  // Release resources.
+  delete[] sumPtr;
+  delete[] referenceInDbPtr;
+
+  return;
+
+} // ~SpectrumReference
+
+/*****************************************************************************
+
+  Name: startCapture
+
+  Purpose: The purpose of this function is to start capturing a new
+  reference.  The current reference stays in use until the new one is
+  complete.
+
+  Calling Sequence: startCapture()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumReference::startCapture(void)
+{
+
+  capturing = true;
+  framesCaptured = 0;
+
+  return;
+
+} // startCapture
+
+/*****************************************************************************
+
+  Name: accumulate
+
+  Purpose: The purpose of this function is to add the power spectrum of a
+  frame to the reference that is being captured.  Once averagingLength
+  frames have been added, the average becomes the reference, and it is
+  saved if there is a file for it.  Nothing is done when a reference
+  isn't being captured.
+
+  Calling Sequence: completed = accumulate(powerBufferPtr,scale)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to numberOfBins linear power values.
+
+    scale - The factor by which each power value is multiplied, so that
+    a sum of spectra can be passed.
+
+ Outputs:
+
+    completed - A flag that indicates whether or not this frame completed
+    the reference.
+
+*****************************************************************************/
+bool SpectrumReference::accumulate(const float *powerBufferPtr,float scale)
+{
+  uint32_t i;
+
+  if (!capturing)
+  {
+    return (false);
+  } // if
+
+  if (framesCaptured == 0)
+  {
+    for (i = 0; i < numberOfBins; i++)
+    {
+      sumPtr[i] = powerBufferPtr[i] * scale;
+    } // for
+  } // if
+  else
+  {
+    for (i = 0; i < numberOfBins; i++)
+    {
+      sumPtr[i] += powerBufferPtr[i] * scale;
+    } // for
+  } // else
+
+  framesCaptured++;
+
+  if (framesCaptured < averagingLength)
+  {
+    return (false);
+  } // if
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    referenceInDbPtr[i] = 10 * log10f((sumPtr[i] / framesCaptured) + 1e-20f);
+  } // for
+
+  capturing = false;
+  available = true;
+
+  if (fileNamePtr != NULL)
+  {
+    save(fileNamePtr);
+  } // if
+
+  return (true);
+
+} // accumulate
+
+/*****************************************************************************
+
+  Name: setSampleRate
+
+  Purpose: The purpose of this function is to tell the reference about a
+  new sample rate.  A reference that was taken at another rate covers
+  other frequencies, so it is dropped, along with any capture that is
+  in progress.
+
+  Calling Sequence: setSampleRate(sampleRate)
+
+  Inputs:
+
+    sampleRate - The sample rate of the IQ data in S/s.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumReference::setSampleRate(float sampleRate)
+{
+
+  if (sampleRate != this->sampleRate)
+  {
+    this->sampleRate = sampleRate;
+
+    available = false;
+    capturing = false;
+  } // if
+
+  return;
+
+} // setSampleRate
+
+/*****************************************************************************
+
+  Name: isCapturing
+
+  Purpose: The purpose of this function is to indicate whether or not a
+  reference is being captured.
+
+  Calling Sequence: capturing = isCapturing()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    capturing - A flag that indicates whether or not a reference is being
+    captured.
+
+*****************************************************************************/
+bool SpectrumReference::isCapturing(void)
+{
+
+  return (capturing);
+
+} // isCapturing
+
+/*****************************************************************************
+
+  Name: isAvailable
+
+  Purpose: The purpose of this function is to indicate whether or not
+  there is a reference to compare against.
+
+  Calling Sequence: available = isAvailable()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    available - A flag that indicates whether or not there is a
+    reference.
+
+*****************************************************************************/
+bool SpectrumReference::isAvailable(void)
+{
+
+  return (available);
+
+} // isAvailable
+
+/*****************************************************************************
+
+  Name: getFramesCaptured
+
+  Purpose: The purpose of this function is to retrieve the number of
+  frames that have been added to the reference that is being captured.
+
+  Calling Sequence: framesCaptured = getFramesCaptured()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    framesCaptured - The number of frames so far.
+
+*****************************************************************************/
+uint32_t SpectrumReference::getFramesCaptured(void)
+{
+
+  return (framesCaptured);
+
+} // getFramesCaptured
+
+/*****************************************************************************
+
+  Name: getAveragingLength
+
+  Purpose: The purpose of this function is to retrieve the number of
+  frames that are averaged into a reference.
+
+  Calling Sequence: averagingLength = getAveragingLength()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    averagingLength - The number of frames in a reference.
+
+*****************************************************************************/
+uint32_t SpectrumReference::getAveragingLength(void)
+{
+
+  return (averagingLength);
+
+} // getAveragingLength
+
+/*****************************************************************************
+
+  Name: getReferenceInDb
+
+  Purpose: The purpose of this function is to retrieve the reference.
+  It is only meaningful when isAvailable() says so.
+
+  Calling Sequence: referenceInDbPtr = getReferenceInDb()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    referenceInDbPtr - A pointer to numberOfBins values in decibels,
+    ordered from the lowest frequency to the highest frequency.
+
+*****************************************************************************/
+const float *SpectrumReference::getReferenceInDb(void)
+{
+
+  return (referenceInDbPtr);
+
+} // getReferenceInDb
+
+/*****************************************************************************
+
+  Name: load
+
+  Purpose: The purpose of this function is to load a reference from a
+  file that was written by save().  The reference is rejected if it was
+  taken with another FFT size or sample rate.
+
+  Calling Sequence: success = load(fileNamePtr)
+
+  Inputs:
+
+    fileNamePtr - The name of the file.
+
+ Outputs:
+
+    success - A flag that indicates whether or not the reference was
+    loaded.
+
+*****************************************************************************/
+bool SpectrumReference::load(const char *fileNamePtr)
+{
+  FILE *streamPtr;
+  char magic[4];
+  uint32_t fileNumberOfBins;
+  float fileSampleRate;
+  uint32_t fileAveragingLength;
+  size_t count;
+
+  streamPtr = fopen(fileNamePtr,"rb");
+
+  if (streamPtr == NULL)
+  {
+    if (errno != ENOENT)
+    {
+      fprintf(stderr,"Could not open reference %s: %s\n",
+              fileNamePtr,strerror(errno));
+    } // if
+
+    return (false);
+  } // if
+
+  // Read the header.
+  count = fread(magic,1,4,streamPtr);
+  count += fread(&fileNumberOfBins,sizeof(fileNumberOfBins),1,streamPtr);
+  count += fread(&fileSampleRate,sizeof(fileSampleRate),1,streamPtr);
+  count += fread(&fileAveragingLength,sizeof(fileAveragingLength),1,
+                 streamPtr);
+
+  if ((count != 7) || (memcmp(magic,"SREF",4) != 0))
+  {
+    fprintf(stderr,"%s is not a reference spectrum\n",fileNamePtr);
+    fclose(streamPtr);
+    return (false);
+  } // if
+
+  if ((fileNumberOfBins != numberOfBins) || (fileSampleRate != sampleRate))
+  {
+    fprintf(stderr,"Reference %s is for a %u point FFT at %.0fS/s,"
+            " not %u points at %.0fS/s\n",
+            fileNamePtr,fileNumberOfBins,fileSampleRate,
+            numberOfBins,sampleRate);
+
+    fclose(streamPtr);
+    return (false);
+  } // if
+
+  // A capture would overwrite what is loaded.
+  capturing = false;
+
+  count = fread(referenceInDbPtr,sizeof(float),numberOfBins,streamPtr);
+
+  fclose(streamPtr);
+
+  available = (count == numberOfBins);
+
+  if (!available)
+  {
+    fprintf(stderr,"Reference %s is truncated\n",fileNamePtr);
+  } // if
+
+  return (available);
+
+} // load
+
+/*****************************************************************************
+
+  Name: save
+
+  Purpose: The purpose of this function is to save the reference to a
+  file.  The file is binary, in host byte order, and is formatted as:
+
+    char magic[4] = "SREF"
+    uint32_t numberOfBins
+    float sampleRate
+    uint32_t averagingLength
+    float reference[numberOfBins]
+
+  The reference is in decibels and is ordered from the lowest frequency
+  to the highest frequency.
+
+  Calling Sequence: success = save(fileNamePtr)
+
+  Inputs:
+
+    fileNamePtr - The name of the file.
+
+ Outputs:
+
+    success - A flag that indicates whether or not the reference was
+    saved.
+
+*****************************************************************************/
+bool SpectrumReference::save(const char *fileNamePtr)
+{
+  FILE *streamPtr;
+  size_t count;
+
+  if (!available)
+  {
+    // Nothing to save.
+    return (false);
+  } // if
+
+  streamPtr = fopen(fileNamePtr,"wb");
+
+  if (streamPtr == NULL)
+  {
+    fprintf(stderr,"Could not save reference %s: %s\n",
+            fileNamePtr,strerror(errno));
+
+    return (false);
+  } // if
+
+  // Write the header.
+  count = fwrite("SREF",1,4,streamPtr);
+  count += fwrite(&numberOfBins,sizeof(numberOfBins),1,streamPtr);
+  count += fwrite(&sampleRate,sizeof(sampleRate),1,streamPtr);
+  count += fwrite(&averagingLength,sizeof(averagingLength),1,streamPtr);
+
+  // Write the reference.
+  count += fwrite(referenceInDbPtr,sizeof(float),numberOfBins,streamPtr);
+
+  if ((fclose(streamPtr) != 0) || (count != (7 + numberOfBins)))
+  {
+    fprintf(stderr,"Could not save reference %s\n",fileNamePtr);
+    return (false);
+  } // if
+
+  return (true);
+
+} // save
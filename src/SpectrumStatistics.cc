@@ -0,0 +1,640 @@
+//************************************************************************
+// file name: SpectrumStatistics.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "SpectrumStatistics.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumStatistics
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumStatistics.
+
+  Calling Sequence: SpectrumStatistics(numberOfBins,
+                                       windowLength,
+                                       percentile,
+                                       statisticsStreamPtr)
+
+  Inputs:
+
+    numberOfBins - The number of bins in each power spectrum.
+
+    windowLength - The number of spectra over which the statistics are
+    computed.
+
+    percentile - The percentile, in the range of 0 to 100, that is to be
+    tracked.  A value of 50 tracks the median.
+
+    statisticsStreamPtr - A pointer to the stream to which statistics
+    records are written.  A value of NULL disables the output.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumStatistics::SpectrumStatistics(uint32_t numberOfBins,
+  uint32_t windowLength,
+  float percentile,
+  FILE *statisticsStreamPtr)
+{
+  uint32_t i;
+
+  if (windowLength == 0)
+  {
+    // Keep it sane.
+    windowLength = 1;
+  } // if
+
+  if (percentile < 0)
+  {
+    percentile = 0;
+  } // if
+  else
+  {
+    if (percentile > 100)
+    {
+      percentile = 100;
+    } // if
+  } // else
+
+  // Retrieve for later use.
+  this->numberOfBins = numberOfBins;
+  this->windowLength = windowLength;
+  this->percentile = percentile;
+  this->statisticsStreamPtr = statisticsStreamPtr;
+
+  // The window is empty.
+  count = 0;
+  oldestIndex = 0;
+  percentileIndex = 0;
+  frameCount = 0;
+
+  // Allocate the windows.
+  historyPtr = new int16_t[numberOfBins * windowLength];
+  sortedPtr = new int16_t[numberOfBins * windowLength];
+  sumPtr = new int32_t[numberOfBins];
+  traceBufferPtr = new float[numberOfBins];
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    sumPtr[i] = 0;
+  } // for
+
+  return;
+
+} // SpectrumStatistics
+
+/*****************************************************************************
+
+  Name: ~SpectrumStatistics
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumStatistics.
+
+  Calling Sequence: ~SpectrumStatistics()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumStatistics::~SpectrumStatistics(void)
+{
+
+  // Release resources.
+  delete[] historyPtr;
+  delete[] sortedPtr;
+  delete[] sumPtr;
+  delete[] traceBufferPtr;
+
+  return;
+
+} // ~SpectrumStatistics
+
+/*****************************************************************************
+
+  Name: processSpectrum
+
+  Purpose: The purpose of this function is to add a power spectrum to the
+  window.  Once the window is full, the oldest spectrum is removed from
+  the window as the new one is added.  The cost is O(windowLength) in
+  the worst case for each bin, but it is a single memmove() of the
+  values that lie between the old value and the new value, which is
+  usually a small fraction of the window.
+
+  Calling Sequence: processSpectrum(powerInDbBufferPtr)
+
+  Inputs:
+
+    powerInDbBufferPtr - A pointer to the power spectrum in decibels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumStatistics::processSpectrum(float *powerInDbBufferPtr)
+{
+  uint32_t i;
+  float value;
+  int16_t newValue;
+  int16_t oldValue;
+  int16_t *binHistoryPtr;
+  int16_t *binSortedPtr;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Quantize to hundredths of a decibel.  Zero power
+    // shows up as -infinity, so clamp it.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    value = powerInDbBufferPtr[i] * 100;
+
+    if (!(value > -32768))
+    {
+      value = -32768;
+    } // if
+    else
+    {
+      if (value > 32767)
+      {
+        value = 32767;
+      } // if
+    } // else
+
+    newValue = (int16_t)lrintf(value);
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    // Reference the window for this bin.
+    binHistoryPtr = &historyPtr[i * windowLength];
+    binSortedPtr = &sortedPtr[i * windowLength];
+
+    if (count < windowLength)
+    {
+      // The window is still filling.
+      insertValue(binSortedPtr,count,newValue);
+      sumPtr[i] += newValue;
+    } // if
+    else
+    {
+      // Replace the oldest value.
+      oldValue = binHistoryPtr[oldestIndex];
+      replaceValue(binSortedPtr,oldValue,newValue);
+      sumPtr[i] += newValue - oldValue;
+    } // else
+
+    binHistoryPtr[oldestIndex] = newValue;
+  } // for
+
+  if (count < windowLength)
+  {
+    count++;
+  } // if
+
+  // Advance the ring.
+  oldestIndex++;
+  if (oldestIndex == windowLength)
+  {
+    oldestIndex = 0;
+  } // if
+
+  // The percentile position depends upon how full the window is.
+  percentileIndex = (uint32_t)(((percentile / 100) * (count - 1)) + 0.5);
+
+  frameCount++;
+
+  if ((frameCount % windowLength) == 0)
+  {
+    // Report once per window so that the records don't overlap.
+    writeStatistics();
+  } // if
+
+  return;
+
+} // processSpectrum
+
+/*****************************************************************************
+
+  Name: insertValue
+
+  Purpose: The purpose of this function is to insert a value into a
+  sorted window that is not yet full.
+
+  Calling Sequence: insertValue(sortedPtr,count,newValue)
+
+  Inputs:
+
+    sortedPtr - A pointer to the sorted window of a bin.
+
+    count - The number of values that are currently in the window.
+
+    newValue - The value to insert.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumStatistics::insertValue(int16_t *sortedPtr,
+  uint32_t count,
+  int16_t newValue)
+{
+  uint32_t low;
+  uint32_t high;
+  uint32_t middle;
+
+  // Find the first value that is greater than the new value.
+  low = 0;
+  high = count;
+
+  while (low < high)
+  {
+    middle = (low + high) / 2;
+
+    if (sortedPtr[middle] <= newValue)
+    {
+      low = middle + 1;
+    } // if
+    else
+    {
+      high = middle;
+    } // else
+  } // while
+
+  // Make room and store.
+  memmove(&sortedPtr[low + 1],
+          &sortedPtr[low],
+          (count - low) * sizeof(int16_t));
+
+  sortedPtr[low] = newValue;
+
+  return;
+
+} // insertValue
+
+/*****************************************************************************
+
+  Name: replaceValue
+
+  Purpose: The purpose of this function is to replace a value in a full
+  sorted window with a new value while keeping the window sorted.  The
+  old value is located with a binary search, and only the values that
+  lie between the old position and the new position are shifted.
+
+  Calling Sequence: replaceValue(sortedPtr,oldValue,newValue)
+
+  Inputs:
+
+    sortedPtr - A pointer to the sorted window of a bin.
+
+    oldValue - The value that is leaving the window.
+
+    newValue - The value that is entering the window.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumStatistics::replaceValue(int16_t *sortedPtr,
+  int16_t oldValue,
+  int16_t newValue)
+{
+  uint32_t low;
+  uint32_t high;
+  uint32_t middle;
+  uint32_t oldPosition;
+
+  if (oldValue == newValue)
+  {
+    // Nothing moves.
+    return;
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Locate the old value.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  low = 0;
+  high = windowLength;
+
+  while (low < high)
+  {
+    middle = (low + high) / 2;
+
+    if (sortedPtr[middle] < oldValue)
+    {
+      low = middle + 1;
+    } // if
+    else
+    {
+      high = middle;
+    } // else
+  } // while
+
+  oldPosition = low;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (newValue > oldValue)
+  {
+    //--------------------------------------------
+    // Find the last value that is not greater
+    // than the new value, and shift everything
+    // in between down by one.
+    //--------------------------------------------
+    low = oldPosition + 1;
+    high = windowLength;
+
+    while (low < high)
+    {
+      middle = (low + high) / 2;
+
+      if (sortedPtr[middle] <= newValue)
+      {
+        low = middle + 1;
+      } // if
+      else
+      {
+        high = middle;
+      } // else
+    } // while
+
+    memmove(&sortedPtr[oldPosition],
+            &sortedPtr[oldPosition + 1],
+            (low - oldPosition - 1) * sizeof(int16_t));
+
+    sortedPtr[low - 1] = newValue;
+    //--------------------------------------------
+  } // if
+  else
+  {
+    //--------------------------------------------
+    // Find the first value that is not less
+    // than the new value, and shift everything
+    // in between up by one.
+    //--------------------------------------------
+    low = 0;
+    high = oldPosition;
+
+    while (low < high)
+    {
+      middle = (low + high) / 2;
+
+      if (sortedPtr[middle] < newValue)
+      {
+        low = middle + 1;
+      } // if
+      else
+      {
+        high = middle;
+      } // else
+    } // while
+
+    memmove(&sortedPtr[low + 1],
+            &sortedPtr[low],
+            (oldPosition - low) * sizeof(int16_t));
+
+    sortedPtr[low] = newValue;
+    //--------------------------------------------
+  } // else
+
+  return;
+
+} // replaceValue
+
+/*****************************************************************************
+
+  Name: getMinimum
+
+  Purpose: The purpose of this function is to retrieve the minimum value
+  of each bin over the window.
+
+  Calling Sequence: getMinimum(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The minimum of each bin in decibels.
+
+*****************************************************************************/
+void SpectrumStatistics::getMinimum(float *traceInDbPtr)
+{
+  uint32_t i;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    if (count > 0)
+    {
+      traceInDbPtr[i] = sortedPtr[i * windowLength] / 100.0f;
+    } // if
+    else
+    {
+      traceInDbPtr[i] = -327.68f;
+    } // else
+  } // for
+
+  return;
+
+} // getMinimum
+
+/*****************************************************************************
+
+  Name: getMaximum
+
+  Purpose: The purpose of this function is to retrieve the maximum value
+  of each bin over the window.
+
+  Calling Sequence: getMaximum(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The maximum of each bin in decibels.
+
+*****************************************************************************/
+void SpectrumStatistics::getMaximum(float *traceInDbPtr)
+{
+  uint32_t i;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    if (count > 0)
+    {
+      traceInDbPtr[i] = sortedPtr[(i * windowLength) + count - 1] / 100.0f;
+    } // if
+    else
+    {
+      traceInDbPtr[i] = -327.68f;
+    } // else
+  } // for
+
+  return;
+
+} // getMaximum
+
+/*****************************************************************************
+
+  Name: getMean
+
+  Purpose: The purpose of this function is to retrieve the mean value
+  of each bin over the window.  This is the mean of the decibel values,
+  which is what a video averaging filter on a spectrum analyzer shows.
+
+  Calling Sequence: getMean(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The mean of each bin in decibels.
+
+*****************************************************************************/
+void SpectrumStatistics::getMean(float *traceInDbPtr)
+{
+  uint32_t i;
+  float scale;
+
+  if (count > 0)
+  {
+    scale = 1.0f / (100.0f * count);
+  } // if
+  else
+  {
+    scale = 0;
+  } // else
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    traceInDbPtr[i] = sumPtr[i] * scale;
+  } // for
+
+  return;
+
+} // getMean
+
+/*****************************************************************************
+
+  Name: getPercentile
+
+  Purpose: The purpose of this function is to retrieve the selected
+  percentile of each bin over the window.  With the default percentile
+  of 50, this is the median, which makes a fine noise floor estimate
+  since it ignores bursts that occupy less than half of the window.
+
+  Calling Sequence: getPercentile(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The percentile of each bin in decibels.
+
+*****************************************************************************/
+void SpectrumStatistics::getPercentile(float *traceInDbPtr)
+{
+  uint32_t i;
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    if (count > 0)
+    {
+      traceInDbPtr[i] =
+        sortedPtr[(i * windowLength) + percentileIndex] / 100.0f;
+    } // if
+    else
+    {
+      traceInDbPtr[i] = -327.68f;
+    } // else
+  } // for
+
+  return;
+
+} // getPercentile
+
+/*****************************************************************************
+
+  Name: writeStatistics
+
+  Purpose: The purpose of this function is to write the current
+  statistics to the statistics stream.  Each record is binary, in host
+  byte order, and is formatted as:
+
+    char magic[4] = "SSTA"
+    uint32_t numberOfBins
+    uint32_t windowLength
+    float percentile
+    uint64_t frameCount
+    float minimum[numberOfBins]
+    float maximum[numberOfBins]
+    float mean[numberOfBins]
+    float percentile[numberOfBins]
+
+  All traces are in decibels and are ordered from the lowest frequency
+  to the highest frequency.
+
+  Calling Sequence: writeStatistics()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumStatistics::writeStatistics(void)
+{
+
+  if (statisticsStreamPtr == NULL)
+  {
+    // Nowhere to write.
+    return;
+  } // if
+
+  // Write the header.
+  fwrite("SSTA",1,4,statisticsStreamPtr);
+  fwrite(&numberOfBins,sizeof(numberOfBins),1,statisticsStreamPtr);
+  fwrite(&windowLength,sizeof(windowLength),1,statisticsStreamPtr);
+  fwrite(&percentile,sizeof(percentile),1,statisticsStreamPtr);
+  fwrite(&frameCount,sizeof(frameCount),1,statisticsStreamPtr);
+
+  // Write the traces.
+  getMinimum(traceBufferPtr);
+  fwrite(traceBufferPtr,sizeof(float),numberOfBins,statisticsStreamPtr);
+
+  getMaximum(traceBufferPtr);
+  fwrite(traceBufferPtr,sizeof(float),numberOfBins,statisticsStreamPtr);
+
+  getMean(traceBufferPtr);
+  fwrite(traceBufferPtr,sizeof(float),numberOfBins,statisticsStreamPtr);
+
+  getPercentile(traceBufferPtr);
+  fwrite(traceBufferPtr,sizeof(float),numberOfBins,statisticsStreamPtr);
+
+  fflush(statisticsStreamPtr);
+
+  return;
+
+} // writeStatistics
@@ -0,0 +1,285 @@
+//************************************************************************
+// file name: SpectrumTables.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SpectrumTables.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumTables
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumTables.  The FFTW plan is made with a pair of
+  scratch arrays that are released once the plan exists, since the plan
+  is only ever executed on the buffers of the engines that share it.
+  FFTW planning isn't thread safe, so only one thread at a time may
+  construct or destroy tables.
+
+  Calling Sequence: SpectrumTables(numberOfPoints,windowType)
+
+  Inputs:
+
+    numberOfPoints - The FFT size.
+
+    windowType - The window that is applied before the FFT.  Valid
+    values are HanningWindow, HammingWindow, BlackmanWindow and
+    RectangularWindow.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumTables::SpectrumTables(uint32_t numberOfPoints,
+                               WindowType windowType)
+{
+  uint32_t i;
+  double phase;
+  double sum;
+  double scale;
+  fftw_complex *inputPtr;
+  fftw_complex *outputPtr;
+
+  // Retrieve for later use.
+  this->numberOfPoints = numberOfPoints;
+  this->windowType = windowType;
+
+  fftShiftTablePtr = new uint32_t[numberOfPoints];
+  windowPtr = new double[numberOfPoints];
+
+  sum = 0;
+
+  // Construct the window array.
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    phase = (2 * M_PI * i) / numberOfPoints;
+
+    switch (windowType)
+    {
+      case HammingWindow:
+      {
+        windowPtr[i] = 0.54 - 0.46 * cos(phase);
+        break;
+      } // case
+
+      case BlackmanWindow:
+      {
+        windowPtr[i] = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2 * phase);
+        break;
+      } // case
+
+      case RectangularWindow:
+      {
+        windowPtr[i] = 1;
+        break;
+      } // case
+
+      default:
+      {
+        // This is the Hanning window.
+        windowPtr[i] = 0.5 - 0.5 * cos(phase);
+        break;
+      } // case
+    } // switch
+
+    sum += windowPtr[i];
+  } // for
+
+  // Match the coherent gain of the Hanning window, which sums to N/2.
+  scale = (numberOfPoints / 2) / sum;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    windowPtr[i] *= scale;
+  } // for
+
+  // Construct the permuted indices.
+  for (i = 0; i < numberOfPoints/2; i++)
+  {
+    fftShiftTablePtr[i] = i + numberOfPoints/2;
+    fftShiftTablePtr[i + numberOfPoints/2] = i;
+  } // for
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // This block of code sets up FFTW for the requested number of points.
+  // Arrays from fftw_malloc() all have the same alignment, so the plan
+  // is good for any buffers that an engine allocates the same way.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  inputPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*numberOfPoints);
+  outputPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*numberOfPoints);
+
+  fftPlan = fftw_plan_dft_1d(numberOfPoints,inputPtr,outputPtr,
+                             FFTW_FORWARD,FFTW_ESTIMATE);
+
+  fftw_free(inputPtr);
+  fftw_free(outputPtr);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // SpectrumTables
+
+/*****************************************************************************
+
+  Name: ~SpectrumTables
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumTables.  Every engine that shares the tables
+  must be gone by now.
+
+  Calling Sequence: ~SpectrumTables()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumTables::~SpectrumTables(void)
+{
+
+  // Release FFT resources.
+  fftw_destroy_plan(fftPlan);
+
+  // Release resources.
+  delete[] fftShiftTablePtr;
+  delete[] windowPtr;
+
+  return;
+
+} // ~SpectrumTables
+
+/*****************************************************************************
+
+  Name: getNumberOfPoints
+
+  Purpose: The purpose of this function is to retrieve the FFT size that
+  the tables were built for.
+
+  Calling Sequence: numberOfPoints = getNumberOfPoints()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfPoints - The FFT size.
+
+*****************************************************************************/
+uint32_t SpectrumTables::getNumberOfPoints(void)
+{
+
+  return (numberOfPoints);
+
+} // getNumberOfPoints
+
+/*****************************************************************************
+
+  Name: getFftShiftTable
+
+  Purpose: The purpose of this function is to retrieve the table that
+  maps an FFT output index to its FFT shifted position.
+
+  Calling Sequence: fftShiftTablePtr = getFftShiftTable()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    fftShiftTablePtr - A pointer to numberOfPoints indices.
+
+*****************************************************************************/
+const uint32_t *SpectrumTables::getFftShiftTable(void)
+{
+
+  return (fftShiftTablePtr);
+
+} // getFftShiftTable
+
+/*****************************************************************************
+
+  Name: getWindowType
+
+  Purpose: The purpose of this function is to retrieve the type of the
+  window that is applied to the data before the FFT.
+
+  Calling Sequence: windowType = getWindowType()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    windowType - The type of the window.
+
+*****************************************************************************/
+WindowType SpectrumTables::getWindowType(void)
+{
+
+  return (windowType);
+
+} // getWindowType
+
+/*****************************************************************************
+
+  Name: getWindow
+
+  Purpose: The purpose of this function is to retrieve the window that
+  is applied to the data before the FFT.
+
+  Calling Sequence: windowPtr = getWindow()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    windowPtr - A pointer to numberOfPoints window values.
+
+*****************************************************************************/
+const double *SpectrumTables::getWindow(void)
+{
+
+  return (windowPtr);
+
+} // getWindow
+
+/*****************************************************************************
+
+  Name: getFftPlan
+
+  Purpose: The purpose of this function is to retrieve the FFTW plan.
+  The plan must be run with fftw_execute_dft() on buffers that were
+  allocated with fftw_malloc(), which is safe from several threads at
+  once.
+
+  Calling Sequence: fftPlan = getFftPlan()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    fftPlan - The forward FFT plan.
+
+*****************************************************************************/
+fftw_plan SpectrumTables::getFftPlan(void)
+{
+
+  return (fftPlan);
+
+} // getFftPlan
@@ -0,0 +1,452 @@
+//************************************************************************
+// file name: SpectrumTraces.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __FMA__
+#include <immintrin.h>
+#endif
+
+#include "SpectrumTraces.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: SpectrumTraces
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an SpectrumTraces.
+
+  Calling Sequence: SpectrumTraces(numberOfBins,traceModes,averagingLength)
+
+  Inputs:
+
+    numberOfBins - The number of bins in each power spectrum.
+
+    traceModes - The traces to maintain.  This is a combination of
+    TRACE_MAX_HOLD, TRACE_MIN_HOLD and TRACE_AVERAGE.
+
+    averagingLength - The number of spectra that are averaged by the
+    video averaging trace.  Once this many spectra have been seen, the
+    average becomes an exponential average with the same time constant.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumTraces::SpectrumTraces(uint32_t numberOfBins,
+  uint32_t traceModes,
+  uint32_t averagingLength)
+{
+
+  if (averagingLength == 0)
+  {
+    // Keep it sane.
+    averagingLength = 1;
+  } // if
+
+  // Retrieve for later use.
+  this->numberOfBins = numberOfBins;
+  this->traceModes = traceModes;
+
+  averagingFactor = 1.0f / averagingLength;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // All storage is allocated up front so that nothing is
+  // allocated while spectra are being processed.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  maxHoldPtr = new float[numberOfBins];
+  minHoldPtr = new float[numberOfBins];
+  averagePtr = new float[numberOfBins];
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Start with empty traces.
+  reset();
+
+  return;
+
+} // SpectrumTraces
+
+/*****************************************************************************
+
+  Name: ~SpectrumTraces
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an SpectrumTraces.
+
+  Calling Sequence: ~SpectrumTraces()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+SpectrumTraces::~SpectrumTraces(void)
+{
+
+  // Release resources.
+  delete[] maxHoldPtr;
+  delete[] minHoldPtr;
+  delete[] averagePtr;
+
+  return;
+
+} // ~SpectrumTraces
+
+/*****************************************************************************
+
+  Name: reset
+
+  Purpose: The purpose of this function is to clear all of the traces.
+  The next spectrum that is accumulated becomes the initial value of
+  each trace.
+
+  Calling Sequence: reset()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumTraces::reset(void)
+{
+
+  count = 0;
+
+  return;
+
+} // reset
+
+/*****************************************************************************
+
+  Name: setAveragingLength
+
+  Purpose: The purpose of this function is to change the number of
+  spectra in the video average.  The average carries on from where it
+  is, so the display doesn't jump.
+
+  Calling Sequence: setAveragingLength(averagingLength)
+
+  Inputs:
+
+    averagingLength - The number of spectra that are averaged by the
+    video averaging trace.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumTraces::setAveragingLength(uint32_t averagingLength)
+{
+
+  if (averagingLength == 0)
+  {
+    // Keep it sane.
+    averagingLength = 1;
+  } // if
+
+  averagingFactor = 1.0f / averagingLength;
+
+  return;
+
+} // setAveragingLength
+
+/*****************************************************************************
+
+  Name: getTraceModes
+
+  Purpose: The purpose of this function is to retrieve the trace modes
+  that are being maintained.
+
+  Calling Sequence: traceModes = getTraceModes()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    traceModes - A combination of TRACE_MAX_HOLD, TRACE_MIN_HOLD and
+    TRACE_AVERAGE.
+
+*****************************************************************************/
+uint32_t SpectrumTraces::getTraceModes(void)
+{
+
+  return (traceModes);
+
+} // getTraceModes
+
+/*****************************************************************************
+
+  Name: accumulate
+
+  Purpose: The purpose of this function is to fold a power spectrum into
+  the traces.  The max-hold and min-hold traces keep the largest and
+  smallest power of each bin, and the average trace is updated as
+  average += factor * (power - average).  Each enabled trace costs one
+  pass over the bins.
+
+  Calling Sequence: accumulate(powerBufferPtr)
+
+  Inputs:
+
+    powerBufferPtr - A pointer to the linear power spectrum.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void SpectrumTraces::accumulate(float *powerBufferPtr)
+{
+  uint32_t i;
+  float factor;
+#ifdef __SSE__
+  __m128 power;
+  __m128 trace;
+  __m128 factorVector;
+#endif
+
+  if (count == 0)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The first spectrum after a reset initializes the
+    // traces.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    memcpy(maxHoldPtr,powerBufferPtr,numberOfBins * sizeof(float));
+    memcpy(minHoldPtr,powerBufferPtr,numberOfBins * sizeof(float));
+    memcpy(averagePtr,powerBufferPtr,numberOfBins * sizeof(float));
+
+    count = 1;
+
+    return;
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  } // if
+
+  // Average the first few spectra evenly, then exponentially.
+  count++;
+  factor = 1.0f / count;
+
+  if (factor < averagingFactor)
+  {
+    factor = averagingFactor;
+  } // if
+
+  // Reference the start of the bins.
+  i = 0;
+
+#ifdef __SSE__
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Process four bins at a time.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  factorVector = _mm_set1_ps(factor);
+
+  for (; (i + 4) <= numberOfBins; i += 4)
+  {
+    power = _mm_loadu_ps(&powerBufferPtr[i]);
+
+    if (traceModes & TRACE_MAX_HOLD)
+    {
+      trace = _mm_loadu_ps(&maxHoldPtr[i]);
+      _mm_storeu_ps(&maxHoldPtr[i],_mm_max_ps(trace,power));
+    } // if
+
+    if (traceModes & TRACE_MIN_HOLD)
+    {
+      trace = _mm_loadu_ps(&minHoldPtr[i]);
+      _mm_storeu_ps(&minHoldPtr[i],_mm_min_ps(trace,power));
+    } // if
+
+    if (traceModes & TRACE_AVERAGE)
+    {
+      trace = _mm_loadu_ps(&averagePtr[i]);
+#ifdef __FMA__
+      trace = _mm_fmadd_ps(factorVector,_mm_sub_ps(power,trace),trace);
+#else
+      trace = _mm_add_ps(trace,
+                         _mm_mul_ps(factorVector,_mm_sub_ps(power,trace)));
+#endif
+      _mm_storeu_ps(&averagePtr[i],trace);
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+#endif
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Handle whatever is left over (or everything, if SSE
+  // is not available).
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (; i < numberOfBins; i++)
+  {
+    if (traceModes & TRACE_MAX_HOLD)
+    {
+      if (powerBufferPtr[i] > maxHoldPtr[i])
+      {
+        maxHoldPtr[i] = powerBufferPtr[i];
+      } // if
+    } // if
+
+    if (traceModes & TRACE_MIN_HOLD)
+    {
+      if (powerBufferPtr[i] < minHoldPtr[i])
+      {
+        minHoldPtr[i] = powerBufferPtr[i];
+      } // if
+    } // if
+
+    if (traceModes & TRACE_AVERAGE)
+    {
+      averagePtr[i] += factor * (powerBufferPtr[i] - averagePtr[i]);
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // accumulate
+
+/*****************************************************************************
+
+  Name: getMaxHold
+
+  Purpose: The purpose of this function is to retrieve the max-hold
+  trace in decibels.
+
+  Calling Sequence: getMaxHold(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The max-hold trace in decibels.
+
+*****************************************************************************/
+void SpectrumTraces::getMaxHold(float *traceInDbPtr)
+{
+
+  convertToDb(maxHoldPtr,traceInDbPtr);
+
+  return;
+
+} // getMaxHold
+
+/*****************************************************************************
+
+  Name: getMinHold
+
+  Purpose: The purpose of this function is to retrieve the min-hold
+  trace in decibels.
+
+  Calling Sequence: getMinHold(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The min-hold trace in decibels.
+
+*****************************************************************************/
+void SpectrumTraces::getMinHold(float *traceInDbPtr)
+{
+
+  convertToDb(minHoldPtr,traceInDbPtr);
+
+  return;
+
+} // getMinHold
+
+/*****************************************************************************
+
+  Name: getAverage
+
+  Purpose: The purpose of this function is to retrieve the video
+  averaging trace in decibels.
+
+  Calling Sequence: getAverage(traceInDbPtr)
+
+  Inputs:
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The average trace in decibels.
+
+*****************************************************************************/
+void SpectrumTraces::getAverage(float *traceInDbPtr)
+{
+
+  convertToDb(averagePtr,traceInDbPtr);
+
+  return;
+
+} // getAverage
+
+/*****************************************************************************
+
+  Name: convertToDb
+
+  Purpose: The purpose of this function is to convert a linear trace to
+  decibels.  This only happens when a trace is displayed, so the
+  expensive log10() is paid at the display rate rather than the FFT
+  rate.
+
+  Calling Sequence: convertToDb(tracePtr,traceInDbPtr)
+
+  Inputs:
+
+    tracePtr - A pointer to a linear trace.
+
+    traceInDbPtr - A pointer to storage for numberOfBins values.
+
+ Outputs:
+
+    traceInDbPtr - The trace in decibels.
+
+*****************************************************************************/
+void SpectrumTraces::convertToDb(float *tracePtr,float *traceInDbPtr)
+{
+  uint32_t i;
+
+  if (count == 0)
+  {
+    for (i = 0; i < numberOfBins; i++)
+    {
+      // Nothing has been accumulated, so keep the trace off screen.
+      traceInDbPtr[i] = -1000;
+    } // for
+
+    return;
+  } // if
+
+  for (i = 0; i < numberOfBins; i++)
+  {
+    traceInDbPtr[i] = 10 * log10f(tracePtr[i] + 1e-20f);
+  } // for
+
+  return;
+
+} // convertToDb
@@ -0,0 +1,943 @@
+//************************************************************************
+// file name: StreamDispatcher.cc
+//************************************************************************
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "StreamDispatcher.h"
+
+using namespace std;
+
+// This marks the wakeup descriptor in the epoll events.
+#define WAKEUP_EVENT (MAX_STREAMS)
+
+/*****************************************************************************
+
+  Name: StreamDispatcher
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an StreamDispatcher.  The processing threads are
+  started here, and they wait until there are blocks to process.
+
+  Calling Sequence: StreamDispatcher(numberOfThreads,unsignedSamples)
+
+  Inputs:
+
+    numberOfThreads - The number of processing threads.  A value of 0
+    uses one thread per processor.
+
+    unsignedSamples - A flag that indicates whether the IQ samples are
+    unsigned 8-bit quantities rather than signed ones.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+StreamDispatcher::StreamDispatcher(uint32_t numberOfThreads,
+                                   bool unsignedSamples)
+{
+  uint32_t i;
+  struct epoll_event event;
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  } // if
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = 1;
+  } // if
+
+  if (numberOfThreads > MAX_DISPATCH_THREADS)
+  {
+    numberOfThreads = MAX_DISPATCH_THREADS;
+  } // if
+
+  // Retrieve for later use.
+  this->numberOfThreads = numberOfThreads;
+  this->unsignedSamples = unsignedSamples;
+
+  numberOfStreams = 0;
+  nextStream = 0;
+  stopping = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // The wakeup descriptor is always watched, so the
+  // reading thread hears about a stream that can be
+  // read again while it waits for the others.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  epollDescriptor = epoll_create1(0);
+  wakeupDescriptor = eventfd(0,EFD_NONBLOCK);
+
+  event.events = EPOLLIN;
+  event.data.u32 = WAKEUP_EVENT;
+  epoll_ctl(epollDescriptor,EPOLL_CTL_ADD,wakeupDescriptor,&event);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  pthread_mutex_init(&queueLock,NULL);
+  pthread_cond_init(&blockQueued,NULL);
+
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    pthread_create(&threads[i],NULL,threadEntry,this);
+  } // for
+
+  return;
+
+} // StreamDispatcher
+
+/*****************************************************************************
+
+  Name: ~StreamDispatcher
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an StreamDispatcher.  The processing threads finish the
+  blocks that are queued before they exit.  The analyzers belong to the
+  caller.
+
+  Calling Sequence: ~StreamDispatcher()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+StreamDispatcher::~StreamDispatcher(void)
+{
+  uint32_t i;
+  uint32_t j;
+
+  pthread_mutex_lock(&queueLock);
+  stopping = true;
+  pthread_cond_broadcast(&blockQueued);
+  pthread_mutex_unlock(&queueLock);
+
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    pthread_join(threads[i],NULL);
+  } // for
+
+  for (i = 0; i < numberOfStreams; i++)
+  {
+    if (!streams[i].ended)
+    {
+      close(streams[i].descriptor);
+    } // if
+
+    for (j = 0; j < STREAM_QUEUE_LENGTH; j++)
+    {
+      delete[] streams[i].blocksPtr[j];
+    } // for
+
+    pthread_mutex_destroy(&streams[i].analyzerLock);
+  } // for
+
+  close(wakeupDescriptor);
+  close(epollDescriptor);
+
+  pthread_mutex_destroy(&queueLock);
+  pthread_cond_destroy(&blockQueued);
+
+  return;
+
+} // ~StreamDispatcher
+
+/*****************************************************************************
+
+  Name: addStream
+
+  Purpose: The purpose of this function is to open an IQ stream.  A
+  name of "-" is stdin, a name of the form host:port that isn't an
+  existing file is a TCP connection, and anything else is a file or a
+  FIFO.  A FIFO doesn't need a writer yet; it is read once one shows
+  up.  Nothing is read until dispatch() is called, and by then the
+  stream must have an analyzer.
+
+  Calling Sequence: success = addStream(namePtr)
+
+  Inputs:
+
+    namePtr - The name of the stream.  It must outlive the dispatcher.
+
+ Outputs:
+
+    success - A flag that indicates whether the stream was added.  A
+    value of true indicates that it was.
+
+*****************************************************************************/
+bool StreamDispatcher::addStream(const char *namePtr)
+{
+  int descriptor;
+  int status;
+  uint32_t i;
+  AnalyzerStream *streamPtr;
+  struct epoll_event event;
+
+  if (numberOfStreams == MAX_STREAMS)
+  {
+    fprintf(stderr,"Too many streams, %s is ignored\n",namePtr);
+    return (false);
+  } // if
+
+  descriptor = openStream(namePtr);
+
+  if (descriptor < 0)
+  {
+    return (false);
+  } // if
+
+  streamPtr = &streams[numberOfStreams];
+
+  streamPtr->namePtr = namePtr;
+  streamPtr->descriptor = descriptor;
+  streamPtr->analyzerPtr = NULL;
+  streamPtr->ended = false;
+
+  for (i = 0; i < STREAM_QUEUE_LENGTH; i++)
+  {
+    streamPtr->blocksPtr[i] = new uint8_t[STREAM_BLOCK_SIZE];
+    streamPtr->blockLengths[i] = 0;
+  } // for
+
+  streamPtr->oldestBlock = 0;
+  streamPtr->numberOfQueuedBlocks = 0;
+  streamPtr->fillLength = 0;
+  streamPtr->paused = false;
+  streamPtr->busy = false;
+
+  pthread_mutex_init(&streamPtr->analyzerLock,NULL);
+
+  event.events = EPOLLIN;
+  event.data.u32 = numberOfStreams;
+  status = epoll_ctl(epollDescriptor,EPOLL_CTL_ADD,descriptor,&event);
+
+  // Regular files are refused with EPERM.
+  streamPtr->pollable = (status == 0);
+
+  pthread_mutex_lock(&queueLock);
+  numberOfStreams++;
+  pthread_mutex_unlock(&queueLock);
+
+  return (true);
+
+} // addStream
+
+/*****************************************************************************
+
+  Name: setAnalyzer
+
+  Purpose: The purpose of this function is to attach a stream to the
+  analyzer that it feeds.
+
+  Calling Sequence: setAnalyzer(index,analyzerPtr)
+
+  Inputs:
+
+    index - The index of the stream, in the order that it was added.
+
+    analyzerPtr - A pointer to the analyzer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::setAnalyzer(uint32_t index,SignalAnalyzer *analyzerPtr)
+{
+
+  streams[index].analyzerPtr = analyzerPtr;
+
+  return;
+
+} // setAnalyzer
+
+/*****************************************************************************
+
+  Name: getNumberOfStreams
+
+  Purpose: The purpose of this function is to retrieve the number of
+  streams that have been added.
+
+  Calling Sequence: numberOfStreams = getNumberOfStreams()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    numberOfStreams - The number of streams.
+
+*****************************************************************************/
+uint32_t StreamDispatcher::getNumberOfStreams(void)
+{
+
+  return (numberOfStreams);
+
+} // getNumberOfStreams
+
+/*****************************************************************************
+
+  Name: getStreamName
+
+  Purpose: The purpose of this function is to retrieve the name of a
+  stream.
+
+  Calling Sequence: namePtr = getStreamName(index)
+
+  Inputs:
+
+    index - The index of the stream, in the order that it was added.
+
+ Outputs:
+
+    namePtr - The name of the stream.
+
+*****************************************************************************/
+const char *StreamDispatcher::getStreamName(uint32_t index)
+{
+
+  return (streams[index].namePtr);
+
+} // getStreamName
+
+/*****************************************************************************
+
+  Name: dispatch
+
+  Purpose: The purpose of this function is to wait for IQ data on any of
+  the streams, read whatever is ready, and queue complete blocks for the
+  processing threads.  This is called over and over by one thread.  It
+  doesn't wait at all while a regular file has room in its queue.
+
+  Calling Sequence: active = dispatch(timeoutInMs)
+
+  Inputs:
+
+    timeoutInMs - The longest time to wait for data in milliseconds.
+
+ Outputs:
+
+    active - A flag that indicates whether there is anything left to do.
+    A value of false indicates that every stream has ended and every
+    block has been processed.
+
+*****************************************************************************/
+bool StreamDispatcher::dispatch(int timeoutInMs)
+{
+  int i;
+  int count;
+  uint32_t index;
+  uint64_t wakeups;
+  bool active;
+  ssize_t status;
+  struct epoll_event events[MAX_STREAMS + 1];
+
+  // Don't wait if a file can be read.
+  for (index = 0; index < numberOfStreams; index++)
+  {
+    if (!streams[index].pollable && !streams[index].ended &&
+        !streams[index].paused)
+    {
+      timeoutInMs = 0;
+    } // if
+  } // for
+
+  count = epoll_wait(epollDescriptor,events,MAX_STREAMS + 1,timeoutInMs);
+
+  for (i = 0; i < count; i++)
+  {
+    if (events[i].data.u32 == WAKEUP_EVENT)
+    {
+      // This only clears the wakeup.
+      status = read(wakeupDescriptor,&wakeups,sizeof(wakeups));
+      (void)status;
+    } // if
+    else
+    {
+      readStream(events[i].data.u32);
+    } // else
+  } // for
+
+  for (index = 0; index < numberOfStreams; index++)
+  {
+    if (!streams[index].pollable && !streams[index].ended &&
+        !streams[index].paused)
+    {
+      readStream(index);
+    } // if
+  } // for
+
+  // Anything that a thread has made room for can be read again.
+  resumeStreams();
+
+  // Default to being finished.
+  active = false;
+
+  pthread_mutex_lock(&queueLock);
+
+  for (index = 0; index < numberOfStreams; index++)
+  {
+    if (!streams[index].ended || (streams[index].numberOfQueuedBlocks > 0) ||
+        streams[index].busy)
+    {
+      active = true;
+    } // if
+  } // for
+
+  pthread_mutex_unlock(&queueLock);
+
+  return (active);
+
+} // dispatch
+
+/*****************************************************************************
+
+  Name: renderStream
+
+  Purpose: The purpose of this function is to render the display of one
+  stream.  The analyzer isn't processing a block while it is rendered.
+
+  Calling Sequence: renderStream(index)
+
+  Inputs:
+
+    index - The index of the stream.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::renderStream(uint32_t index)
+{
+
+  pthread_mutex_lock(&streams[index].analyzerLock);
+  streams[index].analyzerPtr->renderDisplay();
+  pthread_mutex_unlock(&streams[index].analyzerLock);
+
+  return;
+
+} // renderStream
+
+/*****************************************************************************
+
+  Name: openStream
+
+  Purpose: The purpose of this function is to open a stream for reading
+  without blocking.
+
+  Calling Sequence: descriptor = openStream(namePtr)
+
+  Inputs:
+
+    namePtr - The name of the stream.
+
+ Outputs:
+
+    descriptor - The file descriptor of the stream, or -1 if it couldn't
+    be opened.
+
+*****************************************************************************/
+int StreamDispatcher::openStream(const char *namePtr)
+{
+  int descriptor;
+  struct stat status;
+
+  if (strcmp(namePtr,"-") == 0)
+  {
+    descriptor = dup(0);
+  } // if
+  else
+  {
+    if ((stat(namePtr,&status) != 0) && (strchr(namePtr,':') != NULL))
+    {
+      descriptor = connectToServer(namePtr);
+    } // if
+    else
+    {
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      // A FIFO that is opened without blocking doesn't
+      // wait for a writer, and epoll doesn't report it
+      // until a writer has shown up.
+      //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      descriptor = open(namePtr,O_RDONLY | O_NONBLOCK);
+    } // else
+  } // else
+
+  if (descriptor < 0)
+  {
+    fprintf(stderr,"Could not open %s: %s\n",namePtr,strerror(errno));
+    return (-1);
+  } // if
+
+  fcntl(descriptor,F_SETFL,fcntl(descriptor,F_GETFL) | O_NONBLOCK);
+
+  return (descriptor);
+
+} // openStream
+
+/*****************************************************************************
+
+  Name: connectToServer
+
+  Purpose: The purpose of this function is to make a TCP connection to a
+  server that sends IQ data, such as rtl_tcp.
+
+  Calling Sequence: descriptor = connectToServer(namePtr)
+
+  Inputs:
+
+    namePtr - The server, as host:port.
+
+ Outputs:
+
+    descriptor - The socket, or -1 if no connection was made.
+
+*****************************************************************************/
+int StreamDispatcher::connectToServer(const char *namePtr)
+{
+  int descriptor;
+  char host[256];
+  const char *portPtr;
+  struct addrinfo hints;
+  struct addrinfo *addressesPtr;
+  struct addrinfo *addressPtr;
+
+  portPtr = strrchr(namePtr,':');
+
+  if ((portPtr - namePtr) >= (int)sizeof(host))
+  {
+    errno = ENAMETOOLONG;
+    return (-1);
+  } // if
+
+  memcpy(host,namePtr,portPtr - namePtr);
+  host[portPtr - namePtr] = 0;
+  portPtr++;
+
+  memset(&hints,0,sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  if (getaddrinfo(host,portPtr,&hints,&addressesPtr) != 0)
+  {
+    errno = EHOSTUNREACH;
+    return (-1);
+  } // if
+
+  descriptor = -1;
+
+  for (addressPtr = addressesPtr;
+       (addressPtr != NULL) && (descriptor < 0);
+       addressPtr = addressPtr->ai_next)
+  {
+    descriptor = socket(addressPtr->ai_family,
+                        addressPtr->ai_socktype,
+                        addressPtr->ai_protocol);
+
+    if (descriptor >= 0)
+    {
+      if (connect(descriptor,addressPtr->ai_addr,addressPtr->ai_addrlen) != 0)
+      {
+        close(descriptor);
+        descriptor = -1;
+      } // if
+    } // if
+  } // for
+
+  freeaddrinfo(addressesPtr);
+
+  return (descriptor);
+
+} // connectToServer
+
+/*****************************************************************************
+
+  Name: readStream
+
+  Purpose: The purpose of this function is to read everything that a
+  stream has for us, until it would block or its queue is full.  Each
+  block that is completed is queued for the processing threads.  A
+  stream with a full queue is paused: epoll stops watching it until a
+  thread has made room.
+
+  Calling Sequence: readStream(index)
+
+  Inputs:
+
+    index - The index of the stream.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::readStream(uint32_t index)
+{
+  bool done;
+  uint32_t block;
+  ssize_t count;
+  AnalyzerStream *streamPtr;
+  struct epoll_event event;
+
+  streamPtr = &streams[index];
+
+  done = false;
+
+  while (!done)
+  {
+    pthread_mutex_lock(&queueLock);
+
+    if (streamPtr->numberOfQueuedBlocks == STREAM_QUEUE_LENGTH)
+    {
+      // The threads will tell us when there is room.
+      streamPtr->paused = true;
+      done = true;
+    } // if
+
+    block = (streamPtr->oldestBlock + streamPtr->numberOfQueuedBlocks) %
+            STREAM_QUEUE_LENGTH;
+
+    pthread_mutex_unlock(&queueLock);
+
+    if (done)
+    {
+      if (streamPtr->pollable)
+      {
+        event.events = 0;
+        event.data.u32 = index;
+        epoll_ctl(epollDescriptor,EPOLL_CTL_MOD,streamPtr->descriptor,&event);
+      } // if
+
+      return;
+    } // if
+
+    // Nobody else touches the block that is being filled.
+    count = read(streamPtr->descriptor,
+                 &streamPtr->blocksPtr[block][streamPtr->fillLength],
+                 STREAM_BLOCK_SIZE - streamPtr->fillLength);
+
+    if (count > 0)
+    {
+      streamPtr->fillLength += count;
+
+      if (streamPtr->fillLength == STREAM_BLOCK_SIZE)
+      {
+        queueBlock(streamPtr);
+      } // if
+    } // if
+    else
+    {
+      if (count == 0)
+      {
+        // Whatever is left is processed as a short block.
+        endStream(streamPtr);
+        done = true;
+      } // if
+      else
+      {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+          // We've read everything there is for now.
+          done = true;
+        } // if
+        else
+        {
+          if (errno != EINTR)
+          {
+            fprintf(stderr,"Error reading %s: %s\n",
+                    streamPtr->namePtr,strerror(errno));
+
+            endStream(streamPtr);
+            done = true;
+          } // if
+        } // else
+      } // else
+    } // else
+  } // while
+
+  return;
+
+} // readStream
+
+/*****************************************************************************
+
+  Name: queueBlock
+
+  Purpose: The purpose of this function is to hand the block that is
+  being filled to the processing threads.
+
+  Calling Sequence: queueBlock(streamPtr)
+
+  Inputs:
+
+    streamPtr - A pointer to the stream.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::queueBlock(AnalyzerStream *streamPtr)
+{
+  uint32_t block;
+
+  pthread_mutex_lock(&queueLock);
+
+  block = (streamPtr->oldestBlock + streamPtr->numberOfQueuedBlocks) %
+          STREAM_QUEUE_LENGTH;
+
+  streamPtr->blockLengths[block] = streamPtr->fillLength;
+  streamPtr->numberOfQueuedBlocks++;
+  streamPtr->fillLength = 0;
+
+  pthread_cond_signal(&blockQueued);
+  pthread_mutex_unlock(&queueLock);
+
+  return;
+
+} // queueBlock
+
+/*****************************************************************************
+
+  Name: endStream
+
+  Purpose: The purpose of this function is to finish a stream that has
+  no more data.  A partial block is queued, and the stream is closed.
+
+  Calling Sequence: endStream(streamPtr)
+
+  Inputs:
+
+    streamPtr - A pointer to the stream.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::endStream(AnalyzerStream *streamPtr)
+{
+
+  if (streamPtr->fillLength > 0)
+  {
+    queueBlock(streamPtr);
+  } // if
+
+  if (streamPtr->pollable)
+  {
+    epoll_ctl(epollDescriptor,EPOLL_CTL_DEL,streamPtr->descriptor,NULL);
+  } // if
+
+  close(streamPtr->descriptor);
+  streamPtr->ended = true;
+
+  return;
+
+} // endStream
+
+/*****************************************************************************
+
+  Name: resumeStreams
+
+  Purpose: The purpose of this function is to start reading the streams
+  again that were paused because their queues were full, once the
+  processing threads have made room.
+
+  Calling Sequence: resumeStreams()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::resumeStreams(void)
+{
+  uint32_t index;
+  bool resume;
+  AnalyzerStream *streamPtr;
+  struct epoll_event event;
+
+  for (index = 0; index < numberOfStreams; index++)
+  {
+    streamPtr = &streams[index];
+
+    pthread_mutex_lock(&queueLock);
+
+    resume = streamPtr->paused &&
+             (streamPtr->numberOfQueuedBlocks < STREAM_QUEUE_LENGTH);
+
+    if (resume)
+    {
+      streamPtr->paused = false;
+    } // if
+
+    pthread_mutex_unlock(&queueLock);
+
+    if (resume && streamPtr->pollable)
+    {
+      event.events = EPOLLIN;
+      event.data.u32 = index;
+      epoll_ctl(epollDescriptor,EPOLL_CTL_MOD,streamPtr->descriptor,&event);
+    } // if
+  } // for
+
+  return;
+
+} // resumeStreams
+
+/*****************************************************************************
+
+  Name: threadEntry
+
+  Purpose: The purpose of this function is to serve as the entry point
+  of a processing thread.
+
+  Calling Sequence: threadEntry(argPtr)
+
+  Inputs:
+
+    argPtr - A pointer to the StreamDispatcher.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void *StreamDispatcher::threadEntry(void *argPtr)
+{
+  StreamDispatcher *dispatcherPtr;
+
+  dispatcherPtr = (StreamDispatcher *)argPtr;
+
+  dispatcherPtr->run();
+
+  return (NULL);
+
+} // threadEntry
+
+/*****************************************************************************
+
+  Name: run
+
+  Purpose: The purpose of this function is to run queued blocks through
+  their analyzers until the dispatcher is being destroyed.  The streams
+  are taken in turn, and a stream that another thread is processing is
+  skipped, so its blocks stay in order.  The queue lock is not held
+  while a block is processed.
+
+  Calling Sequence: run()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void StreamDispatcher::run(void)
+{
+  uint32_t i;
+  uint32_t index;
+  uint32_t length;
+  uint64_t wakeup;
+  bool done;
+  int8_t *blockPtr;
+  ssize_t status;
+  AnalyzerStream *streamPtr;
+
+  done = false;
+
+  pthread_mutex_lock(&queueLock);
+
+  while (!done)
+  {
+    streamPtr = NULL;
+
+    for (i = 0; (i < numberOfStreams) && (streamPtr == NULL); i++)
+    {
+      index = (nextStream + i) % numberOfStreams;
+
+      if ((streams[index].numberOfQueuedBlocks > 0) && !streams[index].busy)
+      {
+        streamPtr = &streams[index];
+        nextStream = index + 1;
+      } // if
+    } // for
+
+    if (streamPtr != NULL)
+    {
+      streamPtr->busy = true;
+      blockPtr = (int8_t *)streamPtr->blocksPtr[streamPtr->oldestBlock];
+      length = streamPtr->blockLengths[streamPtr->oldestBlock];
+
+      pthread_mutex_unlock(&queueLock);
+
+      if (unsignedSamples)
+      {
+        for (i = 0; i < length; i++)
+        {
+          // Convert unsigned samples to signed quantities.
+          blockPtr[i] -= 128;
+        } // for
+      } // if
+
+      pthread_mutex_lock(&streamPtr->analyzerLock);
+      streamPtr->analyzerPtr->acceptSamples(blockPtr,length);
+      pthread_mutex_unlock(&streamPtr->analyzerLock);
+
+      pthread_mutex_lock(&queueLock);
+
+      streamPtr->oldestBlock =
+        (streamPtr->oldestBlock + 1) % STREAM_QUEUE_LENGTH;
+      streamPtr->numberOfQueuedBlocks--;
+      streamPtr->busy = false;
+
+      if (streamPtr->paused)
+      {
+        // There is room now, so the stream can be read again.
+        wakeup = 1;
+        status = write(wakeupDescriptor,&wakeup,sizeof(wakeup));
+        (void)status;
+      } // if
+    } // if
+    else
+    {
+      if (stopping)
+      {
+        done = true;
+      } // if
+      else
+      {
+        pthread_cond_wait(&blockQueued,&queueLock);
+      } // else
+    } // else
+  } // while
+
+  pthread_mutex_unlock(&queueLock);
+
+  return;
+
+} // run
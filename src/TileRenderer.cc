@@ -0,0 +1,777 @@
+//************************************************************************
+// file name: TileRenderer.cc
+//************************************************************************
+#include <stdio.h>
+
+#include "TileRenderer.h"
+
+using namespace std;
+
+// These are the Cohen-Sutherland outcodes.
+#define OUTCODE_LEFT (1)
+#define OUTCODE_RIGHT (2)
+#define OUTCODE_TOP (4)
+#define OUTCODE_BOTTOM (8)
+
+/*****************************************************************************
+
+  Name: TileRenderer
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an TileRenderer.
+
+  Calling Sequence: TileRenderer(parentPtr,x,y,width,height)
+
+  Inputs:
+
+    parentPtr - A pointer to the renderer of the whole display.
+
+    x - The left edge of the tile in pixels of the parent display.
+
+    y - The top edge of the tile in pixels of the parent display.
+
+    width - The width of the tile in pixels.
+
+    height - The height of the tile in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+TileRenderer::TileRenderer(Renderer *parentPtr,
+                           int x,
+                           int y,
+                           int width,
+                           int height)
+{
+
+  // Retrieve for later use.
+  this->parentPtr = parentPtr;
+  this->x = x;
+  this->y = y;
+  this->width = width;
+  this->height = height;
+
+  numberOfSegments = 0;
+
+  // No keystrokes yet.
+  keyHead = 0;
+  keyCount = 0;
+  pointerPosition = -1;
+
+  return;
+
+} // TileRenderer
+
+/*****************************************************************************
+
+  Name: ~TileRenderer
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an TileRenderer.  The parent renderer belongs to the
+  caller.
+
+  Calling Sequence: ~TileRenderer()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+TileRenderer::~TileRenderer(void)
+{
+
+  return;
+
+} // ~TileRenderer
+
+/*****************************************************************************
+
+  Name: setTitle
+
+  Purpose: The purpose of this function is to ignore a title.  The title
+  of the display belongs to whoever owns the parent renderer.
+
+  Calling Sequence: setTitle(titlePtr)
+
+  Inputs:
+
+    titlePtr - The title.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::setTitle(const char *titlePtr)
+{
+
+  (void)titlePtr;
+
+  return;
+
+} // setTitle
+
+/*****************************************************************************
+
+  Name: getFontHeight
+
+  Purpose: The purpose of this function is to retrieve the height of the
+  font of the parent renderer.
+
+  Calling Sequence: height = getFontHeight()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    height - The font height in pixels.
+
+*****************************************************************************/
+int TileRenderer::getFontHeight(void)
+{
+
+  return (parentPtr->getFontHeight());
+
+} // getFontHeight
+
+/*****************************************************************************
+
+  Name: beginFrame
+
+  Purpose: The purpose of this function is to start a frame by erasing
+  the tile.  The rest of the display is left alone.
+
+  Calling Sequence: beginFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::beginFrame(void)
+{
+
+  parentPtr->clearArea(x,y,width,height);
+
+  return;
+
+} // beginFrame
+
+/*****************************************************************************
+
+  Name: endFrame
+
+  Purpose: The purpose of this function is to finish a frame.  Nothing
+  happens here, since the frame of the whole display is finished by
+  whoever owns the parent renderer, once every tile has been drawn.
+
+  Calling Sequence: endFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::endFrame(void)
+{
+
+  return;
+
+} // endFrame
+
+/*****************************************************************************
+
+  Name: clearArea
+
+  Purpose: The purpose of this function is to erase a rectangle of the
+  tile to the background color.
+
+  Calling Sequence: clearArea(x,y,width,height)
+
+  Inputs:
+
+    x - The left edge of the rectangle in pixels of the tile.
+
+    y - The top edge of the rectangle in pixels of the tile.
+
+    width - The width of the rectangle in pixels.
+
+    height - The height of the rectangle in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::clearArea(int x,int y,int width,int height)
+{
+
+  parentPtr->clearArea(this->x + x,this->y + y,width,height);
+
+  return;
+
+} // clearArea
+
+/*****************************************************************************
+
+  Name: setColor
+
+  Purpose: The purpose of this function is to select the color that
+  everything is drawn with from now on.
+
+  Calling Sequence: setColor(color)
+
+  Inputs:
+
+    color - The color.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::setColor(RenderColor color)
+{
+
+  parentPtr->setColor(color);
+
+  return;
+
+} // setColor
+
+/*****************************************************************************
+
+  Name: drawLine
+
+  Purpose: The purpose of this function is to draw a line in the tile.
+
+  Calling Sequence: drawLine(x1,y1,x2,y2)
+
+  Inputs:
+
+    x1 - The horizontal position of the start of the line.
+
+    y1 - The vertical position of the start of the line.
+
+    x2 - The horizontal position of the end of the line.
+
+    y2 - The vertical position of the end of the line.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::drawLine(int x1,int y1,int x2,int y2)
+{
+
+  if (clipLine(&x1,&y1,&x2,&y2))
+  {
+    parentPtr->drawLine(x1 + x,y1 + y,x2 + x,y2 + y);
+  } // if
+
+  return;
+
+} // drawLine
+
+/*****************************************************************************
+
+  Name: drawLines
+
+  Purpose: The purpose of this function is to draw a connected line
+  through a set of points in the tile.  Each piece of the line is
+  clipped on its own, so the line is drawn as segments.
+
+  Calling Sequence: drawLines(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+
+  for (i = 1; i < numberOfPoints; i++)
+  {
+    addSegment(pointsPtr[i - 1].x,pointsPtr[i - 1].y,
+               pointsPtr[i].x,pointsPtr[i].y);
+  } // for
+
+  flushSegments();
+
+  return;
+
+} // drawLines
+
+/*****************************************************************************
+
+  Name: drawSegments
+
+  Purpose: The purpose of this function is to draw a set of unconnected
+  line segments in the tile.
+
+  Calling Sequence: drawSegments(segmentsPtr,numberOfSegments)
+
+  Inputs:
+
+    segmentsPtr - A pointer to the segments.
+
+    numberOfSegments - The number of segments.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::drawSegments(RenderSegment *segmentsPtr,
+                                uint32_t numberOfSegments)
+{
+  uint32_t i;
+
+  for (i = 0; i < numberOfSegments; i++)
+  {
+    addSegment(segmentsPtr[i].x1,segmentsPtr[i].y1,
+               segmentsPtr[i].x2,segmentsPtr[i].y2);
+  } // for
+
+  flushSegments();
+
+  return;
+
+} // drawSegments
+
+/*****************************************************************************
+
+  Name: drawPoints
+
+  Purpose: The purpose of this function is to draw the points of a set
+  that are in the tile.
+
+  Calling Sequence: drawPoints(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+  uint32_t count;
+
+  count = 0;
+
+  for (i = 0; i < numberOfPoints; i++)
+  {
+    if (computeOutcode(pointsPtr[i].x,pointsPtr[i].y) == 0)
+    {
+      points[count].x = pointsPtr[i].x + x;
+      points[count].y = pointsPtr[i].y + y;
+      count++;
+
+      if (count == TILE_CHUNK_SIZE)
+      {
+        parentPtr->drawPoints(points,count);
+        count = 0;
+      } // if
+    } // if
+  } // for
+
+  if (count > 0)
+  {
+    parentPtr->drawPoints(points,count);
+  } // if
+
+  return;
+
+} // drawPoints
+
+/*****************************************************************************
+
+  Name: drawString
+
+  Purpose: The purpose of this function is to draw a string in the tile.
+
+  Calling Sequence: drawString(x,y,textPtr)
+
+  Inputs:
+
+    x - The horizontal position of the start of the string.
+
+    y - The vertical position of the baseline of the string.
+
+    textPtr - The string.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::drawString(int x,int y,const char *textPtr)
+{
+
+  parentPtr->drawString(this->x + x,this->y + y,textPtr);
+
+  return;
+
+} // drawString
+
+/*****************************************************************************
+
+  Name: queueKeystroke
+
+  Purpose: The purpose of this function is to hand a keystroke to the
+  tile.  It is returned by a later call to getKeystroke().  If the queue
+  is full, the keystroke is dropped.
+
+  Calling Sequence: queueKeystroke(key,pointerPosition)
+
+  Inputs:
+
+    key - The keystroke.
+
+    pointerPosition - The horizontal position of the pointer in pixels of
+    the parent display, or -1 if the keystroke didn't come from the
+    pointer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::queueKeystroke(int key,int pointerPosition)
+{
+  uint32_t index;
+
+  if (keyCount < TILE_KEY_QUEUE_SIZE)
+  {
+    index = (keyHead + keyCount) % TILE_KEY_QUEUE_SIZE;
+
+    keys[index] = key;
+    keyPointerPositions[index] = pointerPosition;
+
+    keyCount++;
+  } // if
+
+  return;
+
+} // queueKeystroke
+
+/*****************************************************************************
+
+  Name: getKeystroke
+
+  Purpose: The purpose of this function is to retrieve the next keystroke
+  that was queued for the tile.
+
+  Calling Sequence: key = getKeystroke()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    key - The keystroke, or 0 if there isn't one.
+
+*****************************************************************************/
+int TileRenderer::getKeystroke(void)
+{
+  int key;
+
+  if (keyCount == 0)
+  {
+    return (0);
+  } // if
+
+  key = keys[keyHead];
+  pointerPosition = keyPointerPositions[keyHead];
+
+  keyHead = (keyHead + 1) % TILE_KEY_QUEUE_SIZE;
+  keyCount--;
+
+  return (key);
+
+} // getKeystroke
+
+/*****************************************************************************
+
+  Name: getPointerPosition
+
+  Purpose: The purpose of this function is to retrieve the horizontal
+  position of the pointer, in pixels of the tile, when the last
+  keystroke was made with it.
+
+  Calling Sequence: x = getPointerPosition()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    x - The horizontal position in pixels, or -1 if the last keystroke
+    didn't come from the pointer.
+
+*****************************************************************************/
+int TileRenderer::getPointerPosition(void)
+{
+
+  if (pointerPosition < 0)
+  {
+    return (-1);
+  } // if
+
+  return (pointerPosition - x);
+
+} // getPointerPosition
+
+/*****************************************************************************
+
+  Name: computeOutcode
+
+  Purpose: The purpose of this function is to compute the Cohen-Sutherland
+  outcode of a point, which indicates on which sides of the tile the
+  point lies.
+
+  Calling Sequence: outcode = computeOutcode(x,y)
+
+  Inputs:
+
+    x - The horizontal position of the point in pixels of the tile.
+
+    y - The vertical position of the point in pixels of the tile.
+
+ Outputs:
+
+    outcode - A combination of OUTCODE_LEFT, OUTCODE_RIGHT, OUTCODE_TOP
+    and OUTCODE_BOTTOM, or 0 if the point is inside.
+
+*****************************************************************************/
+int TileRenderer::computeOutcode(int x,int y)
+{
+  int outcode;
+
+  outcode = 0;
+
+  if (x < 0)
+  {
+    outcode |= OUTCODE_LEFT;
+  } // if
+  else
+  {
+    if (x >= width)
+    {
+      outcode |= OUTCODE_RIGHT;
+    } // if
+  } // else
+
+  if (y < 0)
+  {
+    outcode |= OUTCODE_TOP;
+  } // if
+  else
+  {
+    if (y >= height)
+    {
+      outcode |= OUTCODE_BOTTOM;
+    } // if
+  } // else
+
+  return (outcode);
+
+} // computeOutcode
+
+/*****************************************************************************
+
+  Name: clipLine
+
+  Purpose: The purpose of this function is to clip a line to the tile
+  using the Cohen-Sutherland algorithm.
+
+  Calling Sequence: visible = clipLine(x1Ptr,y1Ptr,x2Ptr,y2Ptr)
+
+  Inputs:
+
+    x1Ptr,y1Ptr - Pointers to the start of the line.
+
+    x2Ptr,y2Ptr - Pointers to the end of the line.
+
+ Outputs:
+
+    x1Ptr,y1Ptr,x2Ptr,y2Ptr - The clipped line.
+
+    visible - A flag that indicates whether any of the line is inside
+    the tile.
+
+*****************************************************************************/
+bool TileRenderer::clipLine(int *x1Ptr,int *y1Ptr,int *x2Ptr,int *y2Ptr)
+{
+  int outcode1;
+  int outcode2;
+  int outcode;
+  int64_t x1, y1, x2, y2;
+  int64_t x, y;
+
+  x1 = *x1Ptr;
+  y1 = *y1Ptr;
+  x2 = *x2Ptr;
+  y2 = *y2Ptr;
+
+  outcode1 = computeOutcode(*x1Ptr,*y1Ptr);
+  outcode2 = computeOutcode(*x2Ptr,*y2Ptr);
+
+  for (;;)
+  {
+    if ((outcode1 | outcode2) == 0)
+    {
+      // Both ends are inside.
+      break;
+    } // if
+
+    if ((outcode1 & outcode2) != 0)
+    {
+      // Both ends are off the same side.
+      return (false);
+    } // if
+
+    // Pick an end that is outside.
+    outcode = (outcode1 != 0) ? outcode1 : outcode2;
+
+    // Move that end to the edge that it is beyond.
+    if (outcode & (OUTCODE_TOP | OUTCODE_BOTTOM))
+    {
+      y = (outcode & OUTCODE_TOP) ? 0 : (height - 1);
+      x = x1 + (((x2 - x1) * (y - y1)) / (y2 - y1));
+    } // if
+    else
+    {
+      x = (outcode & OUTCODE_LEFT) ? 0 : (width - 1);
+      y = y1 + (((y2 - y1) * (x - x1)) / (x2 - x1));
+    } // else
+
+    if (outcode == outcode1)
+    {
+      x1 = x;
+      y1 = y;
+      outcode1 = computeOutcode((int)x1,(int)y1);
+    } // if
+    else
+    {
+      x2 = x;
+      y2 = y;
+      outcode2 = computeOutcode((int)x2,(int)y2);
+    } // else
+  } // for
+
+  *x1Ptr = (int)x1;
+  *y1Ptr = (int)y1;
+  *x2Ptr = (int)x2;
+  *y2Ptr = (int)y2;
+
+  return (true);
+
+} // clipLine
+
+/*****************************************************************************
+
+  Name: addSegment
+
+  Purpose: The purpose of this function is to clip a segment, move it to
+  the tile, and add it to the segments that are waiting to be sent to
+  the parent renderer.  A full chunk is sent right away.
+
+  Calling Sequence: addSegment(x1,y1,x2,y2)
+
+  Inputs:
+
+    x1,y1 - The start of the segment in pixels of the tile.
+
+    x2,y2 - The end of the segment in pixels of the tile.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::addSegment(int x1,int y1,int x2,int y2)
+{
+
+  if (clipLine(&x1,&y1,&x2,&y2))
+  {
+    segments[numberOfSegments].x1 = x1 + x;
+    segments[numberOfSegments].y1 = y1 + y;
+    segments[numberOfSegments].x2 = x2 + x;
+    segments[numberOfSegments].y2 = y2 + y;
+    numberOfSegments++;
+
+    if (numberOfSegments == TILE_CHUNK_SIZE)
+    {
+      flushSegments();
+    } // if
+  } // if
+
+  return;
+
+} // addSegment
+
+/*****************************************************************************
+
+  Name: flushSegments
+
+  Purpose: The purpose of this function is to send the segments that are
+  waiting to the parent renderer.
+
+  Calling Sequence: flushSegments()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void TileRenderer::flushSegments(void)
+{
+
+  if (numberOfSegments > 0)
+  {
+    parentPtr->drawSegments(segments,numberOfSegments);
+    numberOfSegments = 0;
+  } // if
+
+  return;
+
+} // flushSegments
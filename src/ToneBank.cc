@@ -0,0 +1,412 @@
+//************************************************************************
+// file name: ToneBank.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ToneBank.h"
+
+// Full scale for 8-bit samples.
+#define FULL_SCALE (127.0)
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: ToneBank
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an ToneBank.
+
+  Calling Sequence: ToneBank(sampleRate,
+                             frequenciesPtr,
+                             numberOfTones,
+                             integrationLength,
+                             reportStreamPtr)
+
+  Inputs:
+
+    sampleRate - The sample rate of the IQ data in S/s.
+
+    frequenciesPtr - A pointer to the frequencies to watch, in Hz
+    relative to the center of the band.  These range from
+    -sampleRate/2 to sampleRate/2.
+
+    numberOfTones - The number of frequencies.  At most MAX_TONES are
+    used.
+
+    integrationLength - The number of samples that each power
+    measurement covers.  The frequency resolution is about
+    sampleRate / integrationLength.
+
+    reportStreamPtr - The stream that the powers are written to.  A
+    value of NULL indicates that nothing is written.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+ToneBank::ToneBank(float sampleRate,
+  float *frequenciesPtr,
+  uint32_t numberOfTones,
+  uint32_t integrationLength,
+  FILE *reportStreamPtr)
+{
+  uint32_t i;
+  double w;
+
+  if (numberOfTones > MAX_TONES)
+  {
+    // Keep it sane.
+    numberOfTones = MAX_TONES;
+  } // if
+
+  if (integrationLength == 0)
+  {
+    // Keep it sane.
+    integrationLength = 1;
+  } // if
+
+  // Retrieve for later use.
+  this->sampleRate = sampleRate;
+  this->numberOfTones = numberOfTones;
+  this->integrationLength = integrationLength;
+  this->reportStreamPtr = reportStreamPtr;
+
+  // Round up to a whole group of two.
+  numberOfGroups = (numberOfTones + 1) / 2;
+
+  // The unused filters of the last group watch DC, harmlessly.
+  for (i = 0; i < MAX_TONES; i++)
+  {
+    w = 0;
+
+    if (i < numberOfTones)
+    {
+      w = (2 * M_PI * frequenciesPtr[i]) / sampleRate;
+    } // if
+
+    coefficients[i] = 2 * cos(w);
+    cosines[i] = cos(w);
+    sines[i] = sin(w);
+
+    powersInDb[i] = -200;
+  } // for
+
+  memset(stateI1,0,sizeof(stateI1));
+  memset(stateI2,0,sizeof(stateI2));
+  memset(stateQ1,0,sizeof(stateQ1));
+  memset(stateQ2,0,sizeof(stateQ2));
+
+  samplesIntegrated = 0;
+  sampleCount = 0;
+
+  return;
+
+} // ToneBank
+
+/*****************************************************************************
+
+  Name: ~ToneBank
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an ToneBank.
+
+  Calling Sequence: ~ToneBank()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+ToneBank::~ToneBank(void)
+{
+
+  return;
+
+} // ~ToneBank
+
+/*****************************************************************************
+
+  Name: acceptSamples
+
+  Purpose: The purpose of this function is to run a block of IQ data
+  through the filters.  Every time an integration period is complete,
+  the powers are computed and reported, so a block can produce any
+  number of reports.
+
+  Calling Sequence: acceptSamples(signalBufferPtr,bufferLength)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.  The buffer is
+    formatted with interleaved data as: I1,Q1,I2,Q2,...
+
+    bufferLength - The number of values in the signal buffer.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ToneBank::acceptSamples(int8_t *signalBufferPtr,
+  uint32_t bufferLength)
+{
+  uint32_t samplesLeft;
+  uint32_t samplesToRun;
+
+  samplesLeft = bufferLength / 2;
+
+  while (samplesLeft > 0)
+  {
+    // Run up to the end of the integration period.
+    samplesToRun = integrationLength - samplesIntegrated;
+
+    if (samplesToRun > samplesLeft)
+    {
+      samplesToRun = samplesLeft;
+    } // if
+
+    runFilters(signalBufferPtr,samplesToRun);
+
+    signalBufferPtr += (2 * samplesToRun);
+    samplesLeft -= samplesToRun;
+    samplesIntegrated += samplesToRun;
+    sampleCount += samplesToRun;
+
+    if (samplesIntegrated == integrationLength)
+    {
+      finishIntegration();
+    } // if
+  } // while
+
+  return;
+
+} // acceptSamples
+
+/*****************************************************************************
+
+  Name: getPowers
+
+  Purpose: The purpose of this function is to retrieve the powers that
+  were measured in the last integration period.
+
+  Calling Sequence: getPowers(powersInDbPtr)
+
+  Inputs:
+
+    powersInDbPtr - A pointer to storage for one power per tone.
+
+ Outputs:
+
+    powersInDbPtr - The powers in dB relative to a full scale tone.
+
+*****************************************************************************/
+void ToneBank::getPowers(float *powersInDbPtr)
+{
+
+  memcpy(powersInDbPtr,powersInDb,numberOfTones * sizeof(float));
+
+  return;
+
+} // getPowers
+
+/*****************************************************************************
+
+  Name: runFilters
+
+  Purpose: The purpose of this function is to run samples through the
+  Goertzel recursion, s[n] = x[n] + 2cos(w)s[n-1] - s[n-2], of every
+  filter.  I and Q each have their own recursion, since the coefficient
+  is real.  The recursion is a resonator, so it is run in double
+  precision; in single precision, a 500Hz filter at 2.4MS/s read more
+  than 30dB low after 100ms.  With SSE2, a group of two filters is kept
+  in registers while all of the samples are run through it, so the
+  samples are read from the cache once per group.
+
+  Calling Sequence: runFilters(signalBufferPtr,numberOfSamples)
+
+  Inputs:
+
+    signalBufferPtr - A pointer to a buffer of IQ data.
+
+    numberOfSamples - The number of IQ samples to run.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ToneBank::runFilters(int8_t *signalBufferPtr,
+  uint32_t numberOfSamples)
+{
+  uint32_t i;
+  uint32_t group;
+#ifdef __SSE2__
+  __m128d coefficient;
+  __m128d i1;
+  __m128d i2;
+  __m128d q1;
+  __m128d q2;
+  __m128d i0;
+  __m128d q0;
+#else
+  uint32_t tone;
+  double coefficient;
+  double i1;
+  double i2;
+  double q1;
+  double q2;
+  double i0;
+  double q0;
+#endif
+
+  for (group = 0; group < numberOfGroups; group++)
+  {
+#ifdef __SSE2__
+    coefficient = _mm_loadu_pd(&coefficients[2 * group]);
+    i1 = _mm_loadu_pd(&stateI1[2 * group]);
+    i2 = _mm_loadu_pd(&stateI2[2 * group]);
+    q1 = _mm_loadu_pd(&stateQ1[2 * group]);
+    q2 = _mm_loadu_pd(&stateQ2[2 * group]);
+
+    for (i = 0; i < numberOfSamples; i++)
+    {
+      i0 = _mm_sub_pd(_mm_add_pd(_mm_set1_pd(signalBufferPtr[2 * i]),
+                                 _mm_mul_pd(coefficient,i1)),
+                      i2);
+
+      q0 = _mm_sub_pd(_mm_add_pd(_mm_set1_pd(signalBufferPtr[(2 * i) + 1]),
+                                 _mm_mul_pd(coefficient,q1)),
+                      q2);
+
+      i2 = i1;
+      i1 = i0;
+      q2 = q1;
+      q1 = q0;
+    } // for
+
+    _mm_storeu_pd(&stateI1[2 * group],i1);
+    _mm_storeu_pd(&stateI2[2 * group],i2);
+    _mm_storeu_pd(&stateQ1[2 * group],q1);
+    _mm_storeu_pd(&stateQ2[2 * group],q2);
+#else
+    for (tone = (2 * group); tone < ((2 * group) + 2); tone++)
+    {
+      coefficient = coefficients[tone];
+      i1 = stateI1[tone];
+      i2 = stateI2[tone];
+      q1 = stateQ1[tone];
+      q2 = stateQ2[tone];
+
+      for (i = 0; i < numberOfSamples; i++)
+      {
+        i0 = signalBufferPtr[2 * i] + (coefficient * i1) - i2;
+        q0 = signalBufferPtr[(2 * i) + 1] + (coefficient * q1) - q2;
+
+        i2 = i1;
+        i1 = i0;
+        q2 = q1;
+        q1 = q0;
+      } // for
+
+      stateI1[tone] = i1;
+      stateI2[tone] = i2;
+      stateQ1[tone] = q1;
+      stateQ2[tone] = q2;
+    } // for
+#endif
+  } // for
+
+  return;
+
+} // runFilters
+
+/*****************************************************************************
+
+  Name: finishIntegration
+
+  Purpose: The purpose of this function is to compute the power of each
+  tone at the end of an integration period, report the powers, and
+  start the next period.  The DFT of I and of Q at frequency w is
+  s[N-1] - exp(-jw)s[N-2] (up to a phase shift that they share), and
+  the DFT of the complex signal is DFT(I) + jDFT(Q).
+
+  Calling Sequence: finishIntegration()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void ToneBank::finishIntegration(void)
+{
+  uint32_t i;
+  double iReal;
+  double iImaginary;
+  double qReal;
+  double qImaginary;
+  double real;
+  double imaginary;
+  double fullScale;
+
+  // A full scale tone has a magnitude of FULL_SCALE * N.
+  fullScale = FULL_SCALE * integrationLength;
+  fullScale *= fullScale;
+
+  for (i = 0; i < numberOfTones; i++)
+  {
+    iReal = stateI1[i] - (cosines[i] * stateI2[i]);
+    iImaginary = sines[i] * stateI2[i];
+    qReal = stateQ1[i] - (cosines[i] * stateQ2[i]);
+    qImaginary = sines[i] * stateQ2[i];
+
+    real = iReal - qImaginary;
+    imaginary = iImaginary + qReal;
+
+    powersInDb[i] = (float)(10 * log10((((real * real) +
+                                         (imaginary * imaginary)) /
+                                        fullScale) + 1e-20));
+  } // for
+
+  // Start the next period.
+  memset(stateI1,0,sizeof(stateI1));
+  memset(stateI2,0,sizeof(stateI2));
+  memset(stateQ1,0,sizeof(stateQ1));
+  memset(stateQ2,0,sizeof(stateQ2));
+  samplesIntegrated = 0;
+
+  if (reportStreamPtr != NULL)
+  {
+    // The time is that of the end of the period.
+    fprintf(reportStreamPtr,"%.6f",sampleCount / sampleRate);
+
+    for (i = 0; i < numberOfTones; i++)
+    {
+      fprintf(reportStreamPtr,",%.1f",powersInDb[i]);
+    } // for
+
+    fprintf(reportStreamPtr,"\n");
+
+    // Whoever is reading wants it now.
+    fflush(reportStreamPtr);
+  } // if
+
+  return;
+
+} // finishIntegration
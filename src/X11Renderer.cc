@@ -0,0 +1,788 @@
+//************************************************************************
+// file name: X11Renderer.cc
+//************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <X11/Xutil.h>
+
+#include "X11Renderer.h"
+
+using namespace std;
+
+/*****************************************************************************
+
+  Name: XErrorCallback
+
+  Purpose: The purpose of this function is to to handle errors that
+  are generated by X.
+
+  Calling Sequence: XErrorCallback(displayPtr,errorPtr)
+
+  Inputs:
+
+    displayPtr - A pointer to the display for which the error was
+    generated.
+
+    errorPtr - A pointer to the error event for which the error
+    was generated.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+static int XErrorCallback(Display *displayPtr,XErrorEvent *errorPtr)
+{
+  char msg[80];
+
+  // Retrieve the error text
+  XGetErrorText (displayPtr,errorPtr->error_code,msg,80);
+
+  // Display the error message to the user.
+  fprintf(stderr,"%s\n",msg);
+
+  return (0);
+
+} // XErrorCallback
+
+/*****************************************************************************
+
+  Name: X11Renderer
+
+  Purpose: The purpose of this function is to serve as the constructor for
+  an instance of an X11Renderer.  The window is created and mapped.
+
+  Calling Sequence: X11Renderer(windowWidthInPixels,windowHeightInPixels)
+
+  Inputs:
+
+    windowWidthInPixels - The width of the window.
+
+    windowHeightInPixels - The height of the window.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+X11Renderer::X11Renderer(int windowWidthInPixels,int windowHeightInPixels)
+{
+
+  // Retrieve for later use.
+  this->windowWidthInPixels = windowWidthInPixels;
+  this->windowHeightInPixels = windowHeightInPixels;
+
+  // No keystroke has come from the pointer.
+  pointerPosition = -1;
+
+  // Do all the cool stuff for X.
+  initializeX();
+
+  return;
+
+} // X11Renderer
+
+/*****************************************************************************
+
+  Name: ~X11Renderer
+
+  Purpose: The purpose of this function is to serve as the destructor for
+  an instance of an X11Renderer.
+
+  Calling Sequence: ~X11Renderer()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+X11Renderer::~X11Renderer(void)
+{
+
+  // We're done with this display.
+  XCloseDisplay(displayPtr);
+
+  return;
+
+} // ~X11Renderer
+
+/*****************************************************************************
+
+  Name: initializeX
+
+  Purpose: The purpose of this function is to perform all of the
+  initialization that is related to launching an X application.
+
+  Note: For a 16-bit display, the partitioning of the color values
+  are as follows (with r = red, g = green, blue = blue):
+
+  r[4:0], g[5:0], blue[4:0] = rrrrr gggggg bbbbb = 16 bits
+
+  Calling Sequence: initializeX()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::initializeX(void)
+{
+  int blackColor;
+  int whiteColor;
+  int screen;
+  Colormap colormap;
+  XColor exact;
+  XColor closest;
+  XEvent event;
+  XFontStruct *fontInfoPtr;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Setup X.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Register the X error handler.
+  XSetErrorHandler(XErrorCallback);
+
+  // Connect to the X server.
+  displayPtr = XOpenDisplay(NULL);
+
+  // Retrieve these two colors.
+  blackColor = BlackPixel(displayPtr,DefaultScreen(displayPtr));
+  whiteColor = WhitePixel(displayPtr,DefaultScreen(displayPtr));
+
+  //-------------------------------------------------------
+  // Initialize colors.  These colors will be used
+  // throughout the application.
+  //-------------------------------------------------------
+  // We need these for the color lookup invocations.
+  screen = DefaultScreen(displayPtr);
+  colormap = DefaultColormap(displayPtr,screen);
+
+  // Background is midnight blue.
+  XAllocNamedColor(displayPtr,colormap,"midnight blue",&exact,&closest);
+  colorTable[BackgroundColor] = closest.pixel;
+
+  // Grid is yellow.
+  XAllocNamedColor(displayPtr,colormap,"yellow",&exact,&closest);
+  colorTable[GridColor] = closest.pixel;
+
+  // Signal is green.
+  XAllocNamedColor(displayPtr,colormap,"green",&exact,&closest);
+  colorTable[SignalColor] = closest.pixel;
+
+  // Noise floor is cyan.
+  XAllocNamedColor(displayPtr,colormap,"cyan",&exact,&closest);
+  colorTable[NoiseFloorColor] = closest.pixel;
+
+  // Max-hold is red.
+  XAllocNamedColor(displayPtr,colormap,"red",&exact,&closest);
+  colorTable[MaxHoldColor] = closest.pixel;
+
+  // Min-hold is magenta.
+  XAllocNamedColor(displayPtr,colormap,"magenta",&exact,&closest);
+  colorTable[MinHoldColor] = closest.pixel;
+
+  // Average is white.
+  XAllocNamedColor(displayPtr,colormap,"white",&exact,&closest);
+  colorTable[AverageColor] = closest.pixel;
+
+  // High resolution is orange.
+  XAllocNamedColor(displayPtr,colormap,"orange",&exact,&closest);
+  colorTable[HighResolutionColor] = closest.pixel;
+
+  // Highlights are hot pink.
+  XAllocNamedColor(displayPtr,colormap,"hot pink",&exact,&closest);
+  colorTable[HighlightColor] = closest.pixel;
+  //-------------------------------------------------------
+
+  // Create the window.
+  window = XCreateSimpleWindow(displayPtr,
+                               DefaultRootWindow(displayPtr),
+                               0,
+                               0,
+                               windowWidthInPixels,
+                               windowHeightInPixels,
+                               0,
+                               blackColor,
+                               colorTable[BackgroundColor]);
+
+  // We want to get MapNotify events, keystrokes and button presses.
+  XSelectInput(displayPtr,
+               window,
+               StructureNotifyMask | KeyPressMask | ButtonPressMask);
+
+  // Create a "Graphics Context".
+  graphicsContext = XCreateGC(displayPtr,window,0,NULL);
+
+  // First-time foreground is white.
+  XSetForeground(displayPtr,graphicsContext,whiteColor);
+
+  //-------------------------------------------------------
+  // This is deterministic with respect to size.  By
+  // experiment, fixed fonts are 9 pixels high and 6
+  // pixels wide.
+  //-------------------------------------------------------
+  fontInfoPtr = XLoadQueryFont(displayPtr,"fixed");
+
+  XSetFont(displayPtr,
+           graphicsContext,
+           fontInfoPtr->fid);
+
+  // Compute the height of the font.
+  fontHeight = fontInfoPtr->ascent - fontInfoPtr->descent;
+  //-------------------------------------------------------
+
+  // Until told otherwise.
+  XStoreName(displayPtr,window,"Signal Analyzer");
+
+  // "Map" the window (that is, make it appear on the screen).
+  XMapWindow(displayPtr,window);
+
+  // Wait for the MapNotify event.
+  for(;;)
+  {
+    XNextEvent(displayPtr, &event);
+
+    if (event.type == MapNotify)
+    {
+      break;
+    } // if);
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Send the request to the server
+  XFlush(displayPtr);
+
+  return;
+
+} // initializeX
+
+/*****************************************************************************
+
+  Name: setTitle
+
+  Purpose: The purpose of this function is to set the title of the
+  window.
+
+  Calling Sequence: setTitle(titlePtr)
+
+  Inputs:
+
+    titlePtr - The title.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::setTitle(const char *titlePtr)
+{
+
+  XStoreName(displayPtr,window,titlePtr);
+
+  return;
+
+} // setTitle
+
+/*****************************************************************************
+
+  Name: getFontHeight
+
+  Purpose: The purpose of this function is to retrieve the height of
+  the font that strings are drawn with.
+
+  Calling Sequence: fontHeight = getFontHeight()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    fontHeight - The font height in pixels.
+
+*****************************************************************************/
+int X11Renderer::getFontHeight(void)
+{
+
+  return (fontHeight);
+
+} // getFontHeight
+
+/*****************************************************************************
+
+  Name: beginFrame
+
+  Purpose: The purpose of this function is to start a new frame by
+  erasing the window.
+
+  Calling Sequence: beginFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::beginFrame(void)
+{
+
+  // Erase the previous plot.
+  XClearWindow(displayPtr,window);
+
+  return;
+
+} // beginFrame
+
+/*****************************************************************************
+
+  Name: endFrame
+
+  Purpose: The purpose of this function is to finish a frame by sending
+  all of the drawing requests to the server.
+
+  Calling Sequence: endFrame()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::endFrame(void)
+{
+
+  // Send the request to the server
+  XFlush(displayPtr);
+
+  return;
+
+} // endFrame
+
+/*****************************************************************************
+
+  Name: synchronize
+
+  Purpose: The purpose of this function is to wait until the server has
+  processed all of the drawing requests of the frame.
+
+  Calling Sequence: synchronize()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::synchronize(void)
+{
+
+  // Wait for the server to catch up.
+  XSync(displayPtr,False);
+
+  return;
+
+} // synchronize
+
+/*****************************************************************************
+
+  Name: clearArea
+
+  Purpose: The purpose of this function is to erase a rectangle of the
+  window to the background color.
+
+  Calling Sequence: clearArea(x,y,width,height)
+
+  Inputs:
+
+    x - The left edge of the rectangle in pixels.
+
+    y - The top edge of the rectangle in pixels.
+
+    width - The width of the rectangle in pixels.
+
+    height - The height of the rectangle in pixels.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::clearArea(int x,int y,int width,int height)
+{
+
+  XClearArea(displayPtr,window,x,y,width,height,False);
+
+  return;
+
+} // clearArea
+
+/*****************************************************************************
+
+  Name: setColor
+
+  Purpose: The purpose of this function is to set the color of
+  everything that is drawn from now on.
+
+  Calling Sequence: setColor(color)
+
+  Inputs:
+
+    color - The color.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::setColor(RenderColor color)
+{
+
+  XSetForeground(displayPtr,graphicsContext,colorTable[color]);
+
+  return;
+
+} // setColor
+
+/*****************************************************************************
+
+  Name: drawLine
+
+  Purpose: The purpose of this function is to draw a line.
+
+  Calling Sequence: drawLine(x1,y1,x2,y2)
+
+  Inputs:
+
+    x1,y1 - The start of the line.
+
+    x2,y2 - The end of the line.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::drawLine(int x1,int y1,int x2,int y2)
+{
+
+  XDrawLine(displayPtr,window,graphicsContext,x1,y1,x2,y2);
+
+  return;
+
+} // drawLine
+
+/*****************************************************************************
+
+  Name: drawLines
+
+  Purpose: The purpose of this function is to draw a polyline through a
+  list of points.  The points are handed to X a chunk at a time, and
+  consecutive chunks share an end point so that the line is unbroken.
+
+  Calling Sequence: drawLines(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::drawLines(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+  uint32_t start;
+  uint32_t count;
+
+  for (start = 0; (start + 1) < numberOfPoints; start += (count - 1))
+  {
+    count = numberOfPoints - start;
+
+    if (count > X11_CHUNK_SIZE)
+    {
+      count = X11_CHUNK_SIZE;
+    } // if
+
+    for (i = 0; i < count; i++)
+    {
+      points[i].x = pointsPtr[start + i].x;
+      points[i].y = pointsPtr[start + i].y;
+    } // for
+
+    XDrawLines(displayPtr,
+               window,
+               graphicsContext,
+               points,count,
+               CoordModeOrigin);
+  } // for
+
+  return;
+
+} // drawLines
+
+/*****************************************************************************
+
+  Name: drawSegments
+
+  Purpose: The purpose of this function is to draw a list of unconnected
+  line segments.
+
+  Calling Sequence: drawSegments(segmentsPtr,numberOfSegments)
+
+  Inputs:
+
+    segmentsPtr - A pointer to the segments.
+
+    numberOfSegments - The number of segments.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::drawSegments(RenderSegment *segmentsPtr,
+  uint32_t numberOfSegments)
+{
+  uint32_t i;
+  uint32_t start;
+  uint32_t count;
+
+  for (start = 0; start < numberOfSegments; start += count)
+  {
+    count = numberOfSegments - start;
+
+    if (count > X11_CHUNK_SIZE)
+    {
+      count = X11_CHUNK_SIZE;
+    } // if
+
+    for (i = 0; i < count; i++)
+    {
+      segments[i].x1 = segmentsPtr[start + i].x1;
+      segments[i].y1 = segmentsPtr[start + i].y1;
+      segments[i].x2 = segmentsPtr[start + i].x2;
+      segments[i].y2 = segmentsPtr[start + i].y2;
+    } // for
+
+    XDrawSegments(displayPtr,
+                  window,
+                  graphicsContext,
+                  segments,count);
+  } // for
+
+  return;
+
+} // drawSegments
+
+/*****************************************************************************
+
+  Name: drawPoints
+
+  Purpose: The purpose of this function is to draw a list of points.
+
+  Calling Sequence: drawPoints(pointsPtr,numberOfPoints)
+
+  Inputs:
+
+    pointsPtr - A pointer to the points.
+
+    numberOfPoints - The number of points.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::drawPoints(RenderPoint *pointsPtr,uint32_t numberOfPoints)
+{
+  uint32_t i;
+  uint32_t start;
+  uint32_t count;
+
+  for (start = 0; start < numberOfPoints; start += count)
+  {
+    count = numberOfPoints - start;
+
+    if (count > X11_CHUNK_SIZE)
+    {
+      count = X11_CHUNK_SIZE;
+    } // if
+
+    for (i = 0; i < count; i++)
+    {
+      points[i].x = pointsPtr[start + i].x;
+      points[i].y = pointsPtr[start + i].y;
+    } // for
+
+    XDrawPoints(displayPtr,
+                window,
+                graphicsContext,
+                points,count,
+                CoordModeOrigin);
+  } // for
+
+  return;
+
+} // drawPoints
+
+/*****************************************************************************
+
+  Name: drawString
+
+  Purpose: The purpose of this function is to draw a string.
+
+  Calling Sequence: drawString(x,y,textPtr)
+
+  Inputs:
+
+    x - The horizontal position of the start of the string.
+
+    y - The vertical position of the baseline of the string.
+
+    textPtr - The string.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+void X11Renderer::drawString(int x,int y,const char *textPtr)
+{
+
+  XDrawString(displayPtr,window,graphicsContext,
+              x,y,
+              textPtr,strlen(textPtr));
+
+  return;
+
+} // drawString
+
+/*****************************************************************************
+
+  Name: getKeystroke
+
+  Purpose: The purpose of this function is to retrieve the next keystroke
+  that was typed in the window, without waiting for one to arrive.  Mouse
+  buttons are turned into keystrokes too: the left button is 'c', and the
+  scroll wheel is '+' (up) and '-' (down).  The position of the pointer
+  is remembered for getPointerPosition().  Any other pending events are
+  discarded along the way.
+
+  Calling Sequence: key = getKeystroke()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    key - The character that was typed, or 0 if there are no more
+    keystrokes.
+
+*****************************************************************************/
+int X11Renderer::getKeystroke(void)
+{
+  XEvent event;
+  KeySym key;
+  char text[8];
+  int count;
+
+  while (XPending(displayPtr) > 0)
+  {
+    XNextEvent(displayPtr,&event);
+
+    if (event.type == KeyPress)
+    {
+      // Map the keystroke to something we understand.
+      count = XLookupString(&event.xkey,text,sizeof(text),&key,NULL);
+
+      if (count > 0)
+      {
+        // This keystroke has nothing to do with the pointer.
+        pointerPosition = -1;
+
+        return ((unsigned char)text[0]);
+      } // if
+    } // if
+
+    if (event.type == ButtonPress)
+    {
+      pointerPosition = event.xbutton.x;
+
+      switch (event.xbutton.button)
+      {
+        case Button1:
+        {
+          return ('c');
+        } // case
+
+        case Button4:
+        {
+          return ('+');
+        } // case
+
+        case Button5:
+        {
+          return ('-');
+        } // case
+
+        default:
+        {
+          break;
+        } // case
+      } // switch
+    } // if
+  } // while
+
+  return (0);
+
+} // getKeystroke
+
+/*****************************************************************************
+
+  Name: getPointerPosition
+
+  Purpose: The purpose of this function is to retrieve the horizontal
+  position of the pointer when the last keystroke was made with it.
+
+  Calling Sequence: x = getPointerPosition()
+
+  Inputs:
+
+    None.
+
+ Outputs:
+
+    x - The horizontal position in pixels, or -1 if the last keystroke
+    was typed.
+
+*****************************************************************************/
+int X11Renderer::getPointerPosition(void)
+{
+
+  return (pointerPosition);
+
+} // getPointerPosition
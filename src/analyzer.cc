@@ -12,7 +12,20 @@
 // To run this program type,
 // 
 //    ./analyzer -d <displaytype> -r <sampleRate> -V <verticalgain>
-//              -R <referenceLevel -U -D < inputFile
+//              -R <referenceLevel -U -D -E <eventFile>
+//              -C <detectionThreshold> -W <statisticsWindow>
+//              -P <percentile> -S <statisticsFile> -T <traceModes>
+//              -A <averagingLength> -F <framesPerSecond>
+//              -G <frameAggregation> -v -I -O <output>
+//              -t <triggerSource> -l <triggerLevel> -e <triggerSlope>
+//              -m <triggerMode> -H <holdoff> -a -q <iqMode>
+//              -Q <iqReportFile> -L -M <demodulation>
+//              -o <audioDescriptor> -j -z -b <preTriggerTime>
+//              -B <postTriggerTime> -f <capturePrefix> -k -g
+//              -c <controlSocket> -i <ringName> -p <channelFile>
+//              -Y <channelLogFile> -X <highResolutionPoints>
+//              -K <realtimeCpus> -n <referenceFile>
+//              -N <referenceFrames> -Z <highlightThreshold> < inputFile
 //
 // where,
 //
@@ -36,6 +49,219 @@
 //    to do this (for example, using a spectral display):
 //    ./analyzer -d 2 > >(other program to accept IQ data).
 //
+//    The E flag enables the CFAR signal detector.  Start and stop
+//    events are written, one per line, to the specified file.  A file
+//    name of "-" writes the events to stderr.  The detector runs on
+//    every FFT regardless of the display type.
+//
+//    The C flag sets the detection threshold, in dB, above the
+//    estimated noise floor.  The default is 10dB.  A signal must be
+//    detected in 3 spectra in a row before it starts, and with the
+//    default, noise alone starts about one signal per 30000 spectra
+//    (a couple of minutes at 2.4MS/s).
+//
+//    The W flag enables running spectral statistics (minimum, maximum,
+//    mean and a percentile of each bin) over a window of the specified
+//    number of spectra.  The percentile is overlaid on the spectrum
+//    display as a noise floor trace.
+//
+//    The P flag sets the percentile that is tracked by the spectral
+//    statistics.  The default is 50 (the median).
+//
+//    The S flag writes binary spectral statistics records to the
+//    specified file once per statistics window.  A file name of "-"
+//    writes the records to stderr.
+//
+//    The T flag enables additional traces on the spectrum display.
+//    The value is the sum of the desired traces: 1 - max-hold (red),
+//    2 - min-hold (magenta), 4 - video average (white).  Press 'r' in
+//    the display window to reset the traces.
+//
+//    The A flag sets the number of spectra in the video average.  The
+//    default is 16.
+//
+//    The F flag sets the display frame rate.  Everything that arrives
+//    between frames is combined, so every sample contributes to the
+//    display, but X is only asked to draw this many times a second.  A
+//    value of 0 draws every block.  The default is 30 frames/s.
+//
+//    The G flag selects how power spectra are combined between frames:
+//    1 - average, 2 - peak hold.  The default is 1.
+//
+//    The v flag reports the achieved frame rate and the compute
+//    headroom to stderr every 10 seconds and at exit.
+//
+//    The I flag selects the 16-bit integer FFT instead of FFTW.  This
+//    is much kinder to older processors.
+//
+//    The O flag selects where the display is drawn:
+//    x - An X window (the default).
+//    null - Nowhere.  Everything is still computed, so this, along with
+//    the v flag, measures the processing throughput.
+//    ppm:<directory> - Color PPM images, one file per frame.
+//    pgm:<directory> - Gray PGM images, one file per frame.
+//    A directory of "-" writes the images back to back to stdout, which
+//    can be piped to "ffmpeg -f image2pipe -i -".  Don't combine this
+//    with the D flag.
+//
+//    The t flag triggers the oscilloscope display.  The value selects
+//    what is compared against the trigger level: 1 - magnitude, 2 - I,
+//    3 - Q.  The default, 0, lets the display free run.
+//
+//    The l flag sets the trigger level.  Magnitudes range from 0 to
+//    191, and I and Q range from -128 to 127.  The default is 64.
+//
+//    The e flag selects the trigger slope: 1 - rising, 2 - falling.
+//    The default is 1.
+//
+//    The m flag selects the trigger mode: 1 - normal, 2 - auto (sweep
+//    anyway if the trigger hasn't fired for two sweeps), 3 - single.
+//    Press 't' in the display window to re-arm a single sweep.  The
+//    default is 2.
+//
+//    The H flag sets the trigger holdoff, the number of samples after
+//    a sweep for which the trigger is ignored.  The default is 0.
+//
+//    The a flag scales the spectrum display automatically.  The
+//    reference level and vertical gain follow the noise floor and the
+//    peaks, so the R and V flags are only a starting point.
+//
+//    The q flag measures the quality of the IQ data (DC offset, gain
+//    and phase imbalance, and the percentage of clipped values) and
+//    shows it in the upper left corner of the display: 1 - measure,
+//    2 - measure and correct the DC offset and imbalance before
+//    anything else sees the samples.  Correcting gets rid of the DC
+//    spike in the middle of an rtl-sdr spectrum.  The default, 0,
+//    does neither.
+//
+//    The Q flag writes the IQ quality, once a second, to the specified
+//    file as lines of IQ,dcI,dcQ,gainImbalanceDb,phaseErrorDeg,clip%.
+//    A file name of "-" writes the lines to stderr.
+//
+//    The L flag measures the latency from the arrival of samples to
+//    their appearance on the display, and reports percentiles to
+//    stderr every 10 seconds and at exit.  Marker blocks that are sent
+//    by fileThrottler (its m flag) are also timed from the moment they
+//    were written.
+//
+//    The M flag demodulates the signal at the center of the band and
+//    writes 16-bit, 48000S/s, mono PCM audio while the display runs:
+//    1 - AM, 2 - narrow FM (5kHz deviation), 3 - wide FM (75kHz
+//    deviation, 75us de-emphasis).  The demodulator runs on its own
+//    thread.  For example,
+//    ./analyzer -d 2 -r 2400000 -U -M 3 | aplay -f S16_LE -r 48000.
+//
+//    The o flag sets the file descriptor that the audio is written to.
+//    The default is 1 (stdout), which is also where the D flag and an
+//    output of ppm:- or pgm:- write, so with either of those the audio
+//    must go somewhere else, as in
+//    ./analyzer -D -M 2 -o 3 3> audio.raw | other program.
+//
+//    The j flag drops blocks of IQ data that the demodulator has no
+//    room for, rather than waiting for whatever reads the audio, so
+//    that live input never holds up the display.  Without it, nothing
+//    is lost when the IQ data comes from a file.  The number of blocks
+//    that were dropped is reported to stderr at exit.
+//
+//    The z flag compresses the IQ data that the D flag writes, without
+//    losing anything, using one thread per processor.  A capture is
+//    typically a half to two thirds of its original size, and
+//    fileThrottler (its x flag) plays it back.  For example,
+//    ./analyzer -d 2 -U -D -z < /dev/stdin > capture.iqz.
+//    It compresses the captures of the b flag too.
+//
+//    The b flag keeps the last preTriggerTime seconds of IQ data in a
+//    ring buffer.  When a capture is triggered, that history and the
+//    following postTriggerTime seconds are written to a file by a
+//    separate thread, so the display keeps running.  A capture is
+//    triggered by the 'w' key, by sending the analyzer SIGUSR1
+//    (kill -USR1 <pid>), or, with the g flag, by the start of a signal
+//    that the detector (E flag) finds.
+//
+//    postTriggerTime - The number of seconds after the trigger that are
+//    captured.  The default is 1 second.
+//
+//    capturePrefix - Captures are written to <capturePrefix>-001.iq,
+//    <capturePrefix>-002.iq and so on.  The default is "capture".
+//
+//    The k flag locks the capture ring into memory and backs it with
+//    huge pages if the system allows it, so that it is never paged out.
+//
+//    The g flag triggers a capture whenever the detector sees a new
+//    signal.  Triggers that arrive during a capture are ignored.
+//
+//    The c flag creates a UNIX domain socket that takes commands, one
+//    per line, while the analyzer runs.  The commands are applied
+//    between frames, and each one is answered with "OK" or "ERROR ...":
+//    reference <dB>, gain <gain>, display <magnitude | spectrum |
+//    lissajous>, rate <S/s>, window <hanning | hamming | blackman |
+//    rectangular>, aggregation <average | peak>, averaging <spectra>
+//    and fft <points>.  "help" lists them.  For example,
+//    echo "window blackman" | socat - UNIX-CONNECT:/tmp/analyzer.
+//
+//    The i flag reads the IQ data from the shared memory ring that
+//    fileThrottler (its S flag) writes, instead of from stdin.  Up to
+//    8 analyzers can read the same ring.  Signed samples are analyzed
+//    where they lie in the ring, without being copied.  An analyzer
+//    that can't keep up skips ahead, and the data that it missed is
+//    reported to stderr at exit.
+//
+//    The p flag measures the channels that are listed in the specified
+//    file, one per line as "centerHz bandwidthHz [spacingHz]", with
+//    frequencies relative to the center of the IQ data.  Lines that
+//    start with '#' are ignored.  For each channel, the channel power,
+//    the occupied bandwidth (99% of the power of the channel and its
+//    neighbors) and the power of the adjacent channels, centered
+//    spacingHz away on either side, relative to the channel (ACPR) are
+//    measured in every FFT.  The spacing defaults to the bandwidth.  The
+//    first 4 channels are shown in the upper left corner of the
+//    spectrum display.  Up to 64 channels can be measured.
+//
+//    The Y flag writes the channel measurements of every FFT to the
+//    specified file as lines of spectrum,seconds,channel,powerDb,obwHz,
+//    lowerAcprDb,upperAcprDb.  A file name of "-" writes the lines to
+//    stderr.
+//
+//    The X flag overlays, in orange, the spectrum of an FFT with the
+//    specified number of points (rounded up to a power of two, from 64k
+//    to 16M) on the spectrum display, along with the frequency of its
+//    strongest point in view, to a fraction of a hertz.  The samples are
+//    collected until there are enough, and the FFT runs on its own
+//    thread, using every processor, while the display keeps updating.
+//    Zoom in to see the resolution.  For example, with -X 4194304 at
+//    2400000S/s, the bins are 0.57Hz apart and a new spectrum shows up
+//    every 1.7 seconds.
+//
+//    The K flag runs the thread that reads, processes and displays the
+//    IQ data in real time.  It is pinned to the first CPU of the
+//    specified list (for example 2,3 or 2-5), every other thread is
+//    confined to the rest of the CPUs (or to every other CPU if the list
+//    has only one, with a warning if there are none), all memory is
+//    locked once the buffers have been allocated, and the thread is run
+//    at SCHED_FIFO priority.  A list of "-" pins nothing.  Locking memory and
+//    SCHED_FIFO need privileges (see ulimit -l and ulimit -r), and are
+//    skipped with a warning without them.  The page faults and context
+//    switches that the thread took are reported to stderr at exit.
+//
+//    Press 's' in the spectrum display window to capture a reference
+//    spectrum, averaged over the next frames, and press 'd' to switch
+//    between the normal display and the differential display, which
+//    shows the live spectrum relative to the reference, with no
+//    difference in the middle of the display.  Whatever rises above the
+//    reference by more than the highlight threshold is marked in pink.
+//    The display becomes differential when a capture completes.
+//
+//    The n flag loads the reference spectrum from the specified file
+//    when it exists, and starts out with the differential display.  New
+//    references are saved to the file.  The file holds the FFT size and
+//    the sample rate, and a reference for other ones is rejected.
+//
+//    The N flag sets the number of frames that are averaged into a
+//    reference spectrum.  The default is 50.
+//
+//    The Z flag sets the highlight threshold of the differential
+//    display in dB.  The default is 10.
+//
 //    sampleRate - The sample rate of the IQ data in S/s.
 //
 //    referenceLevel - The reference level of the spectrum display in dB.
@@ -45,9 +271,24 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include <unistd.h>
+#include <signal.h>
 
 #include "SignalAnalyzer.h"
+#include "DisplayGovernor.h"
+#include "X11Renderer.h"
+#include "NullRenderer.h"
+#include "ImageRenderer.h"
+#include "LatencyMonitor.h"
+#include "Demodulator.h"
+#include "IqCompressor.h"
+#include "ControlSocket.h"
+#include "SharedRing.h"
+#include "SpectrumMeter.h"
+#include "HighResolutionSpectrum.h"
+#include "RealtimeMode.h"
+#include "SpectrumReference.h"
 
 // This structure is used to consolidate user parameters.
 struct MyParameters
@@ -58,8 +299,78 @@ struct MyParameters
   int32_t *spectrumReferenceLevelPtr;
   bool *unsignedSamplesPtr;
   bool *iqDumpPtr;
+  char **eventFileNamePtr;
+  float *detectionThresholdPtr;
+  uint32_t *statisticsWindowPtr;
+  float *percentilePtr;
+  char **statisticsFileNamePtr;
+  uint32_t *traceModesPtr;
+  uint32_t *averagingLengthPtr;
+  float *framesPerSecondPtr;
+  int *frameAggregationPtr;
+  bool *verbosePtr;
+  bool *integerFftPtr;
+  char **outputPtr;
+  int *triggerSourcePtr;
+  int *triggerLevelPtr;
+  int *triggerSlopePtr;
+  int *triggerModePtr;
+  uint32_t *holdoffPtr;
+  bool *autoScalePtr;
+  int *iqModePtr;
+  char **iqReportFileNamePtr;
+  bool *latencyPtr;
+  int *demodulationPtr;
+  int *audioDescriptorPtr;
+  bool *dropAudioPtr;
+  bool *compressDumpPtr;
+  float *preTriggerTimePtr;
+  float *postTriggerTimePtr;
+  char **capturePrefixPtr;
+  bool *lockCaptureRingPtr;
+  bool *triggerOnDetectionPtr;
+  char **controlSocketPathPtr;
+  char **ringNamePtr;
+  char **channelFileNamePtr;
+  char **channelLogFileNamePtr;
+  uint32_t *highResolutionPointsPtr;
+  char **realtimeCpusPtr;
+  char **referenceFileNamePtr;
+  uint32_t *referenceFramesPtr;
+  float *highlightThresholdPtr;
 };
 
+// This is set by SIGUSR1 to ask for a capture.
+static volatile sig_atomic_t captureRequested = 0;
+
+/*****************************************************************************
+
+  Name: requestCapture
+
+  Purpose: The purpose of this function is to serve as the handler for
+  SIGUSR1.  It only notes the request, and the main loop starts the
+  capture.
+
+  Calling Sequence: requestCapture(signalNumber)
+
+  Inputs:
+
+    signalNumber - The signal that arrived.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+static void requestCapture(int signalNumber)
+{
+
+  captureRequested = 1;
+
+  return;
+
+} // requestCapture
+
 /*****************************************************************************
 
   Name: getUserArguments
@@ -110,6 +421,119 @@ bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
 
   // Default to not dumping IQ data.
   *parameters.iqDumpPtr = false;
+
+  // Default to no signal detection.
+  *parameters.eventFileNamePtr = NULL;
+
+  // Default to a 10dB detection threshold.
+  *parameters.detectionThresholdPtr = 10;
+
+  // Default to no spectral statistics.
+  *parameters.statisticsWindowPtr = 0;
+
+  // Default to the median.
+  *parameters.percentilePtr = 50;
+
+  // Default to no statistics output.
+  *parameters.statisticsFileNamePtr = NULL;
+
+  // Default to the live trace only.
+  *parameters.traceModesPtr = 0;
+
+  // Default to averaging 16 spectra.
+  *parameters.averagingLengthPtr = 16;
+
+  // Default to 30 frames/s.
+  *parameters.framesPerSecondPtr = 30;
+
+  // Default to averaging spectra between frames.
+  *parameters.frameAggregationPtr = AverageFrames;
+
+  // Default to no performance reports.
+  *parameters.verbosePtr = false;
+
+  // Default to FFTW.
+  *parameters.integerFftPtr = false;
+
+  // Default to an X window.
+  *parameters.outputPtr = (char *)"x";
+
+  // Default to a free running oscilloscope.
+  *parameters.triggerSourcePtr = 0;
+
+  // Default to a rising edge through a magnitude of 64.
+  *parameters.triggerLevelPtr = 64;
+  *parameters.triggerSlopePtr = RisingEdge;
+
+  // Default to sweeping even without a trigger.
+  *parameters.triggerModePtr = AutoTrigger;
+
+  // Default to no holdoff.
+  *parameters.holdoffPtr = 0;
+
+  // Default to the scale that was asked for.
+  *parameters.autoScalePtr = false;
+
+  // Default to not looking at the quality of the IQ data.
+  *parameters.iqModePtr = 0;
+
+  // Default to no IQ quality reports.
+  *parameters.iqReportFileNamePtr = NULL;
+
+  // Default to no latency measurement.
+  *parameters.latencyPtr = false;
+
+  // Default to no demodulation.
+  *parameters.demodulationPtr = 0;
+
+  // Default to writing the audio to stdout.
+  *parameters.audioDescriptorPtr = 1;
+
+  // Default to waiting for the audio rather than dropping IQ data.
+  *parameters.dropAudioPtr = false;
+
+  // Default to dumping plain IQ data.
+  *parameters.compressDumpPtr = false;
+
+  // Default to no capture ring.
+  *parameters.preTriggerTimePtr = 0;
+
+  // Default to a second after the trigger.
+  *parameters.postTriggerTimePtr = 1;
+
+  // Default to captures in the current directory.
+  *parameters.capturePrefixPtr = (char *)"capture";
+
+  // Default to an ordinary capture ring.
+  *parameters.lockCaptureRingPtr = false;
+
+  // Default to capturing on request only.
+  *parameters.triggerOnDetectionPtr = false;
+
+  // Default to no control socket.
+  *parameters.controlSocketPathPtr = NULL;
+
+  // Default to reading from stdin.
+  *parameters.ringNamePtr = NULL;
+
+  // Default to no channel measurements.
+  *parameters.channelFileNamePtr = NULL;
+  *parameters.channelLogFileNamePtr = NULL;
+
+  // Default to the display FFT only.
+  *parameters.highResolutionPointsPtr = 0;
+
+  // Default to ordinary scheduling.
+  *parameters.realtimeCpusPtr = NULL;
+
+  // Default to keeping references in memory.
+  *parameters.referenceFileNamePtr = NULL;
+
+  // Default to a few seconds of frames.
+  *parameters.referenceFramesPtr = 50;
+
+  // Default to highlighting 10dB above the reference.
+  *parameters.highlightThresholdPtr = 10;
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
 
   // Set up for loop entry.
@@ -121,7 +545,7 @@ bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
   while (!done)
   {
     // Retrieve the next option.
-    opt = getopt(argc,argv,"d:r:V:R:UDh");
+    opt = getopt(argc,argv,"d:r:V:R:UDE:C:W:P:S:T:A:F:G:vIO:t:l:e:m:H:aq:Q:LM:o:jzb:B:f:kgc:i:p:Y:X:K:n:N:Z:h");
 
     switch (opt)
     {
@@ -161,139 +585,1361 @@ bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
         break;
       } // case
 
-      case 'h':
+      case 'E':
       {
-        // Display usage.
-        fprintf(stderr,"./analyzer -d [1 - magnitude | 2 - spectrum |"
-                " 3 - lissajous]\n"
-                "           -r samplerate (S/s) \n"
-                "           -R spectrumreferencelevel (dB)\n"
-                "           -V Vertical gain of signal to display\n"
-                "           -U (unsigned samples)\n"
-                "           -D (dump raw IQ) < inputFile\n");
+        *parameters.eventFileNamePtr = optarg;
+        break;
+      } // case
 
-        // Indicate that program must be exited.
-        exitProgram = true;
+      case 'C':
+      {
+        *parameters.detectionThresholdPtr = atof(optarg);
         break;
       } // case
 
-      case -1:
+      case 'W':
       {
-        // All options consumed, so bail out.
-        done = true;
+        *parameters.statisticsWindowPtr = atol(optarg);
+        break;
       } // case
-    } // switch
 
-  } // while
-  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+      case 'P':
+      {
+        *parameters.percentilePtr = atof(optarg);
+        break;
+      } // case
 
-  return (exitProgram);
+      case 'S':
+      {
+        *parameters.statisticsFileNamePtr = optarg;
+        break;
+      } // case
 
-} // getUserArguments
+      case 'T':
+      {
+        *parameters.traceModesPtr = atol(optarg);
+        break;
+      } // case
 
-//*************************************************************************
-// Mainline code.
-//*************************************************************************
-int main(int argc,char **argv)
-{
-  bool done;
-  int8_t *signedBufferPtr;
-  bool exitProgram;
-  uint32_t i;
-  uint32_t count;
-  uint8_t inputBuffer[16384];
-  SignalAnalyzer *analyzerPtr;
-  int displayType;
-  float sampleRate;
-  bool unsignedSamples;
-  float verticalGain;
-  int32_t spectrumReferenceLevel;
-  bool iqDump;
-  struct MyParameters parameters;
+      case 'A':
+      {
+        *parameters.averagingLengthPtr = atol(optarg);
+        break;
+      } // case
 
-  // Set up for parameter transmission.
-  parameters.displayTypePtr = &displayType;
-  parameters.sampleRatePtr = &sampleRate;
-  parameters.unsignedSamplesPtr = &unsignedSamples;
-  parameters.verticalGainPtr = &verticalGain;
-  parameters.spectrumReferenceLevelPtr = &spectrumReferenceLevel;
-  parameters.iqDumpPtr = &iqDump;
+      case 'F':
+      {
+        *parameters.framesPerSecondPtr = atof(optarg);
+        break;
+      } // case
 
-  // Retrieve the system parameters.
-  exitProgram = getUserArguments(argc,argv,parameters);
+      case 'G':
+      {
+        *parameters.frameAggregationPtr = atoi(optarg);
+        break;
+      } // case
 
-  if (exitProgram)
-  {
-    // Bail out.
-    return (0);
-  } // if
+      case 'v':
+      {
+        *parameters.verbosePtr = true;
+        break;
+      } // case
 
-  // Instantiate signal analyzer.
-  analyzerPtr = new SignalAnalyzer((DisplayType)displayType,
-                                   sampleRate,
-                                   verticalGain,
-                                   spectrumReferenceLevel);
+      case 'I':
+      {
+        *parameters.integerFftPtr = true;
+        break;
+      } // case
 
-  // Reference the input buffer in 8-bit signed context.
-  signedBufferPtr = (int8_t *)inputBuffer;
+      case 'O':
+      {
+        *parameters.outputPtr = optarg;
+        break;
+      } // case
 
-  // Set up for loop entry.
-  done = false;
+      case 't':
+      {
+        *parameters.triggerSourcePtr = atoi(optarg);
+        break;
+      } // case
 
-  while (!done)
-  {
-    // Read a block of input samples (2 * complex FFT length).
-    count = fread(inputBuffer,sizeof(int8_t),(2 * N),stdin);
+      case 'l':
+      {
+        *parameters.triggerLevelPtr = atoi(optarg);
+        break;
+      } // case
 
-    if (count == 0)
-    {
-      // We're done.
-      done = true;
-    } // if
-    else
-    {
-      if (unsignedSamples)
+      case 'e':
       {
-        for (i = 0; i < count; i++)
-        {
-          // Convert unsigned samples to signed quantities.
-          signedBufferPtr[i] -= 128;
-        } // for
-      } // if
+        *parameters.triggerSlopePtr = atoi(optarg);
+        break;
+      } // case
 
-      switch (displayType)
+      case 'm':
       {
-        case SignalMagnitude:
-        {
-          analyzerPtr->plotSignalMagnitude(signedBufferPtr,count);
-          break;
-        } // case
+        *parameters.triggerModePtr = atoi(optarg);
+        break;
+      } // case
 
-        case PowerSpectrum:
-        {
-          analyzerPtr->plotPowerSpectrum(signedBufferPtr,count);
-          break;
-        } // case
+      case 'H':
+      {
+        *parameters.holdoffPtr = atol(optarg);
+        break;
+      } // case
 
-        case Lissajous:
-        {
-          analyzerPtr->plotLissajous(signedBufferPtr,count);
-          break;
-        } // case
+      case 'a':
+      {
+        *parameters.autoScalePtr = true;
+        break;
+      } // case
 
-      } // switch
+      case 'q':
+      {
+        *parameters.iqModePtr = atoi(optarg);
+        break;
+      } // case
 
-      if (iqDump == true)
+      case 'Q':
       {
-        // Write to stdout so that raw IQ can be piped to another program.
-        fwrite(signedBufferPtr,sizeof(int8_t),(2 * N),stdout);
-      } // if
+        *parameters.iqReportFileNamePtr = optarg;
+        break;
+      } // case
 
-    } // else
-  } // while
+      case 'L':
+      {
+        *parameters.latencyPtr = true;
+        break;
+      } // case
 
-  // Release resources.
-  delete analyzerPtr;
+      case 'M':
+      {
+        *parameters.demodulationPtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'o':
+      {
+        *parameters.audioDescriptorPtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'j':
+      {
+        *parameters.dropAudioPtr = true;
+        break;
+      } // case
+
+      case 'z':
+      {
+        *parameters.compressDumpPtr = true;
+        break;
+      } // case
+
+      case 'b':
+      {
+        *parameters.preTriggerTimePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'B':
+      {
+        *parameters.postTriggerTimePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'f':
+      {
+        *parameters.capturePrefixPtr = optarg;
+        break;
+      } // case
+
+      case 'k':
+      {
+        *parameters.lockCaptureRingPtr = true;
+        break;
+      } // case
+
+      case 'g':
+      {
+        *parameters.triggerOnDetectionPtr = true;
+        break;
+      } // case
+
+      case 'c':
+      {
+        *parameters.controlSocketPathPtr = optarg;
+        break;
+      } // case
+
+      case 'i':
+      {
+        *parameters.ringNamePtr = optarg;
+        break;
+      } // case
+
+      case 'p':
+      {
+        *parameters.channelFileNamePtr = optarg;
+        break;
+      } // case
+
+      case 'Y':
+      {
+        *parameters.channelLogFileNamePtr = optarg;
+        break;
+      } // case
+
+      case 'X':
+      {
+        *parameters.highResolutionPointsPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'K':
+      {
+        *parameters.realtimeCpusPtr = optarg;
+        break;
+      } // case
+
+      case 'n':
+      {
+        *parameters.referenceFileNamePtr = optarg;
+        break;
+      } // case
+
+      case 'N':
+      {
+        *parameters.referenceFramesPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'Z':
+      {
+        *parameters.highlightThresholdPtr = atof(optarg);
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./analyzer -d [1 - magnitude | 2 - spectrum |"
+                " 3 - lissajous]\n"
+                "           -r samplerate (S/s) \n"
+                "           -R spectrumreferencelevel (dB)\n"
+                "           -V Vertical gain of signal to display\n"
+                "           -U (unsigned samples)\n"
+                "           -D (dump raw IQ)\n"
+                "           -E eventfile (- for stderr)\n"
+                "           -C detectionthreshold (dB)\n"
+                "           -W statisticswindow (spectra)\n"
+                "           -P statisticspercentile\n"
+                "           -S statisticsfile (- for stderr)\n"
+                "           -T [1 - maxhold | 2 - minhold | 4 - average]\n"
+                "           -A averaginglength (spectra)\n"
+                "           -F framespersecond (0 - every block)\n"
+                "           -G [1 - average | 2 - peak hold] between frames\n"
+                "           -v (report frame rate and headroom)\n"
+                "           -I (integer FFT)\n"
+                "           -O [x | null | ppm:directory | pgm:directory]\n"
+                "           -t [0 - off | 1 - magnitude | 2 - I | 3 - Q]"
+                " trigger\n"
+                "           -l triggerlevel\n"
+                "           -e [1 - rising | 2 - falling] edge\n"
+                "           -m [1 - normal | 2 - auto | 3 - single]\n"
+                "           -H holdoff (samples)\n"
+                "           -a (automatic spectrum scaling)\n"
+                "           -q [0 - off | 1 - measure | 2 - correct] IQ\n"
+                "           -Q iqreportfile (- for stderr)\n"
+                "           -L (report display latency)\n"
+                "           -M [1 - AM | 2 - narrow FM | 3 - wide FM]\n"
+                "           -o audiodescriptor\n"
+                "           -j (drop IQ data when the audio falls behind)\n"
+                "           -z (compress dumped IQ)\n"
+                "           -b pretriggertime (s)\n"
+                "           -B posttriggertime (s)\n"
+                "           -f captureprefix\n"
+                "           -k (lock the capture ring in memory)\n"
+                "           -g (capture when a signal is detected)\n"
+                "           -c controlsocket\n"
+                "           -i ringname\n"
+                "           -p channelfile\n"
+                "           -Y channellogfile\n"
+                "           -X highresolutionpoints\n"
+                "           -K realtimecpus (- for no pinning)\n"
+                "           -n referencefile\n"
+                "           -N referenceframes\n"
+                "           -Z highlightthreshold (dB) < inputFile\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+/*****************************************************************************
+
+  Name: applyControlCommands
+
+  Purpose: The purpose of this function is to apply the commands that
+  have arrived on the control socket since the last frame, and to
+  answer each of them.  New windows arrive with their tables already
+  built, so swapping one in costs no more than a pointer, and the old
+  tables are handed back to the control thread to be destroyed.
+
+  Calling Sequence: applyControlCommands(controlPtr,
+                                         analyzerPtr,
+                                         tracesPtr,
+                                         fixedPointFftPtr,
+                                         windowTablesPtrPtr)
+
+  Inputs:
+
+    controlPtr - A pointer to the control socket.
+
+    analyzerPtr - A pointer to the signal analyzer.
+
+    tracesPtr - A pointer to the hold and average traces, or NULL if
+    there are none.
+
+    fixedPointFftPtr - A pointer to the integer FFT, or NULL if FFTW is
+    used.
+
+    windowTablesPtrPtr - A pointer to the tables that were last swapped
+    in, which the caller owns.  It is updated when the window changes.
+
+ Outputs:
+
+    None.
+
+*****************************************************************************/
+static void applyControlCommands(ControlSocket *controlPtr,
+                                 SignalAnalyzer *analyzerPtr,
+                                 SpectrumTraces *tracesPtr,
+                                 FixedPointFft *fixedPointFftPtr,
+                                 SpectrumTables **windowTablesPtrPtr)
+{
+  ControlCommand command;
+  const char *replyPtr;
+  char sizeReply[64];
+
+  while (controlPtr->getCommand(&command))
+  {
+    // Default to success.
+    replyPtr = "OK";
+
+    switch (command.type)
+    {
+      case ControlReferenceLevel:
+      {
+        analyzerPtr->setReferenceLevel((int32_t)command.value);
+        break;
+      } // case
+
+      case ControlVerticalGain:
+      {
+        analyzerPtr->setVerticalGain(command.value);
+        break;
+      } // case
+
+      case ControlDisplayType:
+      {
+        analyzerPtr->setDisplayType((DisplayType)command.value);
+        break;
+      } // case
+
+      case ControlSampleRate:
+      {
+        analyzerPtr->setSampleRate(command.value);
+        break;
+      } // case
+
+      case ControlFrameAggregation:
+      {
+        analyzerPtr->setFrameAggregation((FrameAggregation)command.value);
+        break;
+      } // case
+
+      case ControlAveragingLength:
+      {
+        if (tracesPtr != NULL)
+        {
+          tracesPtr->setAveragingLength((uint32_t)command.value);
+        } // if
+        else
+        {
+          replyPtr = "ERROR there is no average trace (T flag)";
+        } // else
+        break;
+      } // case
+
+      case ControlWindow:
+      {
+        if (fixedPointFftPtr != NULL)
+        {
+          // The integer FFT has a window of its own.
+          replyPtr = "ERROR the integer FFT has a fixed window";
+          controlPtr->retireTables(command.tablesPtr);
+        } // if
+        else
+        {
+          // The tables that come back are whatever was in use.
+          controlPtr->retireTables(
+              analyzerPtr->setSpectrumTables(command.tablesPtr));
+
+          *windowTablesPtrPtr = command.tablesPtr;
+        } // else
+        break;
+      } // case
+
+      case ControlFftSize:
+      {
+        if ((uint32_t)command.value != N)
+        {
+          // Every buffer in the analyzer is sized at compile time.
+          snprintf(sizeReply,sizeof(sizeReply),
+                   "ERROR the FFT size is fixed at %d",N);
+          replyPtr = sizeReply;
+        } // if
+        break;
+      } // case
+    } // switch
+
+    controlPtr->reply(&command,replyPtr);
+  } // while
+
+  return;
+
+} // applyControlCommands
+
+/*****************************************************************************
+
+  Name: loadChannels
+
+  Purpose: The purpose of this function is to read the channels that
+  are to be measured from a file, one per line as
+  "centerHz bandwidthHz [spacingHz]".  Blank lines and lines that start
+  with '#' are ignored.
+
+  Calling Sequence: success = loadChannels(meterPtr,fileNamePtr)
+
+  Inputs:
+
+    meterPtr - A pointer to the meter that the channels are added to.
+
+    fileNamePtr - The name of the channel file.
+
+  Outputs:
+
+    success - A flag that indicates whether or not at least one channel
+    was added.
+
+*****************************************************************************/
+static bool loadChannels(SpectrumMeter *meterPtr,char *fileNamePtr)
+{
+  FILE *streamPtr;
+  char line[256];
+  int numberOfFields;
+  float centerFrequency;
+  float bandwidth;
+  float spacing;
+  uint32_t lineNumber;
+
+  streamPtr = fopen(fileNamePtr,"r");
+
+  if (streamPtr == NULL)
+  {
+    fprintf(stderr,"Could not open channel file %s\n",fileNamePtr);
+    return (false);
+  } // if
+
+  lineNumber = 0;
+
+  while (fgets(line,sizeof(line),streamPtr) != NULL)
+  {
+    lineNumber++;
+
+    // The spacing is optional.
+    spacing = 0;
+
+    numberOfFields = sscanf(line,"%f %f %f",
+                            &centerFrequency,&bandwidth,&spacing);
+
+    if ((line[0] != '#') && (numberOfFields >= 2))
+    {
+      if (!meterPtr->addChannel(centerFrequency,bandwidth,spacing))
+      {
+        fprintf(stderr,"%s:%u: channel ignored\n",fileNamePtr,lineNumber);
+      } // if
+    } // if
+  } // while
+
+  fclose(streamPtr);
+
+  return (meterPtr->getNumberOfChannels() > 0);
+
+} // loadChannels
+
+/*****************************************************************************
+
+  Name: createRenderer
+
+  Purpose: The purpose of this function is to create the renderer that
+  the display is drawn with.
+
+  Calling Sequence: rendererPtr = createRenderer(outputPtr)
+
+  Inputs:
+
+    outputPtr - The output that was specified with the O flag: "x",
+    "null", "ppm:<directory>" or "pgm:<directory>".
+
+  Outputs:
+
+    rendererPtr - A pointer to the renderer, or NULL if the output is
+    not understood.
+
+*****************************************************************************/
+static Renderer *createRenderer(char *outputPtr)
+{
+  Renderer *rendererPtr;
+
+  // Default to not understanding the output.
+  rendererPtr = NULL;
+
+  if (strcmp(outputPtr,"x") == 0)
+  {
+    rendererPtr = new X11Renderer(DISPLAY_WIDTH,DISPLAY_HEIGHT);
+  } // if
+
+  if (strcmp(outputPtr,"null") == 0)
+  {
+    rendererPtr = new NullRenderer();
+  } // if
+
+  if (strncmp(outputPtr,"ppm:",4) == 0)
+  {
+    rendererPtr = new ImageRenderer(DISPLAY_WIDTH,DISPLAY_HEIGHT,
+                                    &outputPtr[4],false);
+  } // if
+
+  if (strncmp(outputPtr,"pgm:",4) == 0)
+  {
+    rendererPtr = new ImageRenderer(DISPLAY_WIDTH,DISPLAY_HEIGHT,
+                                    &outputPtr[4],true);
+  } // if
+
+  return (rendererPtr);
+
+} // createRenderer
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool done;
+  int8_t *signedBufferPtr;
+  bool exitProgram;
+  uint32_t i;
+  uint32_t count;
+  uint8_t inputBuffer[16384];
+  int8_t correctedBuffer[16384];
+  int8_t *correctedBufferPtr;
+  const int8_t *ringDataPtr;
+  SignalAnalyzer *analyzerPtr;
+  char *output;
+  Renderer *rendererPtr;
+  int displayType;
+  float sampleRate;
+  bool unsignedSamples;
+  float verticalGain;
+  int32_t spectrumReferenceLevel;
+  bool iqDump;
+  char *eventFileName;
+  float detectionThreshold;
+  FILE *eventStreamPtr;
+  SpectrumDetector *detectorPtr;
+  uint32_t statisticsWindow;
+  float percentile;
+  char *statisticsFileName;
+  FILE *statisticsStreamPtr;
+  SpectrumStatistics *statisticsPtr;
+  uint32_t traceModes;
+  uint32_t averagingLength;
+  SpectrumTraces *tracesPtr;
+  float framesPerSecond;
+  int frameAggregation;
+  bool verbose;
+  DisplayGovernor *governorPtr;
+  bool integerFft;
+  FixedPointFft *fixedPointFftPtr;
+  int triggerSource;
+  int triggerLevel;
+  int triggerSlope;
+  int triggerMode;
+  uint32_t holdoff;
+  ScopeTrigger *triggerPtr;
+  bool autoScale;
+  SpectrumAutoScaler *autoScalerPtr;
+  int iqMode;
+  char *iqReportFileName;
+  FILE *iqReportStreamPtr;
+  IqCorrector *correctorPtr;
+  bool latency;
+  LatencyMonitor *latencyPtr;
+  int demodulation;
+  int audioDescriptor;
+  bool dropAudio;
+  Demodulator *demodulatorPtr;
+  bool compressDump;
+  IqCompressor *compressorPtr;
+  float preTriggerTime;
+  float postTriggerTime;
+  char *capturePrefix;
+  bool lockCaptureRing;
+  bool triggerOnDetection;
+  CaptureRing *capturePtr;
+  uint64_t numberOfStarts;
+  char *controlSocketPath;
+  ControlSocket *controlPtr;
+  char *ringName;
+  SharedRing *ringPtr;
+  char *channelFileName;
+  char *channelLogFileName;
+  FILE *channelLogStreamPtr;
+  SpectrumMeter *meterPtr;
+  uint32_t highResolutionPoints;
+  HighResolutionSpectrum *highResolutionPtr;
+  char *realtimeCpus;
+  RealtimeMode *realtimePtr;
+  char *referenceFileName;
+  uint32_t referenceFrames;
+  float highlightThreshold;
+  SpectrumReference *referencePtr;
+  SpectrumTables *windowTablesPtr;
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.displayTypePtr = &displayType;
+  parameters.sampleRatePtr = &sampleRate;
+  parameters.unsignedSamplesPtr = &unsignedSamples;
+  parameters.verticalGainPtr = &verticalGain;
+  parameters.spectrumReferenceLevelPtr = &spectrumReferenceLevel;
+  parameters.iqDumpPtr = &iqDump;
+  parameters.eventFileNamePtr = &eventFileName;
+  parameters.detectionThresholdPtr = &detectionThreshold;
+  parameters.statisticsWindowPtr = &statisticsWindow;
+  parameters.percentilePtr = &percentile;
+  parameters.statisticsFileNamePtr = &statisticsFileName;
+  parameters.traceModesPtr = &traceModes;
+  parameters.averagingLengthPtr = &averagingLength;
+  parameters.framesPerSecondPtr = &framesPerSecond;
+  parameters.frameAggregationPtr = &frameAggregation;
+  parameters.verbosePtr = &verbose;
+  parameters.integerFftPtr = &integerFft;
+  parameters.outputPtr = &output;
+  parameters.triggerSourcePtr = &triggerSource;
+  parameters.triggerLevelPtr = &triggerLevel;
+  parameters.triggerSlopePtr = &triggerSlope;
+  parameters.triggerModePtr = &triggerMode;
+  parameters.holdoffPtr = &holdoff;
+  parameters.autoScalePtr = &autoScale;
+  parameters.iqModePtr = &iqMode;
+  parameters.iqReportFileNamePtr = &iqReportFileName;
+  parameters.latencyPtr = &latency;
+  parameters.demodulationPtr = &demodulation;
+  parameters.audioDescriptorPtr = &audioDescriptor;
+  parameters.dropAudioPtr = &dropAudio;
+  parameters.compressDumpPtr = &compressDump;
+  parameters.preTriggerTimePtr = &preTriggerTime;
+  parameters.postTriggerTimePtr = &postTriggerTime;
+  parameters.capturePrefixPtr = &capturePrefix;
+  parameters.lockCaptureRingPtr = &lockCaptureRing;
+  parameters.triggerOnDetectionPtr = &triggerOnDetection;
+  parameters.controlSocketPathPtr = &controlSocketPath;
+  parameters.ringNamePtr = &ringName;
+  parameters.channelFileNamePtr = &channelFileName;
+  parameters.channelLogFileNamePtr = &channelLogFileName;
+  parameters.highResolutionPointsPtr = &highResolutionPoints;
+  parameters.realtimeCpusPtr = &realtimeCpus;
+  parameters.referenceFileNamePtr = &referenceFileName;
+  parameters.referenceFramesPtr = &referenceFrames;
+  parameters.highlightThresholdPtr = &highlightThreshold;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  if ((demodulation != 0) && (audioDescriptor == 1))
+  {
+    if (iqDump || (strcmp(output,"ppm:-") == 0) ||
+        (strcmp(output,"pgm:-") == 0))
+    {
+      fprintf(stderr,"The audio and the %s would both go to stdout,"
+              " so send the audio elsewhere with -o\n",
+              iqDump ? "dumped IQ data" : "images");
+      return (1);
+    } // if
+  } // if
+
+  // Default to stdin.
+  ringPtr = NULL;
+
+  if (ringName != NULL)
+  {
+    // This waits for fileThrottler to create the ring.
+    ringPtr = new SharedRing(ringName);
+
+    if (!ringPtr->isValid())
+    {
+      delete ringPtr;
+      return (1);
+    } // if
+  } // if
+
+  // Default to ordinary scheduling.
+  realtimePtr = NULL;
+
+  if (realtimeCpus != NULL)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // This moves the process to the helper CPUs,
+    // so it is created before any thread, and the
+    // threads inherit them.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    realtimePtr = new RealtimeMode(realtimeCpus);
+
+    if (!realtimePtr->isValid())
+    {
+      delete realtimePtr;
+      return (1);
+    } // if
+  } // if
+
+  // Instantiate the renderer.
+  rendererPtr = createRenderer(output);
+
+  if (rendererPtr == NULL)
+  {
+    fprintf(stderr,"Unknown output: %s\n",output);
+    return (1);
+  } // if
+
+  // Instantiate signal analyzer.
+  analyzerPtr = new SignalAnalyzer(rendererPtr,
+                                   (DisplayType)displayType,
+                                   sampleRate,
+                                   verticalGain,
+                                   spectrumReferenceLevel,
+                                   (FrameAggregation)frameAggregation,
+                                   NULL);
+
+  // Default to FFTW.
+  fixedPointFftPtr = NULL;
+
+  if (integerFft)
+  {
+    // Instantiate the fixed-point FFT.
+    fixedPointFftPtr = new FixedPointFft(N);
+
+    analyzerPtr->setFixedPointFft(fixedPointFftPtr);
+  } // if
+
+  // Instantiate the display governor.
+  governorPtr = new DisplayGovernor(framesPerSecond,sampleRate,verbose);
+
+  // Default to no signal detection.
+  eventStreamPtr = NULL;
+  detectorPtr = NULL;
+
+  if (eventFileName != NULL)
+  {
+    if (strcmp(eventFileName,"-") == 0)
+    {
+      eventStreamPtr = stderr;
+    } // if
+    else
+    {
+      eventStreamPtr = fopen(eventFileName,"w");
+    } // else
+
+    if (eventStreamPtr == NULL)
+    {
+      fprintf(stderr,"Could not open event file %s\n",eventFileName);
+    } // if
+    else
+    {
+      // Instantiate the signal detector.
+      detectorPtr = new SpectrumDetector(N,
+                                         sampleRate,
+                                         detectionThreshold,
+                                         eventStreamPtr);
+
+      analyzerPtr->setSignalDetector(detectorPtr);
+    } // else
+  } // if
+
+  // Default to no spectral statistics.
+  statisticsStreamPtr = NULL;
+  statisticsPtr = NULL;
+
+  if (statisticsWindow > 0)
+  {
+    if (statisticsFileName != NULL)
+    {
+      if (strcmp(statisticsFileName,"-") == 0)
+      {
+        statisticsStreamPtr = stderr;
+      } // if
+      else
+      {
+        statisticsStreamPtr = fopen(statisticsFileName,"w");
+      } // else
+
+      if (statisticsStreamPtr == NULL)
+      {
+        fprintf(stderr,"Could not open statistics file %s\n",
+                statisticsFileName);
+      } // if
+    } // if
+
+    // Instantiate the spectral statistics.
+    statisticsPtr = new SpectrumStatistics(N,
+                                           statisticsWindow,
+                                           percentile,
+                                           statisticsStreamPtr);
+
+    analyzerPtr->setSpectrumStatistics(statisticsPtr);
+  } // if
+
+  // Default to the live trace only.
+  tracesPtr = NULL;
+
+  if (traceModes != 0)
+  {
+    // Instantiate the hold and average traces.
+    tracesPtr = new SpectrumTraces(N,traceModes,averagingLength);
+
+    analyzerPtr->setSpectrumTraces(tracesPtr);
+  } // if
+
+  // Default to no channel measurements.
+  channelLogStreamPtr = NULL;
+  meterPtr = NULL;
+
+  if (channelFileName != NULL)
+  {
+    if (channelLogFileName != NULL)
+    {
+      if (strcmp(channelLogFileName,"-") == 0)
+      {
+        channelLogStreamPtr = stderr;
+      } // if
+      else
+      {
+        channelLogStreamPtr = fopen(channelLogFileName,"w");
+      } // else
+
+      if (channelLogStreamPtr == NULL)
+      {
+        fprintf(stderr,"Could not open channel log file %s\n",
+                channelLogFileName);
+      } // if
+    } // if
+
+    // Instantiate the channel meter.
+    meterPtr = new SpectrumMeter(N,sampleRate,channelLogStreamPtr);
+
+    if (loadChannels(meterPtr,channelFileName))
+    {
+      analyzerPtr->setSpectrumMeter(meterPtr);
+    } // if
+    else
+    {
+      delete meterPtr;
+      meterPtr = NULL;
+    } // else
+  } // if
+
+  // Default to the display FFT only.
+  highResolutionPtr = NULL;
+
+  if (highResolutionPoints != 0)
+  {
+    // Use every processor.
+    highResolutionPtr = new HighResolutionSpectrum(highResolutionPoints,N,0);
+
+    if (highResolutionPtr->isValid())
+    {
+      analyzerPtr->setHighResolutionSpectrum(highResolutionPtr);
+    } // if
+    else
+    {
+      delete highResolutionPtr;
+      highResolutionPtr = NULL;
+    } // else
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // A reference costs nothing until one is
+  // captured, so it is always there.  This loads
+  // the reference file if there is one.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  referencePtr = new SpectrumReference(N,
+                                       sampleRate,
+                                       referenceFrames,
+                                       referenceFileName);
+
+  analyzerPtr->setSpectrumReference(referencePtr,highlightThreshold);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Default to a free running oscilloscope.
+  triggerPtr = NULL;
+
+  if (triggerSource != 0)
+  {
+    // Instantiate the oscilloscope trigger.
+    triggerPtr = new ScopeTrigger(N,
+                                  (TriggerSource)triggerSource,
+                                  (TriggerSlope)triggerSlope,
+                                  triggerLevel,
+                                  (TriggerMode)triggerMode,
+                                  holdoff);
+
+    analyzerPtr->setScopeTrigger(triggerPtr);
+  } // if
+
+  // Default to the scale that was asked for.
+  autoScalerPtr = NULL;
+
+  if (autoScale)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // The scaler is updated once per frame, and
+    // when every block is a frame, that's the
+    // block rate.  The display is 80dB high at
+    // unity gain.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    autoScalerPtr = new SpectrumAutoScaler(
+        (framesPerSecond > 0) ? framesPerSecond : (sampleRate / N),
+        80);
+
+    analyzerPtr->setAutoScaler(autoScalerPtr);
+  } // if
+
+  // Default to no IQ quality reports.
+  iqReportStreamPtr = NULL;
+
+  if (iqReportFileName != NULL)
+  {
+    if (strcmp(iqReportFileName,"-") == 0)
+    {
+      iqReportStreamPtr = stderr;
+    } // if
+    else
+    {
+      iqReportStreamPtr = fopen(iqReportFileName,"w");
+    } // else
+
+    if (iqReportStreamPtr == NULL)
+    {
+      fprintf(stderr,"Could not open IQ report file %s\n",iqReportFileName);
+    } // if
+  } // if
+
+  // Default to not looking at the quality of the IQ data.
+  correctorPtr = NULL;
+
+  if ((iqMode != 0) || (iqReportStreamPtr != NULL))
+  {
+    // Instantiate the IQ front end stage.
+    correctorPtr = new IqCorrector((iqMode == 2),
+                                   sampleRate,
+                                   iqReportStreamPtr);
+
+    analyzerPtr->setIqCorrector(correctorPtr);
+  } // if
+
+  // Default to no latency measurement.
+  latencyPtr = NULL;
+
+  if (latency)
+  {
+    latencyPtr = new LatencyMonitor();
+  } // if
+
+  // Default to no demodulation.
+  demodulatorPtr = NULL;
+
+  if (demodulation != 0)
+  {
+    // This starts the demodulation thread.
+    demodulatorPtr = new Demodulator((DemodulationType)demodulation,
+                                     sampleRate,
+                                     audioDescriptor,
+                                     dropAudio);
+  } // if
+
+  // Default to dumping plain IQ data.
+  compressorPtr = NULL;
+
+  if (iqDump && compressDump)
+  {
+    // This starts the compression threads.
+    compressorPtr = new IqCompressor(stdout,0);
+  } // if
+
+  // Default to no capture ring.
+  capturePtr = NULL;
+  numberOfStarts = 0;
+
+  if (preTriggerTime > 0)
+  {
+    // This allocates the ring and starts the writer thread.
+    capturePtr = new CaptureRing(sampleRate,
+                                 preTriggerTime,
+                                 postTriggerTime,
+                                 capturePrefix,
+                                 lockCaptureRing,
+                                 compressDump);
+
+    analyzerPtr->setCaptureRing(capturePtr);
+
+    signal(SIGUSR1,requestCapture);
+  } // if
+
+  // Default to the window that the analyzer was built with.
+  controlPtr = NULL;
+  windowTablesPtr = NULL;
+
+  if (controlSocketPath != NULL)
+  {
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // This starts the control thread.  It plans
+    // FFTs for new windows, so it is started after
+    // everything else that plans them.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    controlPtr = new ControlSocket(controlSocketPath,N);
+
+    if (!controlPtr->isListening())
+    {
+      delete controlPtr;
+      controlPtr = NULL;
+    } // if
+  } // if
+
+  if (realtimePtr != NULL)
+  {
+    // Everything is allocated, so lock it down and pin this thread.
+    realtimePtr->enterHotPath();
+  } // if
+
+  // Set up for loop entry.
+  done = false;
+
+  while (!done)
+  {
+    // Reference the input buffer in 8-bit signed context.
+    signedBufferPtr = (int8_t *)inputBuffer;
+
+    if (ringPtr != NULL)
+    {
+      // Read a block of input samples (2 * complex FFT length).
+      count = ringPtr->acquire(&ringDataPtr,(2 * N));
+
+      if (unsignedSamples || (correctorPtr != NULL))
+      {
+        // The ring is read-only, so the samples are changed in a copy.
+        memcpy(inputBuffer,ringDataPtr,count);
+      } // if
+      else
+      {
+        // Nothing writes to the samples, so leave them where they are.
+        signedBufferPtr = (int8_t *)ringDataPtr;
+      } // else
+    } // if
+    else
+    {
+      // Read a block of input samples (2 * complex FFT length).
+      count = fread(inputBuffer,sizeof(int8_t),(2 * N),stdin);
+    } // else
+
+    if (count == 0)
+    {
+      // We're done.
+      done = true;
+    } // if
+    else
+    {
+      if (latencyPtr != NULL)
+      {
+        // This has to see the block exactly as it was sent.
+        latencyPtr->stampBlock(signedBufferPtr,count);
+      } // if
+
+      if (correctorPtr != NULL)
+      {
+        // This converts unsigned samples in the same pass.
+        correctorPtr->acceptSamples(signedBufferPtr,count,unsignedSamples);
+      } // if
+      else
+      {
+        if (unsignedSamples)
+        {
+          for (i = 0; i < count; i++)
+          {
+            // Convert unsigned samples to signed quantities.
+            signedBufferPtr[i] -= 128;
+          } // for
+        } // if
+      } // else
+
+      // Default to passing the samples along as they are.
+      correctedBufferPtr = signedBufferPtr;
+
+      if ((iqMode == 2) &&
+          ((capturePtr != NULL) || (demodulatorPtr != NULL) || iqDump))
+      {
+        //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+        // The analyzer corrects the samples itself, since
+        // the spectrum is corrected in floating point, but
+        // everything else here takes 8-bit samples.
+        //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+        correctorPtr->correctSamples(signedBufferPtr,count,correctedBuffer);
+        correctedBufferPtr = correctedBuffer;
+      } // if
+
+      if (capturePtr != NULL)
+      {
+        // This only copies the block into the ring.
+        capturePtr->acceptSamples(correctedBufferPtr,count);
+
+        if (captureRequested)
+        {
+          captureRequested = 0;
+          capturePtr->trigger("signal");
+        } // if
+      } // if
+
+      if (demodulatorPtr != NULL)
+      {
+        // This only queues the block for the demodulation thread.
+        demodulatorPtr->acceptSamples(correctedBufferPtr,count);
+      } // if
+
+      // Process every block.
+      governorPtr->startCompute();
+      analyzerPtr->acceptSamples(signedBufferPtr,count);
+      governorPtr->stopCompute(count / 2);
+
+      if ((capturePtr != NULL) && triggerOnDetection && (detectorPtr != NULL))
+      {
+        if (detectorPtr->getNumberOfStarts() != numberOfStarts)
+        {
+          numberOfStarts = detectorPtr->getNumberOfStarts();
+          capturePtr->trigger("detection");
+        } // if
+      } // if
+
+      if (governorPtr->isFrameDue())
+      {
+        // Display everything that has accumulated since the last frame.
+        governorPtr->startRender();
+        analyzerPtr->renderDisplay();
+        governorPtr->stopRender();
+
+        if (latencyPtr != NULL)
+        {
+          // Wait until the frame is really on the display.
+          rendererPtr->synchronize();
+          latencyPtr->frameDisplayed();
+        } // if
+
+        if (controlPtr != NULL)
+        {
+          // Changes take effect at the start of the next frame.
+          applyControlCommands(controlPtr,
+                               analyzerPtr,
+                               tracesPtr,
+                               fixedPointFftPtr,
+                               &windowTablesPtr);
+        } // if
+      } // if
+
+      if (iqDump == true)
+      {
+        if (compressorPtr != NULL)
+        {
+          compressorPtr->acceptSamples(correctedBufferPtr,count);
+        } // if
+        else
+        {
+          // Write to stdout so that raw IQ can be piped to another program.
+          fwrite(correctedBufferPtr,sizeof(int8_t),count,stdout);
+        } // else
+      } // if
+
+      if (ringPtr != NULL)
+      {
+        // The producer may now write over the block.
+        ringPtr->release(count);
+      } // if
+    } // else
+  } // while
+
+  if (realtimePtr != NULL)
+  {
+    // Stop counting, and shut down at the normal priority.
+    realtimePtr->leaveHotPath();
+  } // if
+
+  // Show whatever is left over.
+  analyzerPtr->renderDisplay();
+
+  if (controlPtr != NULL)
+  {
+    // This stops the control thread before anything it refers to goes.
+    delete controlPtr;
+  } // if
+
+  if (latencyPtr != NULL)
+  {
+    rendererPtr->synchronize();
+    latencyPtr->frameDisplayed();
+
+    // This reports the statistics for the whole run.
+    delete latencyPtr;
+  } // if
+
+  if (demodulatorPtr != NULL)
+  {
+    demodulatorPtr->reportStatistics();
+
+    // This finishes whatever audio is still queued.
+    delete demodulatorPtr;
+  } // if
+
+  if (compressorPtr != NULL)
+  {
+    // This writes the last block and the block index.
+    delete compressorPtr;
+  } // if
+
+  if (capturePtr != NULL)
+  {
+    // This finishes a capture that is in progress.
+    delete capturePtr;
+  } // if
+
+  // Release resources.
+  delete governorPtr;
+  delete analyzerPtr;
+  delete rendererPtr;
+
+  if (windowTablesPtr != NULL)
+  {
+    // The analyzer doesn't own tables that were swapped in.
+    delete windowTablesPtr;
+  } // if
+
+  if (detectorPtr != NULL)
+  {
+    // This flushes any signals that are still active.
+    delete detectorPtr;
+  } // if
+
+  if ((eventStreamPtr != NULL) && (eventStreamPtr != stderr))
+  {
+    fclose(eventStreamPtr);
+  } // if
+
+  if (statisticsPtr != NULL)
+  {
+    delete statisticsPtr;
+  } // if
+
+  if ((statisticsStreamPtr != NULL) && (statisticsStreamPtr != stderr))
+  {
+    fclose(statisticsStreamPtr);
+  } // if
+
+  if (tracesPtr != NULL)
+  {
+    delete tracesPtr;
+  } // if
+
+  if (meterPtr != NULL)
+  {
+    delete meterPtr;
+  } // if
+
+  if (highResolutionPtr != NULL)
+  {
+    // This waits for a spectrum that is being computed.
+    delete highResolutionPtr;
+  } // if
+
+  delete referencePtr;
+
+  if ((channelLogStreamPtr != NULL) && (channelLogStreamPtr != stderr))
+  {
+    fclose(channelLogStreamPtr);
+  } // if
+
+  if (triggerPtr != NULL)
+  {
+    delete triggerPtr;
+  } // if
+
+  if (autoScalerPtr != NULL)
+  {
+    delete autoScalerPtr;
+  } // if
+
+  if (correctorPtr != NULL)
+  {
+    delete correctorPtr;
+  } // if
+
+  if ((iqReportStreamPtr != NULL) && (iqReportStreamPtr != stderr))
+  {
+    fclose(iqReportStreamPtr);
+  } // if
+
+  if (fixedPointFftPtr != NULL)
+  {
+    delete fixedPointFftPtr;
+  } // if
+
+  if (ringPtr != NULL)
+  {
+    ringPtr->reportStatistics();
+    delete ringPtr;
+  } // if
+
+  if (realtimePtr != NULL)
+  {
+    // This reports the faults and context switches of the loop.
+    delete realtimePtr;
+  } // if
 
   return (0);
 
@@ -0,0 +1,604 @@
+//*************************************************************************
+// File name: correlator.cc
+//*************************************************************************
+
+//*************************************************************************
+// This program cross-correlates two synchronized streams of IQ data,
+// such as the outputs of two receivers that share a clock, to find the
+// time offset between them and how coherent they are.  The correlation
+// is computed with FFT's by a pool of threads.  For each integration
+// period, the coherence is displayed at every lag, and a line of the
+// form,
+//
+//    lag,lagInMicroseconds,coherence,phaseInDegrees
+//
+// is written to stdout.  The lag of the peak is interpolated to a
+// fraction of a sample.  A positive lag means that the signal arrives
+// at the first stream later than at the second.  The data is 8-bit
+// signed 2's complement, and is formatted as I1,Q1; I2,Q2; ...
+//
+// To run this program type,
+//
+//    ./correlator -r <sampleRate> -L <maximumLag> -T <integrationTime>
+//                 -j <threads> -U -O <output> firstStream secondStream
+//
+// where,
+//
+//    sampleRate - The sample rate of both streams in S/s.  It is only
+//    used to show the lag in time.
+//
+//    maximumLag - The largest lag, in samples, in either direction.
+//    The FFT grows to cover it.  The default is 1024.
+//
+//    integrationTime - The time, in seconds, that is summed into each
+//    result.  The default is 0.1 seconds.
+//
+//    threads - The number of correlation threads.  The default, 0, uses
+//    one thread per processor.
+//
+//    The U flag indicates that the IQ samples are unsigned 8-bit
+//    quantities rather than the default signed values.
+//
+//    The O flag selects where the display is drawn: x (the default),
+//    null, ppm:<directory> or pgm:<directory>, as for the analyzer.
+//
+//    stream - A stream of IQ data: "-" for stdin, or the name of a file
+//    or FIFO.
+//
+// The program exits when either stream ends.
+///*************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CrossCorrelator.h"
+#include "X11Renderer.h"
+#include "NullRenderer.h"
+#include "ImageRenderer.h"
+
+// These are the display dimensions in pixels.
+#define DISPLAY_WIDTH (1024)
+#define DISPLAY_HEIGHT (256)
+
+// This structure is used to consolidate user parameters.
+struct MyParameters
+{
+  float *sampleRatePtr;
+  uint32_t *maximumLagPtr;
+  float *integrationTimePtr;
+  uint32_t *numberOfThreadsPtr;
+  bool *unsignedSamplesPtr;
+  char **outputPtr;
+};
+
+/*****************************************************************************
+
+  Name: getUserArguments
+
+  Purpose: The purpose of this function is to retrieve the user arguments
+  that were passed to the program.  Any arguments that are specified are
+  set to reasonable default values.
+
+  Calling Sequence: exitProgram = getUserArguments(parameters)
+
+  Inputs:
+
+    parameters - A structure that contains pointers to the user parameters.
+
+  Outputs:
+
+    exitProgram - A flag that indicates whether or not the program should
+    be exited.  A value of true indicates to exit the program, and a value
+    of false indicates that the program should not be exited..
+
+*****************************************************************************/
+bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
+{
+  bool exitProgram;
+  bool done;
+  int opt;
+
+  // Default not to exit program.
+  exitProgram = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default parameters.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default to 2400000S/s.
+  *parameters.sampleRatePtr = 2400000;
+
+  // Default to 1024 samples either way.
+  *parameters.maximumLagPtr = 1024;
+
+  // Default to ten results a second.
+  *parameters.integrationTimePtr = 0.1;
+
+  // Default to one thread per processor.
+  *parameters.numberOfThreadsPtr = 0;
+
+  // Default to signed IQ samples.
+  *parameters.unsignedSamplesPtr = false;
+
+  // Default to an X window.
+  *parameters.outputPtr = (char *)"x";
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up for loop entry.
+  done = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Retrieve the command line arguments.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  while (!done)
+  {
+    // Retrieve the next option.
+    opt = getopt(argc,argv,"r:L:T:j:UO:h");
+
+    switch (opt)
+    {
+      case 'r':
+      {
+        *parameters.sampleRatePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'L':
+      {
+        *parameters.maximumLagPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'T':
+      {
+        *parameters.integrationTimePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'j':
+      {
+        *parameters.numberOfThreadsPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'U':
+      {
+        *parameters.unsignedSamplesPtr = true;
+        break;
+      } // case
+
+      case 'O':
+      {
+        *parameters.outputPtr = optarg;
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./correlator -r samplerate (S/s)\n"
+                "             -L maximumlag (samples)\n"
+                "             -T integrationtime (s)\n"
+                "             -j threads\n"
+                "             -U (unsigned samples)\n"
+                "             -O [x | null | ppm:directory | pgm:directory]\n"
+                "             firststream secondstream\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (!exitProgram && ((argc - optind) != 2))
+  {
+    fprintf(stderr,"Two streams must be specified\n");
+    exitProgram = true;
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Keep things sane.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if (*parameters.sampleRatePtr <= 0)
+  {
+    *parameters.sampleRatePtr = 2400000;
+  } // if
+
+  if (*parameters.maximumLagPtr == 0)
+  {
+    *parameters.maximumLagPtr = 1024;
+  } // if
+
+  if (*parameters.integrationTimePtr <= 0)
+  {
+    *parameters.integrationTimePtr = 0.1;
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+/*****************************************************************************
+
+  Name: createRenderer
+
+  Purpose: The purpose of this function is to create the renderer that
+  the display is drawn with.
+
+  Calling Sequence: rendererPtr = createRenderer(outputPtr)
+
+  Inputs:
+
+    outputPtr - The output that was specified with the O flag: "x",
+    "null", "ppm:<directory>" or "pgm:<directory>".
+
+  Outputs:
+
+    rendererPtr - A pointer to the renderer, or NULL if the output is
+    not understood.
+
+*****************************************************************************/
+static Renderer *createRenderer(char *outputPtr)
+{
+  Renderer *rendererPtr;
+
+  // Default to not understanding the output.
+  rendererPtr = NULL;
+
+  if (strcmp(outputPtr,"x") == 0)
+  {
+    rendererPtr = new X11Renderer(DISPLAY_WIDTH,DISPLAY_HEIGHT);
+  } // if
+
+  if (strcmp(outputPtr,"null") == 0)
+  {
+    rendererPtr = new NullRenderer();
+  } // if
+
+  if (strncmp(outputPtr,"ppm:",4) == 0)
+  {
+    rendererPtr = new ImageRenderer(DISPLAY_WIDTH,DISPLAY_HEIGHT,
+                                    &outputPtr[4],false);
+  } // if
+
+  if (strncmp(outputPtr,"pgm:",4) == 0)
+  {
+    rendererPtr = new ImageRenderer(DISPLAY_WIDTH,DISPLAY_HEIGHT,
+                                    &outputPtr[4],true);
+  } // if
+
+  return (rendererPtr);
+
+} // createRenderer
+
+/*****************************************************************************
+
+  Name: openStream
+
+  Purpose: The purpose of this function is to open a stream of IQ data.
+
+  Calling Sequence: streamPtr = openStream(namePtr)
+
+  Inputs:
+
+    namePtr - The name of the stream: "-" for stdin, or the name of a
+    file or FIFO.
+
+  Outputs:
+
+    streamPtr - A pointer to the stream, or NULL if it couldn't be
+    opened.
+
+*****************************************************************************/
+static FILE *openStream(const char *namePtr)
+{
+  FILE *streamPtr;
+
+  if (strcmp(namePtr,"-") == 0)
+  {
+    streamPtr = stdin;
+  } // if
+  else
+  {
+    streamPtr = fopen(namePtr,"rb");
+
+    if (streamPtr == NULL)
+    {
+      fprintf(stderr,"Could not open stream %s\n",namePtr);
+    } // if
+  } // else
+
+  return (streamPtr);
+
+} // openStream
+
+/*****************************************************************************
+
+  Name: renderCorrelation
+
+  Purpose: The purpose of this function is to draw the coherence of the
+  latest result at every lag, with zero lag in the center of the
+  display.  When there are more lags than columns, each column shows
+  the largest coherence that it covers.  The peak is marked, and its
+  lag, coherence and phase are shown in the upper left corner.
+
+  Calling Sequence: renderCorrelation(rendererPtr,
+                                      correlatorPtr,
+                                      sampleRate)
+
+  Inputs:
+
+    rendererPtr - A pointer to the renderer.
+
+    correlatorPtr - A pointer to the correlator.
+
+    sampleRate - The sample rate in S/s.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+static void renderCorrelation(Renderer *rendererPtr,
+                              CrossCorrelator *correlatorPtr,
+                              float sampleRate)
+{
+  uint32_t i;
+  uint32_t lag;
+  uint32_t firstLag;
+  uint32_t lastLag;
+  uint32_t numberOfLags;
+  int x;
+  int fontHeight;
+  float coherence;
+  const float *coherencePtr;
+  char textBuffer[80];
+  RenderPoint points[DISPLAY_WIDTH];
+
+  numberOfLags = (2 * correlatorPtr->getMaximumLag()) + 1;
+  coherencePtr = correlatorPtr->getCoherence();
+  fontHeight = rendererPtr->getFontHeight();
+
+  rendererPtr->beginFrame();
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Draw the grid, with a line at every quarter of the
+  // coherence and zero lag in the center.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  rendererPtr->setColor(GridColor);
+
+  for (i = 1; i < 16; i++)
+  {
+    x = (i * DISPLAY_WIDTH) / 16;
+    rendererPtr->drawLine(x,0,x,DISPLAY_HEIGHT);
+  } // for
+
+  for (i = 1; i < 4; i++)
+  {
+    rendererPtr->drawLine(0,
+                          (i * DISPLAY_HEIGHT) / 4,
+                          DISPLAY_WIDTH,
+                          (i * DISPLAY_HEIGHT) / 4);
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Bin the lags to the display width.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < DISPLAY_WIDTH; i++)
+  {
+    firstLag = (uint32_t)(((uint64_t)i * numberOfLags) / DISPLAY_WIDTH);
+    lastLag = (uint32_t)(((uint64_t)(i + 1) * numberOfLags) / DISPLAY_WIDTH);
+
+    if (lastLag <= firstLag)
+    {
+      // There are more columns than lags.
+      lastLag = firstLag + 1;
+    } // if
+
+    coherence = 0;
+
+    for (lag = firstLag; lag < lastLag; lag++)
+    {
+      if (coherencePtr[lag] > coherence)
+      {
+        coherence = coherencePtr[lag];
+      } // if
+    } // for
+
+    if (coherence > 1)
+    {
+      coherence = 1;
+    } // if
+
+    points[i].x = i;
+    points[i].y = (DISPLAY_HEIGHT - 1) -
+                  (int16_t)(coherence * (DISPLAY_HEIGHT - 1));
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Mark the peak, behind the trace.
+  x = (int)(((correlatorPtr->getPeakLag() + correlatorPtr->getMaximumLag() +
+              0.5) * DISPLAY_WIDTH) / numberOfLags);
+
+  rendererPtr->setColor(MaxHoldColor);
+  rendererPtr->drawLine(x,0,x,DISPLAY_HEIGHT);
+
+  rendererPtr->setColor(SignalColor);
+  rendererPtr->drawLines(points,DISPLAY_WIDTH);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Annotate the display.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  rendererPtr->setColor(SignalColor);
+
+  snprintf(textBuffer,sizeof(textBuffer),"Lag: %+.2f samples (%+.3fus)",
+           correlatorPtr->getPeakLag(),
+           (1000000 * correlatorPtr->getPeakLag()) / sampleRate);
+  rendererPtr->drawString(8,fontHeight + 4,textBuffer);
+
+  snprintf(textBuffer,sizeof(textBuffer),
+           "Coherence: %.3f  Phase: %+.1f deg",
+           correlatorPtr->getPeakCoherence(),
+           correlatorPtr->getPeakPhase());
+  rendererPtr->drawString(8,(2 * fontHeight) + 6,textBuffer);
+
+  snprintf(textBuffer,sizeof(textBuffer),"Span: +/-%u samples (+/-%.1fus)",
+           correlatorPtr->getMaximumLag(),
+           (1000000 * correlatorPtr->getMaximumLag()) / sampleRate);
+  rendererPtr->drawString(DISPLAY_WIDTH - 260,fontHeight + 4,textBuffer);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  rendererPtr->endFrame();
+
+  return;
+
+} // renderCorrelation
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool done;
+  bool exitProgram;
+  uint32_t i;
+  uint32_t blockLength;
+  float sampleRate;
+  uint32_t maximumLag;
+  float integrationTime;
+  uint32_t numberOfThreads;
+  bool unsignedSamples;
+  char *output;
+  FILE *firstStreamPtr;
+  FILE *secondStreamPtr;
+  int8_t *firstBufferPtr;
+  int8_t *secondBufferPtr;
+  Renderer *rendererPtr;
+  CrossCorrelator *correlatorPtr;
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.sampleRatePtr = &sampleRate;
+  parameters.maximumLagPtr = &maximumLag;
+  parameters.integrationTimePtr = &integrationTime;
+  parameters.numberOfThreadsPtr = &numberOfThreads;
+  parameters.unsignedSamplesPtr = &unsignedSamples;
+  parameters.outputPtr = &output;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  firstStreamPtr = openStream(argv[optind]);
+  secondStreamPtr = openStream(argv[optind + 1]);
+
+  if ((firstStreamPtr == NULL) || (secondStreamPtr == NULL))
+  {
+    return (1);
+  } // if
+
+  // Instantiate the renderer.
+  rendererPtr = createRenderer(output);
+
+  if (rendererPtr == NULL)
+  {
+    fprintf(stderr,"Unknown output: %s\n",output);
+    return (1);
+  } // if
+
+  rendererPtr->setTitle("Cross-Correlation");
+
+  // This starts the correlation threads.
+  correlatorPtr = new CrossCorrelator(maximumLag,
+                                      (uint32_t)(integrationTime * sampleRate),
+                                      numberOfThreads);
+
+  blockLength = correlatorPtr->getBlockLength();
+
+  fprintf(stderr,"%u lags, %u samples per block\n",
+          (2 * maximumLag) + 1,blockLength);
+
+  firstBufferPtr = new int8_t[2 * blockLength];
+  secondBufferPtr = new int8_t[2 * blockLength];
+
+  // Set up for loop entry.
+  done = false;
+
+  while (!done)
+  {
+    // Read a block of each stream.
+    if ((fread(firstBufferPtr,1,2 * blockLength,firstStreamPtr) !=
+         (2 * blockLength)) ||
+        (fread(secondBufferPtr,1,2 * blockLength,secondStreamPtr) !=
+         (2 * blockLength)))
+    {
+      // We're done.
+      done = true;
+    } // if
+    else
+    {
+      if (unsignedSamples)
+      {
+        for (i = 0; i < (2 * blockLength); i++)
+        {
+          // Convert unsigned samples to signed quantities.
+          firstBufferPtr[i] -= 128;
+          secondBufferPtr[i] -= 128;
+        } // for
+      } // if
+
+      if (correlatorPtr->acceptSamples(firstBufferPtr,secondBufferPtr))
+      {
+        fprintf(stdout,"%.3f,%.4f,%.4f,%.1f\n",
+                correlatorPtr->getPeakLag(),
+                (1000000 * correlatorPtr->getPeakLag()) / sampleRate,
+                correlatorPtr->getPeakCoherence(),
+                correlatorPtr->getPeakPhase());
+        fflush(stdout);
+
+        renderCorrelation(rendererPtr,correlatorPtr,sampleRate);
+
+        // Keystrokes aren't used, but the window needs its events read.
+        while (rendererPtr->getKeystroke() != 0)
+        {
+        } // while
+      } // if
+    } // else
+  } // while
+
+  // Release resources.
+  delete correlatorPtr;
+  delete rendererPtr;
+  delete[] firstBufferPtr;
+  delete[] secondBufferPtr;
+
+  if (firstStreamPtr != stdin)
+  {
+    fclose(firstStreamPtr);
+  } // if
+
+  if (secondStreamPtr != stdin)
+  {
+    fclose(secondStreamPtr);
+  } // if
+
+  return (0);
+
+} // main
@@ -0,0 +1,344 @@
+//*************************************************************************
+// File name: fftBenchmark.cc
+//*************************************************************************
+
+//*************************************************************************
+// This program compares the 16-bit fixed-point FFT with the FFTW double
+// precision FFT that is used by the signal analyzer.  A test signal (a
+// tone plus noise) is quantized to 8-bit IQ samples, both engines
+// transform it, and the signal to noise ratio of the fixed-point result,
+// relative to the FFTW result, is reported along with the time that each
+// engine takes per FFT.  The time includes windowing and the power
+// computation, since that's what the analyzer pays.
+//
+// To run this program type,
+//
+//     ./fftBenchmark -n <iterations> -a <amplitude>
+//
+// where,
+//
+//    iterations - The number of FFT's to time for each engine.
+//
+//    amplitude - The amplitude of the test tone in 8-bit units.  The
+//    noise has an RMS value of about 3 units.
+///*************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <fftw3.h>
+
+#include "FixedPointFft.h"
+
+// This provides N, so the FFT size is the one that the analyzer uses.
+#include "FftSize.h"
+
+// This structure is used to consolidate user parameters.
+struct MyParameters
+{
+  uint32_t *iterationsPtr;
+  float *amplitudePtr;
+};
+
+/*****************************************************************************
+
+  Name: getUserArguments
+
+  Purpose: The purpose of this function is to retrieve the user arguments
+  that were passed to the program.  Any arguments that are specified are
+  set to reasonable default values.
+
+  Calling Sequence: exitProgram = getUserArguments(parameters)
+
+  Inputs:
+
+    parameters - A structure that contains pointers to the user parameters.
+
+  Outputs:
+
+    exitProgram - A flag that indicates whether or not the program should
+    be exited.  A value of true indicates to exit the program, and a value
+    of false indicates that the program should not be exited..
+
+*****************************************************************************/
+bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
+{
+  bool exitProgram;
+  bool done;
+  int opt;
+
+  // Default not to exit program.
+  exitProgram = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default parameters.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default to 2000 FFT's per engine.
+  *parameters.iterationsPtr = 2000;
+
+  // Default to a strong tone.
+  *parameters.amplitudePtr = 100;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up for loop entry.
+  done = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Retrieve the command line arguments.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  while (!done)
+  {
+    // Retrieve the next option.
+    opt = getopt(argc,argv,"n:a:h");
+
+    switch (opt)
+    {
+      case 'n':
+      {
+        *parameters.iterationsPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'a':
+      {
+        *parameters.amplitudePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./fftBenchmark -n iterations "
+                "-a toneamplitude\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+/*****************************************************************************
+
+  Name: getTimeInSeconds
+
+  Purpose: The purpose of this function is to read the monotonic clock.
+
+  Calling Sequence: now = getTimeInSeconds()
+
+  Inputs:
+
+    None.
+
+  Outputs:
+
+    now - The current time in seconds.
+
+*****************************************************************************/
+static double getTimeInSeconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC,&now);
+
+  return (now.tv_sec + (now.tv_nsec / 1e9));
+
+} // getTimeInSeconds
+
+/*****************************************************************************
+
+  Name: clip
+
+  Purpose: The purpose of this function is to quantize a value to an
+  8-bit sample.
+
+  Calling Sequence: sample = clip(value)
+
+  Inputs:
+
+    value - The value to quantize.
+
+  Outputs:
+
+    sample - The quantized value.
+
+*****************************************************************************/
+static int8_t clip(double value)
+{
+
+  value = floor(value + 0.5);
+
+  if (value > 127)
+  {
+    value = 127;
+  } // if
+  else
+  {
+    if (value < -128)
+    {
+      value = -128;
+    } // if
+  } // else
+
+  return ((int8_t)value);
+
+} // clip
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool exitProgram;
+  uint32_t i;
+  uint32_t iteration;
+  uint32_t iterations;
+  float amplitude;
+  int8_t signalBuffer[2 * N];
+  double hanningWindow[N];
+  double fixedSpectrum[2 * N];
+  float powerBuffer[N];
+  double signalEnergy;
+  double errorEnergy;
+  double iError;
+  double qError;
+  double startTime;
+  double fftwTime;
+  double fixedTime;
+  fftw_complex *fftInputPtr;
+  fftw_complex *fftOutputPtr;
+  fftw_plan fftPlan;
+  FixedPointFft *fixedPointFftPtr;
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.iterationsPtr = &iterations;
+  parameters.amplitudePtr = &amplitude;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Construct a tone plus noise test signal.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  srand48(1);
+
+  for (i = 0; i < N; i++)
+  {
+    signalBuffer[2*i] = clip(amplitude * cos(2 * M_PI * 0.1234 * i) +
+                             (6 * (drand48() - 0.5) * 1.73));
+
+    signalBuffer[(2*i)+1] = clip(amplitude * sin(2 * M_PI * 0.1234 * i) +
+                                 (6 * (drand48() - 0.5) * 1.73));
+
+    hanningWindow[i] = 0.5 - 0.5 * cos((2 * M_PI * i)/N);
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up both engines.
+  fftInputPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*N);
+  fftOutputPtr = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*N);
+  fftPlan = fftw_plan_dft_1d(N,fftInputPtr,fftOutputPtr,
+                             FFTW_FORWARD,FFTW_ESTIMATE);
+
+  fixedPointFftPtr = new FixedPointFft(N);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Time FFTW the way the signal analyzer uses it.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  startTime = getTimeInSeconds();
+
+  for (iteration = 0; iteration < iterations; iteration++)
+  {
+    for (i = 0; i < N; i++)
+    {
+      fftInputPtr[i][0] = (double)signalBuffer[2*i] * hanningWindow[i];
+      fftInputPtr[i][1] = (double)signalBuffer[(2*i)+1] * hanningWindow[i];
+    } // for
+
+    fftw_execute(fftPlan);
+
+    for (i = 0; i < N; i++)
+    {
+      // Flipping the top bit swaps the halves, just like fftShiftTable[].
+      powerBuffer[i ^ (N/2)] = (float)(((fftOutputPtr[i][0] *
+                                         fftOutputPtr[i][0]) +
+                                        (fftOutputPtr[i][1] *
+                                         fftOutputPtr[i][1])) / N);
+    } // for
+  } // for
+
+  fftwTime = (getTimeInSeconds() - startTime) / iterations;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Time the fixed-point FFT.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  startTime = getTimeInSeconds();
+
+  for (iteration = 0; iteration < iterations; iteration++)
+  {
+    fixedPointFftPtr->computePowerSpectrum(signalBuffer,2 * N,powerBuffer);
+  } // for
+
+  fixedTime = (getTimeInSeconds() - startTime) / iterations;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Measure the accuracy of the fixed-point result.  The
+  // FFTW output of the last iteration is the reference.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  fixedPointFftPtr->transform(signalBuffer,2 * N);
+  fixedPointFftPtr->getComplexSpectrum(fixedSpectrum);
+
+  signalEnergy = 0;
+  errorEnergy = 0;
+
+  for (i = 0; i < N; i++)
+  {
+    iError = fixedSpectrum[2*i] - fftOutputPtr[i][0];
+    qError = fixedSpectrum[(2*i)+1] - fftOutputPtr[i][1];
+
+    signalEnergy += (fftOutputPtr[i][0] * fftOutputPtr[i][0]) +
+                    (fftOutputPtr[i][1] * fftOutputPtr[i][1]);
+
+    errorEnergy += (iError * iError) + (qError * qError);
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  fprintf(stdout,"FFTW (double):       %8.1f us/FFT\n",fftwTime * 1e6);
+  fprintf(stdout,"Fixed-point (int16): %8.1f us/FFT\n",fixedTime * 1e6);
+  fprintf(stdout,"Speedup:             %8.2f\n",fftwTime / fixedTime);
+  fprintf(stdout,"SNR relative to FFTW: %.1f dB\n",
+          10 * log10(signalEnergy / errorEnergy));
+
+  // Release resources.
+  delete fixedPointFftPtr;
+  fftw_destroy_plan(fftPlan);
+  fftw_free(fftInputPtr);
+  fftw_free(fftOutputPtr);
+
+  return (0);
+
+} // main
@@ -15,30 +15,177 @@
 //
 // To run this program type,
 // 
-//     ./fileThrottler > -b blockSize -d <delayTime>
+//     ./fileThrottler > -b blockSize -d <delayTime> -m <markerPeriod>
+//                       -x -z -s <startTime> -r <sampleRate>
+//                       -S <ringName> -k <ringSize>
 //
 // where,
 //
 //    blockSize - The number of bytes in each block that is read.
 //
 //    delayTime - Delay time, in microseconds, between reads from stdin.
+//
+//    markerPeriod - Every markerPeriod'th block is replaced by a latency
+//    marker, a block that carries the time that it was written, so that
+//    the analyzer (with its L flag) can measure how long the block took
+//    to reach the display.  Leave the block size at 16384 so that the
+//    markers line up with the blocks that the analyzer reads.  The
+//    default, 0, sends no markers.
+//
+//    The x flag indicates that the input is compressed IQ data, as
+//    written by the analyzer with its D and z flags.  The output is
+//    plain IQ data.
+//
+//    The z flag indicates that the output is to be compressed.  With
+//    the x flag too, this cuts a piece out of a compressed capture
+//    (see startTime).
+//
+//    startTime - The time, in seconds from the start of the input, at
+//    which to start.  Compressed files use their block index, so only
+//    one block is decoded to get there, and plain files seek straight
+//    to it.  Pipes are read up to that point.
+//
+//    sampleRate - The sample rate of the IQ data in S/s, so that the
+//    start time can be turned into an offset.  The default is
+//    256000S/s.
+//
+//    ringName - The name of a shared memory ring to write the IQ data
+//    into, instead of stdout.  Any number of analyzers (up to 8, with
+//    their i flag) can read the ring at once, without the data being
+//    copied through a pipe.  The data is read from the input straight
+//    into the ring.  The output is never compressed.
+//
+//    ringSize - The size of the ring in KiB.  An analyzer that falls
+//    this far behind loses data.  The default is 4096KiB.
 ///*************************************************************************
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#include "LatencyMonitor.h"
+#include "IqCompressor.h"
+#include "IqDecompressor.h"
+#include "SharedRing.h"
+
 #define MAX_BLOCK_SIZE (65536)
 #define DEFAULT_BLOCK_SIZE (16384)
 #define DEFAULT_DELAY (32000)
+#define DEFAULT_RING_SIZE (4096)
 
 // This structure is used to consolidate user parameters.
 struct MyParameters
 {
   uint32_t *blockSizePtr;
   uint32_t *delayPtr;
+  uint32_t *markerPeriodPtr;
+  bool *compressedInputPtr;
+  bool *compressedOutputPtr;
+  float *startTimePtr;
+  float *sampleRatePtr;
+  char **ringNamePtr;
+  uint32_t *ringSizePtr;
 };
 
+/*****************************************************************************
+
+  Name: readInput
+
+  Purpose: The purpose of this function is to read IQ data from stdin,
+  decompressing it if need be.
+
+  Calling Sequence: count = readInput(decompressorPtr,bufferPtr,length)
+
+  Inputs:
+
+    decompressorPtr - A pointer to the decompressor, or NULL if the input
+    is plain IQ data.
+
+    bufferPtr - A pointer to storage for the IQ data.
+
+    length - The number of bytes to read.
+
+  Outputs:
+
+    count - The number of bytes that were read.  A value of 0 indicates
+    the end of the input.
+
+*****************************************************************************/
+static uint32_t readInput(IqDecompressor *decompressorPtr,
+                          int8_t *bufferPtr,
+                          uint32_t length)
+{
+  uint32_t count;
+
+  if (decompressorPtr != NULL)
+  {
+    count = decompressorPtr->readSamples(bufferPtr,length);
+  } // if
+  else
+  {
+    count = fread(bufferPtr,1,length,stdin);
+  } // else
+
+  return (count);
+
+} // readInput
+
+/*****************************************************************************
+
+  Name: skipInput
+
+  Purpose: The purpose of this function is to move to an offset in the
+  input.  Seeking is tried first, and if the input can't seek, it is
+  read and thrown away up to the offset.
+
+  Calling Sequence: skipInput(decompressorPtr,offset)
+
+  Inputs:
+
+    decompressorPtr - A pointer to the decompressor, or NULL if the input
+    is plain IQ data.
+
+    offset - The offset in bytes of IQ data.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+static void skipInput(IqDecompressor *decompressorPtr,uint64_t offset)
+{
+  bool done;
+  uint32_t count;
+  int8_t buffer[MAX_BLOCK_SIZE];
+
+  if (decompressorPtr != NULL)
+  {
+    done = decompressorPtr->seek(offset);
+  } // if
+  else
+  {
+    done = (fseeko(stdin,(off_t)offset,SEEK_SET) == 0);
+  } // else
+
+  while (!done && (offset > 0))
+  {
+    count = readInput(decompressorPtr,buffer,
+                      (offset > MAX_BLOCK_SIZE) ?
+                      MAX_BLOCK_SIZE : (uint32_t)offset);
+
+    if (count == 0)
+    {
+      // The input ended first.
+      done = true;
+    } // if
+
+    offset -= count;
+  } // while
+
+  return;
+
+} // skipInput
+
 /*****************************************************************************
 
   Name: getUserArguments
@@ -77,6 +224,25 @@ bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
 
   // Default to 32ms (delay in microseconds).
   *parameters.delayPtr = DEFAULT_DELAY;
+
+  // Default to no latency markers.
+  *parameters.markerPeriodPtr = 0;
+
+  // Default to plain IQ data in and out.
+  *parameters.compressedInputPtr = false;
+  *parameters.compressedOutputPtr = false;
+
+  // Default to the start of the input.
+  *parameters.startTimePtr = 0;
+
+  // Default to 256000S/s.
+  *parameters.sampleRatePtr = 256000;
+
+  // Default to writing to stdout.
+  *parameters.ringNamePtr = NULL;
+
+  // Default to a 4MiB ring.
+  *parameters.ringSizePtr = DEFAULT_RING_SIZE;
   //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
 
   // Set up for loop entry.
@@ -88,7 +254,7 @@ bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
   while (!done)
   {
     // Retrieve the next option.
-    opt = getopt(argc,argv,"b:d:h");
+    opt = getopt(argc,argv,"b:d:m:xzs:r:S:k:h");
 
     switch (opt)
     {
@@ -110,11 +276,65 @@ bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
         break;
       } // case
 
+      case 'm':
+      {
+        *parameters.markerPeriodPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'x':
+      {
+        *parameters.compressedInputPtr = true;
+        break;
+      } // case
+
+      case 'z':
+      {
+        *parameters.compressedOutputPtr = true;
+        break;
+      } // case
+
+      case 's':
+      {
+        *parameters.startTimePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'r':
+      {
+        *parameters.sampleRatePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'S':
+      {
+        *parameters.ringNamePtr = optarg;
+        break;
+      } // case
+
+      case 'k':
+      {
+        *parameters.ringSizePtr = atol(optarg);
+
+        if (*parameters.ringSizePtr < (MAX_BLOCK_SIZE / 1024))
+        {
+          // A block has to fit.
+          *parameters.ringSizePtr = MAX_BLOCK_SIZE / 1024;
+        } // if
+        break;
+      } // case
+
       case 'h':
       {
         // Display usage.
         fprintf(stderr,"./fileThrottler -b blockSizeInBytes "
-                "-d delayTimeInMicrosedonds\n");
+                "-d delayTimeInMicrosedonds "
+                "-m markerPeriodInBlocks\n"
+                "                -x (compressed input) "
+                "-z (compressed output)\n"
+                "                -s startTimeInSeconds "
+                "-r sampleRate (S/s)\n"
+                "                -S ringName -k ringSizeInKiB\n");
 
         // Indicate that program must be exited.
         exitProgram = true;
@@ -143,15 +363,33 @@ int main(int argc,char **argv)
   bool done;
   bool exitProgram;
   uint32_t count;
-  int status;
   int8_t inputBuffer[MAX_BLOCK_SIZE];
   uint32_t blockSize;
   uint32_t delay;
+  uint32_t markerPeriod;
+  uint32_t blocksSinceMarker;
+  bool compressedInput;
+  bool compressedOutput;
+  float startTime;
+  float sampleRate;
+  char *ringName;
+  uint32_t ringSize;
+  int8_t *bufferPtr;
+  SharedRing *ringPtr;
+  IqDecompressor *decompressorPtr;
+  IqCompressor *compressorPtr;
   struct MyParameters parameters;
 
   // Set up for parameter transmission.
   parameters.blockSizePtr = &blockSize;
   parameters.delayPtr = &delay;
+  parameters.markerPeriodPtr = &markerPeriod;
+  parameters.compressedInputPtr = &compressedInput;
+  parameters.compressedOutputPtr = &compressedOutput;
+  parameters.startTimePtr = &startTime;
+  parameters.sampleRatePtr = &sampleRate;
+  parameters.ringNamePtr = &ringName;
+  parameters.ringSizePtr = &ringSize;
 
   // Retrieve the system parameters.
   exitProgram = getUserArguments(argc,argv,parameters);
@@ -162,13 +400,61 @@ int main(int argc,char **argv)
     return (0);
   } // if
 
+  decompressorPtr = NULL;
+  compressorPtr = NULL;
+
+  if (compressedInput)
+  {
+    decompressorPtr = new IqDecompressor(stdin);
+
+    if (!decompressorPtr->isValid())
+    {
+      delete decompressorPtr;
+      return (1);
+    } // if
+  } // if
+
+  if (startTime > 0)
+  {
+    // Start on an I value.
+    skipInput(decompressorPtr,2 * (uint64_t)(startTime * sampleRate));
+  } // if
+
+  // Default to stdout.
+  ringPtr = NULL;
+
+  if (ringName != NULL)
+  {
+    ringPtr = new SharedRing(ringName,ringSize * 1024);
+
+    if (!ringPtr->isValid())
+    {
+      delete ringPtr;
+      delete decompressorPtr;
+      return (1);
+    } // if
+  } // if
+  else
+  {
+    if (compressedOutput)
+    {
+      compressorPtr = new IqCompressor(stdout,0);
+    } // if
+  } // else
+
+  // The first block is a marker.
+  blocksSinceMarker = markerPeriod;
+
   // Set up for loop entry.
   done = false;
 
   while (!done)
   {
+    // Read straight into the ring if there is one.
+    bufferPtr = (ringPtr != NULL) ? ringPtr->reserve(blockSize) : inputBuffer;
+
     // Read a block of input samples (2 * complex FFT length).
-    count = fread(inputBuffer,1,blockSize,stdin);
+    count = readInput(decompressorPtr,bufferPtr,blockSize);
 
     if (count == 0)
     {
@@ -177,15 +463,63 @@ int main(int argc,char **argv)
     } // if
     else
     {
-      // Write to stdout to pipe to another program.
-      fwrite(inputBuffer,1,blockSize,stdout);
+      if (markerPeriod > 0)
+      {
+        if (blocksSinceMarker >= markerPeriod)
+        {
+          // Stamp the block as late as possible.
+          LatencyMonitor::writeMarker(bufferPtr,
+                                      count,
+                                      LatencyMonitor::getTimeInNs());
+
+          blocksSinceMarker = 0;
+        } // if
+
+        blocksSinceMarker++;
+      } // if
+
+      if (ringPtr != NULL)
+      {
+        // This is all it takes for the analyzers to see the block.
+        ringPtr->commit(count);
+      } // if
+      else
+      {
+        if (compressorPtr != NULL)
+        {
+          compressorPtr->acceptSamples(inputBuffer,count);
+        } // if
+        else
+        {
+          // Write to stdout to pipe to another program.
+          fwrite(inputBuffer,1,count,stdout);
+        } // else
+      } // else
 
       // Throttle the output.
-      status = usleep(delay);
+      usleep(delay);
     } // else
 
   } // while
 
+  // Release resources.
+  if (ringPtr != NULL)
+  {
+    // This tells the analyzers that there is no more.
+    delete ringPtr;
+  } // if
+
+  if (compressorPtr != NULL)
+  {
+    // This finishes the compressed stream.
+    delete compressorPtr;
+  } // if
+
+  if (decompressorPtr != NULL)
+  {
+    delete decompressorPtr;
+  } // if
+
   return (0);
 
 } // main
@@ -0,0 +1,543 @@
+//*************************************************************************
+// File name: multiAnalyzer.cc
+//*************************************************************************
+
+//*************************************************************************
+// This program analyzes several streams of IQ data at once, in one
+// process, and shows their displays as tiles, one above the other, in
+// one window.  The streams can be FIFOs, files, TCP connections (such
+// as rtl_tcp) or stdin.  One thread waits on all of the streams with
+// epoll, and a pool of threads runs the blocks through the analyzers,
+// which share their FFT tables.  This costs much less than running an
+// analyzer per stream.  The data is 8-bit signed 2's complement, and is
+// formatted as I1,Q1; I2,Q2; ...
+//
+// To run this program type,
+// 
+//    ./multiAnalyzer -d <displaytype> -r <sampleRate> -V <verticalgain>
+//              -R <referenceLevel> -U -F <framesPerSecond>
+//              -G <frameAggregation> -O <output> -w <threads>
+//              stream1 stream2 ...
+//
+// where,
+//
+//    displayType - The type of display.  Valid values are;
+//    1 - Magnitude display.
+//    2 - Power spectrum display.
+//    3 - Lissajous display.
+//    The default is 2.
+//
+//    The R flag sets the reference level on the spectrum analyzer
+//    display.
+//
+//    The V flag sets the vertical gain of the signal to be displayed on
+//    the spectrum analyzer display.
+//
+//    The U flag indicates that the IQ samples are unsigned 8-bit
+//    quantities rather than the default signed values.
+//
+//    The F flag sets the display frame rate.  The default is 30
+//    frames/s.
+//
+//    The G flag selects how power spectra are combined between frames:
+//    1 - average, 2 - peak hold.  The default is 1.
+//
+//    The O flag selects where the display is drawn: x (the default),
+//    null, ppm:<directory> or pgm:<directory>, as for the analyzer.
+//
+//    The w flag sets the number of processing threads.  The default, 0,
+//    uses one thread per processor.
+//
+//    sampleRate - The sample rate of the IQ data in S/s.  Every stream
+//    has the same sample rate and options.
+//
+//    stream - A stream of IQ data: "-" for stdin, host:port for a TCP
+//    connection, or the name of a file or FIFO.  A FIFO is read once a
+//    writer shows up.  Up to 8 streams can be analyzed.
+//
+// Keystrokes go to the tile whose name is marked with '>', and the Tab
+// key moves the mark to the next tile.  The program exits once every
+// stream has ended.
+///*************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SignalAnalyzer.h"
+#include "SpectrumTables.h"
+#include "StreamDispatcher.h"
+#include "DisplayGovernor.h"
+#include "TileRenderer.h"
+#include "X11Renderer.h"
+#include "NullRenderer.h"
+#include "ImageRenderer.h"
+
+// The longest time, in milliseconds, to wait for data between frames.
+#define DISPATCH_TIMEOUT (5)
+
+// This structure is used to consolidate user parameters.
+struct MyParameters
+{
+  int *displayTypePtr;
+  float *sampleRatePtr;
+  float *verticalGainPtr;
+  int32_t *spectrumReferenceLevelPtr;
+  bool *unsignedSamplesPtr;
+  float *framesPerSecondPtr;
+  int *frameAggregationPtr;
+  char **outputPtr;
+  uint32_t *numberOfThreadsPtr;
+};
+
+/*****************************************************************************
+
+  Name: getUserArguments
+
+  Purpose: The purpose of this function is to retrieve the user arguments
+  that were passed to the program.  Any arguments that are specified are
+  set to reasonable default values.
+
+  Calling Sequence: exitProgram = getUserArguments(parameters)
+
+  Inputs:
+
+    parameters - A structure that contains pointers to the user parameters.
+
+  Outputs:
+
+    exitProgram - A flag that indicates whether or not the program should
+    be exited.  A value of true indicates to exit the program, and a value
+    of false indicates that the program should not be exited..
+
+*****************************************************************************/
+bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
+{
+  bool exitProgram;
+  bool done;
+  int opt;
+
+  // Default not to exit program.
+  exitProgram = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default parameters.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default spectrum display.
+  *parameters.displayTypePtr = PowerSpectrum;
+
+  // Default to 256000S/s.
+  *parameters.sampleRatePtr = 256000;
+
+  // Default to no amplification.
+  *parameters.verticalGainPtr = 1;
+
+  // Default to 0dB reference level.
+  *parameters.spectrumReferenceLevelPtr = 0;
+
+  // Default to signed IQ samples.
+  *parameters.unsignedSamplesPtr = false;
+
+  // Default to 30 frames/s.
+  *parameters.framesPerSecondPtr = 30;
+
+  // Default to averaging spectra between frames.
+  *parameters.frameAggregationPtr = AverageFrames;
+
+  // Default to an X window.
+  *parameters.outputPtr = (char *)"x";
+
+  // Default to one thread per processor.
+  *parameters.numberOfThreadsPtr = 0;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up for loop entry.
+  done = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Retrieve the command line arguments.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  while (!done)
+  {
+    // Retrieve the next option.
+    opt = getopt(argc,argv,"d:r:V:R:UF:G:O:w:h");
+
+    switch (opt)
+    {
+      case 'd':
+      {
+        *parameters.displayTypePtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'r':
+      {
+        *parameters.sampleRatePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'V':
+      {
+        *parameters.verticalGainPtr = atof(optarg);
+        break;
+      } // case
+
+      case 'R':
+      {
+        *parameters.spectrumReferenceLevelPtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'U':
+      {
+        *parameters.unsignedSamplesPtr = true;
+        break;
+      } // case
+
+      case 'F':
+      {
+        *parameters.framesPerSecondPtr = atof(optarg);
+        break;
+      } // case
+
+      case 'G':
+      {
+        *parameters.frameAggregationPtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'O':
+      {
+        *parameters.outputPtr = optarg;
+        break;
+      } // case
+
+      case 'w':
+      {
+        *parameters.numberOfThreadsPtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./multiAnalyzer -d [1 - magnitude | 2 - spectrum |"
+                " 3 - lissajous]\n"
+                "           -r samplerate (S/s) \n"
+                "           -R spectrumreferencelevel (dB)\n"
+                "           -V Vertical gain of signal to display\n"
+                "           -U (unsigned samples)\n"
+                "           -F framespersecond\n"
+                "           -G [1 - average | 2 - peak hold] between frames\n"
+                "           -O [x | null | ppm:directory | pgm:directory]\n"
+                "           -w threads (0 - one per processor)\n"
+                "           stream1 stream2 ... (- | host:port | file)\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+/*****************************************************************************
+
+  Name: createRenderer
+
+  Purpose: The purpose of this function is to create the renderer that
+  the whole display is drawn with.
+
+  Calling Sequence: rendererPtr = createRenderer(outputPtr,height)
+
+  Inputs:
+
+    outputPtr - The output that was specified with the O flag: "x",
+    "null", "ppm:<directory>" or "pgm:<directory>".
+
+    height - The height of the display in pixels.
+
+  Outputs:
+
+    rendererPtr - A pointer to the renderer, or NULL if the output is
+    not understood.
+
+*****************************************************************************/
+static Renderer *createRenderer(char *outputPtr,int height)
+{
+  Renderer *rendererPtr;
+
+  // Default to not understanding the output.
+  rendererPtr = NULL;
+
+  if (strcmp(outputPtr,"x") == 0)
+  {
+    rendererPtr = new X11Renderer(DISPLAY_WIDTH,height);
+  } // if
+
+  if (strcmp(outputPtr,"null") == 0)
+  {
+    rendererPtr = new NullRenderer();
+  } // if
+
+  if (strncmp(outputPtr,"ppm:",4) == 0)
+  {
+    rendererPtr = new ImageRenderer(DISPLAY_WIDTH,height,
+                                    &outputPtr[4],false);
+  } // if
+
+  if (strncmp(outputPtr,"pgm:",4) == 0)
+  {
+    rendererPtr = new ImageRenderer(DISPLAY_WIDTH,height,
+                                    &outputPtr[4],true);
+  } // if
+
+  return (rendererPtr);
+
+} // createRenderer
+
+/*****************************************************************************
+
+  Name: renderTiles
+
+  Purpose: The purpose of this function is to render a frame of the
+  whole display.  Each analyzer draws everything that has accumulated
+  since the last frame into its tile, the name of each stream is drawn
+  in the lower left corner of its tile, and then the frame is sent to
+  the display.
+
+  Calling Sequence: renderTiles(rendererPtr,
+                                tilesPtr,
+                                dispatcherPtr,
+                                focus)
+
+  Inputs:
+
+    rendererPtr - A pointer to the renderer of the whole display.
+
+    tilesPtr - A pointer to the tile of each stream.
+
+    dispatcherPtr - A pointer to the dispatcher of the streams.
+
+    focus - The index of the tile that gets the keystrokes.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+static void renderTiles(Renderer *rendererPtr,
+                        TileRenderer **tilesPtr,
+                        StreamDispatcher *dispatcherPtr,
+                        uint32_t focus)
+{
+  uint32_t i;
+  int fontHeight;
+  char label[80];
+
+  fontHeight = rendererPtr->getFontHeight();
+
+  for (i = 0; i < dispatcherPtr->getNumberOfStreams(); i++)
+  {
+    dispatcherPtr->renderStream(i);
+
+    snprintf(label,sizeof(label),"%c %s",
+             (i == focus) ? '>' : ' ',
+             dispatcherPtr->getStreamName(i));
+
+    // A tile that wasn't redrawn still has its old label.
+    tilesPtr[i]->clearArea(0,
+                           DISPLAY_HEIGHT - fontHeight - 6,
+                           DISPLAY_WIDTH / 2,
+                           fontHeight + 6);
+
+    tilesPtr[i]->setColor(SignalColor);
+    tilesPtr[i]->drawString(8,DISPLAY_HEIGHT - 4,label);
+  } // for
+
+  rendererPtr->endFrame();
+
+  return;
+
+} // renderTiles
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool exitProgram;
+  bool active;
+  uint32_t i;
+  uint32_t numberOfStreams;
+  uint32_t focus;
+  int key;
+  int displayType;
+  float sampleRate;
+  float verticalGain;
+  int32_t spectrumReferenceLevel;
+  bool unsignedSamples;
+  float framesPerSecond;
+  int frameAggregation;
+  char *output;
+  uint32_t numberOfThreads;
+  char title[80];
+  Renderer *rendererPtr;
+  SpectrumTables *tablesPtr;
+  StreamDispatcher *dispatcherPtr;
+  DisplayGovernor *governorPtr;
+  TileRenderer *tilesPtr[MAX_STREAMS];
+  SignalAnalyzer *analyzersPtr[MAX_STREAMS];
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.displayTypePtr = &displayType;
+  parameters.sampleRatePtr = &sampleRate;
+  parameters.verticalGainPtr = &verticalGain;
+  parameters.spectrumReferenceLevelPtr = &spectrumReferenceLevel;
+  parameters.unsignedSamplesPtr = &unsignedSamples;
+  parameters.framesPerSecondPtr = &framesPerSecond;
+  parameters.frameAggregationPtr = &frameAggregation;
+  parameters.outputPtr = &output;
+  parameters.numberOfThreadsPtr = &numberOfThreads;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  if ((argc - optind) == 0)
+  {
+    fprintf(stderr,"At least one stream is needed\n");
+    return (1);
+  } // if
+
+  // This starts the processing threads.
+  dispatcherPtr = new StreamDispatcher(numberOfThreads,unsignedSamples);
+
+  for (i = optind; i < (uint32_t)argc; i++)
+  {
+    // A stream that can't be opened is reported and left out.
+    dispatcherPtr->addStream(argv[i]);
+  } // for
+
+  numberOfStreams = dispatcherPtr->getNumberOfStreams();
+
+  if (numberOfStreams == 0)
+  {
+    delete dispatcherPtr;
+    return (1);
+  } // if
+
+  // The tiles are stacked, one above the other.
+  rendererPtr = createRenderer(output,DISPLAY_HEIGHT * numberOfStreams);
+
+  if (rendererPtr == NULL)
+  {
+    fprintf(stderr,"Unknown output: %s\n",output);
+    delete dispatcherPtr;
+    return (1);
+  } // if
+
+  // Every analyzer uses these.
+  tablesPtr = new SpectrumTables(N,HanningWindow);
+
+  for (i = 0; i < numberOfStreams; i++)
+  {
+    tilesPtr[i] = new TileRenderer(rendererPtr,
+                                   0,
+                                   DISPLAY_HEIGHT * i,
+                                   DISPLAY_WIDTH,
+                                   DISPLAY_HEIGHT);
+
+    analyzersPtr[i] = new SignalAnalyzer(tilesPtr[i],
+                                         (DisplayType)displayType,
+                                         sampleRate,
+                                         verticalGain,
+                                         spectrumReferenceLevel,
+                                         (FrameAggregation)frameAggregation,
+                                         tablesPtr);
+
+    dispatcherPtr->setAnalyzer(i,analyzersPtr[i]);
+  } // for
+
+  snprintf(title,sizeof(title),"Signal Analyzer - %u streams",
+           numberOfStreams);
+  rendererPtr->setTitle(title);
+
+  // Start with an empty display.
+  rendererPtr->beginFrame();
+
+  // Instantiate the display governor.
+  governorPtr = new DisplayGovernor(framesPerSecond,sampleRate,false);
+
+  // Keystrokes go to the first tile.
+  focus = 0;
+
+  // Set up for loop entry.
+  active = true;
+
+  while (active)
+  {
+    // Read whatever is ready, and queue it for the analyzers.
+    active = dispatcherPtr->dispatch(DISPATCH_TIMEOUT);
+
+    // Hand each keystroke to the tile that has the focus.
+    for (key = rendererPtr->getKeystroke();
+         key != 0;
+         key = rendererPtr->getKeystroke())
+    {
+      if (key == '\t')
+      {
+        focus = (focus + 1) % numberOfStreams;
+      } // if
+      else
+      {
+        tilesPtr[focus]->queueKeystroke(key,
+                                        rendererPtr->getPointerPosition());
+      } // else
+    } // for
+
+    if (governorPtr->isFrameDue())
+    {
+      // Display everything that has accumulated since the last frame.
+      renderTiles(rendererPtr,tilesPtr,dispatcherPtr,focus);
+    } // if
+  } // while
+
+  // Show whatever is left over.
+  renderTiles(rendererPtr,tilesPtr,dispatcherPtr,focus);
+
+  // The threads are finished before the analyzers go away.
+  delete dispatcherPtr;
+
+  for (i = 0; i < numberOfStreams; i++)
+  {
+    delete analyzersPtr[i];
+    delete tilesPtr[i];
+  } // for
+
+  // Release resources.
+  delete governorPtr;
+  delete tablesPtr;
+  delete rendererPtr;
+
+  return (0);
+
+} // main
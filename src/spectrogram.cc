@@ -0,0 +1,718 @@
+//*************************************************************************
+// File name: spectrogram.cc
+//*************************************************************************
+
+//*************************************************************************
+// This program turns an entire IQ file into a spectrogram image, with
+// frequency running from left to right and time running from top to
+// bottom.  Each FFT is computed exactly as the signal analyzer computes
+// it (Hanning window, 8192-point FFT, FFT shifted), and each row of the
+// image combines K consecutive FFT's, either by taking the maximum of
+// each bin or by averaging each bin, so a multi-hour capture can be
+// squeezed into a fixed image height.
+//
+// The rows are computed in parallel, one thread per core, a strip at a
+// time, and each strip is written as soon as it is done.  The memory
+// that is used doesn't depend upon the size of the file.  The output is
+// a binary PGM image.
+//
+// To run this program type,
+//
+//     ./spectrogram -i <inputFile> -o <outputFile> -H <height>
+//                   -K <fftsPerRow> -m <rowMode> -w <width>
+//                   -L <lowLevel> -D <dynamicRange> -j <threads> -U
+//
+// where,
+//
+//    inputFile - The IQ file.  The data is 8-bit signed 2's complement
+//    (or unsigned with the U flag), formatted as I1,Q1; I2,Q2; ...
+//
+//    outputFile - The PGM file to write.  A value of "-" writes the image
+//    to stdout.
+//
+//    height - The number of rows in the image.  The number of FFT's per
+//    row is chosen so that the whole file fits.
+//
+//    fftsPerRow - The number of FFT's per row.  This overrides the
+//    height.  The default is 1.
+//
+//    rowMode - How the FFT's of a row are combined: 1 - maximum,
+//    2 - mean.  The default is 2.
+//
+//    width - The number of columns in the image.  Each column shows the
+//    largest bin that it covers.  The default is 1024.
+//
+//    lowLevel - The power, in dB, that maps to black.  The default is 0.
+//
+//    dynamicRange - The range, in dB, from black to white.  The default
+//    is 80.
+//
+//    threads - The number of threads.  The default is the number of
+//    processors.
+//
+//    The U flag indicates that the IQ samples are unsigned 8-bit
+//    quantities, as written by rtl_sdr.
+///*************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "SpectrumEngine.h"
+
+// This provides N, so the FFT size is the one that the analyzer uses.
+#include "FftSize.h"
+
+// The number of rows that each thread computes for each strip.
+#define ROWS_PER_THREAD (16)
+
+// The largest number of threads that will be used.
+#define MAX_THREADS (64)
+
+// These are the ways that the FFT's of a row are combined.
+#define ROW_MAXIMUM (1)
+#define ROW_MEAN (2)
+
+// This structure is used to consolidate user parameters.
+struct MyParameters
+{
+  char **inputFileNamePtr;
+  char **outputFileNamePtr;
+  uint32_t *heightPtr;
+  uint32_t *fftsPerRowPtr;
+  int *rowModePtr;
+  uint32_t *widthPtr;
+  float *lowLevelPtr;
+  float *dynamicRangePtr;
+  uint32_t *numberOfThreadsPtr;
+  bool *unsignedSamplesPtr;
+};
+
+//*************************************************************************
+// This is everything that a worker thread needs.  The engine and the
+// buffers belong to the thread, so the threads share nothing but the
+// input file descriptor (which is only read with pread()) and the strip,
+// of which each thread fills its own rows.
+//*************************************************************************
+struct WorkerContext
+{
+  pthread_t thread;
+  uint32_t threadIndex;
+  uint32_t numberOfThreads;
+
+  // The job.
+  int inputDescriptor;
+  uint64_t numberOfFfts;
+  uint32_t fftsPerRow;
+  int rowMode;
+  bool unsignedSamples;
+  uint32_t width;
+  float lowLevel;
+  float dynamicRange;
+
+  // The strip that is being computed.
+  uint32_t firstRow;
+  uint32_t numberOfRows;
+  uint8_t *stripPtr;
+
+  // Per-thread resources.
+  SpectrumEngine *enginePtr;
+  int8_t *inputBufferPtr;
+  float *powerBufferPtr;
+  float *rowBufferPtr;
+  float *columnBufferPtr;
+};
+
+/*****************************************************************************
+
+  Name: getUserArguments
+
+  Purpose: The purpose of this function is to retrieve the user arguments
+  that were passed to the program.  Any arguments that are specified are
+  set to reasonable default values.
+
+  Calling Sequence: exitProgram = getUserArguments(parameters)
+
+  Inputs:
+
+    parameters - A structure that contains pointers to the user parameters.
+
+  Outputs:
+
+    exitProgram - A flag that indicates whether or not the program should
+    be exited.  A value of true indicates to exit the program, and a value
+    of false indicates that the program should not be exited..
+
+*****************************************************************************/
+bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
+{
+  bool exitProgram;
+  bool done;
+  int opt;
+  long processors;
+
+  // Default not to exit program.
+  exitProgram = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default parameters.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // There is no sensible default input file.
+  *parameters.inputFileNamePtr = NULL;
+
+  // Default to stdout.
+  *parameters.outputFileNamePtr = (char *)"-";
+
+  // Default to a row per FFT.
+  *parameters.heightPtr = 0;
+  *parameters.fftsPerRowPtr = 0;
+
+  // Default to averaging the FFT's of a row.
+  *parameters.rowModePtr = ROW_MEAN;
+
+  // Default to the width of the analyzer display.
+  *parameters.widthPtr = 1024;
+
+  // Default to 0dB through 80dB.
+  *parameters.lowLevelPtr = 0;
+  *parameters.dynamicRangePtr = 80;
+
+  // Default to one thread per processor.
+  processors = sysconf(_SC_NPROCESSORS_ONLN);
+  *parameters.numberOfThreadsPtr = (processors > 0) ? processors : 1;
+
+  // Default to signed IQ samples.
+  *parameters.unsignedSamplesPtr = false;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up for loop entry.
+  done = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Retrieve the command line arguments.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  while (!done)
+  {
+    // Retrieve the next option.
+    opt = getopt(argc,argv,"i:o:H:K:m:w:L:D:j:Uh");
+
+    switch (opt)
+    {
+      case 'i':
+      {
+        *parameters.inputFileNamePtr = optarg;
+        break;
+      } // case
+
+      case 'o':
+      {
+        *parameters.outputFileNamePtr = optarg;
+        break;
+      } // case
+
+      case 'H':
+      {
+        *parameters.heightPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'K':
+      {
+        *parameters.fftsPerRowPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'm':
+      {
+        *parameters.rowModePtr = atoi(optarg);
+        break;
+      } // case
+
+      case 'w':
+      {
+        *parameters.widthPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'L':
+      {
+        *parameters.lowLevelPtr = atof(optarg);
+        break;
+      } // case
+
+      case 'D':
+      {
+        *parameters.dynamicRangePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'j':
+      {
+        *parameters.numberOfThreadsPtr = atol(optarg);
+        break;
+      } // case
+
+      case 'U':
+      {
+        *parameters.unsignedSamplesPtr = true;
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./spectrogram -i inputfile -o outputfile (- for stdout)\n"
+                "              -H height (rows)\n"
+                "              -K fftsperrow (overrides height)\n"
+                "              -m [1 - maximum | 2 - mean]\n"
+                "              -w width (columns)\n"
+                "              -L lowlevel (dB)\n"
+                "              -D dynamicrange (dB)\n"
+                "              -j threads\n"
+                "              -U (unsigned samples)\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Keep things sane.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  if ((*parameters.widthPtr == 0) || (*parameters.widthPtr > N))
+  {
+    *parameters.widthPtr = 1024;
+  } // if
+
+  if (*parameters.numberOfThreadsPtr == 0)
+  {
+    *parameters.numberOfThreadsPtr = 1;
+  } // if
+
+  if (*parameters.numberOfThreadsPtr > MAX_THREADS)
+  {
+    *parameters.numberOfThreadsPtr = MAX_THREADS;
+  } // if
+
+  if (*parameters.dynamicRangePtr <= 0)
+  {
+    *parameters.dynamicRangePtr = 80;
+  } // if
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+/*****************************************************************************
+
+  Name: computeRow
+
+  Purpose: The purpose of this function is to compute one row of the
+  spectrogram.  The FFT's of the row are read from the input file,
+  combined in linear power, converted to decibels, binned to the image
+  width and mapped to gray levels.
+
+  Calling Sequence: computeRow(contextPtr,row,pixelsPtr)
+
+  Inputs:
+
+    contextPtr - A pointer to the worker context.
+
+    row - The row number.
+
+    pixelsPtr - A pointer to storage for the width pixels of the row.
+
+  Outputs:
+
+    pixelsPtr - The gray levels of the row.
+
+*****************************************************************************/
+static void computeRow(struct WorkerContext *contextPtr,
+  uint32_t row,
+  uint8_t *pixelsPtr)
+{
+  uint32_t i;
+  uint32_t numberOfFfts;
+  uint64_t fft;
+  uint64_t firstFft;
+  uint64_t lastFft;
+  ssize_t count;
+  float level;
+
+  firstFft = (uint64_t)row * contextPtr->fftsPerRow;
+  lastFft = firstFft + contextPtr->fftsPerRow;
+
+  if (lastFft > contextPtr->numberOfFfts)
+  {
+    // The last row may be short.
+    lastFft = contextPtr->numberOfFfts;
+  } // if
+
+  numberOfFfts = 0;
+
+  for (fft = firstFft; fft < lastFft; fft++)
+  {
+    count = pread(contextPtr->inputDescriptor,
+                  contextPtr->inputBufferPtr,
+                  2 * N,
+                  (off_t)(fft * 2 * N));
+
+    if (count != (2 * N))
+    {
+      // This should only happen if the file shrinks under us.
+      break;
+    } // if
+
+    if (contextPtr->unsignedSamples)
+    {
+      for (i = 0; i < (2 * N); i++)
+      {
+        // Convert unsigned samples to signed quantities.
+        contextPtr->inputBufferPtr[i] -= 128;
+      } // for
+    } // if
+
+    contextPtr->enginePtr->computePowerSpectrum(contextPtr->inputBufferPtr,
+                                                2 * N,
+                                                contextPtr->powerBufferPtr);
+
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    // Combine the FFT's of the row in linear power.
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+    if (numberOfFfts == 0)
+    {
+      memcpy(contextPtr->rowBufferPtr,
+             contextPtr->powerBufferPtr,
+             N * sizeof(float));
+    } // if
+    else
+    {
+      if (contextPtr->rowMode == ROW_MAXIMUM)
+      {
+        for (i = 0; i < N; i++)
+        {
+          if (contextPtr->powerBufferPtr[i] > contextPtr->rowBufferPtr[i])
+          {
+            contextPtr->rowBufferPtr[i] = contextPtr->powerBufferPtr[i];
+          } // if
+        } // for
+      } // if
+      else
+      {
+        for (i = 0; i < N; i++)
+        {
+          contextPtr->rowBufferPtr[i] += contextPtr->powerBufferPtr[i];
+        } // for
+      } // else
+    } // else
+    //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+    numberOfFfts++;
+  } // for
+
+  if (numberOfFfts == 0)
+  {
+    // Nothing to show.
+    memset(pixelsPtr,0,contextPtr->width);
+    return;
+  } // if
+
+  // Turn a sum into an average, and convert to decibels.
+  contextPtr->enginePtr->convertToDb(contextPtr->rowBufferPtr,
+    (contextPtr->rowMode == ROW_MAXIMUM) ? 1.0f : (1.0f / numberOfFfts),
+    contextPtr->rowBufferPtr);
+
+  // Fit the bins to the image width.
+  contextPtr->enginePtr->binSpectrum(contextPtr->rowBufferPtr,
+                                     contextPtr->columnBufferPtr,
+                                     contextPtr->width);
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Map the levels to gray.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < contextPtr->width; i++)
+  {
+    level = (contextPtr->columnBufferPtr[i] - contextPtr->lowLevel) *
+            (255 / contextPtr->dynamicRange);
+
+    if (level < 0)
+    {
+      level = 0;
+    } // if
+
+    if (level > 255)
+    {
+      level = 255;
+    } // if
+
+    pixelsPtr[i] = (uint8_t)level;
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return;
+
+} // computeRow
+
+/*****************************************************************************
+
+  Name: workerThread
+
+  Purpose: The purpose of this function is to compute this thread's
+  share of the rows of a strip.  The rows are dealt out to the threads
+  like cards, so that each thread gets the same amount of work.
+
+  Calling Sequence: workerThread(argumentPtr)
+
+  Inputs:
+
+    argumentPtr - A pointer to the worker context.
+
+  Outputs:
+
+    None.
+
+*****************************************************************************/
+static void *workerThread(void *argumentPtr)
+{
+  uint32_t row;
+  struct WorkerContext *contextPtr;
+
+  contextPtr = (struct WorkerContext *)argumentPtr;
+
+  for (row = contextPtr->threadIndex;
+       row < contextPtr->numberOfRows;
+       row += contextPtr->numberOfThreads)
+  {
+    computeRow(contextPtr,
+               contextPtr->firstRow + row,
+               &contextPtr->stripPtr[row * contextPtr->width]);
+  } // for
+
+  return (NULL);
+
+} // workerThread
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool exitProgram;
+  uint32_t i;
+  uint32_t row;
+  uint32_t height;
+  uint32_t fftsPerRow;
+  int rowMode;
+  uint32_t width;
+  float lowLevel;
+  float dynamicRange;
+  uint32_t numberOfThreads;
+  uint32_t stripHeight;
+  uint32_t numberOfRows;
+  uint64_t numberOfFfts;
+  bool unsignedSamples;
+  bool success;
+  char *inputFileName;
+  char *outputFileName;
+  int inputDescriptor;
+  uint8_t *stripPtr;
+  FILE *outputStreamPtr;
+  struct stat fileStatus;
+  struct WorkerContext *contextPtr;
+  struct WorkerContext contexts[MAX_THREADS];
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.inputFileNamePtr = &inputFileName;
+  parameters.outputFileNamePtr = &outputFileName;
+  parameters.heightPtr = &height;
+  parameters.fftsPerRowPtr = &fftsPerRow;
+  parameters.rowModePtr = &rowMode;
+  parameters.widthPtr = &width;
+  parameters.lowLevelPtr = &lowLevel;
+  parameters.dynamicRangePtr = &dynamicRange;
+  parameters.numberOfThreadsPtr = &numberOfThreads;
+  parameters.unsignedSamplesPtr = &unsignedSamples;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  if (inputFileName == NULL)
+  {
+    fprintf(stderr,"An input file must be specified with -i\n");
+    return (1);
+  } // if
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Size up the job.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  inputDescriptor = open(inputFileName,O_RDONLY);
+
+  if (inputDescriptor < 0)
+  {
+    fprintf(stderr,"Could not open input file %s\n",inputFileName);
+    return (1);
+  } // if
+
+  fstat(inputDescriptor,&fileStatus);
+
+  // A partial FFT at the end of the file is ignored.
+  numberOfFfts = (uint64_t)fileStatus.st_size / (2 * N);
+
+  if (numberOfFfts == 0)
+  {
+    fprintf(stderr,"The input file is shorter than one FFT\n");
+    close(inputDescriptor);
+    return (1);
+  } // if
+
+  if (fftsPerRow == 0)
+  {
+    if (height == 0)
+    {
+      // One row per FFT.
+      fftsPerRow = 1;
+    } // if
+    else
+    {
+      // Round up so that the whole file fits.
+      fftsPerRow = (uint32_t)((numberOfFfts + height - 1) / height);
+    } // else
+  } // if
+
+  numberOfRows = (uint32_t)((numberOfFfts + fftsPerRow - 1) / fftsPerRow);
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  if (strcmp(outputFileName,"-") == 0)
+  {
+    outputStreamPtr = stdout;
+  } // if
+  else
+  {
+    outputStreamPtr = fopen(outputFileName,"wb");
+
+    if (outputStreamPtr == NULL)
+    {
+      fprintf(stderr,"Could not open output file %s\n",outputFileName);
+      close(inputDescriptor);
+      return (1);
+    } // if
+  } // else
+
+  // The strip is the only image memory.
+  stripHeight = numberOfThreads * ROWS_PER_THREAD;
+  stripPtr = new uint8_t[stripHeight * width];
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Set up the workers.  FFTW planning isn't thread safe,
+  // so the engines are all created here.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    contextPtr = &contexts[i];
+
+    contextPtr->threadIndex = i;
+    contextPtr->numberOfThreads = numberOfThreads;
+    contextPtr->inputDescriptor = inputDescriptor;
+    contextPtr->numberOfFfts = numberOfFfts;
+    contextPtr->fftsPerRow = fftsPerRow;
+    contextPtr->rowMode = rowMode;
+    contextPtr->unsignedSamples = unsignedSamples;
+    contextPtr->width = width;
+    contextPtr->lowLevel = lowLevel;
+    contextPtr->dynamicRange = dynamicRange;
+    contextPtr->stripPtr = stripPtr;
+
+    contextPtr->enginePtr = new SpectrumEngine(N);
+    contextPtr->inputBufferPtr = new int8_t[2 * N];
+    contextPtr->powerBufferPtr = new float[N];
+    contextPtr->rowBufferPtr = new float[N];
+    contextPtr->columnBufferPtr = new float[width];
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  fprintf(stderr,"%llu FFT's, %u per row, %u x %u image, %u threads\n",
+          (unsigned long long)numberOfFfts,fftsPerRow,
+          width,numberOfRows,numberOfThreads);
+
+  fprintf(outputStreamPtr,"P5\n%u %u\n255\n",width,numberOfRows);
+
+  success = true;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Compute and write the image a strip at a time.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  for (row = 0; (row < numberOfRows) && success; row += stripHeight)
+  {
+    for (i = 0; i < numberOfThreads; i++)
+    {
+      contexts[i].firstRow = row;
+      contexts[i].numberOfRows = numberOfRows - row;
+
+      if (contexts[i].numberOfRows > stripHeight)
+      {
+        contexts[i].numberOfRows = stripHeight;
+      } // if
+
+      pthread_create(&contexts[i].thread,NULL,workerThread,&contexts[i]);
+    } // for
+
+    for (i = 0; i < numberOfThreads; i++)
+    {
+      pthread_join(contexts[i].thread,NULL);
+    } // for
+
+    if (fwrite(stripPtr,width,contexts[0].numberOfRows,outputStreamPtr) !=
+        contexts[0].numberOfRows)
+    {
+      fprintf(stderr,"Could not write the image\n");
+      success = false;
+    } // if
+  } // for
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Release resources.
+  for (i = 0; i < numberOfThreads; i++)
+  {
+    delete contexts[i].enginePtr;
+    delete[] contexts[i].inputBufferPtr;
+    delete[] contexts[i].powerBufferPtr;
+    delete[] contexts[i].rowBufferPtr;
+    delete[] contexts[i].columnBufferPtr;
+  } // for
+
+  delete[] stripPtr;
+  close(inputDescriptor);
+
+  if (outputStreamPtr != stdout)
+  {
+    if (fclose(outputStreamPtr) != 0)
+    {
+      success = false;
+    } // if
+  } // if
+
+  return (success ? 0 : 1);
+
+} // main
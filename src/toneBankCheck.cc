@@ -0,0 +1,336 @@
+//*************************************************************************
+// File name: toneBankCheck.cc
+//*************************************************************************
+
+//*************************************************************************
+// This program checks the levels that are measured by the Goertzel
+// filter bank of toneMonitor.  Complex tones of a known level are
+// quantized to 8-bit IQ samples and run through a ToneBank that watches
+// their frequencies, for several integration times, and each measured
+// level is compared with the level of the tone.  Low frequencies and
+// long integration times are included, since that is where a filter
+// that lacks precision goes wrong.  Each measurement is written to
+// stdout, and the exit status is 0 when every level is within 0.5dB and
+// 1 otherwise.
+//
+// To run this program type,
+//
+//     ./toneBankCheck -r <sampleRate> -a <amplitude>
+//
+// where,
+//
+//    sampleRate - The sample rate of the IQ data in S/s.  The default is
+//    2400000S/s.
+//
+//    amplitude - The amplitude of the test tones in 8-bit units.  The
+//    default is 40, which is about -10dB relative to full scale.
+///*************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "ToneBank.h"
+
+// The largest error that is accepted, in dB.
+#define TOLERANCE (0.5)
+
+// This structure is used to consolidate user parameters.
+struct MyParameters
+{
+  float *sampleRatePtr;
+  float *amplitudePtr;
+};
+
+/*****************************************************************************
+
+  Name: getUserArguments
+
+  Purpose: The purpose of this function is to retrieve the user arguments
+  that were passed to the program.  Any arguments that are specified are
+  set to reasonable default values.
+
+  Calling Sequence: exitProgram = getUserArguments(parameters)
+
+  Inputs:
+
+    parameters - A structure that contains pointers to the user parameters.
+
+  Outputs:
+
+    exitProgram - A flag that indicates whether or not the program should
+    be exited.  A value of true indicates to exit the program, and a value
+    of false indicates that the program should not be exited..
+
+*****************************************************************************/
+bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
+{
+  bool exitProgram;
+  bool done;
+  int opt;
+
+  // Default not to exit program.
+  exitProgram = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default parameters.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default to the sample rate of an rtl-sdr.
+  *parameters.sampleRatePtr = 2400000;
+
+  // Default to about -10dB relative to full scale.
+  *parameters.amplitudePtr = 40;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up for loop entry.
+  done = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Retrieve the command line arguments.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  while (!done)
+  {
+    // Retrieve the next option.
+    opt = getopt(argc,argv,"r:a:h");
+
+    switch (opt)
+    {
+      case 'r':
+      {
+        *parameters.sampleRatePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'a':
+      {
+        *parameters.amplitudePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./toneBankCheck -r samplerate (S/s) "
+                "-a toneamplitude\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+/*****************************************************************************
+
+  Name: clip
+
+  Purpose: The purpose of this function is to quantize a value to an
+  8-bit sample.
+
+  Calling Sequence: sample = clip(value)
+
+  Inputs:
+
+    value - The value to quantize.
+
+  Outputs:
+
+    sample - The quantized value.
+
+*****************************************************************************/
+static int8_t clip(double value)
+{
+
+  value = floor(value + 0.5);
+
+  if (value > 127)
+  {
+    value = 127;
+  } // if
+  else
+  {
+    if (value < -128)
+    {
+      value = -128;
+    } // if
+  } // else
+
+  return ((int8_t)value);
+
+} // clip
+
+/*****************************************************************************
+
+  Name: measureTone
+
+  Purpose: The purpose of this function is to measure the level of a
+  complex tone with a ToneBank for one integration period.
+
+  Calling Sequence: powerInDb = measureTone(sampleRate,
+                                            frequency,
+                                            amplitude,
+                                            integrationLength)
+
+  Inputs:
+
+    sampleRate - The sample rate of the IQ data in S/s.
+
+    frequency - The frequency of the tone in Hz, relative to the center
+    of the band.
+
+    amplitude - The amplitude of the tone in 8-bit units.
+
+    integrationLength - The number of samples that the measurement
+    covers.
+
+  Outputs:
+
+    powerInDb - The measured power in dB relative to a full scale tone.
+
+*****************************************************************************/
+static float measureTone(float sampleRate,
+  float frequency,
+  float amplitude,
+  uint32_t integrationLength)
+{
+  uint32_t i;
+  uint32_t samplesLeft;
+  uint32_t samplesInBlock;
+  uint64_t n;
+  double w;
+  int8_t signalBuffer[16384];
+  float powerInDb;
+  ToneBank *bankPtr;
+
+  bankPtr = new ToneBank(sampleRate,&frequency,1,integrationLength,NULL);
+
+  w = (2 * M_PI * frequency) / sampleRate;
+
+  n = 0;
+  samplesLeft = integrationLength;
+
+  while (samplesLeft > 0)
+  {
+    samplesInBlock = sizeof(signalBuffer) / 2;
+
+    if (samplesInBlock > samplesLeft)
+    {
+      samplesInBlock = samplesLeft;
+    } // if
+
+    for (i = 0; i < samplesInBlock; i++)
+    {
+      signalBuffer[2 * i] = clip(amplitude * cos(w * n));
+      signalBuffer[(2 * i) + 1] = clip(amplitude * sin(w * n));
+      n++;
+    } // for
+
+    bankPtr->acceptSamples(signalBuffer,2 * samplesInBlock);
+
+    samplesLeft -= samplesInBlock;
+  } // while
+
+  bankPtr->getPowers(&powerInDb);
+
+  // Release resources.
+  delete bankPtr;
+
+  return (powerInDb);
+
+} // measureTone
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool exitProgram;
+  bool passed;
+  uint32_t i;
+  uint32_t j;
+  uint32_t integrationLength;
+  float sampleRate;
+  float amplitude;
+  float expectedInDb;
+  float powerInDb;
+  float frequencies[5];
+  float integrationTimes[5] = {10, 50, 100, 200, 500};
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.sampleRatePtr = &sampleRate;
+  parameters.amplitudePtr = &amplitude;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  // DC, low frequencies on both sides, and a quarter of the band.
+  frequencies[0] = 0;
+  frequencies[1] = 500;
+  frequencies[2] = -1000;
+  frequencies[3] = 12500;
+  frequencies[4] = sampleRate / 4;
+
+  expectedInDb = 20 * log10f(amplitude / 127);
+
+  passed = true;
+
+  printf("Tone level %.2fdB at %.0fS/s\n",expectedInDb,sampleRate);
+
+  for (i = 0; i < 5; i++)
+  {
+    for (j = 0; j < 5; j++)
+    {
+      integrationLength = (uint32_t)((integrationTimes[j] * sampleRate) /
+                                     1000);
+
+      powerInDb = measureTone(sampleRate,
+                              frequencies[i],
+                              amplitude,
+                              integrationLength);
+
+      printf("%10.0fHz %5.0fms: %7.2fdB",
+             frequencies[i],integrationTimes[j],powerInDb);
+
+      if (fabsf(powerInDb - expectedInDb) > TOLERANCE)
+      {
+        printf(" FAILED\n");
+        passed = false;
+      } // if
+      else
+      {
+        printf("\n");
+      } // else
+    } // for
+  } // for
+
+  if (!passed)
+  {
+    printf("Some levels are off by more than %.1fdB\n",TOLERANCE);
+    return (1);
+  } // if
+
+  printf("All levels are within %.1fdB\n",TOLERANCE);
+
+  return (0);
+
+} // main
@@ -0,0 +1,310 @@
+//*************************************************************************
+// File name: toneMonitor.cc
+//*************************************************************************
+
+//*************************************************************************
+// This program watches the power at a handful of fixed frequencies
+// (pilots, beacons, and so on) in IQ data that is provided by stdin.
+// Rather than computing a whole spectrum, a bank of Goertzel filters
+// computes only the frequencies of interest, so it takes a small
+// fraction of the CPU that the signal analyzer takes, and it reports
+// after every integration period rather than at the display frame rate.
+// Each report is one line on stdout: the time, in seconds, of the end of
+// the integration period, followed by the power of each tone in dB
+// relative to a full scale tone, separated by commas.  The output is
+// flushed after every line.  For example, to watch a beacon while the
+// analyzer shows the spectrum,
+//
+//    ./analyzer -d 2 -D < inputFile | ./toneMonitor -f 12500
+//
+// To run this program type,
+//
+//     ./toneMonitor -r <sampleRate> -f <frequencies>
+//                   -i <integrationTime> -U < inputFile
+//
+// where,
+//
+//    sampleRate - The sample rate of the IQ data in S/s.  The default is
+//    256000S/s.
+//
+//    frequencies - A comma separated list of up to 32 frequencies, in
+//    Hz relative to the center of the band.  For example,
+//    -f -25000,1000,50000.
+//
+//    integrationTime - The length of each measurement in milliseconds.
+//    Longer times give finer frequency resolution (about 1000 /
+//    integrationTime Hz) and less noise, and shorter times report more
+//    often.  The default is 10ms.
+//
+//    The U flag indicates that the IQ samples are unsigned 8-bit
+//    quantities, as written by rtl_sdr.
+///*************************************************************************
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "ToneBank.h"
+
+// This structure is used to consolidate user parameters.
+struct MyParameters
+{
+  float *sampleRatePtr;
+  float *frequenciesPtr;
+  uint32_t *numberOfTonesPtr;
+  float *integrationTimePtr;
+  bool *unsignedSamplesPtr;
+};
+
+/*****************************************************************************
+
+  Name: parseFrequencies
+
+  Purpose: The purpose of this function is to convert a comma separated
+  list of frequencies into an array.
+
+  Calling Sequence: numberOfTones = parseFrequencies(listPtr,
+                                                     frequenciesPtr)
+
+  Inputs:
+
+    listPtr - A pointer to the list.
+
+    frequenciesPtr - A pointer to storage for MAX_TONES frequencies.
+
+  Outputs:
+
+    frequenciesPtr - The frequencies.
+
+    numberOfTones - The number of frequencies in the list.
+
+*****************************************************************************/
+static uint32_t parseFrequencies(char *listPtr,float *frequenciesPtr)
+{
+  uint32_t numberOfTones;
+  char *endPtr;
+
+  numberOfTones = 0;
+
+  while ((*listPtr != '\0') && (numberOfTones < MAX_TONES))
+  {
+    frequenciesPtr[numberOfTones] = strtod(listPtr,&endPtr);
+
+    if (endPtr == listPtr)
+    {
+      // Not a number, so stop here.
+      break;
+    } // if
+
+    numberOfTones++;
+
+    // Skip the comma.
+    listPtr = (*endPtr == ',') ? (endPtr + 1) : endPtr;
+  } // while
+
+  return (numberOfTones);
+
+} // parseFrequencies
+
+/*****************************************************************************
+
+  Name: getUserArguments
+
+  Purpose: The purpose of this function is to retrieve the user arguments
+  that were passed to the program.  Any arguments that are specified are
+  set to reasonable default values.
+
+  Calling Sequence: exitProgram = getUserArguments(parameters)
+
+  Inputs:
+
+    parameters - A structure that contains pointers to the user parameters.
+
+  Outputs:
+
+    exitProgram - A flag that indicates whether or not the program should
+    be exited.  A value of true indicates to exit the program, and a value
+    of false indicates that the program should not be exited..
+
+*****************************************************************************/
+bool getUserArguments(int argc,char **argv,struct MyParameters parameters)
+{
+  bool exitProgram;
+  bool done;
+  int opt;
+
+  // Default not to exit program.
+  exitProgram = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default parameters.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Default to 256000S/s.
+  *parameters.sampleRatePtr = 256000;
+
+  // There is no sensible default frequency.
+  *parameters.numberOfTonesPtr = 0;
+
+  // Default to 10ms.
+  *parameters.integrationTimePtr = 10;
+
+  // Default to signed IQ samples.
+  *parameters.unsignedSamplesPtr = false;
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  // Set up for loop entry.
+  done = false;
+
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  // Retrieve the command line arguments.
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+  while (!done)
+  {
+    // Retrieve the next option.
+    opt = getopt(argc,argv,"r:f:i:Uh");
+
+    switch (opt)
+    {
+      case 'r':
+      {
+        *parameters.sampleRatePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'f':
+      {
+        *parameters.numberOfTonesPtr =
+          parseFrequencies(optarg,parameters.frequenciesPtr);
+        break;
+      } // case
+
+      case 'i':
+      {
+        *parameters.integrationTimePtr = atof(optarg);
+        break;
+      } // case
+
+      case 'U':
+      {
+        *parameters.unsignedSamplesPtr = true;
+        break;
+      } // case
+
+      case 'h':
+      {
+        // Display usage.
+        fprintf(stderr,"./toneMonitor -r samplerate (S/s)\n"
+                "              -f frequency,frequency,... (Hz)\n"
+                "              -i integrationtime (ms)\n"
+                "              -U (unsigned samples) < inputFile\n");
+
+        // Indicate that program must be exited.
+        exitProgram = true;
+        break;
+      } // case
+
+      case -1:
+      {
+        // All options consumed, so bail out.
+        done = true;
+      } // case
+    } // switch
+
+  } // while
+  //_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/
+
+  return (exitProgram);
+
+} // getUserArguments
+
+//*************************************************************************
+// Mainline code.
+//*************************************************************************
+int main(int argc,char **argv)
+{
+  bool done;
+  bool exitProgram;
+  uint32_t i;
+  uint32_t count;
+  int8_t inputBuffer[16384];
+  float sampleRate;
+  float frequencies[MAX_TONES];
+  uint32_t numberOfTones;
+  float integrationTime;
+  uint32_t integrationLength;
+  bool unsignedSamples;
+  ToneBank *bankPtr;
+  struct MyParameters parameters;
+
+  // Set up for parameter transmission.
+  parameters.sampleRatePtr = &sampleRate;
+  parameters.frequenciesPtr = frequencies;
+  parameters.numberOfTonesPtr = &numberOfTones;
+  parameters.integrationTimePtr = &integrationTime;
+  parameters.unsignedSamplesPtr = &unsignedSamples;
+
+  // Retrieve the system parameters.
+  exitProgram = getUserArguments(argc,argv,parameters);
+
+  if (exitProgram)
+  {
+    // Bail out.
+    return (0);
+  } // if
+
+  if (numberOfTones == 0)
+  {
+    fprintf(stderr,"At least one frequency must be specified with -f\n");
+    return (1);
+  } // if
+
+  // Convert the integration time to samples.
+  integrationLength = (uint32_t)((integrationTime * sampleRate) / 1000);
+
+  if (integrationLength == 0)
+  {
+    // Keep it sane.
+    integrationLength = 1;
+  } // if
+
+  // Instantiate the filter bank.
+  bankPtr = new ToneBank(sampleRate,
+                         frequencies,
+                         numberOfTones,
+                         integrationLength,
+                         stdout);
+
+  // Set up for loop entry.
+  done = false;
+
+  while (!done)
+  {
+    // Read a block of input samples.
+    count = fread(inputBuffer,sizeof(int8_t),sizeof(inputBuffer),stdin);
+
+    if (count == 0)
+    {
+      // We're done.
+      done = true;
+    } // if
+    else
+    {
+      if (unsignedSamples)
+      {
+        for (i = 0; i < count; i++)
+        {
+          // Convert unsigned samples to signed quantities.
+          inputBuffer[i] -= 128;
+        } // for
+      } // if
+
+      bankPtr->acceptSamples(inputBuffer,count);
+    } // else
+  } // while
+
+  // Release resources.
+  delete bankPtr;
+
+  return (0);
+
+} // main